@@ -0,0 +1,44 @@
+#pragma once
+#include "defines.h"
+
+#include "ECS/ecs_types.h"
+
+#define COMMAND_BUFFER_MIN_CAPACITY 64
+#define COMMAND_BUFFER_MIN_DATA_CAPACITY 4096
+
+/*
+ * Records structural changes to a scene so that systems can make them while
+ * the scene is being iterated over, possibly by other threads. Recording is
+ * thread safe. The commands are applied in one batch sorted by entity, and
+ * the commands of any one entity are applied in the order they were
+ * recorded. Entities created while recording have handles reserved in the
+ * scene's entity table, which come after every existing entity, so their
+ * commands are applied after those of the existing entities.
+ */
+CommandBuffer *createCommandBuffer(void);
+void freeCommandBuffer(CommandBuffer **buffer);
+
+// Gives the reserved entity a UUID, the entity is removed again if the UUID
+// already belongs to another entity
+void commandBufferRegisterEntity(
+	CommandBuffer *buffer,
+	EntityHandle entity,
+	UUID id);
+void commandBufferRemoveEntity(CommandBuffer *buffer, EntityHandle entity);
+// The component data is copied, so it doesn't have to outlive the call
+void commandBufferAddComponentToEntity(
+	CommandBuffer *buffer,
+	EntityHandle entity,
+	ComponentTypeHandle componentType,
+	void *componentData,
+	uint32 componentSize);
+void commandBufferRemoveComponentFromEntity(
+	CommandBuffer *buffer,
+	EntityHandle entity,
+	ComponentTypeHandle componentType);
+
+// Must only be called while no system is running on the scene. The buffer
+// isn't locked while the commands are applied, so commands recorded by
+// component hooks are applied in another batch afterwards.
+void commandBufferApply(CommandBuffer *buffer, Scene *scene);
+void commandBufferClear(CommandBuffer *buffer);
@@ -3,23 +3,63 @@
 
 #include "ECS/ecs_types.h"
 
-#define CDT_ID_BUCKETS 10007
+#define CDT_MIN_SPARSE_SIZE 64
+#define CDT_CHUNK_SIZE_BYTES 16384
+
+// Creates the component type registry, before any system or scene
+void initializeComponentTypes(void);
+// Returns INVALID_HANDLE once MAX_COMPONENT_TYPES types are registered
+ComponentTypeHandle componentTypeFromName(const char *name);
+ComponentTypeHandle componentTypeFromID(UUID componentID);
+// Returns the component type of a signature bit
+ComponentTypeHandle componentTypeFromIndex(uint32 index);
+UUID componentTypeGetID(ComponentTypeHandle componentType);
+void freeComponentTypes(void);
+
+bool signatureHasComponentType(
+	ComponentSignature const *signature,
+	ComponentTypeHandle componentType);
+void signatureAddComponentType(
+	ComponentSignature *signature,
+	ComponentTypeHandle componentType);
+void signatureRemoveComponentType(
+	ComponentSignature *signature,
+	ComponentTypeHandle componentType);
+// Returns true if the signature has every one of the component types
+bool signatureContains(
+	ComponentSignature const *signature,
+	ComponentSignature const *componentTypes);
+// Returns the first set bit at or after index, or MAX_COMPONENT_TYPES
+uint32 signatureGetNextIndex(
+	ComponentSignature const *signature,
+	uint32 index);
 
 ComponentDataTable *createComponentDataTable(
 	UUID componentID,
 	uint32 numEntries,
 	uint32 componentSize);
 void freeComponentDataTable(ComponentDataTable **table);
+void cdtLogUsage(ComponentDataTable *table);
 
-int32 cdtInsert(ComponentDataTable *table, UUID entityID, void *componentData);
-void cdtRemove(ComponentDataTable *table, UUID entityID);
-void *cdtGet(ComponentDataTable *table, UUID entityID);
-UUID cdtGetIndexUUID(ComponentDataTable *table, uint32 index);
+int32 cdtInsert(
+	ComponentDataTable *table,
+	EntityHandle entity,
+	void *componentData);
+void cdtRemove(ComponentDataTable *table, EntityHandle entity);
+void *cdtGet(ComponentDataTable *table, EntityHandle entity);
+EntityHandle cdtGetIndexEntity(ComponentDataTable *table, uint32 index);
 void *cdtGetIndexData(ComponentDataTable *table, uint32 index);
-uint32 cdtGetIndexNF(ComponentDataTable *table, uint32 index);
+// Components are only contiguous within a chunk, returns NULL past the last
+// chunk with active components
+void *cdtGetChunkData(
+	ComponentDataTable *table,
+	uint32 chunk,
+	uint32 *numComponents);
 
+// Only the current entity and entities which have already been visited may
+// be removed while iterating, other removals have to be deferred
 ComponentDataTableIterator cdtGetIterator(ComponentDataTable *table);
 void cdtMoveIterator(ComponentDataTableIterator *itr);
 uint32 cdtIteratorAtEnd(ComponentDataTableIterator itr);
-UUID cdtIteratorGetUUID(ComponentDataTableIterator itr) ;
+EntityHandle cdtIteratorGetEntity(ComponentDataTableIterator itr);
 void *cdtIteratorGetData(ComponentDataTableIterator itr);
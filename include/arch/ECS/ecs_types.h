@@ -3,29 +3,56 @@
 
 #include "data/data_types.h"
 
+#include "file/file_types.h"
+
+#include <cjson/cJSON.h>
+
 #include <ode/ode.h>
 
-typedef struct component_data_entry_t
+#include <pthread.h>
+
+// Interned entity UUID, only valid in the scene that created it
+typedef Handle EntityHandle;
+// Interned component type UUID, valid in every scene
+typedef Handle ComponentTypeHandle;
+
+// Component type handles index the signature bits, so this is the most
+// component types which can be registered
+#define MAX_COMPONENT_TYPES 256
+
+// Bit i is set if the signature has the component type with handle index i
+typedef struct component_signature_t
 {
-	UUID entity;
-	uint32 nextFree;
-	uint8 data[];
-} ComponentDataEntry;
+	uint64 bits[MAX_COMPONENT_TYPES / 64];
+} ComponentSignature;
 
 typedef struct component_data_table_t
 {
 	// Name of component
 	UUID componentID;
-	// Maximum number of active components
+	// Expected number of active components, taken from the component limit
 	uint32 numEntries;
 	// Byte size of the component structure
 	uint32 componentSize;
-	// Index of the first free component in the array
-	uint32 firstFree;
-	// Maps UUID to uint32 index of component
-	HashMap idToIndex;
-	// Data table
-	uint8 data[];
+	// Number of active components, packed at the front of the data table
+	uint32 numComponents;
+	// Largest number of components that have been active at once
+	uint32 highWaterMark;
+	// Each chunk holds (1 << chunkShift) components
+	uint32 chunkShift;
+	uint32 numChunks;
+	// Components are allocated a chunk at a time, so growing the table
+	// never moves existing components
+	uint8 **chunks;
+	// Number of entries in the sparse array
+	uint32 sparseSize;
+	// Maps entity handle indices to the index of their component
+	uint32 *sparse;
+	// Entity which owns each active component
+	EntityHandle *entities;
+	// Lowest index removed since an iterator last moved, only tracked in
+	// debug builds to catch removals which break iteration
+	uint32 lowestRemovedIndex;
 } ComponentDataTable;
 
 typedef struct
@@ -34,6 +61,64 @@ typedef struct
 	ComponentDataTable *table;
 } ComponentDataTableIterator;
 
+#define QUERY_MAX_COMPONENT_TYPES 8
+
+typedef struct query_t
+{
+	// Component types an entity needs to match, in the order their
+	// components are returned by the query iterator
+	uint32 numComponentTypes;
+	ComponentTypeHandle componentTypes[QUERY_MAX_COMPONENT_TYPES];
+	ComponentSignature signature;
+	// Number of matching entities, packed at the front of entities
+	uint32 numEntities;
+	uint32 capacity;
+	EntityHandle *entities;
+	// Number of entries in the sparse array
+	uint32 sparseSize;
+	// Maps entity handle indices to their index in entities
+	uint32 *sparse;
+} Query;
+
+typedef enum scene_command_type_e
+{
+	SCENE_COMMAND_REGISTER_ENTITY = 0,
+	SCENE_COMMAND_REMOVE_ENTITY,
+	SCENE_COMMAND_ADD_COMPONENT,
+	SCENE_COMMAND_REMOVE_COMPONENT
+} SceneCommandType;
+
+typedef struct scene_command_t
+{
+	SceneCommandType type;
+	// Entities created through the command buffer have a reserved handle
+	EntityHandle entity;
+	ComponentTypeHandle componentType;
+	// Order the command was recorded in
+	uint32 sequence;
+	// Offset of the component data, or the UUID of a registered entity, in
+	// the command buffer's data
+	uint32 dataOffset;
+} SceneCommand;
+
+typedef struct command_buffer_t
+{
+	uint32 numCommands;
+	uint32 capacity;
+	SceneCommand *commands;
+	// Copies of the component data of every add component command
+	uint32 dataSize;
+	uint32 dataCapacity;
+	uint8 *data;
+	// The batch being applied is swapped out into these, so that commands
+	// can be recorded while it is applied
+	uint32 applyCapacity;
+	SceneCommand *applyCommands;
+	uint32 applyDataCapacity;
+	uint8 *applyData;
+	pthread_mutex_t mutex;
+} CommandBuffer;
+
 typedef enum data_type_e {
 	INVALID_DATA_TYPE = -1,
 	DATA_TYPE_UINT8 = 0,
@@ -70,14 +155,228 @@ typedef struct component_definition_t
 	ComponentValueDefinition *values;
 } ComponentDefinition;
 
+typedef struct loaded_entity_component_t
+{
+	// Index of the component's entity and definition in its batch
+	uint32 entity;
+	uint32 componentDefinition;
+	// Offset of the component's data in the batch's data
+	uint64 dataOffset;
+} LoadedEntityComponent;
+
+// Staging buffers of the entity files which one job parsed, nothing in them
+// is shared with the other batches
+typedef struct loaded_entity_batch_t
+{
+	uint32 firstFile;
+	uint32 numFiles;
+	// Every file holds a single entity
+	UUID *entities;
+	uint32 numComponents;
+	uint32 componentCapacity;
+	LoadedEntityComponent *components;
+	uint64 dataSize;
+	uint64 dataCapacity;
+	uint8 *data;
+	// Definition of each component the batch's files have, taken from the
+	// first file which has it
+	uint32 numComponentDefinitions;
+	ComponentDefinition *componentDefinitions;
+	// Every file is read whole into the same buffer
+	uint64 fileBufferCapacity;
+	uint8 *fileBuffer;
+	int32 error;
+} LoadedEntityBatch;
+
+// Entities of a scene which have been read, but not added to it yet
+typedef struct loaded_scene_entities_t
+{
+	// Sorted, so that entities are always registered in the same order
+	uint32 numFiles;
+	char **filenames;
+	uint32 numBatches;
+	LoadedEntityBatch *batches;
+} LoadedSceneEntities;
+
+#define SCENE_SNAPSHOT_EXTENSION "snapshot"
+#define SCENE_SNAPSHOT_MAGIC "GSNP"
+#define SCENE_SNAPSHOT_VERSION 2
+
+typedef enum scene_snapshot_flags_e
+{
+	// The record only holds the chunks which changed since the record before
+	SCENE_SNAPSHOT_DELTA = 1,
+	// The record holds every entity, otherwise its chunks refer to the
+	// entities of the last record which does
+	SCENE_SNAPSHOT_ENTITIES = 2
+} SceneSnapshotFlags;
+
+// A snapshot is a full record followed by any number of delta records, the
+// offsets in a record are relative to the start of its header
+typedef struct scene_snapshot_header_t
+{
+	char magic[4];
+	uint32 version;
+	uint32 flags;
+	uint32 numEntities;
+	uint32 numComponentDefinitions;
+	uint32 numValueDefinitions;
+	uint32 numTables;
+	uint32 numChunks;
+	// Size of the whole record, the next record starts right after it
+	uint64 size;
+	uint64 entitiesOffset;
+	uint64 componentDefinitionsOffset;
+	uint64 valueDefinitionsOffset;
+	uint64 chunksOffset;
+	uint64 tablesOffset;
+	uint64 stringsOffset;
+} SceneSnapshotHeader;
+
+typedef struct scene_snapshot_component_definition_t
+{
+	// Names are offsets into the snapshot's strings
+	uint32 nameOffset;
+	uint32 size;
+	// The component's values follow each other in the value definitions
+	uint32 firstValue;
+	uint32 numValues;
+} SceneSnapshotComponentDefinition;
+
+typedef struct scene_snapshot_value_definition_t
+{
+	uint32 nameOffset;
+	int32 type;
+	uint32 maxStringSize;
+	uint32 count;
+} SceneSnapshotValueDefinition;
+
+typedef struct scene_snapshot_chunk_t
+{
+	// Index of each component's entity in the record's entities
+	uint64 entitiesOffset;
+	// The raw components, packed the same way as in their data table
+	uint64 dataOffset;
+	// Chunk i holds the components from i * chunkSize onwards
+	uint32 index;
+	uint32 numComponents;
+} SceneSnapshotChunk;
+
+typedef struct scene_snapshot_table_t
+{
+	uint32 componentDefinition;
+	// Number of components in the whole table, chunks past the end of the
+	// table are dropped
+	uint32 numComponents;
+	uint32 chunkSize;
+	// The table's chunks follow each other in the record's chunks
+	uint32 firstChunk;
+	uint32 numChunks;
+} SceneSnapshotTable;
+
+typedef struct scene_snapshot_record_t
+{
+	const SceneSnapshotHeader *header;
+	const UUID *entities;
+	const SceneSnapshotComponentDefinition *componentDefinitions;
+	const SceneSnapshotValueDefinition *valueDefinitions;
+	const SceneSnapshotChunk *chunks;
+	const SceneSnapshotTable *tables;
+	const char *strings;
+	// Index of the last record up to this one which holds every entity
+	uint32 entitiesRecord;
+} SceneSnapshotRecord;
+
+typedef struct scene_snapshot_t
+{
+	char *filename;
+	MappedFile file;
+	uint32 numRecords;
+	SceneSnapshotRecord *records;
+	// Size of the full record, and of every record which could be read
+	uint64 baseSize;
+	uint64 size;
+} SceneSnapshot;
+
+typedef struct scene_snapshot_table_state_t
+{
+	uint32 numComponents;
+	// Hash of the entities and components of each chunk as they were written
+	uint32 numChunks;
+	uint64 *chunkHashes;
+} SceneSnapshotTableState;
+
+// Copy of a component data table, with its chunks packed one after another
+typedef struct scene_snapshot_table_copy_t
+{
+	// Index of the component's definition in the snapshot copy, equal to the
+	// number of definitions if the scene doesn't have one
+	uint32 componentDefinition;
+	uint32 componentSize;
+	uint32 numComponents;
+	uint32 chunkShift;
+	EntityHandle *entities;
+	uint8 *data;
+} SceneSnapshotTableCopy;
+
+// Everything a snapshot is written from, copied out of the scene so that it
+// can be written while the scene keeps running
+typedef struct scene_snapshot_copy_t
+{
+	char *sceneName;
+	uint64 entitiesGeneration;
+	// Every entity in the order it's written, and the number of entity
+	// handle indices which were in use
+	uint32 numEntities;
+	uint32 numEntitySlots;
+	EntityHandle *entityHandles;
+	UUID *entities;
+	uint32 numComponentDefinitions;
+	uint32 numValueDefinitions;
+	SceneSnapshotComponentDefinition *componentDefinitions;
+	SceneSnapshotValueDefinition *valueDefinitions;
+	uint64 stringsSize;
+	char *strings;
+	// Indexed by component type handle index, NULL where the scene has no
+	// table
+	uint32 numTables;
+	SceneSnapshotTableCopy **tables;
+} SceneSnapshotCopy;
+
+// What the scene's snapshot file holds, so that only changes are written
+typedef struct scene_snapshot_state_t
+{
+	char *filename;
+	// No deltas can be written until the scene has a full record
+	uint32 numRecords;
+	uint64 baseSize;
+	uint64 size;
+	// Entity generation of the scene when its entities were last written
+	uint64 entitiesGeneration;
+	// Indexed by component type handle index
+	uint32 numTables;
+	SceneSnapshotTableState *tables;
+} SceneSnapshotState;
+
 typedef struct scene_t
 {
 	char *name;
-	// Maps component UUIDs to pointers to component data tables
-	HashMap componentTypes;
-	// Maps entity UUIDs to lists of component UUIDs
-	HashMap entities;
+	// Component data tables indexed by component type handle
+	uint32 numComponentTables;
+	ComponentDataTable **componentTables;
+	// Queries which are kept up to date as components are added and removed
+	uint32 numQueries;
+	Query **queries;
+	// Structural changes made while systems are running, which are applied
+	// once no system is iterating over the scene
+	CommandBuffer *commandBuffer;
+	// Interns entity UUIDs, each entity has the signature of its components
+	InternTable entities;
+	// Incremented whenever an entity is registered or removed
+	uint64 entitiesGeneration;
 	UUID mainCamera;
+	// Resolved from mainCamera when the scene is loaded
+	EntityHandle mainCameraEntity;
 	UUID player;
 	List physicsFrameSystems;
 	List renderFrameSystems;
@@ -92,18 +391,61 @@ typedef struct scene_t
 	dSpaceID physicsSpace;
 	dJointGroupID contactGroup;
 	real32 gravity;
+	// Only used on the serialization thread once the scene has been loaded
+	SceneSnapshotState *snapshotState;
 } Scene;
 
+// Error is -1 if the save couldn't be written
+typedef void(*SaveCallback)(uint32 slot, int32 error);
+
+// Copy of everything which is written when a scene is exported into the
+// runtime state
+typedef struct runtime_scene_export_t
+{
+	char *name;
+	cJSON *json;
+	SceneSnapshotCopy *snapshot;
+	SceneSnapshotState *snapshotState;
+} RuntimeSceneExport;
+
+typedef struct
+{
+	uint32 index;
+	// Index of the last entity the iterator visits
+	uint32 first;
+	Query *query;
+	ComponentDataTable *tables[QUERY_MAX_COMPONENT_TYPES];
+	// Components of the current entity, in the order of the query types
+	void *components[QUERY_MAX_COMPONENT_TYPES];
+} QueryIterator;
+
 typedef void(*InitSystem)(Scene *scene);
 typedef void(*BeginSystem)(Scene *scene, real64 dt);
-typedef void(*RunSystem)(Scene *scene, UUID entityID, real64 dt);
+typedef void(*RunSystem)(
+	Scene *scene,
+	EntityHandle entity,
+	void **components,
+	real64 dt);
 typedef void(*EndSystem)(Scene *scene, real64 dt);
 typedef void(*ShutdownSystem)(Scene *scene);
 
 typedef struct system_t
 {
+	// List of component type handles, the run function is passed the
+	// components of each entity in the same order
 	List componentTypes;
 
+	// Component types the system reads and writes, systems which do not
+	// declare either are assumed to access everything in the scene
+	List readComponentTypes;
+	List writeComponentTypes;
+	// Systems which use OpenGL, OpenAL or Lua have to run on the main thread
+	bool mainThread;
+	// Systems whose run function only touches the components of its own
+	// entity can be run over chunks of their query on several threads. Their
+	// structural changes have to go through the scene's deferred functions.
+	bool parallel;
+
 	InitSystem init;
 	BeginSystem begin;
 	RunSystem run;
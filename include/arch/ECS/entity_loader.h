@@ -0,0 +1,41 @@
+#pragma once
+#include "defines.h"
+
+#include "ECS/ecs_types.h"
+
+#include "threading/threading_types.h"
+
+#define ENTITY_BINARY_FILE_VERSION 1
+
+// Number of entity files a job parses into its batch's staging buffers
+#define ENTITY_LOADER_BATCH_SIZE 64
+
+/*
+ * Finds every entity file below the folder in a single walk, exporting JSON
+ * entities on the way, and parses the files in batches on the pool. Each
+ * file is read exactly once, so nothing has to be read again when the
+ * entities are added to the scene. Fails if any of the files can't be read.
+ */
+int32 readSceneEntities(
+	const char *folder,
+	ThreadPool *pool,
+	LoadedSceneEntities *entities);
+void freeLoadedSceneEntities(LoadedSceneEntities *entities);
+
+// Creates the scene's component definitions, the definition of a component
+// comes from the first entity file which has it
+void loadSceneEntityDefinitions(
+	Scene *scene,
+	const LoadedSceneEntities *entities);
+// Registers the entities and adds their components to the scene, the
+// component types have to have been added already
+void loadSceneEntities(Scene *scene, const LoadedSceneEntities *entities);
+
+// Writes numEntities generated entity files below the folder, then logs how
+// long loading them with the old two-pass loader, reading them on one thread
+// and on the pool, and loading them into a scene, takes. The loader is meant
+// to load 20k entities at least 5x faster than the two-pass loader.
+int32 benchmarkEntityLoading(
+	const char *folder,
+	uint32 numEntities,
+	ThreadPool *pool);
@@ -0,0 +1,40 @@
+#pragma once
+#include "defines.h"
+
+#include "ECS/ecs_types.h"
+
+#define QUERY_MIN_CAPACITY 64
+
+/*
+ * A query is the set of entities which have every one of its component
+ * types. Scenes keep their queries up to date as components are added and
+ * removed, so iterating a query never has to check for missing components.
+ */
+Query *createQuery(
+	uint32 numComponentTypes,
+	ComponentTypeHandle *componentTypes);
+void freeQuery(Query **query);
+
+bool queryHasComponentType(Query *query, ComponentTypeHandle componentType);
+bool queryMatchesEntity(Query *query, Scene *scene, EntityHandle entity);
+bool queryContainsEntity(Query *query, EntityHandle entity);
+
+// Adds every matching entity in the scene to the query
+void queryRefresh(Query *query, Scene *scene);
+void queryAddEntity(Query *query, EntityHandle entity);
+void queryRemoveEntity(Query *query, EntityHandle entity);
+void queryClear(Query *query);
+
+// Iterates from the back of the query so that the current entity can be
+// removed without skipping any other entities
+QueryIterator queryGetIterator(Query *query, Scene *scene);
+// Only visits the count entities starting at index first
+QueryIterator queryGetRangeIterator(
+	Query *query,
+	Scene *scene,
+	uint32 first,
+	uint32 count);
+void queryMoveIterator(QueryIterator *itr);
+uint32 queryIteratorAtEnd(QueryIterator itr);
+EntityHandle queryIteratorGetEntity(QueryIterator itr);
+void *queryIteratorGetComponent(QueryIterator itr, uint32 index);
@@ -5,7 +5,19 @@
 
 #define SAVE_FOLDER "resources/saves"
 
-int32 exportSave(void *data, uint32 size, uint32 slot);
+/*
+ * Copies the active scenes and the data, then writes the save on the
+ * serialization thread. The callback is run by updateSaves on the main
+ * thread once the save has been written, and may be NULL.
+ */
+int32 exportSave(void *data, uint32 size, uint32 slot, SaveCallback callback);
+// Runs the callbacks of saves which have finished
+void updateSaves(void);
+bool isSaving(void);
+// Fraction of the save which is being written that's done, 1 if there is
+// nothing to write
+real32 getSaveProgress(void);
+
 int32 loadSave(uint32 slot, void **data);
 bool getSaveSlotAvailability(uint32 slot);
 int32 deleteSave(uint32 slot);
\ No newline at end of file
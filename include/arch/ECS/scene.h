@@ -15,6 +15,15 @@ Scene *createScene(void);
 int32 loadSceneFile(const char *name, Scene **scene);
 Scene *getScene(const char *name);
 void freeScene(Scene **scene);
+// Copies the scene and writes it into the runtime state on the
+// serialization thread, its snapshot only gets the changes since it was
+// last written
+void exportRuntimeScene(Scene *scene);
+// Copies everything exporting the scene into the runtime state writes, so
+// that it can be written on another thread
+RuntimeSceneExport *copyRuntimeScene(Scene *scene);
+int32 writeRuntimeScene(const RuntimeSceneExport *sceneExport);
+void freeRuntimeSceneExport(RuntimeSceneExport **sceneExport);
 
 int32 loadScene(const char *name);
 int32 reloadScene(const char *name, bool reloadAssets, bool togglePBR);
@@ -25,7 +34,7 @@ int32 deactivateScene(Scene *scene);
 
 void exportEntitySnapshot(
 	Scene *scene,
-	UUID entity,
+	EntityHandle entity,
 	const char *filename);
 void exportSceneSnapshot(Scene *scene, const char *filename);
 
@@ -52,29 +61,75 @@ void sceneShutdownLua(lua_State **L, Scene *scene);
 
 void sceneAddComponentType(
 	Scene *scene,
-	UUID componentID,
+	ComponentTypeHandle componentType,
 	uint32 componentSize,
 	uint32 maxComponents);
-void sceneRemoveComponentType(Scene *scene, UUID componentID);
+void sceneRemoveComponentType(Scene *scene, ComponentTypeHandle componentType);
+ComponentDataTable *sceneGetComponentDataTable(
+	Scene *scene,
+	ComponentTypeHandle componentType);
 
-void sceneRegisterEntity(Scene *s, UUID newEntity);
-UUID sceneCreateEntity(Scene *s);
-void sceneRemoveEntity(Scene *s, UUID entity);
-void sceneRemoveEntityComponents(Scene *s, UUID entity);
+// Returns the query for the component types, creating it on first use
+Query *sceneGetQuery(
+	Scene *scene,
+	uint32 numComponentTypes,
+	ComponentTypeHandle *componentTypes);
+
+EntityHandle sceneRegisterEntity(Scene *s, UUID newEntity);
+// The entity doesn't get a UUID until sceneGetEntityID asks for it
+EntityHandle sceneCreateEntity(Scene *s);
+void sceneRemoveEntity(Scene *s, EntityHandle entity);
+void sceneRemoveEntityComponents(Scene *s, EntityHandle entity);
+
+// Returns INVALID_HANDLE if the entity is not in the scene
+EntityHandle sceneGetEntity(Scene *s, UUID entity);
+// Generates the UUID of entities which don't have one yet, which is a
+// structural change to the scene
+UUID sceneGetEntityID(Scene *s, EntityHandle entity);
+bool sceneEntityExists(Scene *s, EntityHandle entity);
+// Returns NULL if the entity is not in the scene
+ComponentSignature *sceneGetEntitySignature(Scene *s, EntityHandle entity);
+bool sceneEntityHasComponentTypes(
+	Scene *s,
+	EntityHandle entity,
+	ComponentSignature const *componentTypes);
 
 int32 sceneAddComponentToEntity(
 	Scene *s,
-	UUID entity,
-	UUID componentType,
+	EntityHandle entity,
+	ComponentTypeHandle componentType,
 	void *componentData);
 void sceneRemoveComponentFromEntity(
 	Scene *s,
-	UUID entity,
-	UUID componentType);
-void sceneRemoveComponentFromAllEntities(Scene *scene, UUID componentID);
+	EntityHandle entity,
+	ComponentTypeHandle componentType);
+void sceneRemoveComponentFromAllEntities(
+	Scene *scene,
+	ComponentTypeHandle componentType);
 void *sceneGetComponentFromEntity(
 	Scene *s,
-	UUID entity,
-	UUID componentType);
+	EntityHandle entity,
+	ComponentTypeHandle componentType);
+
+// Deferred versions of the structural changes above, which are safe to make
+// while iterating over the scene and from system run functions on any
+// thread. Entities created this way get a reserved handle straight away,
+// which only becomes valid once the scene's commands are applied. The
+// scheduler applies them between systems which can't run alongside any
+// other system and after the last system of each frame.
+EntityHandle sceneDeferRegisterEntity(Scene *s, UUID newEntity);
+EntityHandle sceneDeferCreateEntity(Scene *s);
+void sceneDeferRemoveEntity(Scene *s, EntityHandle entity);
+int32 sceneDeferAddComponentToEntity(
+	Scene *s,
+	EntityHandle entity,
+	ComponentTypeHandle componentType,
+	void *componentData);
+void sceneDeferRemoveComponentFromEntity(
+	Scene *s,
+	EntityHandle entity,
+	ComponentTypeHandle componentType);
+// Applies every deferred change, only while no systems are running
+void sceneApplyCommands(Scene *s);
 
 UUID idFromName(const char *name);
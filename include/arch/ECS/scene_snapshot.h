@@ -0,0 +1,43 @@
+#pragma once
+#include "defines.h"
+
+#include "ECS/ecs_types.h"
+
+// Table data is aligned so that components can be read in place
+#define SCENE_SNAPSHOT_ALIGNMENT 16
+
+// Copies the scene's entities, component definitions and component data
+// tables, which is all that has to happen while the scene is in use
+SceneSnapshotCopy* copySceneSnapshot(Scene *scene);
+/*
+ * Writes every entity of the copy and its components into a single file.
+ * The component definitions are stored once, followed by the UUID of every
+ * entity and a block of entity indices and raw component data per chunk of
+ * each component data table, so loading the snapshot is a handful of large
+ * reads. If the file holds the state's last snapshot, only the chunks which
+ * changed since, and the entities if any were registered or removed, are
+ * appended to it as a delta record. The whole snapshot is rewritten once
+ * there are too many deltas or they have outgrown the full record. Nothing
+ * but the copy and the state is used, so it can run on any thread.
+ */
+int32 writeSceneSnapshot(
+	const SceneSnapshotCopy *copy,
+	SceneSnapshotState *state,
+	const char *filename);
+void freeSceneSnapshotCopy(SceneSnapshotCopy **copy);
+
+// Maps and validates the snapshot, so loading it can trust its contents. A
+// delta record which was only partially written is ignored.
+int32 openSceneSnapshot(const char *filename, SceneSnapshot *snapshot);
+void closeSceneSnapshot(SceneSnapshot *snapshot);
+
+// Creates the scene's component definitions from the snapshot's
+void loadSceneSnapshotComponentDefinitions(
+	Scene *scene,
+	const SceneSnapshot *snapshot);
+// Registers the snapshot's entities and adds their components to the scene,
+// the component types have to have been added already. The scene remembers
+// what the snapshot holds, so its next snapshot can be a delta.
+void loadSceneSnapshotEntities(Scene *scene, const SceneSnapshot *snapshot);
+
+void freeSceneSnapshotState(SceneSnapshotState **state);
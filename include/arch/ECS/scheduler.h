@@ -0,0 +1,14 @@
+#pragma once
+#include "defines.h"
+
+#include "ECS/ecs_types.h"
+
+#include "data/data_types.h"
+
+/*
+ * Runs the named systems in order, except that systems whose declared
+ * component accesses do not conflict may run at the same time on the
+ * system thread pool. Systems which have to stay on the main thread are run
+ * by the calling thread.
+ */
+void schedulerRunSystems(Scene *scene, List *systemNames, real64 dt);
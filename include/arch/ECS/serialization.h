@@ -0,0 +1,26 @@
+#pragma once
+#include "defines.h"
+
+#include "threading/threading_types.h"
+
+// Scenes and saves are written on a single background thread, so the frame
+// only pays for copying what's written
+void initializeSerialization(void);
+// Blocks until everything which has been queued has been written
+void shutdownSerialization(void);
+
+/*
+ * Jobs run one at a time on the serialization thread, in the order they
+ * were queued. The job writes the runtime state of the named scenes, which
+ * can't be read until it has finished.
+ */
+void serializationAddJob(
+	JobFunction function,
+	void *data,
+	uint32 numSceneNames,
+	char **sceneNames);
+
+// Blocks until no queued job writes the scene's runtime state
+void waitForSceneSerialization(const char *name);
+// Blocks until every job which has been queued has finished
+void waitForSerialization(void);
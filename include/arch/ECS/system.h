@@ -1,6 +1,9 @@
 #pragma once
 #include "ECS/ecs_types.h"
 
+// Number of entities each thread claims at a time in parallel systems
+#define SYSTEM_CHUNK_SIZE 64
+
 System createSystem(
 	List components,
 	InitSystem init,
@@ -8,6 +11,14 @@ System createSystem(
 	RunSystem run,
 	EndSystem end,
 	ShutdownSystem shutdown);
+
+// Returns the scene's query for the component types of the system
+Query *systemGetQuery(Scene *scene, System *system);
+
+bool systemDeclaresAccess(System *system);
+// Returns true if the systems can not safely run at the same time
+bool systemsConflict(System *a, System *b);
+
 void systemRun(
 	Scene *scene,
 	System *system,
@@ -0,0 +1,29 @@
+#pragma once
+#include "defines.h"
+
+#include "file/file_types.h"
+
+#include <stdio.h>
+
+/*
+ * Asset files are looked up in the asset archive first and fall back to
+ * loose files on disk, so the loaders don't need to know which one they're
+ * reading from.
+ */
+int32 openAssetFileArchive(const char *filename);
+void closeAssetFileArchive(void);
+
+// Folders are also stored in the archive
+bool assetFileExists(const char *filename);
+FILE* openAssetFile(const char *filename);
+/*
+ * Returns the whole file. If the data had to be copied, *buffer is set to
+ * memory the caller has to free, otherwise it's set to NULL and the data
+ * points straight into the archive.
+ */
+const uint8* readAssetFile(
+	const char *filename,
+	uint64 *size,
+	uint8 **buffer);
+// Uncompressed archive entries are borrowed instead of mapped again
+int32 mapAssetFile(const char *filename, MappedFile *file);
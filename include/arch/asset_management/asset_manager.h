@@ -1,8 +1,16 @@
 #pragma once
 #include "defines.h"
 
+#include "asset_management/asset_manager_types.h"
+
+#include "data/list.h"
+
 #include "ECS/ecs_types.h"
 
+#include "threading/job_graph.h"
+#include "threading/thread_pool.h"
+#include "threading/threading_types.h"
+
 #define EXTERN_ASSET_VARIABLES(assets, Assets) \
 extern HashMap assets; \
 extern pthread_mutex_t assets ## Mutex; \
@@ -11,144 +19,262 @@ extern HashMap loading ## Assets; \
 extern pthread_mutex_t loading ## Assets ## Mutex; \
 \
 extern HashMap upload ## Assets ## Queue; \
-extern pthread_mutex_t upload ## Assets ## Mutex
+extern pthread_mutex_t upload ## Assets ## Mutex; \
+\
+extern List unused ## Assets ## Queue; \
+extern HashMap pending ## Assets ## References; \
+\
+extern HashMap published ## Assets
 
 #define EXTERN_ASSET_MANAGER_VARIABLES \
-extern uint32 assetThreadCount; \
-extern pthread_mutex_t assetThreadsMutex; \
-extern pthread_cond_t assetThreadsCondition; \
+extern ThreadPool *assetThreadPool; \
 \
-extern uint32 totalThreadCount; \
-extern pthread_mutex_t totalThreadsMutex; \
-extern pthread_cond_t totalThreadsCondition; \
+extern uint64 assetManagerTick; \
 \
 extern bool assetManagerIsShutdown; \
 extern pthread_mutex_t assetManagerShutdownMutex
 
 #define INTERNAL_ASSET_THREAD_VARIABLES(Asset) \
-internal void* acquire ## Asset ## Thread(void *arg); \
-internal void* load ## Asset ## Thread(void *arg)
+internal void acquire ## Asset ## Job(void *data); \
+internal void* load ## Asset ## Thread(void *arg); \
+internal void free ## Asset ## ThreadArgs(void *arg)
 
-#define START_ACQUISITION_THREAD(asset, Asset, Assets, arg, name) \
+#define QUEUE_ACQUISITION_JOB( \
+	Asset, \
+	Assets, \
+	jobArg, \
+	jobName, \
+	jobPriority, \
+	jobPromise, \
+	jobDependent) \
 pthread_mutex_lock(&assetManagerShutdownMutex); \
 \
 if (assetManagerIsShutdown) \
 { \
 	pthread_mutex_unlock(&assetManagerShutdownMutex); \
+\
+	free ## Asset ## ThreadArgs(jobArg); \
+	completeAssetPromise(jobPromise); \
+\
 	return; \
 } \
 \
 pthread_mutex_unlock(&assetManagerShutdownMutex); \
 \
-bool loading = true; \
+/* The lookup and the insert have to happen under the same lock, otherwise */ \
+/* two requests could both queue a load and one would lose its waiters */ \
 pthread_mutex_lock(&loading ## Assets ## Mutex); \
-hashMapInsert(loading ## Assets, &name, &loading); \
-pthread_mutex_unlock(&loading ## Assets ## Mutex); \
 \
-pthread_mutex_lock(&totalThreadsMutex); \
-totalThreadCount++; \
-pthread_cond_broadcast(&totalThreadsCondition); \
-pthread_mutex_unlock(&totalThreadsMutex); \
-\
-pthread_t acquisitionThread; \
-pthread_create( \
-	&acquisitionThread, \
-	NULL, \
-	&acquire ## Asset ## Thread, \
-	(void*)arg); \
-pthread_detach(acquisitionThread)
-
-#define ACQUISITION_THREAD(Asset) \
-void* acquire ## Asset ## Thread(void *arg) \
+AssetLoadingState *existingLoadingState = \
+	hashMapGetData(loading ## Assets, &jobName); \
+if (existingLoadingState) \
 { \
-	pthread_mutex_lock(&assetThreadsMutex); \
+	existingLoadingState->wanted = true; \
+	addAssetPromise(existingLoadingState, jobPromise); \
+	addAssetDependentJob(existingLoadingState, jobDependent); \
 \
-	while (assetThreadCount == config.assetsConfig.maxThreadCount) \
-	{ \
-		pthread_cond_wait(&assetThreadsCondition, &assetThreadsMutex); \
-	} \
+	pthread_mutex_unlock(&loading ## Assets ## Mutex); \
 \
-	assetThreadCount++; \
+	free ## Asset ## ThreadArgs(jobArg); \
 \
-	pthread_cond_broadcast(&assetThreadsCondition); \
-	pthread_mutex_unlock(&assetThreadsMutex); \
+	return; \
+} \
+\
+AssetLoadingState queuedLoadingState; \
+queuedLoadingState.wanted = true; \
+queuedLoadingState.promises = createList(sizeof(Promise*)); \
+queuedLoadingState.dependentJobs = createList(sizeof(JobNode*)); \
+addAssetPromise(&queuedLoadingState, jobPromise); \
+addAssetDependentJob(&queuedLoadingState, jobDependent); \
+\
+hashMapInsert(loading ## Assets, &jobName, &queuedLoadingState); \
+\
+pthread_mutex_unlock(&loading ## Assets ## Mutex); \
+\
+AssetJob *acquisitionJob = malloc(sizeof(AssetJob)); \
+acquisitionJob->name = jobName; \
+acquisitionJob->arg = jobArg; \
+\
+threadPoolAddPriorityJob( \
+	assetThreadPool, \
+	&acquire ## Asset ## Job, \
+	acquisitionJob, \
+	jobPriority)
+
+#define ACQUISITION_JOB(Asset, Assets) \
+void acquire ## Asset ## Job(void *data) \
+{ \
+	AssetJob *job = data; \
 \
-	pthread_mutex_lock(&assetManagerShutdownMutex); \
+	pthread_mutex_lock(&loading ## Assets ## Mutex); \
 \
-	if (assetManagerIsShutdown) \
+	/* A missing state means the load has already been finished */ \
+	AssetLoadingState *loadingState = \
+		hashMapGetData(loading ## Assets, &job->name); \
+	bool wanted = loadingState && loadingState->wanted; \
+\
+	if (loadingState && !wanted) \
 	{ \
-		pthread_mutex_unlock(&assetManagerShutdownMutex); \
+		finishLoadingAsset(loading ## Assets, &job->name); \
+	} \
 \
-		pthread_mutex_lock(&totalThreadsMutex); \
-		totalThreadCount--; \
-		pthread_cond_broadcast(&totalThreadsCondition); \
-		pthread_mutex_unlock(&totalThreadsMutex); \
+	pthread_mutex_unlock(&loading ## Assets ## Mutex); \
 \
-		EXIT_THREAD(NULL); \
+	if (wanted) \
+	{ \
+		load ## Asset ## Thread(job->arg); \
+	} \
+	else \
+	{ \
+		free ## Asset ## ThreadArgs(job->arg); \
 	} \
 \
-	pthread_mutex_unlock(&assetManagerShutdownMutex); \
+	free(job); \
+}
+
+// Loads which were queued for upload aren't finished until the asset has been
+// uploaded, so that nothing which depends on it can be published before it
+#define FINISH_LOADING_ASSET(Assets, name) \
+pthread_mutex_lock(&loading ## Assets ## Mutex); \
+pthread_mutex_lock(&upload ## Assets ## Mutex); \
 \
-	pthread_mutex_lock(&totalThreadsMutex); \
-	totalThreadCount++; \
-	pthread_cond_broadcast(&totalThreadsCondition); \
-	pthread_mutex_unlock(&totalThreadsMutex); \
+bool uploading ## Assets = hashMapGetData( \
+	upload ## Assets ## Queue, \
+	&name) != NULL; \
 \
-	pthread_t loadingThread; \
-	pthread_create(&loadingThread, NULL, &load ## Asset ## Thread, arg); \
-	pthread_join(loadingThread, NULL); \
+pthread_mutex_unlock(&upload ## Assets ## Mutex); \
 \
-	pthread_mutex_lock(&totalThreadsMutex); \
-	totalThreadCount--; \
-	pthread_cond_broadcast(&totalThreadsCondition); \
-	pthread_mutex_unlock(&totalThreadsMutex); \
+if (!uploading ## Assets) \
+{ \
+	finishLoadingAsset(loading ## Assets, &name); \
+} \
 \
-	EXIT_THREAD(NULL); \
-}
+pthread_mutex_unlock(&loading ## Assets ## Mutex)
 
-#define EXIT_LOADING_THREAD \
-pthread_mutex_lock(&assetThreadsMutex); \
-assetThreadCount--; \
-pthread_cond_broadcast(&assetThreadsCondition); \
-pthread_mutex_unlock(&assetThreadsMutex); \
+#define CANCEL_LOADING_ASSET(Assets, name) \
+pthread_mutex_lock(&loading ## Assets ## Mutex); \
 \
-pthread_mutex_lock(&totalThreadsMutex); \
-totalThreadCount--; \
-pthread_cond_broadcast(&totalThreadsCondition); \
-pthread_mutex_unlock(&totalThreadsMutex); \
+AssetLoadingState *loadingState = hashMapGetData(loading ## Assets, &name); \
+if (loadingState) \
+{ \
+	loadingState->wanted = false; \
+} \
 \
-EXIT_THREAD(NULL)
+pthread_mutex_unlock(&loading ## Assets ## Mutex)
+
+#define EXIT_LOADING_THREAD \
+return NULL
 
+// Lookups go through the published copy of the asset map, which is never
+// changed once it has been published, so they don't take any locks. Assets
+// aren't found until their upload has finished. The asset returned stays valid
+// until freeAssets is next called and must not be held onto any longer than
+// that.
 #define GET_ASSET_FUNCTION( \
 	asset, \
 	assets, \
 	Asset, \
+	Assets, \
 	functionSignature, \
 	getNameFunction) \
-Asset functionSignature \
+Asset* functionSignature \
 { \
-	Asset asset = {}; \
+	if (strlen(name) > 0) \
+	{ \
+		UUID asset ## Name = getNameFunction; \
+\
+		HashMap published ## Assets ## Map = __atomic_load_n( \
+			&published ## Assets, \
+			__ATOMIC_ACQUIRE); \
+\
+		Asset **asset ## Resource = hashMapGetData( \
+			published ## Assets ## Map, \
+			&asset ## Name); \
+		if (asset ## Resource && __atomic_load_n( \
+			&(*asset ## Resource)->usage.resident, \
+			__ATOMIC_ACQUIRE)) \
+		{ \
+			useAsset(&(*asset ## Resource)->usage); \
+			return *asset ## Resource; \
+		} \
+	} \
 \
+	return NULL; \
+}
+
+// References can be taken before the asset has been loaded, in which case
+// they're handed to it once it has been uploaded
+#define ACQUIRE_ASSET_FUNCTION( \
+	asset, \
+	assets, \
+	Asset, \
+	Assets, \
+	functionSignature, \
+	getNameFunction) \
+void functionSignature \
+{ \
 	if (strlen(name) > 0) \
 	{ \
 		UUID asset ## Name = getNameFunction; \
 \
 		pthread_mutex_lock(&assets ## Mutex); \
 \
-		Asset *asset ## Resource = hashMapGetData(assets, &asset ## Name); \
+		Asset **asset ## Resource = hashMapGetData(assets, &asset ## Name); \
 		if (asset ## Resource) \
 		{ \
-			asset ## Resource->lifetime = \
-				config.assetsConfig.min ## Asset ## Lifetime; \
-			asset = *asset ## Resource; \
+			__atomic_add_fetch( \
+				&(*asset ## Resource)->usage.refCount, \
+				1, \
+				__ATOMIC_RELAXED); \
+		} \
+		else \
+		{ \
+			addPendingAssetReference( \
+				pending ## Assets ## References, \
+				&asset ## Name); \
 		} \
 \
 		pthread_mutex_unlock(&assets ## Mutex); \
 	} \
+}
+
+#define RELEASE_ASSET_FUNCTION( \
+	asset, \
+	assets, \
+	Asset, \
+	Assets, \
+	functionSignature, \
+	getNameFunction) \
+void functionSignature \
+{ \
+	if (strlen(name) > 0) \
+	{ \
+		UUID asset ## Name = getNameFunction; \
+\
+		pthread_mutex_lock(&assets ## Mutex); \
+\
+		Asset **asset ## Resource = hashMapGetData(assets, &asset ## Name); \
+		if (asset ## Resource) \
+		{ \
+			releaseAssetUsage( \
+				&unused ## Assets ## Queue, \
+				&asset ## Name, \
+				&(*asset ## Resource)->usage); \
+		} \
+		else \
+		{ \
+			removePendingAssetReference( \
+				pending ## Assets ## References, \
+				&asset ## Name); \
+		} \
 \
-	return asset; \
+		pthread_mutex_unlock(&assets ## Mutex); \
+	} \
 }
 
+// Loads queued with a higher priority are started first
+#define DEFAULT_ASSET_PRIORITY 0
+
 #define MODELS_BUCKET_COUNT 1031
 #define TEXTURES_BUCKET_COUNT 5003
 #define MATERIAL_FOLDERS_BUCKET_COUNT 521
@@ -179,4 +305,23 @@ uint32 getNumLoadingAssets(void);
 void setUpdateAssetManagerFlag(void);
 void uploadAssets(void);
 void freeAssets(void);
-void shutdownAssetManager(void);
\ No newline at end of file
+void shutdownAssetManager(void);
+
+// The promise or job may be NULL, in which case nothing is added or completed
+void addAssetPromise(AssetLoadingState *loadingState, Promise *promise);
+void completeAssetPromise(Promise *promise);
+// The job won't run until the asset has finished loading
+void addAssetDependentJob(AssetLoadingState *loadingState, JobNode *job);
+// Completes the promises and dependent jobs of a loading asset and removes it
+// from the loading map, which must already be locked
+void finishLoadingAsset(HashMap loadingAssets, UUID *name);
+
+// Marks the asset as used on the current asset manager tick
+void useAsset(AssetUsage *usage);
+// The asset map must be locked for all of the following
+void addPendingAssetReference(HashMap pendingReferences, UUID *name);
+void removePendingAssetReference(HashMap pendingReferences, UUID *name);
+// Queues the asset to be freed once its last reference has been released and
+// it has gone unused for its minimum lifetime
+void releaseAssetUsage(List *unusedAssets, UUID *name, AssetUsage *usage);
+void queueUnusedAsset(List *unusedAssets, UUID *name, AssetUsage *usage);
\ No newline at end of file
@@ -1,6 +1,10 @@
 #pragma once
 #include "defines.h"
 
+#include "data/data_types.h"
+
+#include "file/file_types.h"
+
 #include "renderer/renderer_types.h"
 
 #include <AL/al.h>
@@ -17,14 +21,56 @@
 
 #include <nuklear/nuklear.h>
 
+#define COOKED_TEXTURE_EXTENSION "tex"
+#define COOKED_TEXTURE_MAGIC "GTEX"
+#define COOKED_TEXTURE_FILE_VERSION 1
+
+#define MAX_TEXTURE_MIP_LEVELS 16
+
+typedef enum texture_format_e
+{
+	TEXTURE_FORMAT_UNCOMPRESSED = 0,
+	TEXTURE_FORMAT_BC1,
+	TEXTURE_FORMAT_BC3,
+	TEXTURE_FORMAT_BC5
+} TextureFormat;
+
+typedef struct texture_mip_level_t
+{
+	uint32 width;
+	uint32 height;
+	// Relative to the start of the texture data
+	uint64 offset;
+	uint64 size;
+} TextureMipLevel;
+
 typedef struct texture_data_t
 {
 	int32 width;
 	int32 height;
 	int32 numComponents;
+	// Every mip level, one after another
 	uint8 *data;
+	TextureFormat format;
+	// Only cooked textures come with their mip chain, the others are mipmapped
+	// when they're uploaded
+	uint32 numMipLevels;
+	TextureMipLevel mipLevels[MAX_TEXTURE_MIP_LEVELS];
 } TextureData;
 
+typedef struct cooked_texture_header_t
+{
+	char magic[4];
+	uint32 version;
+	uint32 width;
+	uint32 height;
+	uint32 numComponents;
+	uint32 format;
+	uint32 numMipLevels;
+	uint32 dataOffset;
+	TextureMipLevel mipLevels[MAX_TEXTURE_MIP_LEVELS];
+} CookedTextureHeader;
+
 typedef struct hdr_texture_data_t
 {
 	int32 width;
@@ -33,10 +79,35 @@ typedef struct hdr_texture_data_t
 	real32 *data;
 } HDRTextureData;
 
+typedef struct asset_usage_t
+{
+	// Assets aren't freed while anything holds a reference to them
+	uint32 refCount;
+	// Asset manager tick the asset was last looked up on
+	uint64 lastUsed;
+	// Whether the asset is waiting in its type's unused queue
+	bool queued;
+	// Bytes the asset takes up once it has been uploaded, in main memory as
+	// well as on the GPU or sound card
+	uint64 size;
+	// Priority the asset was loaded with, assets with a lower priority are
+	// evicted first when all of them are over their memory budget
+	int32 priority;
+	// Set once the asset's upload has finished, lookups don't find it before
+	bool resident;
+} AssetUsage;
+
+typedef struct unused_asset_t
+{
+	UUID name;
+	uint64 lastUsed;
+	int32 priority;
+} UnusedAsset;
+
 typedef struct texture_t
 {
 	UUID name;
-	real64 lifetime;
+	AssetUsage usage;
 	GLuint id;
 	GLuint64 handle;
 	TextureData data;
@@ -51,7 +122,7 @@ typedef struct material_folder_t
 typedef struct model_t
 {
 	UUID name;
-	real64 lifetime;
+	AssetUsage usage;
 	UUID materialTexture;
 	UUID opacityTexture;
 	uint32 numSubsets;
@@ -59,12 +130,14 @@ typedef struct model_t
 	Skeleton skeleton;
 	uint32 numAnimations;
 	Animation *animations;
+	// Backs the subsets' meshes until they have been uploaded
+	MappedFile meshFile;
 } Model;
 
 typedef struct font_t
 {
 	UUID name;
-	real64 lifetime;
+	AssetUsage usage;
 	bool autoScaling;
 	struct nk_font_atlas atlas;
 	struct nk_font *font;
@@ -78,7 +151,7 @@ typedef struct font_t
 typedef struct image_t
 {
 	UUID name;
-	real64 lifetime;
+	AssetUsage usage;
 	GLuint id;
 	TextureData data;
 	bool textureFiltering;
@@ -87,19 +160,25 @@ typedef struct image_t
 typedef struct audio_file_t
 {
 	UUID name;
-	real64 lifetime;
+	AssetUsage usage;
 	ALuint id;
 	int32 channels;
 	int32 sample_rate;
 	int32 size;
 	int16 *data;
 	ALenum format;
+	// Long files are decoded while they play instead of when they're loaded
+	bool streamed;
+	const uint8 *encodedData;
+	uint64 encodedSize;
+	// Owns the encoded data, unless it's borrowed from the asset archive
+	uint8 *encodedBuffer;
 } AudioFile;
 
 typedef struct particle_t
 {
 	UUID name;
-	real64 lifetime;
+	AssetUsage usage;
 	GLuint id;
 	TextureData data;
 	bool textureFiltering;
@@ -111,11 +190,72 @@ typedef struct particle_t
 typedef struct cubemap_t
 {
 	UUID name;
-	real64 lifetime;
+	AssetUsage usage;
 	HDRTextureData cubemapData[6];
 	GLuint cubemapID;
 	HDRTextureData irradianceData[6];
 	GLuint irradianceID;
 	HDRTextureData prefilterData[5][6];
 	GLuint prefilterID;
-} Cubemap;
\ No newline at end of file
+} Cubemap;
+
+typedef struct asset_loading_state_t
+{
+	// Cleared once nothing wants the asset anymore, which cancels the load
+	// if it hasn't been started yet
+	bool wanted;
+	// Promise* to complete once the load has finished or been cancelled
+	List promises;
+	// JobNode* which depend on the load
+	List dependentJobs;
+} AssetLoadingState;
+
+typedef struct asset_upload_backend_t
+{
+	// Seconds since an arbitrary point in time
+	real64 (*getTime)(void);
+	// Fences are signalled once every upload issued before them has finished
+	void* (*createFence)(void);
+	bool (*isFenceSignalled)(void *fence);
+	void (*deleteFence)(void *fence);
+} AssetUploadBackend;
+
+typedef struct asset_upload_batch_t
+{
+	uint64 id;
+	void *fence;
+	// Staging memory used by the batch and every batch before it
+	uint64 stagingEnd;
+} AssetUploadBatch;
+
+typedef struct asset_upload_scheduler_t
+{
+	const AssetUploadBackend *backend;
+	// Seconds and bytes each frame's uploads are limited to, 0 is unbounded
+	real64 maxFrameTime;
+	uint64 maxFrameSize;
+	real64 frameStartTime;
+	uint64 frameSize;
+	uint32 numFrameUploads;
+	// Nothing else is uploaded in a frame once one upload has been refused,
+	// which keeps uploads in the order they were scheduled in
+	bool frameBudgetSpent;
+	// Batch the current frame's uploads are part of
+	uint64 batch;
+	// Every batch up to and including this one has finished uploading
+	uint64 finishedBatch;
+	// AssetUploadBatch which are waiting on their fence, oldest first
+	List pendingBatches;
+	// Staging memory is a ring buffer, the head and tail only ever increase
+	// and wrap around the size
+	uint64 stagingSize;
+	uint64 stagingHead;
+	uint64 stagingTail;
+	uint64 stagingFenced;
+} AssetUploadScheduler;
+
+typedef struct asset_job_t
+{
+	UUID name;
+	void *arg;
+} AssetJob;
\ No newline at end of file
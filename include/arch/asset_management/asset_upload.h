@@ -0,0 +1,26 @@
+#pragma once
+#include "defines.h"
+
+#include <GL/glew.h>
+
+// Staging goes through a persistently mapped buffer if it is supported, the
+// GL context has to be current
+void initializeAssetUploads(void);
+void shutdownAssetUploads(void);
+
+void beginAssetUploads(void);
+bool canUploadAsset(uint64 size);
+// Returns the batch the asset was uploaded in
+uint64 finishAssetUpload(uint64 size);
+void endAssetUploads(void);
+// Assets only become resident once the batch they were uploaded in has
+// finished
+bool hasAssetUploadFinished(uint64 batch);
+
+// Copies the data into the staging buffer and binds it to the target, in which
+// case the data's offset in the staging buffer is returned. Otherwise the data
+// itself is returned and the target is left unbound.
+const void* stageAssetData(GLenum target, const void *data, uint64 size);
+void unstageAssetData(GLenum target);
+// Fills the buffer bound to the target through the staging buffer
+void uploadAssetBufferData(GLenum target, const void *data, uint64 size);
@@ -3,7 +3,13 @@
 
 #include "asset_management/asset_manager_types.h"
 
+// Audio files at least this many seconds long are streamed
+#define MIN_STREAMED_AUDIO_DURATION 10.0
+
 void loadAudio(const char *name);
 int32 uploadAudioToSoundCard(AudioFile *audio);
-AudioFile getAudio(const char *name);
+AudioFile* getAudio(const char *name);
+void acquireAudio(const char *name);
+void releaseAudio(const char *name);
+uint64 getAudioFileSize(const AudioFile *audio);
 void freeAudioFileData(AudioFile *audio);
\ No newline at end of file
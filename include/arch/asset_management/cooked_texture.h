@@ -0,0 +1,25 @@
+#pragma once
+#include "defines.h"
+
+#include "asset_management/asset_manager_types.h"
+
+/*
+ * Cooked textures are always RGBA, and are stored with their whole mip chain
+ * already generated (and block compressed, for the BC formats) so that
+ * loading them doesn't need to decode anything. None of this touches the GPU.
+ */
+int32 cookTexture(
+	const char *filename,
+	const char *cookedFilename,
+	TextureFormat format);
+// Cooks every source image below folder into a .tex file next to it
+int32 cookTextures(const char *folder, TextureFormat format);
+int32 loadCookedTextureData(
+	const char *filename,
+	int32 numComponents,
+	TextureData *data);
+uint64 getTextureMipLevelSize(
+	TextureFormat format,
+	uint32 numComponents,
+	uint32 width,
+	uint32 height);
@@ -5,5 +5,8 @@
 
 void loadCubemap(const char *name);
 int32 uploadCubemapToGPU(Cubemap *cubemap);
-Cubemap getCubemap(const char *name);
+Cubemap* getCubemap(const char *name);
+void acquireCubemap(const char *name);
+void releaseCubemap(const char *name);
+uint64 getCubemapSize(const Cubemap *cubemap);
 void freeCubemapData(Cubemap *cubemap);
\ No newline at end of file
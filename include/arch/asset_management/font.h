@@ -5,5 +5,8 @@
 
 void loadFont(const char *name, real32 size, bool autoScaling);
 int32 uploadFontToGPU(Font *font);
-Font getFont(const char *name, real32 size, bool autoScaling);
+Font* getFont(const char *name, real32 size, bool autoScaling);
+void acquireFont(const char *name, real32 size, bool autoScaling);
+void releaseFont(const char *name, real32 size, bool autoScaling);
+uint64 getFontSize(const Font *font);
 void freeFontData(Font *font);
\ No newline at end of file
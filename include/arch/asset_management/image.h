@@ -4,5 +4,8 @@
 #include "asset_management/asset_manager_types.h"
 
 void loadImage(const char *name, bool textureFiltering);
-Image getImage(const char *name);
+Image* getImage(const char *name);
+void acquireImage(const char *name);
+void releaseImage(const char *name);
+uint64 getImageSize(const Image *image);
 void freeImageData(Image *image);
\ No newline at end of file
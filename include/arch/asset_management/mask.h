@@ -4,11 +4,18 @@
 #include "renderer/renderer_types.h"
 #include "asset_management/asset_manager_types.h"
 
+#include "threading/threading_types.h"
+
 #include <stdio.h>
 
-void loadMask(Mask *mask, FILE *file, const char *modelName);
+void loadMask(
+	Mask *mask,
+	FILE *file,
+	const char *modelName,
+	JobNode *dependentJob);
 int32 loadMaskTexture(
 	const char *masksFolder,
 	Model *model,
 	char suffix,
-	UUID *textureName);
\ No newline at end of file
+	UUID *textureName,
+	JobNode *dependentJob);
\ No newline at end of file
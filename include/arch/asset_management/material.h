@@ -3,12 +3,20 @@
 
 #include "renderer/renderer_types.h"
 
+#include "threading/threading_types.h"
+
 #include <stdio.h>
 
-int32 loadMaterial(Material *material, FILE *file, const char *modelName);
+// Textures are queued as dependencies of the job, if there is one
+int32 loadMaterial(
+	Material *material,
+	FILE *file,
+	const char *modelName,
+	JobNode *dependentJob);
 int32 createMaterial(UUID name, Material *material);
 void loadMaterialFolders(UUID name);
 int32 loadMaterialComponentTexture(
 	UUID materialName,
 	MaterialComponentType materialComponentType,
-	UUID *textureName);
\ No newline at end of file
+	UUID *textureName,
+	JobNode *dependentJob);
\ No newline at end of file
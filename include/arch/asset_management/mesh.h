@@ -3,8 +3,5 @@
 
 #include "renderer/renderer_types.h"
 
-#include <stdio.h>
-
-void loadMesh(Mesh *mesh, FILE *file, const char *modelName);
 void uploadMeshToGPU(Mesh *mesh, const char *name);
 void freeMesh(Mesh *mesh);
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+#include "defines.h"
+
+#include "file/file_types.h"
+
+#include "renderer/renderer_types.h"
+
+#include <stdio.h>
+
+/*
+ * Reading mesh files doesn't touch the GPU, so these live apart from the
+ * upload code in mesh.c and can be used without a GL context.
+ */
+
+// From this version on, mesh files pad their version number out to
+// MESH_FILE_ALIGNMENT bytes, so that every vertex and index array in them is
+// aligned and can be used straight from a mapping of the file
+#define ALIGNED_MESH_BINARY_FILE_VERSION 2
+#define MESH_FILE_ALIGNMENT 4
+
+// Reads the version of a mesh file and leaves the file at the first mesh
+uint8 readMeshFileHeader(FILE *file);
+void loadMesh(Mesh *mesh, FILE *file, const char *modelName);
+// Points the mesh at the vertices and indices in a mapped mesh file instead of
+// copying them. The offset is moved past the mesh.
+int32 loadMappedMesh(
+	Mesh *mesh,
+	const MappedFile *file,
+	uint64 *offset,
+	const char *modelName);
\ No newline at end of file
@@ -3,11 +3,26 @@
 
 #include "asset_management/asset_manager_types.h"
 
-#define MESH_BINARY_FILE_VERSION 1
+#include "threading/threading_types.h"
+
+#define MESH_BINARY_FILE_VERSION 2
+// Older mesh files are copied into memory instead of being mapped
+#define MIN_MESH_BINARY_FILE_VERSION 1
 
 void loadModel(const char *name);
+// The promise, if there is one, is completed once the model has been loaded
+// and is waiting to be uploaded, has failed to load or has been cancelled. It
+// must not be freed before then.
+void queueModel(const char *name, int32 priority, Promise *promise);
+// Drops the model's load if it is still waiting for a thread
+void cancelModelLoad(const char *name);
 void uploadModelToGPU(Model *model);
-Model getModel(const char *name);
+Model* getModel(const char *name);
+// Acquired models aren't freed until every reference has been released,
+// however long they go unused for
+void acquireModel(const char *name);
+void releaseModel(const char *name);
+uint64 getModelSize(const Model *model);
 void freeModelData(Model *model);
 
 void swapMeshMaterial(
@@ -9,5 +9,8 @@ void loadParticle(
 	uint32 rows,
 	uint32 columns,
 	bool textureFiltering);
-Particle getParticle(const char *name);
+Particle* getParticle(const char *name);
+void acquireParticle(const char *name);
+void releaseParticle(const char *name);
+uint64 getParticleSize(const Particle *particle);
 void freeParticleData(Particle *particle);
\ No newline at end of file
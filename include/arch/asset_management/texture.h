@@ -5,7 +5,16 @@
 
 #include "core/log.h"
 
+#include "threading/threading_types.h"
+
 void loadTexture(const char *filename, const char *name);
+// The dependent job, if there is one, won't run until the texture has finished
+// loading
+void queueTexture(
+	const char *filename,
+	const char *name,
+	int32 priority,
+	JobNode *dependentJob);
 int32 loadTextureData(
 	AssetLogType type,
 	const char *typeName,
@@ -29,6 +38,12 @@ int32 uploadTextureToGPU(
 	TextureData *data,
 	bool textureFiltering,
 	bool transparent);
-Texture getTexture(const char *name);
+Texture* getTexture(const char *name);
+void acquireTexture(const char *name);
+void releaseTexture(const char *name);
+uint64 getTextureSize(const Texture *texture);
+// Size of the texture data once it has been uploaded along with its mip chain
+uint64 getTextureDataSize(const TextureData *data);
+uint64 getHDRTextureDataSize(const HDRTextureData *data);
 char* getFullTextureFilename(const char *filename);
 void freeTextureData(Texture *texture);
\ No newline at end of file
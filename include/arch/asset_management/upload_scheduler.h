@@ -0,0 +1,37 @@
+#pragma once
+#include "defines.h"
+
+#include "asset_management/asset_manager_types.h"
+
+// Staging memory is handed out in multiples of this many bytes
+#define UPLOAD_STAGING_ALIGNMENT 256
+
+// The scheduler only decides what is uploaded when, the backend is what talks
+// to the GPU
+void initializeUploadScheduler(
+	AssetUploadScheduler *scheduler,
+	const AssetUploadBackend *backend,
+	real64 maxFrameTime,
+	uint64 maxFrameSize,
+	uint64 stagingSize);
+// Deletes the fences of every batch which hasn't finished yet
+void freeUploadScheduler(AssetUploadScheduler *scheduler);
+
+// Polls the fences of the previous frames' batches and starts the frame's
+// time and size budget over
+void beginUploadFrame(AssetUploadScheduler *scheduler);
+// The first upload of a frame is always allowed, so that assets larger than
+// the budget are still uploaded eventually
+bool canScheduleUpload(AssetUploadScheduler *scheduler, uint64 size);
+// Returns the batch the upload is part of
+uint64 scheduleUpload(AssetUploadScheduler *scheduler, uint64 size);
+// Fences the frame's batch, if anything was uploaded or staged
+void endUploadFrame(AssetUploadScheduler *scheduler);
+bool isUploadBatchFinished(AssetUploadScheduler *scheduler, uint64 batch);
+
+// Fails if there isn't enough staging memory until earlier batches have
+// finished
+bool allocateUploadStagingMemory(
+	AssetUploadScheduler *scheduler,
+	uint64 size,
+	uint64 *offset);
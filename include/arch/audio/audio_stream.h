@@ -0,0 +1,28 @@
+#pragma once
+#include "defines.h"
+
+#include "asset_management/asset_manager_types.h"
+
+#define NUM_AUDIO_STREAM_BUFFERS 4
+#define AUDIO_STREAM_BUFFER_FRAMES 8192
+
+// Seconds between refilling the buffers of every playing stream
+#define AUDIO_STREAM_UPDATE_INTERVAL 0.01
+
+/*
+ * Streams are tied to the audio source they play on. A background thread
+ * decodes the next chunk of a stream whenever the source has finished playing
+ * one of its buffers.
+ */
+int32 initAudioStreams(void);
+void shutdownAudioStreams(void);
+
+int32 playAudioStream(uint32 sourceID, const AudioFile *audio, bool looping);
+void stopAudioStream(uint32 sourceID);
+// Stops every stream which is decoding the audio file
+void stopAudioFileStreams(UUID name);
+void stopAllAudioStreams(void);
+
+bool isAudioStreamActive(uint32 sourceID);
+// Streaming sources loop by rewinding their decoder instead of their buffers
+void setAudioSourceLooping(uint32 sourceID, bool looping);
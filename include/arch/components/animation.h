@@ -9,9 +9,10 @@
 
 typedef struct joint_transform_t
 {
-	TransformComponent *transform;
-	UUID uuid;
+	EntityHandle entity;
 } JointTransform;
 
+void initializeAnimationComponent(void);
+
 void addSkeleton(Scene *scene, UUID skeletonID);
 void removeSkeleton(Scene *scene, UUID skeletonID);
\ No newline at end of file
@@ -27,4 +27,7 @@ void stopAnimation(AnimatorComponent *animator);
 void resetAnimator(
 	AnimatorComponent *animator,
 	AnimationReference *animationReference);
-void removeAnimator(AnimatorComponent *animator);
\ No newline at end of file
+void removeAnimator(AnimatorComponent *animator);
+void moveAnimator(
+	AnimatorComponent *animator,
+	AnimatorComponent *newAnimator);
\ No newline at end of file
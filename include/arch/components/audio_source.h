@@ -1,6 +1,8 @@
 #include "defines.h"
 #include "ECS/ecs_types.h"
 
+#include "asset_management/asset_manager_types.h"
+
 #include "components/component_types.h"
 
 #define MAX_AUDIO_WAIT_TIME 5.0
@@ -14,10 +16,16 @@ typedef struct play_audio_queue_data_t
 void playSoundAtSource(
 	AudioSourceComponent *audioSource,
 	const char *soundName);
+void playAudioFileAtSource(
+	AudioSourceComponent *audioSource,
+	const AudioFile *audio);
 void pauseSoundAtSource(AudioSourceComponent *audioSource);
 void resumeSoundAtSource(AudioSourceComponent *audioSource);
 void stopSoundAtSource(AudioSourceComponent *audioSource);
 bool isSourceActive(AudioSourceComponent *audioSource);
+void moveAudioSource(
+	AudioSourceComponent *audioSource,
+	AudioSourceComponent *newAudioSource);
 
 void pauseAllAudio(void);
 void stopAllAudio(void);
@@ -3,4 +3,5 @@
 
 #include "components/component_types.h"
 
+void initializeCollisionComponent(void);
 void removeCollisionComponent(Scene *scene, CollisionComponent *coll);
\ No newline at end of file
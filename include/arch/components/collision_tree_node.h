@@ -3,7 +3,8 @@
 
 #include "components/component_types.h"
 
+void initializeCollisionTreeNodeComponent(void);
 void removeCollisionTreeNode(
 	Scene *scene,
-	UUID entity,
+	EntityHandle entity,
 	CollisionTreeNodeComponent *node);
\ No newline at end of file
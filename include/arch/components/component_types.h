@@ -190,8 +190,9 @@ typedef struct collision_tree_node_t
 typedef struct collision_component_t
 {
 	UUID collisionTree;
-	UUID hitList;
-	UUID lastHitList;
+	// Hit lists only last a frame, so they are linked by handle
+	EntityHandle hitList;
+	EntityHandle lastHitList;
 } CollisionComponent;
 
 typedef struct cubemap_component_t
@@ -300,8 +301,8 @@ typedef struct hit_information_component_t
 
 typedef struct hit_list_component_t
 {
-	UUID nextHit;
-	UUID hit;
+	EntityHandle nextHit;
+	EntityHandle hit;
 } HitListComponent;
 
 typedef struct image_component_t
@@ -3,4 +3,5 @@
 
 #include "components/component_types.h"
 
+void initializePanelComponent(void);
 void removePanelWidgets(Scene *scene, PanelComponent *panel);
\ No newline at end of file
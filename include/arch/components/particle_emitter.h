@@ -63,4 +63,8 @@ void stopParticleEmitter(
 
 void removeParticleEmitter(
 	UUID entity,
-	ParticleEmitterComponent *particleEmitter);
\ No newline at end of file
+	ParticleEmitterComponent *particleEmitter);
+void moveParticleEmitter(
+	UUID entity,
+	ParticleEmitterComponent *particleEmitter,
+	ParticleEmitterComponent *newParticleEmitter);
\ No newline at end of file
@@ -6,7 +6,9 @@
 
 #include "components/component_types.h"
 
-void registerRigidBody(Scene *scene, UUID entity);
+void initializeRigidBodyComponent(void);
+
+void registerRigidBody(Scene *scene, EntityHandle entity);
 void createCollisionGeoms(
 	Scene *scene,
 	TransformComponent *bodyTrans,
@@ -33,4 +35,8 @@ void updateRigidBodyPosition(
 	RigidBodyComponent *body,
 	TransformComponent *trans);
 
+void removeRigidBody(
+	Scene *scene,
+	EntityHandle entity,
+	RigidBodyComponent *body);
 void destroyRigidBody(RigidBodyComponent *body);
\ No newline at end of file
@@ -8,7 +8,9 @@
 
 #include <kazmath/mat4.h>
 
-void tMarkDirty(Scene *scene, UUID entityID);
+void initializeTransformComponent(void);
+
+void tMarkDirty(Scene *scene, EntityHandle entityID);
 
 void tDecomposeMat4(
 	kmMat4 const *transform,
@@ -46,6 +48,15 @@ void tConcatenateTransforms(
 	TransformComponent *transformB);
 
 void applyParentTransform(Scene *scene, TransformComponent *outTransform);
-
-int32 removeTransform(Scene *scene, UUID entity, TransformComponent *transform);
+// Applies the transform to its dirty descendants, top down. Runs on the
+// system threads, so it takes the transform component type from its caller.
+void applyChildTransforms(
+	Scene *scene,
+	ComponentTypeHandle transformType,
+	TransformComponent *transform);
+
+int32 removeTransform(
+	Scene *scene,
+	EntityHandle entity,
+	TransformComponent *transform);
 TransformComponent readTransform(FILE *file);
\ No newline at end of file
@@ -3,4 +3,5 @@
 
 #include "ECS/ecs_types.h"
 
-void removeWidget(Scene *scene, UUID entity);
\ No newline at end of file
+void initializeWidgetComponent(void);
+void removeWidget(Scene *scene, EntityHandle entity);
\ No newline at end of file
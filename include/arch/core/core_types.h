@@ -0,0 +1,12 @@
+#pragma once
+#include "defines.h"
+
+typedef enum log_level_e
+{
+	LOG_LEVEL_DEBUG = 0,
+	LOG_LEVEL_INFO,
+	LOG_LEVEL_WARNING,
+	LOG_LEVEL_ERROR,
+	// Filters out every message
+	LOG_LEVEL_NONE
+} LogLevel;
@@ -1,26 +1,52 @@
 #pragma once
 #include "defines.h"
 
+#include "core/core_types.h"
 #include "core/config.h"
 
 #include "file/utilities.h"
 
 #include <stdio.h>
 
-FILE *logFile;
-
 extern Config config;
 
+// Number of messages which can wait for the log thread, a power of two
+#define LOG_QUEUE_SIZE 4096
+// Messages and deferred arguments up to this size are stored in the queue
+#define LOG_MESSAGE_SIZE 480
+// Seconds the log thread sleeps for once the queue is empty
+#define LOG_FLUSH_INTERVAL 0.005
+
+// Messages below this level are compiled out
+#ifndef LOG_COMPILE_LEVEL
+#ifdef _DEBUG
+#define LOG_COMPILE_LEVEL LOG_LEVEL_DEBUG
+#else
+#define LOG_COMPILE_LEVEL LOG_LEVEL_INFO
+#endif
+#endif
+
+// Engine messages go to standard output in debug builds
 #ifdef _DEBUG
 #define LOG_FILE_NAME NULL
-#define LOG(...) printf(__VA_ARGS__)
 #else
 #define LOG_FILE_NAME config.logConfig.engineFile
-#define LOG(...) logFile = fopen(LOG_FILE_NAME, "a"); \
-				 fprintf(logFile, __VA_ARGS__); \
-				 fclose(logFile)
 #endif
 
+// The format has to be a string literal, since it can be formatted on the
+// log thread long after the call
+#define LOG_AT_LEVEL(level, ...) ((level) >= LOG_COMPILE_LEVEL ? \
+	logMessage(level, "" __VA_ARGS__) : (void)0)
+
+#define LOG(...) LOG_AT_LEVEL(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG_AT_LEVEL(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_AT_LEVEL( \
+	LOG_LEVEL_WARNING, \
+	"WARNING: " __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT_LEVEL( \
+	LOG_LEVEL_ERROR, \
+	"ERROR: " __VA_ARGS__)
+
 typedef enum asset_log_type_e
 {
 	ASSET_LOG_TYPE_NONE = -1,
@@ -48,6 +74,20 @@ typedef enum asset_log_type_e
 	ASSET_LOG_TYPE_ ## type, \
 	name)
 
+/*
+ * Starts the log thread, which opens the log files and writes every message
+ * which is queued from then on. Queueing a message never waits for the
+ * thread or for a file, messages are dropped if the queue is full. Until
+ * the thread is started, and once it's been shut down, messages are written
+ * straight away.
+ */
+void initializeLog(void);
+// Blocks until every message which has been queued has been written
+void flushLog(void);
+void shutdownLog(void);
+
+void logMessage(LogLevel level, const char *format, ...);
+
 void initializeAssetLog(void);
 void logFunction(const char *format, ...);
 void assetLogWrite(
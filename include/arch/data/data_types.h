@@ -20,27 +20,75 @@ typedef struct list_iterator_t
 	ListNode *curr;
 } ListIterator;
 
-typedef List HashMapBucket;
-
 typedef int32(*ComparisonOp)(void*, void*);
+typedef uint64(*HashFunction)(void*, uint32);
 
 typedef struct hash_map_t
 {
 	ComparisonOp comparison;
+	HashFunction hashFunction;
 	uint32 keySizeBytes;
 	uint32 valueSizeBytes;
-	uint32 bucketCount;
+	// Byte size of a slot (stored hash, padded key and padded value)
+	uint32 slotSizeBytes;
+	// Byte offset of the value from the start of the key in a slot
+	uint32 valueOffset;
+	// Number of slots, always a power of two
+	uint32 capacity;
 	uint32 count;
-	HashMapBucket buckets[];
+	// Number of tombstones left behind by deletions
+	uint32 numDeleted;
+	// One control byte per slot (empty, deleted, or the top 7 hash bits)
+	uint8 *control;
+	uint8 *slots;
 } *HashMap;
 
 typedef struct hash_map_iterator_t
 {
 	HashMap map;
-	ListIterator itr;
-	uint32 bucket;
+	uint32 slot;
 } HashMapIterator;
 
+// Dense 64 bit handle, the low 32 bits are a slot index and the high 32 bits
+// are the generation of that slot
+typedef uint64 Handle;
+
+typedef struct intern_table_slot_t
+{
+	UUID id;
+	// Incremented every time the slot is freed
+	uint32 generation;
+	bool used;
+	// Index of the next free slot while this slot is unused
+	uint32 nextFree;
+} InternTableSlot;
+
+typedef struct intern_table_t
+{
+	// Maps UUIDs to handles
+	HashMap idToHandle;
+	uint32 valueSizeBytes;
+	// Number of allocated slots
+	uint32 capacity;
+	// Number of slots which have been used at least once
+	uint32 numSlots;
+	// Number of interned UUIDs
+	uint32 count;
+	// Index of the first free slot, or INTERN_TABLE_FREE_LIST_END
+	uint32 firstFree;
+	// Number of handles reserved past numSlots which aren't used yet
+	uint32 numReserved;
+	InternTableSlot *slots;
+	// One value of valueSizeBytes per slot
+	uint8 *values;
+} *InternTable;
+
+typedef struct intern_table_iterator_t
+{
+	InternTable table;
+	uint32 index;
+} InternTableIterator;
+
 typedef struct closure_data_t
 {
 	uint8 numArgs;
@@ -5,12 +5,31 @@
 
 #define HASH_SEED 10007
 
+// Hashes a NUL terminated string key of at most keySize bytes
+uint64 hashString(void *key, uint32 keySize);
+// Hashes all keySize bytes of a key (pointers, numbers, packed structs)
+uint64 hashBytes(void *key, uint32 keySize);
+
+/*
+ * The bucket count is only a hint for the initial capacity, the map grows
+ * automatically. Inserting may move every entry, so pointers returned by
+ * hashMapGetData and live iterators are invalidated by an insert. Deleting
+ * never moves other entries.
+ */
 HashMap createHashMap(
 	uint32 keySize,
 	uint32 valueSize,
 	uint32 bucketCount,
 	ComparisonOp comparison);
+HashMap createHashMapWithHashFunction(
+	uint32 keySize,
+	uint32 valueSize,
+	uint32 bucketCount,
+	ComparisonOp comparison,
+	HashFunction hashFunction);
 void freeHashMap(HashMap *map);
+// Copies the map's slots as they are, without hashing any keys again
+HashMap copyHashMap(HashMap map);
 
 void hashMapPush(HashMap map, void *key, void *value);
 void hashMapInsert(HashMap map, void *key, void *value);
@@ -0,0 +1,60 @@
+#pragma once
+#include "defines.h"
+
+#include "data_types.h"
+
+#define HANDLE_INDEX_BITS 32
+#define HANDLE_INDEX_MASK 0xFFFFFFFF
+
+// A slot is retired instead of being reused once its generation reaches this
+#define MAX_HANDLE_GENERATION 0xFFFFFFFF
+
+#define INVALID_HANDLE 0xFFFFFFFFFFFFFFFF
+
+#define HANDLE_GET_INDEX(handle) ((uint32)((handle) & HANDLE_INDEX_MASK))
+#define HANDLE_GET_GENERATION(handle) ((uint32)((handle) >> HANDLE_INDEX_BITS))
+
+/*
+ * Maps UUIDs to dense handles once so that later lookups are array indexing.
+ * The capacity is only a hint, the table grows automatically. Every handle
+ * owns a zeroed value of valueSize bytes. Inserting may move the values, so
+ * pointers returned by internTableGetData are invalidated by an insert.
+ * Removing a UUID bumps the generation of its slot, so stale handles are
+ * rejected instead of aliasing whatever reuses the slot. A slot whose
+ * generation has run out is never reused, so generations can't wrap around
+ * to a stale handle's. Anonymous handles have an empty UUID until one is
+ * set, which saves hashing a UUID for handles that never need one.
+ */
+InternTable createInternTable(uint32 valueSize, uint32 capacity);
+void freeInternTable(InternTable *table);
+
+// Returns the existing handle if the UUID has already been interned
+Handle internTableInsert(InternTable table, UUID id);
+Handle internTableInsertAnonymous(InternTable table);
+// Reserves an anonymous handle without changing the table, so it can be
+// called from several threads at once while the table is only being read.
+// The handle is invalid until internTableCommitReserved is called.
+Handle internTableReserve(InternTable table);
+// Turns every reserved handle into an anonymous handle which is in use
+void internTableCommitReserved(InternTable table);
+// Replaces the UUID of the handle, fails if the UUID belongs to another handle
+int32 internTableSetID(InternTable table, Handle handle, UUID id);
+void internTableRemove(InternTable table, Handle handle);
+void internTableClear(InternTable table);
+
+Handle internTableGetHandle(InternTable table, UUID id);
+bool internTableIsValid(InternTable table, Handle handle);
+UUID *internTableGetID(InternTable table, Handle handle);
+// Returns the handle currently using the slot, or INVALID_HANDLE
+Handle internTableGetIndexHandle(InternTable table, uint32 index);
+void *internTableGetData(InternTable table, Handle handle);
+
+InternTableIterator internTableGetIterator(InternTable table);
+void internTableMoveIterator(InternTableIterator *itr);
+int32 internTableIteratorAtEnd(InternTableIterator itr);
+Handle internTableIteratorGetHandle(InternTableIterator itr);
+UUID *internTableIteratorGetID(InternTableIterator itr);
+void *internTableIteratorGetData(InternTableIterator itr);
+
+// Comparison function for hash maps keyed by handles
+int32 compareHandles(void *a, void *b);
@@ -0,0 +1,22 @@
+#pragma once
+#include "defines.h"
+
+// Worst case size of an LZ4 block holding size bytes of incompressible data
+#define LZ4_COMPRESS_BOUND(size) ((size) + (size) / 255 + 16)
+
+/*
+ * Compresses source into a raw LZ4 block (no frame header or checksum).
+ * Returns the compressed size, or 0 if the block doesn't fit in
+ * destinationSize bytes.
+ */
+uint64 lz4Compress(
+	const uint8 *source,
+	uint64 sourceSize,
+	uint8 *destination,
+	uint64 destinationSize);
+// Fails unless the block decompresses to exactly destinationSize bytes
+int32 lz4Decompress(
+	const uint8 *source,
+	uint64 sourceSize,
+	uint8 *destination,
+	uint64 destinationSize);
@@ -39,6 +39,7 @@ typedef union uuid_t
 			#test,											\
 			__FILE__,										\
 			__LINE__);										\
+		flushLog();											\
 		volatile int32* crash = 0;							\
 		*crash = 0;											\
 	}
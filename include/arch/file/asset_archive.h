@@ -0,0 +1,34 @@
+#pragma once
+#include "defines.h"
+
+#include "file/file_types.h"
+
+// Entry data is aligned so that mapped meshes can be read in place
+#define ASSET_ARCHIVE_ALIGNMENT 16
+
+/*
+ * Packs every file and folder below folder into a single archive. Paths are
+ * stored as folder/relative/path, the same way the loaders build them. With
+ * compress set, files are LZ4 compressed whenever that saves enough space,
+ * except for meshes which have to stay mappable.
+ */
+int32 packAssetArchive(
+	const char *folder,
+	const char *filename,
+	bool compress);
+
+// Maps and validates the archive, so lookups can trust its contents
+int32 openAssetArchive(const char *filename, AssetArchive *archive);
+void closeAssetArchive(AssetArchive *archive);
+
+const AssetArchiveEntry* getAssetArchiveEntry(
+	const AssetArchive *archive,
+	const char *path);
+// Points straight into the mapped archive, or NULL if the entry is compressed
+const uint8* getAssetArchiveEntryData(
+	const AssetArchive *archive,
+	const AssetArchiveEntry *entry);
+// Returns a decompressed copy of the entry which the caller has to free
+uint8* readAssetArchiveEntry(
+	const AssetArchive *archive,
+	const AssetArchiveEntry *entry);
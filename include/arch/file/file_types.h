@@ -0,0 +1,60 @@
+#pragma once
+#include "defines.h"
+
+typedef struct mapped_file_t
+{
+	uint8 *data;
+	uint64 size;
+	// Views into memory owned by something else (such as an asset archive)
+	// are only forgotten when they're unmapped
+	bool borrowed;
+#ifdef _WIN32
+	void *fileHandle;
+	void *mappingHandle;
+#endif
+} MappedFile;
+
+#define ASSET_ARCHIVE_MAGIC "GPAK"
+#define ASSET_ARCHIVE_VERSION 1
+
+typedef enum asset_archive_compression_e
+{
+	ASSET_ARCHIVE_COMPRESSION_NONE = 0,
+	ASSET_ARCHIVE_COMPRESSION_LZ4
+} AssetArchiveCompression;
+
+typedef enum asset_archive_entry_flags_e
+{
+	ASSET_ARCHIVE_ENTRY_USED = 1,
+	ASSET_ARCHIVE_ENTRY_FOLDER = 2
+} AssetArchiveEntryFlags;
+
+typedef struct asset_archive_header_t
+{
+	char magic[4];
+	uint32 version;
+	uint32 numEntries;
+	uint32 numSlots;
+	uint64 entriesOffset;
+	uint64 pathsOffset;
+} AssetArchiveHeader;
+
+// One slot of the open addressed table of contents
+typedef struct asset_archive_entry_t
+{
+	uint64 hash;
+	uint64 offset;
+	uint64 size;
+	uint64 originalSize;
+	uint32 pathOffset;
+	uint16 compression;
+	uint16 flags;
+} AssetArchiveEntry;
+
+typedef struct asset_archive_t
+{
+	MappedFile file;
+	const AssetArchiveHeader *header;
+	const AssetArchiveEntry *entries;
+	const char *paths;
+} AssetArchive;
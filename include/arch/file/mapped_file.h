@@ -0,0 +1,9 @@
+#pragma once
+#include "defines.h"
+
+#include "file/file_types.h"
+
+// Maps the whole file read-only into memory
+int32 mapFile(const char *filename, MappedFile *file);
+// Does nothing if the file isn't mapped
+void unmapFile(MappedFile *file);
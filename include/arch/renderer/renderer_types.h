@@ -33,6 +33,9 @@ typedef struct mesh_t
 	Vertex *vertices;
 	uint32 numIndices;
 	uint32 *indices;
+	// Vertices and indices point into a mapped mesh file instead of being
+	// allocated
+	bool mapped;
 } Mesh;
 
 typedef enum material_component_type_e
@@ -0,0 +1,20 @@
+#pragma once
+#include "defines.h"
+
+#include "threading_types.h"
+
+// The node's function is queued on the pool once the node has been started
+// and all of its dependencies have finished. A node with a parent is one of
+// the parent's dependencies, and finishes once its function has returned.
+JobNode *createJobNode(
+	ThreadPool *pool,
+	JobFunction function,
+	void *data,
+	int32 priority,
+	JobNode *parent);
+// Nodes are freed once they have finished
+void startJobNode(JobNode *node);
+
+// Every dependency which is added must be finished exactly once
+void jobNodeAddDependency(JobNode *node);
+void jobNodeFinishDependency(JobNode *node);
@@ -8,5 +8,7 @@ void freePromise(Promise **p);
 
 Promise *pReturn(void *pData);
 Promise *pBind(Promise **p, Promise *(*fn)(void *pData));
+// Blocks until the promise has been completed and returns its data
+void *pAwait(Promise *p);
 
 void pComplete(Promise *p, void *pData);
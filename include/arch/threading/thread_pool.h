@@ -0,0 +1,31 @@
+#pragma once
+#include "defines.h"
+
+#include "threading_types.h"
+
+#define THREAD_POOL_MIN_JOB_CAPACITY 64
+
+// A pool with no threads runs every job on the calling thread
+ThreadPool *createThreadPool(uint32 numThreads);
+void freeThreadPool(ThreadPool **pool);
+
+void threadPoolAddJob(ThreadPool *pool, JobFunction function, void *data);
+// Queued jobs with a higher priority are started before those with a lower
+// one, and jobs with equal priorities are started in the order they were added
+void threadPoolAddPriorityJob(
+	ThreadPool *pool,
+	JobFunction function,
+	void *data,
+	int32 priority);
+// Blocks until every job which has been added has finished
+void threadPoolWait(ThreadPool *pool);
+
+// Splits count items into chunks which idle threads claim until none are
+// left. The calling thread works on chunks as well, so this is safe to call
+// from inside a job. Returns once every item has been processed.
+void threadPoolParallelFor(
+	ThreadPool *pool,
+	uint32 count,
+	uint32 chunkSize,
+	ParallelForFunction function,
+	void *data);
@@ -10,3 +10,48 @@ typedef struct promise_t
 	pthread_cond_t cond;
 	pthread_mutex_t mut;
 } Promise;
+
+typedef void(*JobFunction)(void *data);
+
+typedef struct job_t
+{
+	JobFunction function;
+	void *data;
+	// Jobs with a higher priority are run first
+	int32 priority;
+	// Orders jobs with the same priority by when they were added
+	uint32 sequence;
+} Job;
+
+// Processes the items in [first, first + count)
+typedef void(*ParallelForFunction)(uint32 first, uint32 count, void *data);
+
+typedef struct thread_pool_t
+{
+	uint32 numThreads;
+	pthread_t *threads;
+	// Binary heap of jobs which are waiting for a thread
+	uint32 jobCapacity;
+	uint32 numJobs;
+	Job *jobs;
+	uint32 nextSequence;
+	// Number of jobs which are queued or running
+	uint32 numUnfinishedJobs;
+	bool shutdown;
+	pthread_mutex_t mutex;
+	pthread_cond_t jobCondition;
+	pthread_cond_t finishedCondition;
+} ThreadPool;
+
+typedef struct job_node_t
+{
+	ThreadPool *pool;
+	JobFunction function;
+	void *data;
+	int32 priority;
+	// Dependencies which haven't finished yet, plus one until the node has
+	// been started
+	uint32 numDependencies;
+	// Has this node as one of its dependencies
+	struct job_node_t *parent;
+} JobNode;
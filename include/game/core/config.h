@@ -1,6 +1,8 @@
 #pragma once
 #include "defines.h"
 
+#include "core/core_types.h"
+
 #include <kazmath/vec2.h>
 #include <kazmath/vec3.h>
 
@@ -23,6 +25,11 @@ typedef struct physics_config_t
 	real32 fps;
 } PhysicsConfig;
 
+typedef struct systems_config_t
+{
+	uint32 numWorkerThreads;
+} SystemsConfig;
+
 typedef struct graphics_config_t
 {
 	kmVec3 backgroundColor;
@@ -49,7 +56,22 @@ typedef struct assets_config_t
 	real64 minModelLifetime;
 	real64 minParticleLifetime;
 	real64 minCubemapLifetime;
+	// Memory budgets in bytes, 0 leaves the memory unbounded
+	uint64 maxMemory;
+	uint64 maxAudioFileMemory;
+	uint64 maxFontMemory;
+	uint64 maxImageMemory;
+	uint64 maxTextureMemory;
+	uint64 maxModelMemory;
+	uint64 maxParticleMemory;
+	uint64 maxCubemapMemory;
+	// Seconds and bytes of assets uploaded each frame, 0 is unbounded
+	real64 maxFrameUploadTime;
+	uint64 maxFrameUploadSize;
+	// 0 uploads assets straight from memory
+	uint64 stagingBufferSize;
 	uint32 maxThreadCount;
+	char *archive;
 } AssetsConfig;
 
 typedef struct log_config_t
@@ -57,12 +79,17 @@ typedef struct log_config_t
 	char *engineFile;
 	char *assetManagerFile;
 	char *luaFile;
+	// Messages below this level are dropped
+	LogLevel level;
+	// Messages are formatted on the log thread from copies of their arguments
+	bool deferFormatting;
 } LogConfig;
 
 typedef struct saves_config_t
 {
 	bool removeJSONScenes;
-	bool removeJSONEntities;
+	// Scene snapshots are rewritten in full once they have this many deltas
+	uint32 maxSnapshotDeltas;
 } SavesConfig;
 
 typedef struct json_config_t
@@ -74,6 +101,7 @@ typedef struct config_t
 {
 	WindowConfig windowConfig;
 	PhysicsConfig physicsConfig;
+	SystemsConfig systemsConfig;
 	GraphicsConfig graphicsConfig;
 	AssetsConfig assetsConfig;
 	LogConfig logConfig;
@@ -47,18 +47,22 @@ void listClear(List *l);
 void listRemove(List *l, ListIterator *itr);
 void listInsert(List *l, ListIterator *itr, void *data);
 
-typedef List HashMapBucket;
-
 typedef int32(*ComparisonOp)(void*, void*);
+typedef uint64(*HashFunction)(void*, uint32);
 
 typedef struct hash_map_t
 {
+  ComparisonOp comparison;
+  HashFunction hashFunction;
   uint32 keySizeBytes;
   uint32 valueSizeBytes;
-  uint32 bucketCount;
-  ComparisonOp comparison;
+  uint32 slotSizeBytes;
+  uint32 valueOffset;
+  uint32 capacity;
   uint32 count;
-  HashMapBucket buckets[];
+  uint32 numDeleted;
+  uint8 *control;
+  uint8 *slots;
 } *HashMap;
 
 void *hashMapGetData(HashMap map, void *key);
@@ -72,6 +76,32 @@ typedef union uuid_t
 UUID idFromName(const char *name);
 UUID stringToUUID(const char *string);
 
+typedef uint64 Handle;
+
+typedef struct intern_table_slot_t
+{
+  UUID id;
+  uint32 generation;
+  bool used;
+  uint32 nextFree;
+} InternTableSlot;
+
+typedef struct intern_table_t
+{
+  HashMap idToHandle;
+  uint32 valueSizeBytes;
+  uint32 capacity;
+  uint32 numSlots;
+  uint32 count;
+  uint32 firstFree;
+  uint32 numReserved;
+  InternTableSlot *slots;
+  uint8 *values;
+} *InternTable;
+
+typedef Handle EntityHandle;
+typedef Handle ComponentTypeHandle;
+
 void setMousePosition(real64 x, real64 y);
 void setMouseHidden(bool hidden);
 void setMouseLocked(bool locked);
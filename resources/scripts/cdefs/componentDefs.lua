@@ -21,9 +21,15 @@ typedef struct component_data_table_t
   UUID componentID;
   uint32 numEntries;
   uint32 componentSize;
-  uint32 firstFree;
-  HashMap idToIndex;
-  uint8 data[];
+  uint32 numComponents;
+  uint32 highWaterMark;
+  uint32 chunkShift;
+  uint32 numChunks;
+  uint8 **chunks;
+  uint32 sparseSize;
+  uint32 *sparse;
+  EntityHandle *entities;
+  uint32 lowestRemovedIndex;
 } ComponentDataTable;
 
 typedef struct
@@ -35,6 +41,28 @@ typedef struct
 ComponentDataTableIterator cdtGetIterator(ComponentDataTable *table);
 void cdtMoveIterator(ComponentDataTableIterator *itr);
 uint32 cdtIteratorAtEnd(ComponentDataTableIterator itr);
-UUID cdtIteratorGetUUID(ComponentDataTableIterator itr) ;
+EntityHandle cdtIteratorGetEntity(ComponentDataTableIterator itr);
 void *cdtIteratorGetData(ComponentDataTableIterator itr);
+
+ComponentTypeHandle componentTypeFromName(const char *name);
+ComponentTypeHandle componentTypeFromID(UUID componentID);
+UUID componentTypeGetID(ComponentTypeHandle componentType);
+
+typedef struct component_signature_t
+{
+  uint64 bits[4];
+} ComponentSignature;
+
+bool signatureHasComponentType(
+  ComponentSignature const *signature,
+  ComponentTypeHandle componentType);
+void signatureAddComponentType(
+  ComponentSignature *signature,
+  ComponentTypeHandle componentType);
+void signatureRemoveComponentType(
+  ComponentSignature *signature,
+  ComponentTypeHandle componentType);
+bool signatureContains(
+  ComponentSignature const *signature,
+  ComponentSignature const *componentTypes);
 ]]
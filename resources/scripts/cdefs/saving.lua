@@ -1,6 +1,10 @@
 ffi.cdef[[
 
-int32 exportSave(void *data, uint32 size, uint32 slot);
+typedef void(*SaveCallback)(uint32 slot, int32 error);
+
+int32 exportSave(void *data, uint32 size, uint32 slot, SaveCallback callback);
+bool isSaving(void);
+real32 getSaveProgress(void);
 int32 loadSave(uint32 slot, void **data);
 bool getSaveSlotAvailability(uint32 slot);
 int32 deleteSave(uint32 slot);
@@ -3,9 +3,15 @@ ffi.cdef[[
 typedef struct scene_t
 {
 	char *name;
-	HashMap componentTypes;
-	HashMap entities;
+	uint32 numComponentTables;
+	ComponentDataTable **componentTables;
+	uint32 numQueries;
+	void **queries;
+	void *commandBuffer;
+	InternTable entities;
+	uint64 entitiesGeneration;
 	UUID mainCamera;
+	EntityHandle mainCameraEntity;
 	UUID player;
 	List physicsFrameSystems;
 	List renderFrameSystems;
@@ -29,38 +35,67 @@ int32 unloadScene(const char *name);
 
 List activeScenes;
 
-void sceneRegisterEntity(Scene *s, UUID newEntity);
-UUID sceneCreateEntity(Scene *s);
-void sceneRemoveEntity(Scene *s, UUID entity);
+EntityHandle sceneRegisterEntity(Scene *s, UUID newEntity);
+EntityHandle sceneCreateEntity(Scene *s);
+void sceneRemoveEntity(Scene *s, EntityHandle entity);
+
+EntityHandle sceneGetEntity(Scene *s, UUID entity);
+UUID sceneGetEntityID(Scene *s, EntityHandle entity);
+bool sceneEntityExists(Scene *s, EntityHandle entity);
+ComponentSignature *sceneGetEntitySignature(Scene *s, EntityHandle entity);
+bool sceneEntityHasComponentTypes(
+  Scene *s,
+  EntityHandle entity,
+  ComponentSignature const *componentTypes);
 
 int32 sceneAddComponentToEntity(
   Scene *s,
-  UUID entity,
-  UUID componentType,
+  EntityHandle entity,
+  ComponentTypeHandle componentType,
   void *componentData);
 
 void sceneRemoveComponentFromEntity(
   Scene *s,
-  UUID entity,
-  UUID componentType);
+  EntityHandle entity,
+  ComponentTypeHandle componentType);
 
-void sceneRemoveComponentFromAllEntities(Scene *scene, UUID componentID);
+void sceneRemoveComponentFromAllEntities(
+  Scene *scene,
+  ComponentTypeHandle componentType);
 
 void *sceneGetComponentFromEntity(
   Scene *s,
-  UUID entity,
-  UUID componentType);
+  EntityHandle entity,
+  ComponentTypeHandle componentType);
+
+EntityHandle sceneDeferRegisterEntity(Scene *s, UUID newEntity);
+EntityHandle sceneDeferCreateEntity(Scene *s);
+void sceneDeferRemoveEntity(Scene *s, EntityHandle entity);
+int32 sceneDeferAddComponentToEntity(
+  Scene *s,
+  EntityHandle entity,
+  ComponentTypeHandle componentType,
+  void *componentData);
+void sceneDeferRemoveComponentFromEntity(
+  Scene *s,
+  EntityHandle entity,
+  ComponentTypeHandle componentType);
+void sceneApplyCommands(Scene *s);
 
 void sceneAddComponentType(
   Scene *scene,
-  UUID componentID,
+  ComponentTypeHandle componentType,
   uint32 componentSize,
   uint32 maxComponents);
 
+ComponentDataTable *sceneGetComponentDataTable(
+  Scene *scene,
+  ComponentTypeHandle componentType);
+
 void exportSceneSnapshot(Scene *scene, const char *filename);
 void exportEntitySnapshot(
 	Scene *scene,
-	UUID entity,
+	EntityHandle entity,
 	const char *filename);
 
 ]]
@@ -1,6 +1,6 @@
 ffi.cdef[[
 
-void registerRigidBody(Scene *scene, UUID entity);
+void registerRigidBody(Scene *scene, EntityHandle entity);
 void createCollisionGeoms(
 	Scene *scene,
 	TransformComponent *bodyTrans,
@@ -2,8 +2,8 @@ ffi.cdef[[
 typedef struct collision_component_t
 {
   UUID collisionTree;
-  UUID hitList;
-  UUID lastHitList;
+  EntityHandle hitList;
+  EntityHandle lastHitList;
 } CollisionComponent;
 ]]
 
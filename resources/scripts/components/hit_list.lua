@@ -1,8 +1,8 @@
 ffi.cdef[[
 typedef struct hit_list_component_t
 {
-  UUID nextHit;
-  UUID hit;
+  EntityHandle nextHit;
+  EntityHandle hit;
 } HitListComponent;
 ]]
 
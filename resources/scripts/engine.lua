@@ -38,6 +38,9 @@ require("resources/scripts/cdefs")
 
 io.write("Created cffi definitions\n")
 
+-- Matches INVALID_HANDLE in data/intern_table.h
+engine.INVALID_HANDLE = 0xFFFFFFFFFFFFFFFFULL
+
 engine.input = require("resources/scripts/input")
 
 engine.keyboard = require("resources/scripts/keyboard")
@@ -146,16 +149,12 @@ function engine.runSystems(pScene, dt, physics)
     end
 
     if system.run then
-	  for component, uuid in scene:getComponentIterator(system.components[1]) do
-		local valid = true
-
-		for k = 2,#system.components do
-		  if scene:getComponent(system.components[k], uuid) == nil then
-			valid = false
-		  end
-		end
+	  if not system.signature then
+		system.signature = scene:getSignature(system.components)
+	  end
 
-		if valid then
+	  for component, uuid in scene:getComponentIterator(system.components[1]) do
+		if scene:hasComponents(system.signature, uuid) then
 		  local err, message = pcall(
 			system.run,
 			scene,
@@ -179,6 +178,8 @@ function engine.runSystems(pScene, dt, physics)
       end
     end
 
+    scene:applyCommands()
+
 	itrRef[0] = itr
     C.listMoveIterator(itrRef)
     itr = itrRef[0]
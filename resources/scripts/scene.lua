@@ -15,8 +15,11 @@ end
 
 function Scene:getComponent(component, entity)
   if engine.components[component] then
-    local componentID = C.idFromName(component)
-    local componentData = C.sceneGetComponentFromEntity(self.ptr, entity, componentID)
+    local componentID = C.componentTypeFromName(component)
+    local componentData = C.sceneGetComponentFromEntity(
+	  self.ptr,
+	  C.sceneGetEntity(self.ptr, entity),
+	  componentID)
     return engine.components[component]:new(componentData)
   else
     io.write(string.format("Attempting to get undefined component type %s\n", component))
@@ -24,18 +27,87 @@ function Scene:getComponent(component, entity)
   end
 end
 
+-- Returns a signature of the component types, for use with hasComponents
+function Scene:getSignature(components)
+  local signature = ffi.new("ComponentSignature")
+  for i = 1,#components do
+	C.signatureAddComponentType(
+	  signature,
+	  C.componentTypeFromName(components[i]))
+  end
+  return signature
+end
+
+function Scene:hasComponents(signature, entity)
+  return C.sceneEntityHasComponentTypes(
+	self.ptr,
+	C.sceneGetEntity(self.ptr, entity),
+	signature)
+end
+
 function Scene:addComponentToEntity(component, entity, componentData)
-  local componentID = C.idFromName(component)
-  return C.sceneAddComponentToEntity(self.ptr, entity, componentID, componentData)
+  local componentID = C.componentTypeFromName(component)
+  return C.sceneAddComponentToEntity(
+	self.ptr,
+	C.sceneGetEntity(self.ptr, entity),
+	componentID,
+	componentData)
 end
 
 function Scene:removeComponentFromEntity(component, entity)
-  local componentID = C.idFromName(component)
-  C.sceneRemoveComponentFromEntity(self.ptr, entity, componentID)
+  local componentID = C.componentTypeFromName(component)
+  C.sceneRemoveComponentFromEntity(
+	self.ptr,
+	C.sceneGetEntity(self.ptr, entity),
+	componentID)
+end
+
+function Scene:createEntity()
+  return C.sceneGetEntityID(self.ptr, C.sceneCreateEntity(self.ptr))
 end
 
 function Scene:removeEntity(entity)
-  C.sceneRemoveEntity(self.ptr, entity)
+  C.sceneRemoveEntity(self.ptr, C.sceneGetEntity(self.ptr, entity))
+end
+
+-- Entities created by deferCreateEntity are only known by their handle
+-- until the commands are applied, so the deferred functions take either
+local function getDeferredEntity(scene, entity)
+  if ffi.istype("EntityHandle", entity) then
+	return entity
+  end
+  return C.sceneGetEntity(scene.ptr, entity)
+end
+
+-- The deferred functions are safe to call while iterating over the scene,
+-- their changes are made once the current system has finished
+function Scene:deferAddComponentToEntity(component, entity, componentData)
+  local componentID = C.componentTypeFromName(component)
+  return C.sceneDeferAddComponentToEntity(
+	self.ptr,
+	getDeferredEntity(self, entity),
+	componentID,
+	componentData)
+end
+
+function Scene:deferRemoveComponentFromEntity(component, entity)
+  local componentID = C.componentTypeFromName(component)
+  C.sceneDeferRemoveComponentFromEntity(
+	self.ptr,
+	getDeferredEntity(self, entity),
+	componentID)
+end
+
+function Scene:deferCreateEntity()
+  return C.sceneDeferCreateEntity(self.ptr)
+end
+
+function Scene:deferRemoveEntity(entity)
+  C.sceneDeferRemoveEntity(self.ptr, getDeferredEntity(self, entity))
+end
+
+function Scene:applyCommands()
+  C.sceneApplyCommands(self.ptr)
 end
 
 function Scene:getComponentIterator(component)
@@ -43,11 +115,9 @@ function Scene:getComponentIterator(component)
   local itr = ffi.new(
 	"ComponentDataTableIterator",
 	C.cdtGetIterator(
-	  ffi.cast(
-		"ComponentDataTable**",
-		C.hashMapGetData(
-		  self.ptr.componentTypes,
-		  C.idFromName(component)))[0]))
+	  C.sceneGetComponentDataTable(
+		self.ptr,
+		C.componentTypeFromName(component))))
   local first = true
   return function ()
 	if not first then
@@ -60,7 +130,7 @@ function Scene:getComponentIterator(component)
 	if C.cdtIteratorAtEnd(itr) == 0 then
 	  return engine.components[component]:new(
 			   C.cdtIteratorGetData(itr)),
-			 C.cdtIteratorGetUUID(itr)
+			 C.sceneGetEntityID(self.ptr, C.cdtIteratorGetEntity(itr))
 	end
   end
 end
@@ -45,7 +45,7 @@ function system.run(scene, uuid, dt)
 	kazmath.kmVec3Assign(rigid_body.velocity, outVec[0])
   end
 
-  if ffi.string(collision.hitList.string) ~= "" then
+  if collision.hitList ~= engine.INVALID_HANDLE then
 	if input.jump.keydown and input.jump.updated then
 	  kazmath.kmVec3Fill(outVec, 0, movement.jumpHeight, 0)
 	  kazmath.kmVec3Scale(outVec, outVec[0], 1 / rigid_body.mass)
@@ -38,7 +38,7 @@ function system.run(scene, entityID, dt)
 			ffi.string(entityID.string)))
 
 	-- Create an entity with a box model
-	local entity = C.sceneCreateEntity(scene.ptr)
+	local entity = scene:createEntity()
 	local transform = ffi.new("TransformComponent")
 	transform.dirty = true
 
@@ -86,10 +86,10 @@ function system.run(scene, entityID, dt)
 	scene:addComponentToEntity("rigid_body", entity, rigidbody)
 
 	local collision = ffi.new("CollisionComponent")
-	collision.hitList = C.idFromName("")
-	collision.lastHitList = C.idFromName("")
+	collision.hitList = engine.INVALID_HANDLE
+	collision.lastHitList = engine.INVALID_HANDLE
 
-	local colliderEntity = C.sceneCreateEntity(scene.ptr)
+	local colliderEntity = scene:createEntity()
 
 	local colliderTransform = ffi.new("TransformComponent")
 	kazmath.kmVec3Assign(vecOut, spawnerTransform.globalPosition)
@@ -144,7 +144,7 @@ function system.run(scene, entityID, dt)
 
 	scene:addComponentToEntity("debug_collision_primitive", colliderEntity, debugCollisionPrimitive)
 
-	C.registerRigidBody(scene.ptr, entity)
+	C.registerRigidBody(scene.ptr, C.sceneGetEntity(scene.ptr, entity))
   end
 end
 
@@ -0,0 +1,308 @@
+#include "ECS/command_buffer.h"
+#include "ECS/scene.h"
+
+#include "core/log.h"
+
+#include "data/intern_table.h"
+
+#include <malloc.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Component data is aligned so that it can be used in place when applied
+#define COMMAND_DATA_ALIGNMENT 16
+
+CommandBuffer *createCommandBuffer(void)
+{
+	CommandBuffer *ret = calloc(1, sizeof(CommandBuffer));
+
+	ASSERT(ret != 0);
+
+	ret->capacity = COMMAND_BUFFER_MIN_CAPACITY;
+	ret->commands = malloc(ret->capacity * sizeof(SceneCommand));
+
+	ASSERT(ret->commands != 0);
+
+	ret->dataCapacity = COMMAND_BUFFER_MIN_DATA_CAPACITY;
+	ret->data = malloc(ret->dataCapacity);
+
+	ASSERT(ret->data != 0);
+
+	ret->applyCapacity = COMMAND_BUFFER_MIN_CAPACITY;
+	ret->applyCommands = malloc(ret->applyCapacity * sizeof(SceneCommand));
+
+	ASSERT(ret->applyCommands != 0);
+
+	ret->applyDataCapacity = COMMAND_BUFFER_MIN_DATA_CAPACITY;
+	ret->applyData = malloc(ret->applyDataCapacity);
+
+	ASSERT(ret->applyData != 0);
+
+	pthread_mutex_init(&ret->mutex, NULL);
+
+	return ret;
+}
+
+void freeCommandBuffer(CommandBuffer **buffer)
+{
+	pthread_mutex_destroy(&(*buffer)->mutex);
+
+	free((*buffer)->commands);
+	free((*buffer)->data);
+	free((*buffer)->applyCommands);
+	free((*buffer)->applyData);
+	free(*buffer);
+	*buffer = NULL;
+}
+
+internal
+void pushCommand(
+	CommandBuffer *buffer,
+	SceneCommandType type,
+	EntityHandle entity,
+	ComponentTypeHandle componentType,
+	void *componentData,
+	uint32 componentSize)
+{
+	pthread_mutex_lock(&buffer->mutex);
+
+	if (buffer->numCommands == buffer->capacity)
+	{
+		buffer->capacity <<= 1;
+		buffer->commands = realloc(
+			buffer->commands,
+			buffer->capacity * sizeof(SceneCommand));
+
+		ASSERT(buffer->commands != 0);
+	}
+
+	SceneCommand *command = &buffer->commands[buffer->numCommands++];
+	command->type = type;
+	command->entity = entity;
+	command->componentType = componentType;
+	command->sequence = buffer->numCommands - 1;
+	command->dataOffset = buffer->dataSize;
+
+	if (componentData)
+	{
+		uint32 dataSize = buffer->dataSize
+			+ (componentSize + COMMAND_DATA_ALIGNMENT - 1)
+			/ COMMAND_DATA_ALIGNMENT * COMMAND_DATA_ALIGNMENT;
+
+		if (dataSize > buffer->dataCapacity)
+		{
+			while (dataSize > buffer->dataCapacity)
+			{
+				buffer->dataCapacity <<= 1;
+			}
+
+			buffer->data = realloc(buffer->data, buffer->dataCapacity);
+
+			ASSERT(buffer->data != 0);
+		}
+
+		memcpy(buffer->data + buffer->dataSize, componentData, componentSize);
+		buffer->dataSize = dataSize;
+	}
+
+	pthread_mutex_unlock(&buffer->mutex);
+}
+
+void commandBufferRegisterEntity(
+	CommandBuffer *buffer,
+	EntityHandle entity,
+	UUID id)
+{
+	pushCommand(
+		buffer,
+		SCENE_COMMAND_REGISTER_ENTITY,
+		entity,
+		INVALID_HANDLE,
+		&id,
+		sizeof(UUID));
+}
+
+void commandBufferRemoveEntity(CommandBuffer *buffer, EntityHandle entity)
+{
+	pushCommand(
+		buffer,
+		SCENE_COMMAND_REMOVE_ENTITY,
+		entity,
+		INVALID_HANDLE,
+		NULL,
+		0);
+}
+
+void commandBufferAddComponentToEntity(
+	CommandBuffer *buffer,
+	EntityHandle entity,
+	ComponentTypeHandle componentType,
+	void *componentData,
+	uint32 componentSize)
+{
+	pushCommand(
+		buffer,
+		SCENE_COMMAND_ADD_COMPONENT,
+		entity,
+		componentType,
+		componentData,
+		componentSize);
+}
+
+void commandBufferRemoveComponentFromEntity(
+	CommandBuffer *buffer,
+	EntityHandle entity,
+	ComponentTypeHandle componentType)
+{
+	pushCommand(
+		buffer,
+		SCENE_COMMAND_REMOVE_COMPONENT,
+		entity,
+		componentType,
+		NULL,
+		0);
+}
+
+internal
+int32 compareSceneCommands(const void *a, const void *b)
+{
+	const SceneCommand *commandA = a;
+	const SceneCommand *commandB = b;
+
+	// Reserved handles have the highest indices, so entities created by the
+	// commands come after the entities which already exist
+	uint32 indexA = HANDLE_GET_INDEX(commandA->entity);
+	uint32 indexB = HANDLE_GET_INDEX(commandB->entity);
+	if (indexA != indexB)
+	{
+		return (indexA > indexB) - (indexA < indexB);
+	}
+
+	return (commandA->sequence > commandB->sequence)
+		- (commandA->sequence < commandB->sequence);
+}
+
+internal
+void applyCommands(
+	Scene *scene,
+	SceneCommand *commands,
+	uint32 numCommands,
+	uint8 *data)
+{
+	// Commands on different entities don't affect each other, so only the
+	// order of each entity's commands has to be kept
+	qsort(commands, numCommands, sizeof(SceneCommand), &compareSceneCommands);
+
+	bool entityExists = false;
+
+	for (uint32 i = 0; i < numCommands; i++)
+	{
+		SceneCommand *command = &commands[i];
+		EntityHandle entity = command->entity;
+
+		if (i == 0 || entity != commands[i - 1].entity)
+		{
+			entityExists = sceneEntityExists(scene, entity);
+		}
+
+		// The entity may never have existed or been removed already
+		if (!entityExists)
+		{
+			continue;
+		}
+
+		switch (command->type)
+		{
+			case SCENE_COMMAND_REGISTER_ENTITY:
+				if (internTableSetID(
+					scene->entities,
+					entity,
+					*(UUID*)(data + command->dataOffset)) == -1)
+				{
+					sceneRemoveEntity(scene, entity);
+					entityExists = false;
+				}
+				break;
+			case SCENE_COMMAND_REMOVE_ENTITY:
+				sceneRemoveEntity(scene, entity);
+				entityExists = false;
+				break;
+			case SCENE_COMMAND_ADD_COMPONENT:
+				sceneAddComponentToEntity(
+					scene,
+					entity,
+					command->componentType,
+					data + command->dataOffset);
+				break;
+			case SCENE_COMMAND_REMOVE_COMPONENT:
+				sceneRemoveComponentFromEntity(
+					scene,
+					entity,
+					command->componentType);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+void commandBufferApply(CommandBuffer *buffer, Scene *scene)
+{
+	while (true)
+	{
+		// Entities created while recording get their slots before any of
+		// their commands are applied
+		if (scene->entities->numReserved > 0)
+		{
+			internTableCommitReserved(scene->entities);
+			scene->entitiesGeneration++;
+		}
+
+		pthread_mutex_lock(&buffer->mutex);
+
+		uint32 numCommands = buffer->numCommands;
+
+		if (numCommands == 0)
+		{
+			pthread_mutex_unlock(&buffer->mutex);
+			break;
+		}
+
+		// Swap the batch out so that hooks called while applying it can
+		// record commands of their own without deadlocking
+		SceneCommand *commands = buffer->commands;
+		uint32 capacity = buffer->capacity;
+		uint8 *data = buffer->data;
+		uint32 dataCapacity = buffer->dataCapacity;
+
+		buffer->commands = buffer->applyCommands;
+		buffer->capacity = buffer->applyCapacity;
+		buffer->data = buffer->applyData;
+		buffer->dataCapacity = buffer->applyDataCapacity;
+		buffer->numCommands = 0;
+		buffer->dataSize = 0;
+
+		pthread_mutex_unlock(&buffer->mutex);
+
+		applyCommands(scene, commands, numCommands, data);
+
+		pthread_mutex_lock(&buffer->mutex);
+
+		buffer->applyCommands = commands;
+		buffer->applyCapacity = capacity;
+		buffer->applyData = data;
+		buffer->applyDataCapacity = dataCapacity;
+
+		pthread_mutex_unlock(&buffer->mutex);
+	}
+}
+
+void commandBufferClear(CommandBuffer *buffer)
+{
+	pthread_mutex_lock(&buffer->mutex);
+
+	buffer->numCommands = 0;
+	buffer->dataSize = 0;
+
+	pthread_mutex_unlock(&buffer->mutex);
+}
@@ -1,22 +1,270 @@
 #include "ECS/component.h"
 #include "ECS/ecs_types.h"
+#include "ECS/scene.h"
 
 #include "core/log.h"
 
-#include "data/hash_map.h"
+#include "data/intern_table.h"
 
+#include <pthread.h>
 #include <stdio.h>
 #include <malloc.h>
 #include <string.h>
 
+extern InternTable componentTypeRegistry;
+
+// Scenes can register component types while systems are running on the
+// thread pool, so lookups take the read lock and only inserts write
+internal pthread_rwlock_t componentTypeRegistryLock;
+
+void initializeComponentTypes(void)
+{
+	pthread_rwlock_init(&componentTypeRegistryLock, NULL);
+	componentTypeRegistry = createInternTable(0, COMPONENT_TYPE_BUCKETS);
+}
+
+ComponentTypeHandle componentTypeFromName(const char *name)
+{
+	return componentTypeFromID(idFromName(name));
+}
+
+ComponentTypeHandle componentTypeFromID(UUID componentID)
+{
+	pthread_rwlock_rdlock(&componentTypeRegistryLock);
+	ComponentTypeHandle componentType = internTableGetHandle(
+		componentTypeRegistry,
+		componentID);
+	pthread_rwlock_unlock(&componentTypeRegistryLock);
+
+	if (componentType == INVALID_HANDLE)
+	{
+		pthread_rwlock_wrlock(&componentTypeRegistryLock);
+		componentType = internTableInsert(
+			componentTypeRegistry,
+			componentID);
+		pthread_rwlock_unlock(&componentTypeRegistryLock);
+	}
+
+	if (HANDLE_GET_INDEX(componentType) >= MAX_COMPONENT_TYPES)
+	{
+		LOG_ERROR("Unable to register the %s component, "
+			"only %d component types are supported\n",
+			componentID.string,
+			MAX_COMPONENT_TYPES);
+		return INVALID_HANDLE;
+	}
+
+	return componentType;
+}
+
+ComponentTypeHandle componentTypeFromIndex(uint32 index)
+{
+	pthread_rwlock_rdlock(&componentTypeRegistryLock);
+	ComponentTypeHandle componentType = internTableGetIndexHandle(
+		componentTypeRegistry,
+		index);
+	pthread_rwlock_unlock(&componentTypeRegistryLock);
+
+	return componentType;
+}
+
+UUID componentTypeGetID(ComponentTypeHandle componentType)
+{
+	UUID componentID = {};
+
+	pthread_rwlock_rdlock(&componentTypeRegistryLock);
+	UUID *registeredID = internTableGetID(componentTypeRegistry, componentType);
+
+	if (registeredID)
+	{
+		componentID = *registeredID;
+	}
+
+	pthread_rwlock_unlock(&componentTypeRegistryLock);
+
+	return componentID;
+}
+
+void freeComponentTypes(void)
+{
+	freeInternTable(&componentTypeRegistry);
+	pthread_rwlock_destroy(&componentTypeRegistryLock);
+}
+
+inline
+bool signatureHasComponentType(
+	ComponentSignature const *signature,
+	ComponentTypeHandle componentType)
+{
+	uint32 index = HANDLE_GET_INDEX(componentType);
+
+	return index < MAX_COMPONENT_TYPES
+		&& (signature->bits[index / 64] >> (index % 64)) & 1;
+}
+
+inline
+void signatureAddComponentType(
+	ComponentSignature *signature,
+	ComponentTypeHandle componentType)
+{
+	uint32 index = HANDLE_GET_INDEX(componentType);
+
+	if (index < MAX_COMPONENT_TYPES)
+	{
+		signature->bits[index / 64] |= 1ULL << (index % 64);
+	}
+}
+
+inline
+void signatureRemoveComponentType(
+	ComponentSignature *signature,
+	ComponentTypeHandle componentType)
+{
+	uint32 index = HANDLE_GET_INDEX(componentType);
+
+	if (index < MAX_COMPONENT_TYPES)
+	{
+		signature->bits[index / 64] &= ~(1ULL << (index % 64));
+	}
+}
+
+bool signatureContains(
+	ComponentSignature const *signature,
+	ComponentSignature const *componentTypes)
+{
+	for (uint32 i = 0; i < MAX_COMPONENT_TYPES / 64; i++)
+	{
+		if ((signature->bits[i] & componentTypes->bits[i])
+			!= componentTypes->bits[i])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+uint32 signatureGetNextIndex(
+	ComponentSignature const *signature,
+	uint32 index)
+{
+	while (index < MAX_COMPONENT_TYPES)
+	{
+		// Ignore the bits below index in its word
+		uint64 bits = signature->bits[index / 64] >> (index % 64);
+
+		if (bits)
+		{
+			return index + __builtin_ctzll(bits);
+		}
+
+		index = (index / 64 + 1) * 64;
+	}
+
+	return MAX_COMPONENT_TYPES;
+}
+
+#define INVALID_DENSE_INDEX 0xFFFFFFFF
+
+internal
+inline
+void *getComponent(ComponentDataTable *table, uint32 index)
+{
+	uint32 chunkMask = (1 << table->chunkShift) - 1;
+
+	return table->chunks[index >> table->chunkShift]
+		+ (uint64)(index & chunkMask) * table->componentSize;
+}
+
 internal
 inline
-ComponentDataEntry *getEntry(ComponentDataTable *table, uint32 index)
+uint32 getCapacity(ComponentDataTable *table)
 {
-	return (ComponentDataEntry *)
-		(table->data
-		 + index
-		 * (table->componentSize + sizeof(ComponentDataEntry)));
+	return table->numChunks << table->chunkShift;
+}
+
+internal
+int32 addChunk(ComponentDataTable *table)
+{
+	uint32 chunkCapacity = 1 << table->chunkShift;
+
+	uint8 *chunk = malloc(
+		(uint64)chunkCapacity * MAX(table->componentSize, 1));
+	uint8 **chunks = realloc(
+		table->chunks,
+		(table->numChunks + 1) * sizeof(uint8*));
+	EntityHandle *entities = realloc(
+		table->entities,
+		(uint64)(table->numChunks + 1) * chunkCapacity * sizeof(EntityHandle));
+
+	if (chunks)
+	{
+		table->chunks = chunks;
+	}
+
+	if (entities)
+	{
+		table->entities = entities;
+	}
+
+	if (!chunk || !chunks || !entities)
+	{
+		free(chunk);
+
+		LOG_ERROR("Failed to grow the %s component data table "
+			"past %d entries\n",
+			table->componentID.string,
+			getCapacity(table));
+
+		return -1;
+	}
+
+	table->chunks[table->numChunks++] = chunk;
+
+	return 0;
+}
+
+internal
+inline
+uint32 getDenseIndex(ComponentDataTable *table, EntityHandle entity)
+{
+	uint32 sparseIndex = HANDLE_GET_INDEX(entity);
+
+	if (sparseIndex >= table->sparseSize)
+	{
+		return INVALID_DENSE_INDEX;
+	}
+
+	uint32 index = table->sparse[sparseIndex];
+
+	// The sparse entry may be stale, so check who owns the dense slot
+	if (index >= table->numComponents || table->entities[index] != entity)
+	{
+		return INVALID_DENSE_INDEX;
+	}
+
+	return index;
+}
+
+internal
+void resizeSparseArray(ComponentDataTable *table, uint32 sparseIndex)
+{
+	uint32 sparseSize = MAX(table->sparseSize, CDT_MIN_SPARSE_SIZE);
+	while (sparseSize <= sparseIndex)
+	{
+		sparseSize <<= 1;
+	}
+
+	table->sparse = realloc(table->sparse, sparseSize * sizeof(uint32));
+
+	ASSERT(table->sparse != 0);
+
+	memset(
+		table->sparse + table->sparseSize,
+		0xFF,
+		(sparseSize - table->sparseSize) * sizeof(uint32));
+
+	table->sparseSize = sparseSize;
 }
 
 ComponentDataTable *createComponentDataTable(
@@ -24,33 +272,33 @@ ComponentDataTable *createComponentDataTable(
 	uint32 numEntries,
 	uint32 componentSize)
 {
-	ComponentDataTable *ret = malloc(
-		sizeof(ComponentDataTable)
-		+ numEntries
-		* (componentSize + sizeof(ComponentDataEntry)));
+	ComponentDataTable *ret = malloc(sizeof(ComponentDataTable));
 
 	ASSERT(ret != 0);
 
 	ret->componentID = componentID;
 	ret->componentSize = componentSize;
-	ret->firstFree = 0;
 	ret->numEntries = numEntries;
-	ret->idToIndex = createHashMap(
-		sizeof(UUID),
-		sizeof(uint32),
-		CDT_ID_BUCKETS,
-		(ComparisonOp)&strcmp);
-
-	ASSERT(ret->idToIndex != 0);
-
-	for (uint32 i = 0; i < numEntries; ++i)
+	ret->numComponents = 0;
+	ret->highWaterMark = 0;
+	ret->numChunks = 0;
+	ret->chunks = NULL;
+	ret->sparseSize = 0;
+	ret->sparse = NULL;
+	ret->entities = NULL;
+	ret->lowestRemovedIndex = INVALID_DENSE_INDEX;
+
+	// Fit as many components in a chunk as the chunk size allows
+	ret->chunkShift = 0;
+	while ((2 << ret->chunkShift) * MAX(componentSize, 1)
+		   <= CDT_CHUNK_SIZE_BYTES)
 	{
-		ComponentDataEntry *entry = getEntry(ret, i);
-
-		entry->nextFree = i + 1;
+		ret->chunkShift++;
 	}
 
-	LOG("Created %s component data table to hold %d entries "
+	resizeSparseArray(ret, 0);
+
+	LOG("Created %s component data table expecting %d entries "
 		"with a size of %d bytes\n",
 		componentID.string,
 		numEntries,
@@ -58,7 +306,7 @@ ComponentDataTable *createComponentDataTable(
 
 	if (componentSize == 0)
 	{
-		LOG("WARNING: Unable to load the definition for the %s component "
+		LOG_WARNING("Unable to load the definition for the %s component "
 		"because no entities in the scene have the %s component\n",
 		componentID.string,
 		componentID.string);
@@ -69,155 +317,206 @@ ComponentDataTable *createComponentDataTable(
 
 void freeComponentDataTable(ComponentDataTable **table)
 {
-	freeHashMap(&(*table)->idToIndex);
+	for (uint32 i = 0; i < (*table)->numChunks; i++)
+	{
+		free((*table)->chunks[i]);
+	}
+
+	free((*table)->chunks);
+	free((*table)->sparse);
+	free((*table)->entities);
 	free(*table);
 	*table = 0;
 }
 
-int32 cdtInsert(ComponentDataTable *table, UUID entityID, void *componentData)
+void cdtLogUsage(ComponentDataTable *table)
 {
-	uint32 i = 0;
+	LOG("%s component data table: %d active, peak of %d, "
+		"%d allocated, limit of %d\n",
+		table->componentID.string,
+		table->numComponents,
+		table->highWaterMark,
+		getCapacity(table),
+		table->numEntries);
+}
+
+int32 cdtInsert(
+	ComponentDataTable *table,
+	EntityHandle entity,
+	void *componentData)
+{
+	uint32 i = getDenseIndex(table, entity);
+
 	// If the entity is not in the table
-	uint32 *indexPtr = hashMapGetData(table->idToIndex, &entityID);
-	if (!indexPtr)
+	if (i == INVALID_DENSE_INDEX)
 	{
-		// Find an empty slot in the component data table
-		if (table->firstFree >= table->numEntries)
+		if (table->numComponents >= getCapacity(table)
+			&& addChunk(table) == -1)
 		{
 			return -1;
 		}
-		else
+
+		uint32 sparseIndex = HANDLE_GET_INDEX(entity);
+		if (sparseIndex >= table->sparseSize)
 		{
-			i = table->firstFree;
+			resizeSparseArray(table, sparseIndex);
 		}
 
-		ASSERT(i >= 0);
-		ASSERT(i < table->numEntries);
+		// Append the entity to the end of the packed entries
+		i = table->numComponents++;
 
-		// Associate the UUID with the index in the map
-		hashMapInsert(table->idToIndex, &entityID, &i);
-	}
-	// If the entity already exists in the table
-	else
-	{
-		// Set i to the index
-		i = *indexPtr;
+		table->sparse[sparseIndex] = i;
+		table->entities[i] = entity;
 
-		ASSERT(i >= 0);
-		ASSERT(i < table->numEntries);
+		table->highWaterMark = MAX(table->highWaterMark, table->numComponents);
 	}
 
-	ComponentDataEntry *entry = getEntry(table, i);
-
-	table->firstFree = entry->nextFree;
+	ASSERT(i < getCapacity(table));
 
-	// Put the UUID into the table
-	memcpy(entry->entity.string, &entityID, sizeof(UUID));
 	// Put the component data into the table
-	memcpy(entry->data, componentData, table->componentSize);
-
-	entry->nextFree = table->numEntries + 1;
+	memcpy(getComponent(table, i), componentData, table->componentSize);
 
 	return 0;
 }
 
 void cdtRemove(
 	ComponentDataTable *table,
-	UUID entityID)
+	EntityHandle entity)
 {
+	uint32 i = getDenseIndex(table, entity);
+
 	// If the entity exists in the table
-	uint32 *pIndex =
-		hashMapGetData(
-			table->idToIndex,
-			&entityID);
-	if (pIndex)
+	if (i != INVALID_DENSE_INDEX)
 	{
-		ComponentDataEntry *entry = getEntry(table, *pIndex);
+		uint32 last = --table->numComponents;
 
-		memset(
-			entry->entity.string,
-			0,
-			sizeof(UUID));
+		// Move the last component into the hole to keep the table packed
+		if (i != last)
+		{
+			EntityHandle lastEntity = table->entities[last];
+
+			memcpy(
+				getComponent(table, i),
+				getComponent(table, last),
+				table->componentSize);
+			table->entities[i] = lastEntity;
+			table->sparse[HANDLE_GET_INDEX(lastEntity)] = i;
+		}
 
-		entry->nextFree = table->firstFree;
-		table->firstFree = *pIndex;
+		table->sparse[HANDLE_GET_INDEX(entity)] = INVALID_DENSE_INDEX;
 
-		hashMapDelete(table->idToIndex, &entityID);
+#ifdef _DEBUG
+		table->lowestRemovedIndex = MIN(table->lowestRemovedIndex, i);
+#endif
 	}
 }
 
-void *cdtGet(ComponentDataTable *table, UUID entityID)
+void *cdtGet(ComponentDataTable *table, EntityHandle entity)
 {
-	uint32 *index = hashMapGetData(table->idToIndex, &entityID);
+	uint32 index = getDenseIndex(table, entity);
 
-	if (index)
+	if (index != INVALID_DENSE_INDEX)
 	{
-		return getEntry(table, *index)->data;
+		return getComponent(table, index);
 	}
 
 	return 0;
 }
 
 inline
-UUID cdtGetIndexUUID(ComponentDataTable *table, uint32 index)
+EntityHandle cdtGetIndexEntity(ComponentDataTable *table, uint32 index)
 {
-	return getEntry(table, index)->entity;
+	return table->entities[index];
 }
 
 inline
 void *cdtGetIndexData(ComponentDataTable *table, uint32 index)
 {
-	return getEntry(table, index)->data;
+	return getComponent(table, index);
 }
 
-inline
-uint32 cdtGetIndexNF(ComponentDataTable *table, uint32 index)
+void *cdtGetChunkData(
+	ComponentDataTable *table,
+	uint32 chunk,
+	uint32 *numComponents)
 {
-	return getEntry(table, index)->nextFree;
+	uint32 first = chunk << table->chunkShift;
+
+	if (chunk >= table->numChunks || first >= table->numComponents)
+	{
+		*numComponents = 0;
+		return NULL;
+	}
+
+	*numComponents = MIN(
+		table->numComponents - first,
+		1 << table->chunkShift);
+
+	return table->chunks[chunk];
 }
 
+// Iterates from the back of the table, since removing a component moves the
+// last component into its place. Removing the current entity, or one which
+// has already been visited, only moves visited components. Removing one
+// which hasn't been visited yet moves the last, already visited, component
+// in front of the iterator so that it is visited twice. Those removals have
+// to go through the scene's command buffer, debug builds assert on them.
 ComponentDataTableIterator cdtGetIterator(ComponentDataTable *table)
 {
 	ComponentDataTableIterator itr = {};
 
-	itr.index = 0;
-	itr.table = table;
-
-	if (getEntry(table, 0)->nextFree < table->numEntries + 1)
+#ifdef _DEBUG
+	// Only removals made while iterating matter, and parallel iterators
+	// over the same table don't write to it unless something was removed
+	if (table->lowestRemovedIndex != INVALID_DENSE_INDEX)
 	{
-		cdtMoveIterator(&itr);
+		table->lowestRemovedIndex = INVALID_DENSE_INDEX;
 	}
+#endif
+
+	// An empty table wraps around to INVALID_DENSE_INDEX
+	itr.index = table->numComponents - 1;
+	itr.table = table;
 
 	return itr;
 }
 
 void cdtMoveIterator(ComponentDataTableIterator *itr)
 {
-	++itr->index;
-	for (; itr->index < itr->table->numEntries; ++itr->index)
+	// Return if the iterator is already at the end
+	if (itr->index == INVALID_DENSE_INDEX)
 	{
-		if (getEntry(itr->table, itr->index)->nextFree
-			== itr->table->numEntries + 1)
-		{
-			break;
-		}
+		return;
 	}
+
+#ifdef _DEBUG
+	if (itr->table->lowestRemovedIndex != INVALID_DENSE_INDEX)
+	{
+		// An entity which hasn't been visited yet was removed
+		ASSERT(itr->table->lowestRemovedIndex >= itr->index);
+		itr->table->lowestRemovedIndex = INVALID_DENSE_INDEX;
+	}
+#endif
+
+	// Entities may have been removed since the iterator last moved, moving
+	// past index 0 wraps around to INVALID_DENSE_INDEX
+	itr->index = MIN(itr->index, itr->table->numComponents) - 1;
 }
 
 inline
 uint32 cdtIteratorAtEnd(ComponentDataTableIterator itr)
 {
-	return itr.index >= itr.table->numEntries;
+	return itr.index == INVALID_DENSE_INDEX;
 }
 
 inline
-UUID cdtIteratorGetUUID(ComponentDataTableIterator itr)
+EntityHandle cdtIteratorGetEntity(ComponentDataTableIterator itr)
 {
-	return getEntry(itr.table, itr.index)->entity;
+	return itr.table->entities[itr.index];
 }
 
 inline
 void *cdtIteratorGetData(ComponentDataTableIterator itr)
 {
-	return getEntry(itr.table, itr.index)->data;
+	return getComponent(itr.table, itr.index);
 }
@@ -0,0 +1,1232 @@
+#include "ECS/entity_loader.h"
+#include "ECS/component.h"
+#include "ECS/scene.h"
+
+#include "core/log.h"
+
+#include "data/data_types.h"
+#include "data/hash_map.h"
+#include "data/intern_table.h"
+
+#include "file/utilities.h"
+
+#include "json/utilities.h"
+
+#include "threading/thread_pool.h"
+
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#define ENTITY_LOADER_MIN_CAPACITY 64
+#define ENTITY_LOADER_MIN_FILE_BUFFER_SIZE 4096
+// Components are copied out of the file buffer, so their data is aligned
+// for sceneAddComponentToEntity to write to
+#define ENTITY_LOADER_DATA_ALIGNMENT 16
+
+#define BENCHMARK_ENTITIES_PER_FOLDER 1000
+
+extern bool reloadingScene;
+
+// Every read is checked against the size of the entity file, the first one
+// which doesn't fit sets error
+typedef struct entity_file_reader_t
+{
+	const uint8 *data;
+	uint64 size;
+	uint64 offset;
+	bool error;
+} EntityFileReader;
+
+typedef struct benchmark_component_t
+{
+	const char *name;
+	uint32 numValues;
+	// Every period-th entity has the component
+	uint32 period;
+} BenchmarkComponent;
+
+#define NUM_BENCHMARK_COMPONENTS 3
+internal const BenchmarkComponent benchmarkComponents[
+	NUM_BENCHMARK_COMPONENTS] = {
+	{ "benchmark_transform", 16, 1 },
+	{ "benchmark_body", 8, 2 },
+	{ "benchmark_mesh", 32, 4 }
+};
+
+internal int32 findEntityFiles(
+	const char *folder,
+	LoadedSceneEntities *entities,
+	uint32 *capacity);
+internal mode_t getEntryMode(const struct dirent *dirEntry, const char *path);
+internal void addEntityFile(
+	LoadedSceneEntities *entities,
+	uint32 *capacity,
+	char *filename);
+internal int32 compareEntityFilenames(const void *a, const void *b);
+
+internal void parseEntityBatches(uint32 first, uint32 count, void *data);
+internal int32 readEntityFile(
+	const char *filename,
+	LoadedEntityBatch *batch,
+	uint64 *size);
+internal int32 parseEntityFile(
+	const char *filename,
+	LoadedEntityBatch *batch,
+	uint32 entity);
+internal uint32 getBatchComponentDefinition(
+	LoadedEntityBatch *batch,
+	const char *name);
+internal void addBatchComponent(
+	LoadedEntityBatch *batch,
+	uint32 entity,
+	uint32 componentDefinition,
+	const uint8 *data,
+	uint32 size);
+
+internal const uint8* readEntityFileData(
+	EntityFileReader *reader,
+	uint64 size);
+internal void readEntityFileBytes(
+	EntityFileReader *reader,
+	void *data,
+	uint64 size);
+internal const char* readEntityFileString(EntityFileReader *reader);
+internal char* copyEntityFileString(const char *string);
+
+internal void copyComponentDefinition(
+	const ComponentDefinition *componentDefinition,
+	ComponentDefinition *copy);
+internal void freeBatchComponentDefinition(
+	ComponentDefinition *componentDefinition);
+
+internal int32 writeBenchmarkEntities(const char *folder, uint32 numEntities);
+internal int32 writeBenchmarkEntity(const char *filename, uint32 entity);
+internal real64 benchmarkTwoPassEntityLoading(
+	const char *folder,
+	uint32 numEntities);
+internal int32 loadTwoPassBenchmarkEntities(
+	Scene *scene,
+	bool loadData,
+	const char *folder);
+internal real64 getBenchmarkTime(void);
+
+int32 readSceneEntities(
+	const char *folder,
+	ThreadPool *pool,
+	LoadedSceneEntities *entities)
+{
+	memset(entities, 0, sizeof(LoadedSceneEntities));
+
+	uint32 capacity = 0;
+	if (findEntityFiles(folder, entities, &capacity) == -1)
+	{
+		freeLoadedSceneEntities(entities);
+		return -1;
+	}
+
+	// A JSON entity and the entity file it was exported to are both found
+	if (entities->numFiles > 0)
+	{
+		qsort(
+			entities->filenames,
+			entities->numFiles,
+			sizeof(char*),
+			&compareEntityFilenames);
+
+		uint32 numFiles = 1;
+		for (uint32 i = 1; i < entities->numFiles; i++)
+		{
+			if (!strcmp(
+				entities->filenames[i],
+				entities->filenames[numFiles - 1]))
+			{
+				free(entities->filenames[i]);
+			}
+			else
+			{
+				entities->filenames[numFiles++] = entities->filenames[i];
+			}
+		}
+
+		entities->numFiles = numFiles;
+	}
+
+	entities->numBatches =
+		(entities->numFiles + ENTITY_LOADER_BATCH_SIZE - 1) /
+		ENTITY_LOADER_BATCH_SIZE;
+	entities->batches = calloc(
+		MAX(entities->numBatches, 1),
+		sizeof(LoadedEntityBatch));
+
+	for (uint32 i = 0; i < entities->numBatches; i++)
+	{
+		LoadedEntityBatch *batch = &entities->batches[i];
+		batch->firstFile = i * ENTITY_LOADER_BATCH_SIZE;
+		batch->numFiles = MIN(
+			ENTITY_LOADER_BATCH_SIZE,
+			entities->numFiles - batch->firstFile);
+	}
+
+	if (pool)
+	{
+		threadPoolParallelFor(
+			pool,
+			entities->numBatches,
+			1,
+			&parseEntityBatches,
+			entities);
+	}
+	else
+	{
+		parseEntityBatches(0, entities->numBatches, entities);
+	}
+
+	for (uint32 i = 0; i < entities->numBatches; i++)
+	{
+		if (entities->batches[i].error == -1)
+		{
+			freeLoadedSceneEntities(entities);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+int32 findEntityFiles(
+	const char *folder,
+	LoadedSceneEntities *entities,
+	uint32 *capacity)
+{
+	DIR *dir = opendir(folder);
+	if (!dir)
+	{
+		LOG("Failed to open %s\n", folder);
+		return -1;
+	}
+
+	int32 error = 0;
+
+	struct dirent *dirEntry = readdir(dir);
+	while (dirEntry && error != -1)
+	{
+		if (strcmp(dirEntry->d_name, ".") && strcmp(dirEntry->d_name, ".."))
+		{
+			char *path = getFullFilePath(dirEntry->d_name, NULL, folder);
+			mode_t mode = getEntryMode(dirEntry, path);
+
+			if (S_ISDIR(mode))
+			{
+				error = findEntityFiles(path, entities, capacity);
+			}
+			else if (S_ISREG(mode))
+			{
+				char *extension = getExtension(dirEntry->d_name);
+
+				if (extension && !strcmp(extension, "json"))
+				{
+					char *entityFilename = removeExtension(path);
+
+					if (exportEntity(entityFilename, &logFunction) == -1)
+					{
+						LOG("Failed to export entity\n");
+						error = -1;
+					}
+					else
+					{
+						addEntityFile(
+							entities,
+							capacity,
+							getFullFilePath(entityFilename, "entity", NULL));
+					}
+
+					free(entityFilename);
+				}
+				else if (extension && !strcmp(extension, "entity"))
+				{
+					addEntityFile(entities, capacity, path);
+					path = NULL;
+				}
+
+				free(extension);
+			}
+
+			free(path);
+		}
+
+		dirEntry = readdir(dir);
+	}
+
+	closedir(dir);
+
+	return error;
+}
+
+mode_t getEntryMode(const struct dirent *dirEntry, const char *path)
+{
+#ifdef _DIRENT_HAVE_D_TYPE
+	// Most file systems already say what the entry is, which saves a stat
+	// for every file
+	if (dirEntry->d_type == DT_DIR)
+	{
+		return S_IFDIR;
+	}
+	else if (dirEntry->d_type == DT_REG)
+	{
+		return S_IFREG;
+	}
+#endif
+
+	struct stat info;
+	if (stat(path, &info) == -1)
+	{
+		return 0;
+	}
+
+	return info.st_mode;
+}
+
+void addEntityFile(
+	LoadedSceneEntities *entities,
+	uint32 *capacity,
+	char *filename)
+{
+	if (entities->numFiles == *capacity)
+	{
+		*capacity = MAX(*capacity << 1, ENTITY_LOADER_MIN_CAPACITY);
+		entities->filenames = realloc(
+			entities->filenames,
+			*capacity * sizeof(char*));
+
+		ASSERT(entities->filenames != 0);
+	}
+
+	entities->filenames[entities->numFiles++] = filename;
+}
+
+int32 compareEntityFilenames(const void *a, const void *b)
+{
+	return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+void parseEntityBatches(uint32 first, uint32 count, void *data)
+{
+	LoadedSceneEntities *entities = data;
+
+	for (uint32 i = first; i < first + count; i++)
+	{
+		LoadedEntityBatch *batch = &entities->batches[i];
+		batch->entities = malloc(batch->numFiles * sizeof(UUID));
+
+		for (uint32 j = 0; j < batch->numFiles && batch->error != -1; j++)
+		{
+			batch->error = parseEntityFile(
+				entities->filenames[batch->firstFile + j],
+				batch,
+				j);
+		}
+
+		// Nothing refers to the files once they've been parsed
+		free(batch->fileBuffer);
+		batch->fileBuffer = NULL;
+		batch->fileBufferCapacity = 0;
+	}
+}
+
+int32 parseEntityFile(
+	const char *filename,
+	LoadedEntityBatch *batch,
+	uint32 entity)
+{
+	uint64 size = 0;
+	if (readEntityFile(filename, batch, &size) == -1)
+	{
+		return -1;
+	}
+
+	EntityFileReader reader = {};
+	reader.data = batch->fileBuffer;
+	reader.size = size;
+
+	int32 error = 0;
+
+	uint8 entityBinaryFileVersion = 0;
+	readEntityFileBytes(&reader, &entityBinaryFileVersion, sizeof(uint8));
+
+	if (!reader.error &&
+		entityBinaryFileVersion < ENTITY_BINARY_FILE_VERSION)
+	{
+		LOG_WARNING("%s out of date\n", filename);
+		return -1;
+	}
+
+	readEntityFileBytes(&reader, &batch->entities[entity], sizeof(UUID));
+
+	uint32 numComponents = 0;
+	readEntityFileBytes(&reader, &numComponents, sizeof(uint32));
+
+	for (uint32 i = 0; i < numComponents && !reader.error && error != -1; i++)
+	{
+		const char *name = readEntityFileString(&reader);
+		if (!name)
+		{
+			break;
+		}
+
+		// Only the first file with a component in the batch copies its
+		// definition, the other files are just checked against it
+		uint32 componentDefinitionIndex = getBatchComponentDefinition(
+			batch,
+			name);
+		ComponentDefinition *componentDefinition = NULL;
+
+		if (componentDefinitionIndex == batch->numComponentDefinitions)
+		{
+			batch->componentDefinitions = realloc(
+				batch->componentDefinitions,
+				(batch->numComponentDefinitions + 1) *
+					sizeof(ComponentDefinition));
+
+			ASSERT(batch->componentDefinitions != 0);
+
+			componentDefinition = &batch->componentDefinitions[
+				batch->numComponentDefinitions++];
+			memset(componentDefinition, 0, sizeof(ComponentDefinition));
+
+			componentDefinition->name = copyEntityFileString(name);
+		}
+
+		uint32 numValues = 0;
+		readEntityFileBytes(&reader, &numValues, sizeof(uint32));
+
+		// Every value takes up more than a byte
+		if (numValues > reader.size - reader.offset)
+		{
+			reader.error = true;
+			break;
+		}
+
+		if (componentDefinition)
+		{
+			componentDefinition->numValues = numValues;
+			componentDefinition->values = calloc(
+				MAX(numValues, 1),
+				sizeof(ComponentValueDefinition));
+		}
+
+		for (uint32 j = 0; j < numValues && !reader.error; j++)
+		{
+			const char *valueName = readEntityFileString(&reader);
+
+			int8 dataType = 0;
+			readEntityFileBytes(&reader, &dataType, sizeof(int8));
+
+			uint32 maxStringSize = 0;
+			if ((DataType)dataType == DATA_TYPE_STRING)
+			{
+				readEntityFileBytes(&reader, &maxStringSize, sizeof(uint32));
+			}
+
+			uint32 count = 0;
+			readEntityFileBytes(&reader, &count, sizeof(uint32));
+
+			if (componentDefinition && !reader.error)
+			{
+				ComponentValueDefinition *componentValueDefinition =
+					&componentDefinition->values[j];
+
+				componentValueDefinition->name =
+					copyEntityFileString(valueName);
+				componentValueDefinition->type = (DataType)dataType;
+				componentValueDefinition->maxStringSize = maxStringSize;
+				componentValueDefinition->count = count;
+			}
+		}
+
+		uint32 size = 0;
+		readEntityFileBytes(&reader, &size, sizeof(uint32));
+
+		const uint8 *data = readEntityFileData(&reader, size);
+		if (!data)
+		{
+			break;
+		}
+
+		if (componentDefinition)
+		{
+			componentDefinition->size = size;
+		}
+		else if (batch->componentDefinitions[componentDefinitionIndex].size
+			!= size)
+		{
+			LOG_WARNING("The %s component in %s is %u bytes instead of %u\n",
+				name,
+				filename,
+				size,
+				batch->componentDefinitions[componentDefinitionIndex].size);
+			error = -1;
+			break;
+		}
+
+		addBatchComponent(batch, entity, componentDefinitionIndex, data, size);
+	}
+
+	if (reader.error)
+	{
+		LOG_WARNING("%s is truncated\n", filename);
+		error = -1;
+	}
+
+	return error;
+}
+
+int32 readEntityFile(
+	const char *filename,
+	LoadedEntityBatch *batch,
+	uint64 *size)
+{
+	FILE *file = fopen(filename, "rb");
+	if (!file)
+	{
+		LOG("Failed to open %s\n", filename);
+		return -1;
+	}
+
+	// Entity files are small, so they are read whole straight into the
+	// batch's buffer instead of through one of stdio's
+	setvbuf(file, NULL, _IONBF, 0);
+
+	*size = 0;
+
+	while (true)
+	{
+		if (*size == batch->fileBufferCapacity)
+		{
+			batch->fileBufferCapacity = MAX(
+				batch->fileBufferCapacity << 1,
+				ENTITY_LOADER_MIN_FILE_BUFFER_SIZE);
+			batch->fileBuffer = realloc(
+				batch->fileBuffer,
+				batch->fileBufferCapacity);
+
+			ASSERT(batch->fileBuffer != 0);
+		}
+
+		*size += fread(
+			batch->fileBuffer + *size,
+			1,
+			batch->fileBufferCapacity - *size,
+			file);
+
+		// Reads only come up short at the end of the file
+		if (*size < batch->fileBufferCapacity)
+		{
+			break;
+		}
+	}
+
+	bool error = ferror(file);
+	fclose(file);
+
+	if (error)
+	{
+		LOG("Failed to read %s\n", filename);
+		return -1;
+	}
+
+	return 0;
+}
+
+uint32 getBatchComponentDefinition(
+	LoadedEntityBatch *batch,
+	const char *name)
+{
+	for (uint32 i = 0; i < batch->numComponentDefinitions; i++)
+	{
+		if (!strcmp(batch->componentDefinitions[i].name, name))
+		{
+			return i;
+		}
+	}
+
+	return batch->numComponentDefinitions;
+}
+
+void addBatchComponent(
+	LoadedEntityBatch *batch,
+	uint32 entity,
+	uint32 componentDefinition,
+	const uint8 *data,
+	uint32 size)
+{
+	if (batch->numComponents == batch->componentCapacity)
+	{
+		batch->componentCapacity = MAX(
+			batch->componentCapacity << 1,
+			ENTITY_LOADER_MIN_CAPACITY);
+		batch->components = realloc(
+			batch->components,
+			batch->componentCapacity * sizeof(LoadedEntityComponent));
+
+		ASSERT(batch->components != 0);
+	}
+
+	LoadedEntityComponent *component =
+		&batch->components[batch->numComponents++];
+	component->entity = entity;
+	component->componentDefinition = componentDefinition;
+	component->dataOffset = batch->dataSize;
+
+	uint64 dataSize = batch->dataSize
+		+ ((uint64)size + ENTITY_LOADER_DATA_ALIGNMENT - 1)
+		/ ENTITY_LOADER_DATA_ALIGNMENT * ENTITY_LOADER_DATA_ALIGNMENT;
+
+	if (dataSize > batch->dataCapacity)
+	{
+		batch->dataCapacity = MAX(
+			batch->dataCapacity,
+			ENTITY_LOADER_MIN_CAPACITY * ENTITY_LOADER_DATA_ALIGNMENT);
+
+		while (dataSize > batch->dataCapacity)
+		{
+			batch->dataCapacity <<= 1;
+		}
+
+		batch->data = realloc(batch->data, batch->dataCapacity);
+
+		ASSERT(batch->data != 0);
+	}
+
+	memcpy(batch->data + batch->dataSize, data, size);
+	batch->dataSize = dataSize;
+}
+
+const uint8* readEntityFileData(EntityFileReader *reader, uint64 size)
+{
+	if (reader->error || size > reader->size - reader->offset)
+	{
+		reader->error = true;
+		return NULL;
+	}
+
+	const uint8 *data = reader->data + reader->offset;
+	reader->offset += size;
+
+	return data;
+}
+
+void readEntityFileBytes(EntityFileReader *reader, void *data, uint64 size)
+{
+	const uint8 *fileData = readEntityFileData(reader, size);
+	if (fileData)
+	{
+		memcpy(data, fileData, size);
+	}
+}
+
+const char* readEntityFileString(EntityFileReader *reader)
+{
+	uint32 length = 0;
+	readEntityFileBytes(reader, &length, sizeof(uint32));
+
+	// The length includes the terminator
+	const char *string = (const char*)readEntityFileData(reader, length);
+	if (string && (length == 0 || string[length - 1] != '\0'))
+	{
+		reader->error = true;
+		return NULL;
+	}
+
+	return string;
+}
+
+char* copyEntityFileString(const char *string)
+{
+	char *copy = malloc(strlen(string) + 1);
+	strcpy(copy, string);
+	return copy;
+}
+
+void freeLoadedSceneEntities(LoadedSceneEntities *entities)
+{
+	for (uint32 i = 0; i < entities->numFiles; i++)
+	{
+		free(entities->filenames[i]);
+	}
+
+	free(entities->filenames);
+
+	for (uint32 i = 0; i < entities->numBatches; i++)
+	{
+		LoadedEntityBatch *batch = &entities->batches[i];
+
+		for (uint32 j = 0; j < batch->numComponentDefinitions; j++)
+		{
+			freeBatchComponentDefinition(&batch->componentDefinitions[j]);
+		}
+
+		free(batch->componentDefinitions);
+		free(batch->entities);
+		free(batch->components);
+		free(batch->data);
+	}
+
+	free(entities->batches);
+
+	memset(entities, 0, sizeof(LoadedSceneEntities));
+}
+
+void loadSceneEntityDefinitions(
+	Scene *scene,
+	const LoadedSceneEntities *entities)
+{
+	scene->componentDefinitions = createHashMap(
+		sizeof(UUID),
+		sizeof(ComponentDefinition),
+		COMPONENT_DEFINITION_BUCKETS,
+		(ComparisonOp)&strcmp);
+
+	// Batches are in the order of their files, so the first file with a
+	// component still decides its definition
+	for (uint32 i = 0; i < entities->numBatches; i++)
+	{
+		const LoadedEntityBatch *batch = &entities->batches[i];
+
+		for (uint32 j = 0; j < batch->numComponentDefinitions; j++)
+		{
+			const ComponentDefinition *batchComponentDefinition =
+				&batch->componentDefinitions[j];
+
+			UUID componentID = idFromName(batchComponentDefinition->name);
+			if (hashMapGetData(scene->componentDefinitions, &componentID))
+			{
+				continue;
+			}
+
+			ComponentDefinition componentDefinition = {};
+			copyComponentDefinition(
+				batchComponentDefinition,
+				&componentDefinition);
+
+			hashMapInsert(
+				scene->componentDefinitions,
+				&componentID,
+				&componentDefinition);
+		}
+	}
+}
+
+void loadSceneEntities(Scene *scene, const LoadedSceneEntities *entities)
+{
+	for (uint32 i = 0; i < entities->numBatches; i++)
+	{
+		const LoadedEntityBatch *batch = &entities->batches[i];
+
+		EntityHandle *entityHandles = malloc(
+			MAX(batch->numFiles, 1) * sizeof(EntityHandle));
+
+		for (uint32 j = 0; j < batch->numFiles; j++)
+		{
+			entityHandles[j] = sceneRegisterEntity(scene, batch->entities[j]);
+		}
+
+		// Component types are only looked up once per batch
+		ComponentTypeHandle *componentTypes = malloc(
+			MAX(batch->numComponentDefinitions, 1) *
+				sizeof(ComponentTypeHandle));
+
+		for (uint32 j = 0; j < batch->numComponentDefinitions; j++)
+		{
+			const ComponentDefinition *componentDefinition =
+				&batch->componentDefinitions[j];
+
+			componentTypes[j] = componentTypeFromName(
+				componentDefinition->name);
+
+			ComponentDataTable *dataTable = sceneGetComponentDataTable(
+				scene,
+				componentTypes[j]);
+
+			if (dataTable &&
+				dataTable->componentSize != componentDefinition->size)
+			{
+				LOG_WARNING("The %s component is %u bytes in some entity "
+					"files of scene %s instead of %u\n",
+					componentDefinition->name,
+					componentDefinition->size,
+					scene->name,
+					dataTable->componentSize);
+				componentTypes[j] = INVALID_HANDLE;
+			}
+		}
+
+		for (uint32 j = 0; j < batch->numComponents; j++)
+		{
+			const LoadedEntityComponent *component = &batch->components[j];
+
+			if (componentTypes[component->componentDefinition] ==
+				INVALID_HANDLE)
+			{
+				continue;
+			}
+
+			sceneAddComponentToEntity(
+				scene,
+				entityHandles[component->entity],
+				componentTypes[component->componentDefinition],
+				batch->data + component->dataOffset);
+		}
+
+		free(componentTypes);
+		free(entityHandles);
+	}
+}
+
+void copyComponentDefinition(
+	const ComponentDefinition *componentDefinition,
+	ComponentDefinition *copy)
+{
+	copy->name = copyEntityFileString(componentDefinition->name);
+	copy->size = componentDefinition->size;
+	copy->numValues = componentDefinition->numValues;
+	copy->values = calloc(
+		MAX(copy->numValues, 1),
+		sizeof(ComponentValueDefinition));
+
+	for (uint32 i = 0; i < copy->numValues; i++)
+	{
+		copy->values[i] = componentDefinition->values[i];
+		copy->values[i].name = copyEntityFileString(
+			componentDefinition->values[i].name);
+	}
+}
+
+void freeBatchComponentDefinition(ComponentDefinition *componentDefinition)
+{
+	free(componentDefinition->name);
+
+	for (uint32 i = 0; i < componentDefinition->numValues; i++)
+	{
+		free(componentDefinition->values[i].name);
+	}
+
+	free(componentDefinition->values);
+}
+
+int32 benchmarkEntityLoading(
+	const char *folder,
+	uint32 numEntities,
+	ThreadPool *pool)
+{
+	LOG("Writing %u entities to %s...\n", numEntities, folder);
+
+	deleteFolder(folder, false, &logFunction);
+
+	int32 error = writeBenchmarkEntities(folder, numEntities);
+
+	LoadedSceneEntities entities = {};
+	real64 twoPassLoadTime = 0.0;
+	real64 singleThreadReadTime = 0.0;
+
+	if (error != -1)
+	{
+		twoPassLoadTime = benchmarkTwoPassEntityLoading(folder, numEntities);
+		if (twoPassLoadTime < 0.0)
+		{
+			error = -1;
+		}
+	}
+
+	if (error != -1)
+	{
+		ThreadPool *mainThread = createThreadPool(0);
+
+		real64 startTime = getBenchmarkTime();
+		error = readSceneEntities(folder, mainThread, &entities);
+		singleThreadReadTime = getBenchmarkTime() - startTime;
+
+		LOG("Read %u entity files in %.2f ms on 1 thread\n",
+			entities.numFiles,
+			singleThreadReadTime * 1000.0);
+
+		freeLoadedSceneEntities(&entities);
+		freeThreadPool(&mainThread);
+	}
+
+	if (error != -1)
+	{
+		real64 startTime = getBenchmarkTime();
+		error = readSceneEntities(folder, pool, &entities);
+		real64 readTime = getBenchmarkTime() - startTime;
+
+		LOG("Read %u entity files in %.2f ms on %u threads (%.1fx)\n",
+			entities.numFiles,
+			readTime * 1000.0,
+			pool->numThreads + 1,
+			singleThreadReadTime / readTime);
+
+		if (error != -1)
+		{
+			Scene *scene = createScene();
+
+			scene->name = malloc(strlen("entity_benchmark") + 1);
+			strcpy(scene->name, "entity_benchmark");
+
+			startTime = getBenchmarkTime();
+
+			loadSceneEntityDefinitions(scene, &entities);
+
+			for (uint32 i = 0; i < NUM_BENCHMARK_COMPONENTS; i++)
+			{
+				sceneAddComponentType(
+					scene,
+					componentTypeFromName(benchmarkComponents[i].name),
+					benchmarkComponents[i].numValues * sizeof(real32),
+					numEntities / benchmarkComponents[i].period + 1);
+			}
+
+			loadSceneEntities(scene, &entities);
+
+			real64 addTime = getBenchmarkTime() - startTime;
+
+			LOG("Added %u entities to a scene in %.2f ms\n",
+				scene->entities->count,
+				addTime * 1000.0);
+			LOG("Loaded %u entities in %.2f ms (%.0f entities per second)\n",
+				scene->entities->count,
+				(readTime + addTime) * 1000.0,
+				scene->entities->count / (readTime + addTime));
+			LOG("Loaded %.1fx faster than the two-pass loader\n",
+				twoPassLoadTime / (readTime + addTime));
+
+			reloadingScene = true;
+			freeScene(&scene);
+			reloadingScene = false;
+		}
+
+		freeLoadedSceneEntities(&entities);
+	}
+
+	deleteFolder(folder, false, &logFunction);
+
+	return error;
+}
+
+int32 writeBenchmarkEntities(const char *folder, uint32 numEntities)
+{
+	MKDIR(folder);
+
+	// Entities are spread over several folders like the entities of a real
+	// scene
+	char *entityFolder = NULL;
+
+	for (uint32 i = 0; i < numEntities; i++)
+	{
+		if (i % BENCHMARK_ENTITIES_PER_FOLDER == 0)
+		{
+			free(entityFolder);
+
+			char folderName[32];
+			sprintf(folderName, "group_%u", i / BENCHMARK_ENTITIES_PER_FOLDER);
+
+			entityFolder = getFullFilePath(folderName, NULL, folder);
+			MKDIR(entityFolder);
+		}
+
+		char entityName[32];
+		sprintf(entityName, "entity_%u", i);
+
+		char *entityFilename = getFullFilePath(
+			entityName,
+			"entity",
+			entityFolder);
+		int32 error = writeBenchmarkEntity(entityFilename, i);
+		free(entityFilename);
+
+		if (error == -1)
+		{
+			free(entityFolder);
+			return -1;
+		}
+	}
+
+	free(entityFolder);
+
+	return 0;
+}
+
+int32 writeBenchmarkEntity(const char *filename, uint32 entity)
+{
+	FILE *file = fopen(filename, "wb");
+	if (!file)
+	{
+		LOG("Failed to open %s\n", filename);
+		return -1;
+	}
+
+	uint8 entityBinaryFileVersion = ENTITY_BINARY_FILE_VERSION;
+	fwrite(&entityBinaryFileVersion, sizeof(uint8), 1, file);
+
+	UUID uuid = {};
+	sprintf(uuid.string, "benchmark_entity_%u", entity);
+	writeUUID(uuid, file);
+
+	uint32 numComponents = 0;
+	for (uint32 i = 0; i < NUM_BENCHMARK_COMPONENTS; i++)
+	{
+		if (entity % benchmarkComponents[i].period == 0)
+		{
+			numComponents++;
+		}
+	}
+
+	fwrite(&numComponents, sizeof(uint32), 1, file);
+
+	real32 values[64];
+	for (uint32 i = 0; i < NUM_BENCHMARK_COMPONENTS; i++)
+	{
+		const BenchmarkComponent *component = &benchmarkComponents[i];
+
+		if (entity % component->period != 0)
+		{
+			continue;
+		}
+
+		writeString(component->name, file);
+
+		uint32 numValues = 1;
+		fwrite(&numValues, sizeof(uint32), 1, file);
+
+		writeString("values", file);
+
+		int8 dataType = DATA_TYPE_FLOAT32;
+		fwrite(&dataType, sizeof(int8), 1, file);
+		fwrite(&component->numValues, sizeof(uint32), 1, file);
+
+		for (uint32 j = 0; j < component->numValues; j++)
+		{
+			values[j] = (real32)(entity + j);
+		}
+
+		uint32 size = component->numValues * sizeof(real32);
+		fwrite(&size, sizeof(uint32), 1, file);
+		fwrite(values, size, 1, file);
+	}
+
+	fclose(file);
+
+	return 0;
+}
+
+real64 benchmarkTwoPassEntityLoading(const char *folder, uint32 numEntities)
+{
+	Scene *scene = createScene();
+
+	scene->name = malloc(strlen("entity_benchmark_two_pass") + 1);
+	strcpy(scene->name, "entity_benchmark_two_pass");
+
+	real64 startTime = getBenchmarkTime();
+
+	scene->componentDefinitions = createHashMap(
+		sizeof(UUID),
+		sizeof(ComponentDefinition),
+		COMPONENT_DEFINITION_BUCKETS,
+		(ComparisonOp)&strcmp);
+
+	int32 error = loadTwoPassBenchmarkEntities(scene, false, folder);
+
+	if (error != -1)
+	{
+		for (uint32 i = 0; i < NUM_BENCHMARK_COMPONENTS; i++)
+		{
+			sceneAddComponentType(
+				scene,
+				componentTypeFromName(benchmarkComponents[i].name),
+				benchmarkComponents[i].numValues * sizeof(real32),
+				numEntities / benchmarkComponents[i].period + 1);
+		}
+
+		error = loadTwoPassBenchmarkEntities(scene, true, folder);
+	}
+
+	real64 loadTime = getBenchmarkTime() - startTime;
+
+	if (error != -1)
+	{
+		LOG("Loaded %u entities with the two-pass loader in %.2f ms\n",
+			scene->entities->count,
+			loadTime * 1000.0);
+	}
+	else
+	{
+		LOG("Failed to load the entities with the two-pass loader\n");
+	}
+
+	reloadingScene = true;
+	freeScene(&scene);
+	reloadingScene = false;
+
+	return error != -1 ? loadTime : -1.0;
+}
+
+// The loader which readSceneEntities replaced, kept as the benchmark's
+// baseline. It walks the folder once for the component definitions and again
+// for the entities, stat'ing every entry and reading each file a field at a
+// time.
+int32 loadTwoPassBenchmarkEntities(
+	Scene *scene,
+	bool loadData,
+	const char *folder)
+{
+	DIR *dir = opendir(folder);
+
+	if (!dir)
+	{
+		LOG("Failed to open %s\n", folder);
+		return -1;
+	}
+
+	int32 error = 0;
+
+	for (struct dirent *dirEntry = readdir(dir);
+		 dirEntry && error != -1;
+		 dirEntry = readdir(dir))
+	{
+		if (!strcmp(dirEntry->d_name, ".") || !strcmp(dirEntry->d_name, ".."))
+		{
+			continue;
+		}
+
+		char *path = getFullFilePath(dirEntry->d_name, NULL, folder);
+
+		struct stat info;
+		stat(path, &info);
+
+		char *extension = getExtension(dirEntry->d_name);
+
+		if (S_ISDIR(info.st_mode))
+		{
+			error = loadTwoPassBenchmarkEntities(scene, loadData, path);
+		}
+		else if (
+			S_ISREG(info.st_mode) &&
+			extension &&
+			!strcmp(extension, "entity"))
+		{
+			FILE *file = fopen(path, "rb");
+
+			if (file)
+			{
+				uint8 entityBinaryFileVersion;
+				fread(&entityBinaryFileVersion, sizeof(uint8), 1, file);
+
+				UUID uuid = readUUID(file);
+				EntityHandle entity = INVALID_HANDLE;
+
+				if (loadData)
+				{
+					entity = sceneRegisterEntity(scene, uuid);
+				}
+
+				uint32 numComponents;
+				fread(&numComponents, sizeof(uint32), 1, file);
+
+				for (uint32 i = 0; i < numComponents; i++)
+				{
+					ComponentDefinition componentDefinition = {};
+					componentDefinition.name = readString(file);
+
+					fread(
+						&componentDefinition.numValues,
+						sizeof(uint32),
+						1,
+						file);
+					componentDefinition.values = calloc(
+						MAX(componentDefinition.numValues, 1),
+						sizeof(ComponentValueDefinition));
+
+					for (uint32 j = 0; j < componentDefinition.numValues; j++)
+					{
+						ComponentValueDefinition *valueDefinition =
+							&componentDefinition.values[j];
+
+						valueDefinition->name = readString(file);
+
+						int8 dataType;
+						fread(&dataType, sizeof(int8), 1, file);
+						valueDefinition->type = (DataType)dataType;
+
+						if (valueDefinition->type == DATA_TYPE_STRING)
+						{
+							fread(
+								&valueDefinition->maxStringSize,
+								sizeof(uint32),
+								1,
+								file);
+						}
+
+						fread(&valueDefinition->count, sizeof(uint32), 1, file);
+					}
+
+					fread(&componentDefinition.size, sizeof(uint32), 1, file);
+
+					void *data = malloc(componentDefinition.size);
+					fread(data, componentDefinition.size, 1, file);
+
+					UUID componentID = idFromName(componentDefinition.name);
+
+					if (loadData)
+					{
+						sceneAddComponentToEntity(
+							scene,
+							entity,
+							componentTypeFromID(componentID),
+							data);
+						freeBatchComponentDefinition(&componentDefinition);
+					}
+					else if (!hashMapGetData(
+						scene->componentDefinitions,
+						&componentID))
+					{
+						hashMapInsert(
+							scene->componentDefinitions,
+							&componentID,
+							&componentDefinition);
+					}
+					else
+					{
+						freeBatchComponentDefinition(&componentDefinition);
+					}
+
+					free(data);
+				}
+
+				fclose(file);
+			}
+			else
+			{
+				LOG("Failed to open %s\n", path);
+				error = -1;
+			}
+		}
+
+		free(extension);
+		free(path);
+	}
+
+	closedir(dir);
+
+	return error;
+}
+
+real64 getBenchmarkTime(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1000000000.0;
+}
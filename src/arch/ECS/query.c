@@ -0,0 +1,302 @@
+#include "ECS/query.h"
+#include "ECS/ecs_types.h"
+#include "ECS/component.h"
+#include "ECS/scene.h"
+
+#include "core/log.h"
+
+#include "data/intern_table.h"
+
+#include <malloc.h>
+#include <string.h>
+
+#define INVALID_QUERY_INDEX 0xFFFFFFFF
+
+internal
+inline
+uint32 getQueryIndex(Query *query, EntityHandle entity)
+{
+	uint32 sparseIndex = HANDLE_GET_INDEX(entity);
+
+	if (sparseIndex >= query->sparseSize)
+	{
+		return INVALID_QUERY_INDEX;
+	}
+
+	uint32 index = query->sparse[sparseIndex];
+
+	// The sparse entry may be stale, so check who owns the dense slot
+	if (index >= query->numEntities || query->entities[index] != entity)
+	{
+		return INVALID_QUERY_INDEX;
+	}
+
+	return index;
+}
+
+internal
+void resizeQuerySparseArray(Query *query, uint32 sparseIndex)
+{
+	uint32 sparseSize = MAX(query->sparseSize, QUERY_MIN_CAPACITY);
+	while (sparseSize <= sparseIndex)
+	{
+		sparseSize <<= 1;
+	}
+
+	query->sparse = realloc(query->sparse, sparseSize * sizeof(uint32));
+
+	ASSERT(query->sparse != 0);
+
+	memset(
+		query->sparse + query->sparseSize,
+		0xFF,
+		(sparseSize - query->sparseSize) * sizeof(uint32));
+
+	query->sparseSize = sparseSize;
+}
+
+internal
+void loadIteratorComponents(QueryIterator *itr)
+{
+	if (itr->index == INVALID_QUERY_INDEX)
+	{
+		return;
+	}
+
+	EntityHandle entity = itr->query->entities[itr->index];
+
+	for (uint32 i = 0; i < itr->query->numComponentTypes; i++)
+	{
+		itr->components[i] = cdtGet(itr->tables[i], entity);
+	}
+}
+
+Query *createQuery(
+	uint32 numComponentTypes,
+	ComponentTypeHandle *componentTypes)
+{
+	if (numComponentTypes > QUERY_MAX_COMPONENT_TYPES)
+	{
+		LOG_ERROR("Queries can have at most %d component types\n",
+			QUERY_MAX_COMPONENT_TYPES);
+		return NULL;
+	}
+
+	Query *ret = calloc(1, sizeof(Query));
+
+	ASSERT(ret != 0);
+
+	ret->numComponentTypes = numComponentTypes;
+	memcpy(
+		ret->componentTypes,
+		componentTypes,
+		numComponentTypes * sizeof(ComponentTypeHandle));
+
+	for (uint32 i = 0; i < numComponentTypes; i++)
+	{
+		signatureAddComponentType(&ret->signature, componentTypes[i]);
+	}
+
+	ret->numEntities = 0;
+	ret->capacity = QUERY_MIN_CAPACITY;
+	ret->entities = malloc(ret->capacity * sizeof(EntityHandle));
+
+	ASSERT(ret->entities != 0);
+
+	resizeQuerySparseArray(ret, 0);
+
+	return ret;
+}
+
+void freeQuery(Query **query)
+{
+	free((*query)->entities);
+	free((*query)->sparse);
+	free(*query);
+	*query = NULL;
+}
+
+inline
+bool queryHasComponentType(Query *query, ComponentTypeHandle componentType)
+{
+	return signatureHasComponentType(&query->signature, componentType);
+}
+
+inline
+bool queryMatchesEntity(Query *query, Scene *scene, EntityHandle entity)
+{
+	return sceneEntityHasComponentTypes(scene, entity, &query->signature);
+}
+
+inline
+bool queryContainsEntity(Query *query, EntityHandle entity)
+{
+	return getQueryIndex(query, entity) != INVALID_QUERY_INDEX;
+}
+
+void queryRefresh(Query *query, Scene *scene)
+{
+	if (query->numComponentTypes == 0)
+	{
+		return;
+	}
+
+	// Only the entities in the smallest table can possibly match
+	ComponentDataTable *smallestTable = NULL;
+
+	for (uint32 i = 0; i < query->numComponentTypes; i++)
+	{
+		ComponentDataTable *table = sceneGetComponentDataTable(
+			scene,
+			query->componentTypes[i]);
+
+		if (!table)
+		{
+			LOG_ERROR("Component limit for the %s component "
+				"is missing from the scene\n",
+				componentTypeGetID(query->componentTypes[i]).string);
+			return;
+		}
+
+		if (!smallestTable
+			|| table->numComponents < smallestTable->numComponents)
+		{
+			smallestTable = table;
+		}
+	}
+
+	for (ComponentDataTableIterator itr = cdtGetIterator(smallestTable);
+		 !cdtIteratorAtEnd(itr);
+		 cdtMoveIterator(&itr))
+	{
+		EntityHandle entity = cdtIteratorGetEntity(itr);
+
+		if (queryMatchesEntity(query, scene, entity))
+		{
+			queryAddEntity(query, entity);
+		}
+	}
+}
+
+void queryAddEntity(Query *query, EntityHandle entity)
+{
+	if (queryContainsEntity(query, entity))
+	{
+		return;
+	}
+
+	if (query->numEntities >= query->capacity)
+	{
+		query->capacity <<= 1;
+		query->entities = realloc(
+			query->entities,
+			query->capacity * sizeof(EntityHandle));
+
+		ASSERT(query->entities != 0);
+	}
+
+	uint32 sparseIndex = HANDLE_GET_INDEX(entity);
+	if (sparseIndex >= query->sparseSize)
+	{
+		resizeQuerySparseArray(query, sparseIndex);
+	}
+
+	uint32 i = query->numEntities++;
+
+	query->sparse[sparseIndex] = i;
+	query->entities[i] = entity;
+}
+
+void queryRemoveEntity(Query *query, EntityHandle entity)
+{
+	uint32 i = getQueryIndex(query, entity);
+
+	if (i == INVALID_QUERY_INDEX)
+	{
+		return;
+	}
+
+	uint32 last = --query->numEntities;
+
+	// Move the last entity into the hole to keep the entities packed
+	if (i != last)
+	{
+		EntityHandle lastEntity = query->entities[last];
+
+		query->entities[i] = lastEntity;
+		query->sparse[HANDLE_GET_INDEX(lastEntity)] = i;
+	}
+
+	query->sparse[HANDLE_GET_INDEX(entity)] = INVALID_QUERY_INDEX;
+}
+
+void queryClear(Query *query)
+{
+	query->numEntities = 0;
+	memset(query->sparse, 0xFF, query->sparseSize * sizeof(uint32));
+}
+
+inline
+QueryIterator queryGetIterator(Query *query, Scene *scene)
+{
+	return queryGetRangeIterator(query, scene, 0, query->numEntities);
+}
+
+QueryIterator queryGetRangeIterator(
+	Query *query,
+	Scene *scene,
+	uint32 first,
+	uint32 count)
+{
+	QueryIterator itr = {};
+
+	uint32 end = MIN(first + count, query->numEntities);
+
+	itr.index = end > first ? end - 1 : INVALID_QUERY_INDEX;
+	itr.first = first;
+	itr.query = query;
+
+	for (uint32 i = 0; i < query->numComponentTypes; i++)
+	{
+		itr.tables[i] = sceneGetComponentDataTable(
+			scene,
+			query->componentTypes[i]);
+	}
+
+	loadIteratorComponents(&itr);
+
+	return itr;
+}
+
+void queryMoveIterator(QueryIterator *itr)
+{
+	// Return if the iterator is already at the end
+	if (itr->index == INVALID_QUERY_INDEX)
+	{
+		return;
+	}
+
+	// Entities may have been removed since the iterator last moved
+	uint32 index = MIN(itr->index, itr->query->numEntities);
+	itr->index = index > itr->first ? index - 1 : INVALID_QUERY_INDEX;
+
+	loadIteratorComponents(itr);
+}
+
+inline
+uint32 queryIteratorAtEnd(QueryIterator itr)
+{
+	return itr.index == INVALID_QUERY_INDEX;
+}
+
+inline
+EntityHandle queryIteratorGetEntity(QueryIterator itr)
+{
+	return itr.query->entities[itr.index];
+}
+
+inline
+void *queryIteratorGetComponent(QueryIterator itr, uint32 index)
+{
+	return itr.components[index];
+}
@@ -1,5 +1,6 @@
 #include "ECS/save.h"
 #include "ECS/scene.h"
+#include "ECS/serialization.h"
 
 #include "core/log.h"
 
@@ -15,192 +16,162 @@
 #include <malloc.h>
 #include <string.h>
 #include <dirent.h>
+#include <pthread.h>
 
 extern Config config;
 extern List activeScenes;
 extern bool loadingSave;
 extern List savedScenes;
 
-int32 exportSave(void *data, uint32 size, uint32 slot)
+typedef struct save_export_t
 {
-	char *saveName = malloc(128);
-	sprintf(saveName, "save_%d", slot);
+	uint32 slot;
+	uint32 size;
+	void *data;
+	uint32 numScenes;
+	char **sceneNames;
+	RuntimeSceneExport **scenes;
+	SaveCallback callback;
+	int32 error;
+	// Each scene is a step, and so is copying the runtime state
+	uint32 numSteps;
+	uint32 numFinishedSteps;
+	bool finished;
+} SaveExport;
+
+// Saves which have been queued, in order, until their callback has run
+internal uint32 numPendingSaves;
+internal SaveExport **pendingSaves;
+internal pthread_mutex_t saveMutex = PTHREAD_MUTEX_INITIALIZER;
+
+internal void exportSaveJob(void *data);
+internal int32 writeSave(const SaveExport *saveExport);
+internal void finishSaveStep(SaveExport *saveExport);
+internal void freeSaveExport(SaveExport *saveExport);
+
+int32 exportSave(void *data, uint32 size, uint32 slot, SaveCallback callback)
+{
+	LOG("Exporting save file (save_%d)...\n", slot);
 
-	LOG("Exporting save file (%s)...\n", saveName);
+	SaveExport *saveExport = calloc(1, sizeof(SaveExport));
 
-	MKDIR(SAVE_FOLDER);
+	saveExport->slot = slot;
+	saveExport->size = size;
+	saveExport->data = malloc(MAX(size, 1));
+	saveExport->callback = callback;
 
-	char *saveFolder = getFullFilePath(saveName, NULL, SAVE_FOLDER);
-	deleteFolder(saveFolder, false, &logFunction);
-	MKDIR(saveFolder);
-
-	char *saveFilename = getFullFilePath(saveName, "save", saveFolder);
-	FILE *file = fopen(saveFilename, "wb");
-	free(saveFilename);
+	if (size > 0)
+	{
+		memcpy(saveExport->data, data, size);
+	}
 
-	uint32 numActiveScenes = listGetSize(&activeScenes);
-	fwrite(&numActiveScenes, sizeof(uint32), 1, file);
+	// Copying the scenes is the only part of the save which happens now
+	saveExport->numScenes = listGetSize(&activeScenes);
+	saveExport->sceneNames = malloc(
+		MAX(saveExport->numScenes, 1) * sizeof(char*));
+	saveExport->scenes = malloc(
+		MAX(saveExport->numScenes, 1) * sizeof(RuntimeSceneExport*));
+	saveExport->numSteps = saveExport->numScenes + 1;
 
+	uint32 i = 0;
 	for (ListIterator itr = listGetIterator(&activeScenes);
 		 !listIteratorAtEnd(itr);
 		 listMoveIterator(&itr))
 	{
 		Scene *scene = *LIST_ITERATOR_GET_ELEMENT(Scene*, itr);
-		writeString(scene->name, file);
+
+		saveExport->sceneNames[i] = malloc(strlen(scene->name) + 1);
+		strcpy(saveExport->sceneNames[i], scene->name);
+		saveExport->scenes[i++] = copyRuntimeScene(scene);
 	}
 
-	fwrite(&size, sizeof(uint32), 1, file);
-	fwrite(data, size, 1, file);
+	pthread_mutex_lock(&saveMutex);
 
-	fclose(file);
+	pendingSaves = realloc(
+		pendingSaves,
+		(numPendingSaves + 1) * sizeof(SaveExport*));
+	pendingSaves[numPendingSaves++] = saveExport;
 
-	DIR *dir = opendir(RUNTIME_STATE_DIR);
-	if (dir)
-	{
-		struct dirent *dirEntry = readdir(dir);
-		while (dirEntry)
-		{
-			if (strcmp(dirEntry->d_name, ".")
-			&& strcmp(dirEntry->d_name, ".."))
-			{
-				char *folderPath = getFullFilePath(
-					dirEntry->d_name,
-					NULL,
-					RUNTIME_STATE_DIR);
+	pthread_mutex_unlock(&saveMutex);
 
-				bool active = false;
-				for (ListIterator itr = listGetIterator(&activeScenes);
-					!listIteratorAtEnd(itr);
-					listMoveIterator(&itr))
-				{
-					Scene *scene = *LIST_ITERATOR_GET_ELEMENT(Scene*, itr);
-					if (!strcmp(scene->name, dirEntry->d_name))
-					{
-						active = true;
-						break;
-					}
-				}
+	serializationAddJob(
+		&exportSaveJob,
+		saveExport,
+		saveExport->numScenes,
+		saveExport->sceneNames);
 
-				struct stat info;
-				stat(folderPath, &info);
+	return 0;
+}
 
-				if (S_ISDIR(info.st_mode) && !active)
-				{
-					char *destinationFolderPath = getFullFilePath(
-						dirEntry->d_name,
-						NULL,
-						saveFolder);
+void updateSaves(void)
+{
+	pthread_mutex_lock(&saveMutex);
 
-					if (copyFolder(
-						folderPath,
-						destinationFolderPath,
-						&logFunction) == -1)
-					{
-						free(folderPath);
-						free(destinationFolderPath);
-						closedir(dir);
-						return -1;
-					}
+	// Callbacks run in the order the saves were queued, and may queue more
+	while (numPendingSaves > 0 && pendingSaves[0]->finished)
+	{
+		SaveExport *saveExport = pendingSaves[0];
 
-					free(destinationFolderPath);
-				}
+		numPendingSaves--;
+		memmove(
+			pendingSaves,
+			pendingSaves + 1,
+			numPendingSaves * sizeof(SaveExport*));
 
-				free(folderPath);
-			}
+		pthread_mutex_unlock(&saveMutex);
 
-			dirEntry = readdir(dir);
+		if (saveExport->callback)
+		{
+			saveExport->callback(saveExport->slot, saveExport->error);
 		}
 
-		closedir(dir);
-	}
-
-	for (ListIterator itr = listGetIterator(&activeScenes);
-		 !listIteratorAtEnd(itr);
-		 listMoveIterator(&itr))
-	{
-		Scene *scene = *LIST_ITERATOR_GET_ELEMENT(Scene*, itr);
-
-		char *sceneFolder = getFullFilePath(scene->name, NULL, saveFolder);
-		char *sceneFilename = getFullFilePath(scene->name, NULL, sceneFolder);
-		char *entitiesFolder = getFullFilePath("entities", NULL, sceneFolder);
-
-		MKDIR(sceneFolder);
-		MKDIR(entitiesFolder);
+		freeSaveExport(saveExport);
 
-		exportSceneSnapshot(scene, sceneFilename);
+		pthread_mutex_lock(&saveMutex);
+	}
 
-		if (exportScene(sceneFilename, &logFunction) == -1)
-		{
-			free(saveFolder);
-			free(sceneFolder);
-			free(sceneFilename);
-			free(entitiesFolder);
-			return -1;
-		}
+	pthread_mutex_unlock(&saveMutex);
+}
 
-		char *jsonSceneFilename = getFullFilePath(
-			sceneFilename,
-			"json",
-			NULL);
+bool isSaving(void)
+{
+	pthread_mutex_lock(&saveMutex);
 
-		if (config.savesConfig.removeJSONScenes)
+	bool saving = false;
+	for (uint32 i = 0; i < numPendingSaves; i++)
+	{
+		if (!pendingSaves[i]->finished)
 		{
-			remove(jsonSceneFilename);
+			saving = true;
+			break;
 		}
+	}
 
-		free(jsonSceneFilename);
+	pthread_mutex_unlock(&saveMutex);
 
-		uint32 entityNumber = 0;
-		for (HashMapIterator itr = hashMapGetIterator(scene->entities);
-			 !hashMapIteratorAtEnd(itr);
-			 hashMapMoveIterator(&itr))
-		{
-			char *entityName = malloc(128);
-			sprintf(entityName, "entity_%d", entityNumber++);
-			char *entityFilename = getFullFilePath(
-				entityName,
-				NULL,
-				entitiesFolder);
-			free(entityName);
-
-			UUID *entity = (UUID*)hashMapIteratorGetKey(itr);
-			exportEntitySnapshot(scene, *entity, entityFilename);
-
-			if (exportEntity(entityFilename, &logFunction) == -1)
-			{
-				free(saveFolder);
-				free(sceneFolder);
-				free(sceneFilename);
-				free(entitiesFolder);
-				free(entityFilename);
-				return -1;
-			}
+	return saving;
+}
 
-			char *jsonEntityFilename = getFullFilePath(
-				entityFilename,
-				"json",
-				NULL);
+real32 getSaveProgress(void)
+{
+	real32 progress = 1.0f;
 
-			if (config.savesConfig.removeJSONEntities)
-			{
-				remove(jsonEntityFilename);
-			}
+	pthread_mutex_lock(&saveMutex);
 
-			free(jsonEntityFilename);
-			free(entityFilename);
+	// Saves are written in order, so the first unfinished one is current
+	for (uint32 i = 0; i < numPendingSaves; i++)
+	{
+		if (!pendingSaves[i]->finished)
+		{
+			progress = (real32)pendingSaves[i]->numFinishedSteps /
+				pendingSaves[i]->numSteps;
+			break;
 		}
-
-		free(sceneFolder);
-		free(sceneFilename);
-		free(entitiesFolder);
 	}
 
-	free(saveFolder);
-
-	LOG("Successfully exported save file (%s)\n", saveName);
-	free(saveName);
+	pthread_mutex_unlock(&saveMutex);
 
-	return 0;
+	return progress;
 }
 
 int32 loadSave(uint32 slot, void **data)
@@ -212,6 +183,10 @@ int32 loadSave(uint32 slot, void **data)
 
 	LOG("Loading save file (%s)...\n", saveName);
 
+	// Loading replaces the runtime state, so everything queued is written
+	// first
+	waitForSerialization();
+
 	char *saveFolder = getFullFilePath(saveName, NULL, SAVE_FOLDER);
 	char *saveFilename = getFullFilePath(saveName, "save", saveFolder);
 
@@ -327,6 +302,18 @@ bool getSaveSlotAvailability(uint32 slot)
 {
 	bool available = true;
 
+	pthread_mutex_lock(&saveMutex);
+
+	for (uint32 i = 0; i < numPendingSaves; i++)
+	{
+		if (pendingSaves[i]->slot == slot)
+		{
+			available = false;
+		}
+	}
+
+	pthread_mutex_unlock(&saveMutex);
+
 	char *saveName = malloc(128);
 	sprintf(saveName, "save_%d", slot);
 
@@ -353,6 +340,8 @@ int32 deleteSave(uint32 slot)
 
 	LOG("Deleting save file (%s)...\n", saveName);
 
+	waitForSerialization();
+
 	if (!getSaveSlotAvailability(slot))
 	{
 		LOG("Save file doesn't exist.\n");
@@ -376,3 +365,147 @@ int32 deleteSave(uint32 slot)
 
 	return error;
 }
+
+void exportSaveJob(void *data)
+{
+	SaveExport *saveExport = data;
+
+	int32 error = 0;
+
+	// Active scenes only append what changed to their runtime state, which
+	// is then copied along with every inactive scene
+	for (uint32 i = 0; i < saveExport->numScenes; i++)
+	{
+		if (writeRuntimeScene(saveExport->scenes[i]) == -1)
+		{
+			error = -1;
+		}
+
+		freeRuntimeSceneExport(&saveExport->scenes[i]);
+		finishSaveStep(saveExport);
+	}
+
+	if (error != -1)
+	{
+		error = writeSave(saveExport);
+	}
+
+	if (error != -1)
+	{
+		LOG("Successfully exported save file (save_%d)\n", saveExport->slot);
+	}
+	else
+	{
+		LOG("Failed to export save file (save_%d)\n", saveExport->slot);
+	}
+
+	pthread_mutex_lock(&saveMutex);
+
+	saveExport->error = error;
+	saveExport->numFinishedSteps = saveExport->numSteps;
+	saveExport->finished = true;
+
+	pthread_mutex_unlock(&saveMutex);
+}
+
+int32 writeSave(const SaveExport *saveExport)
+{
+	int32 error = 0;
+
+	char *saveName = malloc(128);
+	sprintf(saveName, "save_%d", saveExport->slot);
+
+	MKDIR(SAVE_FOLDER);
+
+	char *saveFolder = getFullFilePath(saveName, NULL, SAVE_FOLDER);
+	deleteFolder(saveFolder, false, &logFunction);
+	MKDIR(saveFolder);
+
+	char *saveFilename = getFullFilePath(saveName, "save", saveFolder);
+	FILE *file = fopen(saveFilename, "wb");
+	free(saveFilename);
+	free(saveName);
+
+	if (!file)
+	{
+		free(saveFolder);
+		return -1;
+	}
+
+	fwrite(&saveExport->numScenes, sizeof(uint32), 1, file);
+
+	for (uint32 i = 0; i < saveExport->numScenes; i++)
+	{
+		writeString(saveExport->sceneNames[i], file);
+	}
+
+	fwrite(&saveExport->size, sizeof(uint32), 1, file);
+	fwrite(saveExport->data, saveExport->size, 1, file);
+
+	fclose(file);
+
+	DIR *dir = opendir(RUNTIME_STATE_DIR);
+	if (dir)
+	{
+		struct dirent *dirEntry = readdir(dir);
+		while (dirEntry && error != -1)
+		{
+			if (strcmp(dirEntry->d_name, ".")
+			&& strcmp(dirEntry->d_name, ".."))
+			{
+				char *folderPath = getFullFilePath(
+					dirEntry->d_name,
+					NULL,
+					RUNTIME_STATE_DIR);
+
+				struct stat info;
+				stat(folderPath, &info);
+
+				if (S_ISDIR(info.st_mode))
+				{
+					char *destinationFolderPath = getFullFilePath(
+						dirEntry->d_name,
+						NULL,
+						saveFolder);
+
+					error = copyFolder(
+						folderPath,
+						destinationFolderPath,
+						&logFunction);
+
+					free(destinationFolderPath);
+				}
+
+				free(folderPath);
+			}
+
+			dirEntry = readdir(dir);
+		}
+
+		closedir(dir);
+	}
+
+	free(saveFolder);
+
+	return error;
+}
+
+void finishSaveStep(SaveExport *saveExport)
+{
+	pthread_mutex_lock(&saveMutex);
+	saveExport->numFinishedSteps++;
+	pthread_mutex_unlock(&saveMutex);
+}
+
+void freeSaveExport(SaveExport *saveExport)
+{
+	for (uint32 i = 0; i < saveExport->numScenes; i++)
+	{
+		free(saveExport->sceneNames[i]);
+	}
+
+	free(saveExport->sceneNames);
+	free(saveExport->scenes);
+	free(saveExport->data);
+	free(saveExport);
+}
@@ -1,15 +1,23 @@
 #include "ECS/scene.h"
+#include "ECS/command_buffer.h"
 #include "ECS/component.h"
+#include "ECS/entity_loader.h"
+#include "ECS/query.h"
+#include "ECS/scene_snapshot.h"
+#include "ECS/scheduler.h"
+#include "ECS/serialization.h"
 #include "ECS/system.h"
 
 #include "core/log.h"
 
 #include "data/data_types.h"
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 #include "data/list.h"
 
 #include "components/component_types.h"
 #include "components/animator.h"
+#include "components/audio_source.h"
 #include "components/collision_tree_node.h"
 #include "components/collision.h"
 #include "components/panel.h"
@@ -43,7 +51,6 @@
 #include <unistd.h>
 
 #define SCENE_BINARY_FILE_VERSION 1
-#define ENTITY_BINARY_FILE_VERSION 1
 
 #define MAX_CONTACTS 4096
 
@@ -54,11 +61,15 @@ extern bool reloadingScene;
 extern bool reloadingAssets;
 extern List unloadedScenes;
 
+extern ThreadPool *systemThreadPool;
+
 internal ComponentDefinition getComponentDefinition(
 	Scene *scene,
 	UUID name);
 internal void freeComponentDefinition(ComponentDefinition *componentDefinition);
 
+internal cJSON *createSceneJSON(Scene *scene);
+
 internal uint32 getDataTypeSize(DataType type);
 internal char* getDataTypeString(
 	const ComponentValueDefinition *componentValueDefinition);
@@ -69,16 +80,15 @@ Scene *createScene(void)
 
 	ASSERT(ret != 0);
 
-	ret->componentTypes = createHashMap(
-		sizeof(UUID),
-		sizeof(ComponentDataTable *),
-		COMPONENT_TYPE_BUCKETS,
-		(ComparisonOp)&strcmp);
-	ret->entities = createHashMap(
-		sizeof(UUID),
-		sizeof(List),
-		ENTITY_BUCKETS,
-		(ComparisonOp)&strcmp);
+	ret->numComponentTables = 0;
+	ret->componentTables = NULL;
+	ret->numQueries = 0;
+	ret->queries = NULL;
+	ret->commandBuffer = createCommandBuffer();
+	ret->entities = createInternTable(
+		sizeof(ComponentSignature),
+		ENTITY_BUCKETS);
+	ret->mainCameraEntity = INVALID_HANDLE;
 
 	ret->physicsFrameSystems = createList(sizeof(UUID));
 	ret->renderFrameSystems = createList(sizeof(UUID));
@@ -89,324 +99,14 @@ Scene *createScene(void)
 	ret->physicsSpace = dHashSpaceCreate(0);
 	ret->contactGroup = dJointGroupCreate(MAX_CONTACTS);
 
+	ret->snapshotState = calloc(1, sizeof(SceneSnapshotState));
+
 	dWorldSetGravity(ret->physicsWorld, 0, -9.8f, 0);
 	dWorldSetAutoDisableFlag(ret->physicsWorld, 1);
 
 	return ret;
 }
 
-internal
-int32 exportSceneJSONEntities(const char *folder)
-{
-	int32 error = 0;
-
-	DIR *dir = opendir(folder);
-
-	if (dir)
-	{
-		struct dirent *dirEntry = readdir(dir);
-		while (dirEntry)
-		{
-			if (strcmp(dirEntry->d_name, ".") && strcmp(dirEntry->d_name, ".."))
-			{
-				char *folderPath = getFullFilePath(
-					dirEntry->d_name,
-					NULL,
-					folder);
-
-				struct stat info;
-				stat(folderPath, &info);
-
-				if (S_ISDIR(info.st_mode))
-				{
-					if (exportSceneJSONEntities(folderPath) == -1)
-					{
-						free(folderPath);
-						closedir(dir);
-						return -1;
-					}
-				}
-				else if (S_ISREG(info.st_mode))
-				{
-					char *extension = getExtension(dirEntry->d_name);
-					if (extension && !strcmp(extension, "json"))
-					{
-						char *entityFilename = removeExtension(
-							dirEntry->d_name);
-						char *jsonEntityFilename = getFullFilePath(
-							entityFilename,
-							NULL,
-							folder);
-						free(entityFilename);
-
-						if (exportEntity(
-							jsonEntityFilename,
-							&logFunction) == -1)
-						{
-							LOG("Failed to export entity\n");
-							free(jsonEntityFilename);
-							free(folderPath);
-							free(extension);
-							closedir(dir);
-							return -1;
-						}
-
-						free(jsonEntityFilename);
-					}
-
-					free(extension);
-				}
-
-				free(folderPath);
-			}
-
-			dirEntry = readdir(dir);
-		}
-
-		closedir(dir);
-	}
-	else
-	{
-		LOG("Failed to open %s\n", folder);
-		error = -1;
-	}
-
-	return error;
-}
-
-internal
-int32 loadSceneEntities(
-	Scene **scene,
-	bool loadData,
-	bool recursive,
-	const char *folder)
-{
-	int32 error = 0;
-
-	if (!scene)
-	{
-		return -1;
-	}
-
-	DIR *dir = opendir(folder);
-
-	if (dir)
-	{
-		uint32 i;
-
-		struct dirent *dirEntry = readdir(dir);
-
-		if (!loadData && !recursive)
-		{
-			(*scene)->componentDefinitions = createHashMap(
-				sizeof(UUID),
-				sizeof(ComponentDefinition),
-				COMPONENT_DEFINITION_BUCKETS,
-				(ComparisonOp)&strcmp);
-		}
-
-		while (dirEntry)
-		{
-			if (strcmp(dirEntry->d_name, ".") && strcmp(dirEntry->d_name, ".."))
-			{
-				char *folderPath = getFullFilePath(
-					dirEntry->d_name,
-					NULL,
-					folder);
-
-				struct stat info;
-				stat(folderPath, &info);
-
-				if (S_ISDIR(info.st_mode))
-				{
-					if (loadSceneEntities(
-						scene,
-						loadData,
-						true,
-						folderPath) == -1)
-					{
-						LOG("Failed to load scene entities\n");
-						free(folderPath);
-						closedir(dir);
-						return -1;
-					}
-				}
-				else if (S_ISREG(info.st_mode))
-				{
-					char *extension = getExtension(dirEntry->d_name);
-					if (extension && !strcmp(extension, "entity"))
-					{
-						FILE *file = fopen(folderPath, "rb");
-
-						if (file)
-						{
-							uint8 entityBinaryFileVersion;
-							fread(
-								&entityBinaryFileVersion,
-								sizeof(uint8),
-								1,
-								file);
-
-							if (entityBinaryFileVersion <
-								ENTITY_BINARY_FILE_VERSION)
-							{
-								LOG("WARNING: %s out of date\n", folderPath);
-								error = -1;
-							}
-						}
-						else
-						{
-							error = -1;
-						}
-
-						if (error != -1)
-						{
-							UUID uuid = readUUID(file);
-
-							if (loadData)
-							{
-								sceneRegisterEntity(*scene, uuid);
-							}
-
-							uint32 numComponents;
-							fread(&numComponents, sizeof(uint32), 1, file);
-
-							for (i = 0; i < numComponents; i++)
-							{
-								ComponentDefinition *componentDefinition =
-									calloc(1, sizeof(ComponentDefinition));
-
-								componentDefinition->name = readString(file);
-
-								fread(&componentDefinition->numValues,
-									sizeof(uint32),
-									1,
-									file);
-
-								componentDefinition->values =
-									calloc(componentDefinition->numValues,
-										sizeof(ComponentValueDefinition));
-
-								for (uint32 j = 0;
-									j < componentDefinition->numValues;
-									j++)
-								{
-									ComponentValueDefinition
-										*componentValueDefinition =
-											&componentDefinition->values[j];
-
-									componentValueDefinition->name =
-										readString(file);
-
-									int8 dataType;
-									fread(
-										&dataType,
-										sizeof(int8),
-										1,
-										file);
-									componentValueDefinition->type =
-										(DataType)dataType;
-
-									if (componentValueDefinition->type
-										== DATA_TYPE_STRING)
-									{
-										fread(
-											&componentValueDefinition
-												->maxStringSize,
-											sizeof(uint32),
-											1,
-											file);
-									}
-
-									fread(
-										&componentValueDefinition->count,
-										sizeof(uint32),
-										1,
-										file);
-								}
-
-								fread(
-									&componentDefinition->size,
-									sizeof(uint32),
-									1,
-									file);
-
-								void *data = malloc(componentDefinition->size);
-								fread(data, componentDefinition->size, 1, file);
-
-								if (!loadData)
-								{
-									UUID componentID =
-										idFromName(componentDefinition->name);
-
-									ComponentDefinition
-										*existingComponentDefinition =
-										(ComponentDefinition*)
-											hashMapGetData(
-												(*scene)->componentDefinitions,
-												&componentID);
-
-									if (!existingComponentDefinition)
-									{
-										hashMapInsert(
-											(*scene)->componentDefinitions,
-											&componentID,
-											componentDefinition);
-									}
-									else
-									{
-										freeComponentDefinition(
-											componentDefinition);
-									}
-								}
-								else
-								{
-									sceneAddComponentToEntity(
-										*scene,
-										uuid,
-										idFromName(componentDefinition->name),
-										data);
-
-									freeComponentDefinition(
-										componentDefinition);
-								}
-
-								free(componentDefinition);
-								free(data);
-							}
-
-							fclose(file);
-						}
-						else
-						{
-							LOG("Failed to open %s\n", folderPath);
-							free(folderPath);
-							free(extension);
-							closedir(dir);
-							return -1;
-						}
-					}
-
-					free(extension);
-				}
-
-				free(folderPath);
-			}
-
-			dirEntry = readdir(dir);
-		}
-
-		closedir(dir);
-	}
-	else
-	{
-		LOG("Failed to open %s\n", folder);
-		error = -1;
-	}
-
-	return error;
-}
-
 int32 loadSceneFile(const char *name, Scene **scene)
 {
 	int32 error = 0;
@@ -424,6 +124,9 @@ int32 loadSceneFile(const char *name, Scene **scene)
 
 	if (!reloadingScene)
 	{
+		// The scene may still be being written after being unloaded
+		waitForSceneSerialization(name);
+
 		DIR *dir = opendir(RUNTIME_STATE_DIR);
 		if (dir)
 		{
@@ -489,7 +192,7 @@ int32 loadSceneFile(const char *name, Scene **scene)
 
 		if (sceneBinaryFileVersion < SCENE_BINARY_FILE_VERSION)
 		{
-			LOG("WARNING: %s out of date\n", sceneFilename);
+			LOG_WARNING("%s out of date\n", sceneFilename);
 			error = -1;
 		}
 	}
@@ -599,22 +302,42 @@ int32 loadSceneFile(const char *name, Scene **scene)
 		}
 
 		char *entityFolder = getFullFilePath("entities", NULL, sceneFolder);
-		if (exportSceneJSONEntities(entityFolder) == -1)
-		{
-			free(sceneFilename);
-			free(entityFolder);
-			free(sceneFolder);
-			free(componentLimitNumbers);
-			fclose(file);
+		char *snapshotFilename = getFullFilePath(
+			name,
+			SCENE_SNAPSHOT_EXTENSION,
+			sceneFolder);
 
-			reloadingScene = true;
-			freeScene(scene);
-			reloadingScene = false;
+		// Runtime state is saved as a single snapshot, while the scenes in
+		// resources keep each entity in its own file
+		SceneSnapshot snapshot = {};
+		LoadedSceneEntities entities = {};
+		bool loadSnapshot = access(snapshotFilename, F_OK) != -1;
 
-			return -1;
+		if (loadSnapshot)
+		{
+			error = openSceneSnapshot(snapshotFilename, &snapshot);
+			if (error != -1)
+			{
+				loadSceneSnapshotComponentDefinitions(*scene, &snapshot);
+			}
 		}
+		else
+		{
+			// Every entity file is read once, the component definitions
+			// are needed before the component types can be added
+			error = readSceneEntities(
+				entityFolder,
+				systemThreadPool,
+				&entities);
+			if (error != -1)
+			{
+				loadSceneEntityDefinitions(*scene, &entities);
+			}
+		}
+
+		free(snapshotFilename);
 
-		if (loadSceneEntities(scene, false, false, entityFolder) == -1)
+		if (error == -1)
 		{
 			LOG("Failed to load scene entities\n");
 			free(sceneFilename);
@@ -635,7 +358,7 @@ int32 loadSceneFile(const char *name, Scene **scene)
 			UUID componentName = idFromName(componentLimitNames[i]);
 			sceneAddComponentType(
 				*scene,
-				componentName,
+				componentTypeFromID(componentName),
 				getComponentDefinition(*scene, componentName).size,
 				componentLimitNumbers[i]);
 		}
@@ -643,26 +366,24 @@ int32 loadSceneFile(const char *name, Scene **scene)
 		(*scene)->numComponentLimitNames = numComponentLimits;
 		(*scene)->componentLimitNames = componentLimitNames;
 
-		if (loadSceneEntities(scene, true, false, entityFolder) == -1)
+		if (loadSnapshot)
 		{
-			LOG("Failed to load scene entities\n");
-			free(sceneFilename);
-			free(entityFolder);
-			free(sceneFolder);
-			free(componentLimitNumbers);
-			fclose(file);
-
-			reloadingScene = true;
-			freeScene(scene);
-			reloadingScene = false;
-
-			return -1;
+			loadSceneSnapshotEntities(*scene, &snapshot);
+			closeSceneSnapshot(&snapshot);
+		}
+		else
+		{
+			loadSceneEntities(*scene, &entities);
+			freeLoadedSceneEntities(&entities);
 		}
 
 		free(entityFolder);
 		free(componentLimitNumbers);
 
 		(*scene)->mainCamera = readUUID(file);
+		(*scene)->mainCameraEntity = sceneGetEntity(
+			*scene,
+			(*scene)->mainCamera);
 
 		fread(&(*scene)->gravity, sizeof(real32), 1, file);
 
@@ -700,7 +421,7 @@ int32 loadSceneFile(const char *name, Scene **scene)
 
 			if (!found)
 			{
-				LOG("ERROR: Component limit for the %s component "
+				LOG_ERROR("Component limit for the %s component "
 					"is missing from the scene\n",
 					componentDefintion->name);
 				error = -2;
@@ -734,82 +455,114 @@ Scene *getScene(const char *name)
 	return NULL;
 }
 
-internal
-void exportRuntimeScene(Scene *scene)
+RuntimeSceneExport *copyRuntimeScene(Scene *scene)
+{
+	RuntimeSceneExport *sceneExport = malloc(sizeof(RuntimeSceneExport));
+
+	sceneExport->name = malloc(strlen(scene->name) + 1);
+	strcpy(sceneExport->name, scene->name);
+
+	sceneExport->json = createSceneJSON(scene);
+	sceneExport->snapshot = copySceneSnapshot(scene);
+	sceneExport->snapshotState = scene->snapshotState;
+
+	return sceneExport;
+}
+
+int32 writeRuntimeScene(const RuntimeSceneExport *sceneExport)
 {
 	MKDIR(RUNTIME_STATE_DIR);
 
 	char *sceneFolder = getFullFilePath(
-		scene->name,
+		sceneExport->name,
 		NULL,
 		RUNTIME_STATE_DIR);
 
-	deleteFolder(sceneFolder, false, &logFunction);
-
 	char *sceneFilename = getFullFilePath(
-		scene->name,
+		sceneExport->name,
 		NULL,
 		sceneFolder);
-	char *entitiesFolder = getFullFilePath("entities", NULL, sceneFolder);
 
 	MKDIR(sceneFolder);
-	MKDIR(entitiesFolder);
 
-	exportSceneSnapshot(scene, sceneFilename);
+	writeJSON(
+		sceneExport->json,
+		sceneFilename,
+		config.jsonConfig.formatted,
+		&logFunction);
 
 	if (exportScene(sceneFilename, &logFunction) == -1)
 	{
 		free(sceneFolder);
 		free(sceneFilename);
-		free(entitiesFolder);
-		return;
+		return -1;
 	}
 
 	char *jsonSceneFilename = getFullFilePath(
 		sceneFilename,
 		"json",
 		NULL);
-	remove(jsonSceneFilename);
-	free(jsonSceneFilename);
 
-	uint32 entityNumber = 0;
-	for (HashMapIterator itr = hashMapGetIterator(scene->entities);
-		 !hashMapIteratorAtEnd(itr);
-		 hashMapMoveIterator(&itr))
+	// Saves are copied from the runtime state
+	if (config.savesConfig.removeJSONScenes)
 	{
-		char *entityName = malloc(128);
-		sprintf(entityName, "entity_%d", entityNumber++);
-		char *entityFilename = getFullFilePath(
-			entityName,
-			NULL,
-			entitiesFolder);
-		free(entityName);
+		remove(jsonSceneFilename);
+	}
 
-		UUID *entity = (UUID*)hashMapIteratorGetKey(itr);
-		exportEntitySnapshot(scene, *entity, entityFilename);
+	free(jsonSceneFilename);
 
-		if (exportEntity(entityFilename, &logFunction) == -1)
-		{
-			free(entityFilename);
-			free(sceneFolder);
-			free(sceneFilename);
-			free(entitiesFolder);
-			return;
-		}
+	char *snapshotFilename = getFullFilePath(
+		sceneExport->name,
+		SCENE_SNAPSHOT_EXTENSION,
+		sceneFolder);
+	int32 error = writeSceneSnapshot(
+		sceneExport->snapshot,
+		sceneExport->snapshotState,
+		snapshotFilename);
+	free(snapshotFilename);
+
+	free(sceneFolder);
+	free(sceneFilename);
 
-		char *jsonEntityFilename = getFullFilePath(
-			entityFilename,
-			"json",
-			NULL);
-		remove(jsonEntityFilename);
-		free(jsonEntityFilename);
+	return error;
+}
 
-		free(entityFilename);
+void freeRuntimeSceneExport(RuntimeSceneExport **sceneExport)
+{
+	if (*sceneExport)
+	{
+		free((*sceneExport)->name);
+		cJSON_Delete((*sceneExport)->json);
+		freeSceneSnapshotCopy(&(*sceneExport)->snapshot);
+		free(*sceneExport);
 	}
 
-	free(sceneFolder);
-	free(sceneFilename);
-	free(entitiesFolder);
+	*sceneExport = NULL;
+}
+
+internal
+void exportRuntimeSceneJob(void *data)
+{
+	RuntimeSceneExport *sceneExport = data;
+
+	writeRuntimeScene(sceneExport);
+	freeRuntimeSceneExport(&sceneExport);
+}
+
+void exportRuntimeScene(Scene *scene)
+{
+	serializationAddJob(
+		&exportRuntimeSceneJob,
+		copyRuntimeScene(scene),
+		1,
+		&scene->name);
+}
+
+internal
+void freeSceneSnapshotStateJob(void *data)
+{
+	SceneSnapshotState *snapshotState = data;
+	freeSceneSnapshotState(&snapshotState);
 }
 
 void freeScene(Scene **scene)
@@ -826,25 +579,35 @@ void freeScene(Scene **scene)
 	listClear(&(*scene)->physicsFrameSystems);
 	listClear(&(*scene)->renderFrameSystems);
 
+	// Report how full each table got so that component limits can be tuned
+	for (uint32 i = 0; i < (*scene)->numComponentTables; i++)
+	{
+		if ((*scene)->componentTables[i])
+		{
+			cdtLogUsage((*scene)->componentTables[i]);
+		}
+	}
+
 	if ((*scene)->entities) {
-		for (HashMapIterator itr = hashMapGetIterator((*scene)->entities);
-			 !hashMapIteratorAtEnd(itr);
-			 hashMapMoveIterator(&itr))
+		for (InternTableIterator itr =
+				 internTableGetIterator((*scene)->entities);
+			 !internTableIteratorAtEnd(itr);
+			 internTableMoveIterator(&itr))
 		{
-			UUID entity = *(UUID*)hashMapIteratorGetKey(itr);
-			sceneRemoveEntityComponents(*scene, entity);
+			sceneRemoveEntityComponents(
+				*scene,
+				internTableIteratorGetHandle(itr));
 		}
 	}
 
-	if ((*scene)->componentTypes) {
-		for (HashMapIterator itr =
-				 hashMapGetIterator((*scene)->componentTypes);
-			 !hashMapIteratorAtEnd(itr);
-			 hashMapMoveIterator(&itr))
+	for (uint32 i = 0; i < (*scene)->numComponentTables; i++)
+	{
+		ComponentDataTable *table = (*scene)->componentTables[i];
+		if (table)
 		{
 			sceneRemoveComponentType(
 				*scene,
-				*(UUID *)hashMapIteratorGetKey(itr));
+				componentTypeFromID(table->componentID));
 		}
 	}
 
@@ -860,13 +623,27 @@ void freeScene(Scene **scene)
 	}
 
 	if ((*scene)->entities) {
-		freeHashMap(&(*scene)->entities);
+		freeInternTable(&(*scene)->entities);
 	}
 
-	if ((*scene)->componentTypes) {
-		freeHashMap(&(*scene)->componentTypes);
+	free((*scene)->componentTables);
+
+	for (uint32 i = 0; i < (*scene)->numQueries; i++)
+	{
+		freeQuery(&(*scene)->queries[i]);
 	}
 
+	free((*scene)->queries);
+
+	freeCommandBuffer(&(*scene)->commandBuffer);
+
+	// Queued exports of the scene still write with its snapshot state
+	serializationAddJob(
+		&freeSceneSnapshotStateJob,
+		(*scene)->snapshotState,
+		0,
+		NULL);
+
 	if ((*scene)->componentDefinitions) {
 		freeHashMap(&(*scene)->componentDefinitions);
 	}
@@ -1177,30 +954,35 @@ char* getDataTypeString(
 	return dataTypeString;
 }
 
-void exportEntitySnapshot(Scene *scene, UUID entity, const char *filename)
+void exportEntitySnapshot(
+	Scene *scene,
+	EntityHandle entity,
+	const char *filename)
 {
 	cJSON *json = cJSON_CreateObject();
 
-	cJSON_AddStringToObject(json, "uuid", entity.string);
+	cJSON_AddStringToObject(
+		json,
+		"uuid",
+		sceneGetEntityID(scene, entity).string);
 	cJSON *jsonComponents = cJSON_AddObjectToObject(json, "components");
 
-	List *components = (List*)hashMapGetData(scene->entities, entity.bytes);
+	ComponentSignature *signature = sceneGetEntitySignature(scene, entity);
 
-	for (ListIterator itr = listGetIterator(components);
-		 !listIteratorAtEnd(itr);
-		 listMoveIterator(&itr))
+	for (uint32 i = signatureGetNextIndex(signature, 0);
+		 i < MAX_COMPONENT_TYPES;
+		 i = signatureGetNextIndex(signature, i + 1))
 	{
-		UUID *componentUUID = LIST_ITERATOR_GET_ELEMENT(UUID, itr);
+		ComponentDataTable *componentDataTable = sceneGetComponentDataTable(
+			scene,
+			componentTypeFromIndex(i));
+		UUID *componentUUID = &componentDataTable->componentID;
+
 		cJSON *jsonComponent = cJSON_AddArrayToObject(
 			jsonComponents,
 			componentUUID->string);
 
-		ComponentDataTable **componentDataTable =
-			(ComponentDataTable**)hashMapGetData(
-				scene->componentTypes,
-				componentUUID->bytes);
-
-		void *componentData = cdtGet((*componentDataTable), entity);
+		void *componentData = cdtGet(componentDataTable, entity);
 
 		ComponentDefinition componentDefinition = getComponentDefinition(
 			scene,
@@ -1498,6 +1280,15 @@ void exportSceneSnapshot(Scene *scene, const char *filename)
 {
 	LOG("Exporting scene (%s)...\n", scene->name);
 
+	cJSON *json = createSceneJSON(scene);
+	writeJSON(json, filename, config.jsonConfig.formatted, &logFunction);
+	cJSON_Delete(json);
+
+	LOG("Successfully exported scene (%s)\n", scene->name);
+}
+
+cJSON *createSceneJSON(Scene *scene)
+{
 	cJSON *json = cJSON_CreateObject();
 	cJSON *systems = cJSON_AddObjectToObject(json, "systems");
 	cJSON *updateSystems = cJSON_AddObjectToObject(systems, "update");
@@ -1553,31 +1344,23 @@ void exportSceneSnapshot(Scene *scene, const char *filename)
 
 	for (uint32 i = 0; i < scene->numComponentLimitNames; i++)
 	{
-		for (HashMapIterator itr = hashMapGetIterator(scene->componentTypes);
-			 !hashMapIteratorAtEnd(itr);
-			 hashMapMoveIterator(&itr))
+		ComponentDataTable *table = sceneGetComponentDataTable(
+			scene,
+			componentTypeFromName(scene->componentLimitNames[i]));
+
+		if (table)
 		{
-			UUID *componentUUID = (UUID*)hashMapIteratorGetKey(itr);
-			if (!strcmp(scene->componentLimitNames[i], componentUUID->string))
-			{
-				uint32 componentLimit =
-					(*(ComponentDataTable**)hashMapIteratorGetValue(itr))
-						->numEntries;
-				cJSON_AddNumberToObject(
-					componentLimits,
-					componentUUID->string,
-					componentLimit);
-			}
+			cJSON_AddNumberToObject(
+				componentLimits,
+				table->componentID.string,
+				table->numEntries);
 		}
 	}
 
 	cJSON_AddStringToObject(json, "active_camera", scene->mainCamera.string);
 	cJSON_AddNumberToObject(json, "gravity", scene->gravity);
 
-	writeJSON(json, filename, config.jsonConfig.formatted, &logFunction);
-	cJSON_Delete(json);
-
-	LOG("Successfully exported scene (%s)\n", scene->name);
+	return json;
 }
 
 inline
@@ -1646,46 +1429,18 @@ void sceneInitSystems(Scene *scene)
 {
 	sceneInitRenderFrameSystems(scene);
 	sceneInitPhysicsFrameSystems(scene);
+
+	sceneApplyCommands(scene);
 }
 
 void sceneRunRenderFrameSystems(Scene *scene, real64 dt)
 {
-	for (ListIterator itr = listGetIterator(&scene->renderFrameSystems);
-		 !listIteratorAtEnd(itr);
-		 listMoveIterator(&itr))
-	{
-		UUID *systemName = LIST_ITERATOR_GET_ELEMENT(UUID, itr);
-		System *system = hashMapGetData(systemRegistry, systemName);
-
-		if (!system)
-		{
-			LOG("System %s doesn't exist in system registry\n",
-				systemName->string);
-			continue;
-		}
-
-		systemRun(scene, system, dt);
-	}
+	schedulerRunSystems(scene, &scene->renderFrameSystems, dt);
 }
 
 void sceneRunPhysicsFrameSystems(Scene *scene, real64 dt)
 {
-	for (ListIterator itr = listGetIterator(&scene->physicsFrameSystems);
-		 !listIteratorAtEnd(itr);
-		 listMoveIterator(&itr))
-	{
-		UUID *systemName = LIST_ITERATOR_GET_ELEMENT(UUID, itr);
-		System *system = hashMapGetData(systemRegistry, systemName);
-
-		if (!system)
-		{
-			LOG("System %s doesn't exist in system registry\n",
-				systemName->string);
-			continue;
-		}
-
-		systemRun(scene, system, dt);
-	}
+	schedulerRunSystems(scene, &scene->physicsFrameSystems, dt);
 }
 
 void sceneShutdownRenderFrameSystems(Scene *scene)
@@ -1772,148 +1527,272 @@ void sceneShutdownLua(lua_State **L, Scene *scene)
 
 void sceneAddComponentType(
 	Scene *scene,
-	UUID componentID,
+	ComponentTypeHandle componentType,
 	uint32 componentSize,
 	uint32 maxComponents)
 {
+	uint32 index = HANDLE_GET_INDEX(componentType);
+
+	ASSERT(componentType != INVALID_HANDLE);
+
+	// Component types can be registered after the scene is created
+	if (index >= scene->numComponentTables)
+	{
+		scene->componentTables = realloc(
+			scene->componentTables,
+			(index + 1) * sizeof(ComponentDataTable*));
+
+		ASSERT(scene->componentTables != 0);
+
+		memset(
+			scene->componentTables + scene->numComponentTables,
+			0,
+			(index + 1 - scene->numComponentTables)
+				* sizeof(ComponentDataTable*));
+
+		scene->numComponentTables = index + 1;
+	}
+
 	ComponentDataTable *table = createComponentDataTable(
-		componentID,
+		componentTypeGetID(componentType),
 		maxComponents,
 		componentSize);
 
 	ASSERT(table);
 
-	hashMapInsert(scene->componentTypes, &componentID, &table);
+	scene->componentTables[index] = table;
 
-	ASSERT(hashMapGetData(scene->componentTypes, &componentID));
-	ASSERT(table == *(ComponentDataTable **)
-		hashMapGetData(
-			scene->componentTypes,
-			&componentID));
+	ASSERT(sceneGetComponentDataTable(scene, componentType) == table);
 }
 
-void sceneRemoveComponentType(Scene *scene, UUID componentID)
+void sceneRemoveComponentType(
+	Scene *scene,
+	ComponentTypeHandle componentType)
 {
 	// Iterate over every entity
-	HashMapIterator itr = hashMapGetIterator(scene->entities);
-	while (!hashMapIteratorAtEnd(itr))
+	InternTableIterator itr = internTableGetIterator(scene->entities);
+	while (!internTableIteratorAtEnd(itr))
 	{
-		// Iterate over every component type in the entity
-		ListIterator litr = listGetIterator(
-			(List *)hashMapIteratorGetValue(itr));
-		while (!listIteratorAtEnd(litr))
+		// Remove this component type from the entity
+		signatureRemoveComponentType(
+			(ComponentSignature *)internTableIteratorGetData(itr),
+			componentType);
+
+		internTableMoveIterator(&itr);
+	}
+
+	// Delete the component data table
+	if (sceneGetComponentDataTable(scene, componentType))
+	{
+		freeComponentDataTable(
+			&scene->componentTables[HANDLE_GET_INDEX(componentType)]);
+	}
+
+	// No entity can match a query which needs the removed component type
+	for (uint32 i = 0; i < scene->numQueries; i++)
+	{
+		if (queryHasComponentType(scene->queries[i], componentType))
 		{
-			// Remove this component from that entity
-			if (!strcmp(
-				LIST_ITERATOR_GET_ELEMENT(UUID, litr)->string,
-				componentID.string))
-			{
-				listRemove((List *)hashMapIteratorGetValue(itr), &litr);
-			}
-			listMoveIterator(&litr);
+			queryClear(scene->queries[i]);
 		}
+	}
+}
+
+inline
+ComponentDataTable *sceneGetComponentDataTable(
+	Scene *scene,
+	ComponentTypeHandle componentType)
+{
+	uint32 index = HANDLE_GET_INDEX(componentType);
 
-		hashMapMoveIterator(&itr);
+	if (index >= scene->numComponentTables)
+	{
+		return NULL;
 	}
 
-	// Delete the component data table
-	ComponentDataTable **temp = (ComponentDataTable **)hashMapGetData(
-		scene->componentTypes,
-		&componentID);
+	return scene->componentTables[index];
+}
+
+Query *sceneGetQuery(
+	Scene *scene,
+	uint32 numComponentTypes,
+	ComponentTypeHandle *componentTypes)
+{
+	for (uint32 i = 0; i < scene->numQueries; i++)
+	{
+		Query *query = scene->queries[i];
+
+		if (query->numComponentTypes == numComponentTypes
+			&& !memcmp(
+				query->componentTypes,
+				componentTypes,
+				numComponentTypes * sizeof(ComponentTypeHandle)))
+		{
+			return query;
+		}
+	}
+
+	Query *query = createQuery(numComponentTypes, componentTypes);
 
-	if (temp)
+	if (!query)
 	{
-		freeComponentDataTable(temp);
+		return NULL;
 	}
+
+	scene->queries = realloc(
+		scene->queries,
+		(scene->numQueries + 1) * sizeof(Query*));
+
+	ASSERT(scene->queries != 0);
+
+	scene->queries[scene->numQueries++] = query;
+
+	queryRefresh(query, scene);
+
+	return query;
 }
 
-void sceneRegisterEntity(Scene *s, UUID newEntity)
+EntityHandle sceneRegisterEntity(Scene *s, UUID newEntity)
 {
 #ifdef _DEBUG
-	List *entityList;
-	if ((entityList = hashMapGetData(s->entities, &newEntity)))
+	EntityHandle existingEntity = internTableGetHandle(s->entities, newEntity);
+	if (existingEntity != INVALID_HANDLE)
 	{
-		LOG("ERROR: Entity %s already exists in scene %s\n",
+		LOG_ERROR("Entity %s already exists in scene %s\n",
 			newEntity.string,
 			s->name);
 
-		listClear(entityList);
-		hashMapDelete(s->entities, &newEntity);
+		internTableRemove(s->entities, existingEntity);
 
 		ASSERT(false);
 	}
 #endif
 
-	List emptyList = createList(sizeof(UUID));
-	hashMapInsert(s->entities, &newEntity, &emptyList);
+	s->entitiesGeneration++;
+
+	// New entities start with an empty signature
+	return internTableInsert(s->entities, newEntity);
 }
 
-UUID sceneCreateEntity(Scene *s)
+EntityHandle sceneCreateEntity(Scene *s)
 {
-	UUID newEntity = generateUUID();
-	sceneRegisterEntity(s, newEntity);
-	return newEntity;
+	// Most entities created at runtime are never referred to by UUID, so
+	// they only get one once sceneGetEntityID is called on them
+	s->entitiesGeneration++;
+	return internTableInsertAnonymous(s->entities);
 }
 
-void sceneRemoveEntityComponents(Scene *s, UUID entity)
+void sceneRemoveEntityComponents(Scene *s, EntityHandle entity)
 {
-	List *entityComponentList = hashMapGetData(s->entities, &entity);
+	ComponentSignature *signature = sceneGetEntitySignature(s, entity);
 
-	if (!entityComponentList)
+	if (!signature)
 	{
 		return;
 	}
 
-	// For each component type
-	while (entityComponentList->front)
+	// Removing a component can remove others, so always restart from the
+	// first component type which is left
+	for (uint32 i = signatureGetNextIndex(signature, 0);
+		 i < MAX_COMPONENT_TYPES;
+		 i = signatureGetNextIndex(signature, 0))
 	{
-		sceneRemoveComponentFromEntity(
-			s,
-			entity,
-			*(UUID *)entityComponentList->front->data);
-	}
+		ComponentTypeHandle componentType = componentTypeFromIndex(i);
+
+		sceneRemoveComponentFromEntity(s, entity, componentType);
 
-	// Clear component list
-	listClear(entityComponentList);
+		// Component types without a table in the scene are left set
+		signatureRemoveComponentType(signature, componentType);
+	}
 }
 
-void sceneRemoveEntity(Scene *s, UUID entity)
+void sceneRemoveEntity(Scene *s, EntityHandle entity)
 {
 	sceneRemoveEntityComponents(s, entity);
-	hashMapDelete(s->entities, &entity);
+	internTableRemove(s->entities, entity);
+	s->entitiesGeneration++;
+}
+
+inline
+EntityHandle sceneGetEntity(Scene *s, UUID entity)
+{
+	return internTableGetHandle(s->entities, entity);
+}
+
+UUID sceneGetEntityID(Scene *s, EntityHandle entity)
+{
+	UUID *entityID = internTableGetID(s->entities, entity);
+
+	if (!entityID)
+	{
+		UUID emptyID = {};
+		return emptyID;
+	}
+
+	if (!strcmp(entityID->string, ""))
+	{
+		internTableSetID(s->entities, entity, generateUUID());
+	}
+
+	return *entityID;
+}
+
+inline
+bool sceneEntityExists(Scene *s, EntityHandle entity)
+{
+	return internTableIsValid(s->entities, entity);
+}
+
+inline
+ComponentSignature *sceneGetEntitySignature(Scene *s, EntityHandle entity)
+{
+	return internTableGetData(s->entities, entity);
+}
+
+bool sceneEntityHasComponentTypes(
+	Scene *s,
+	EntityHandle entity,
+	ComponentSignature const *componentTypes)
+{
+	ComponentSignature *signature = sceneGetEntitySignature(s, entity);
+
+	return signature && signatureContains(signature, componentTypes);
 }
 
 int32 sceneAddComponentToEntity(
 	Scene *s,
-	UUID entity,
-	UUID componentType,
+	EntityHandle entity,
+	ComponentTypeHandle componentType,
 	void *componentData)
 {
-	// LOG("Adding %s component to entity with id %s\n",
-	// 	componentType.string,
-	// 	entity.string);
-
 	// Get the data table
-	ComponentDataTable **dataTable = hashMapGetData(
-		s->componentTypes,
-		&componentType);
+	ComponentDataTable *dataTable = sceneGetComponentDataTable(
+		s,
+		componentType);
+
+	if (!dataTable)
+	{
+		return -1;
+	}
+
+	ComponentSignature *signature = sceneGetEntitySignature(s, entity);
 
-	if (!dataTable || !*dataTable)
+	if (!signature)
 	{
 		return -1;
 	}
 
-	List *l = hashMapGetData(s->entities, &entity);
+	const char *componentName = dataTable->componentID.string;
 
-	if (!strcmp(componentType.string, "transform"))
+	if (!strcmp(componentName, "transform"))
 	{
 		((TransformComponent*)componentData)->dirty = true;
 	}
-	if (!strcmp(componentType.string, "model"))
+	if (!strcmp(componentName, "model"))
 	{
 		loadModel(((ModelComponent*)componentData)->name);
 	}
-	else if (!strcmp(componentType.string, "font"))
+	else if (!strcmp(componentName, "font"))
 	{
 		FontComponent *fontComponent = (FontComponent*)componentData;
 		loadFont(
@@ -1921,16 +1800,22 @@ int32 sceneAddComponentToEntity(
 			fontComponent->size,
 			fontComponent->autoScaling);
 	}
-	else if (!strcmp(componentType.string, "image"))
+	else if (!strcmp(componentName, "image"))
 	{
 		ImageComponent *imageComponent = (ImageComponent*)componentData;
 		loadImage(imageComponent->name, imageComponent->textureFiltering);
 	}
-	else if (!strcmp(componentType.string, "cubemap"))
+	else if (!strcmp(componentName, "cubemap"))
 	{
 		loadCubemap(((CubemapComponent*)componentData)->name);
 	}
-	else if (!strcmp(componentType.string, "button"))
+	else if (!strcmp(componentName, "particle_emitter"))
+	{
+		// Particle emitters are keyed by entity UUID, so the UUID has to
+		// exist before the particle simulator looks it up on other threads
+		sceneGetEntityID(s, entity);
+	}
+	else if (!strcmp(componentName, "button"))
 	{
 		ButtonComponent *buttonComponent = (ButtonComponent*)componentData;
 		buttonComponent->pressed = false;
@@ -1941,38 +1826,73 @@ int32 sceneAddComponentToEntity(
 
 	// Add the component to the data table
 	if (cdtInsert(
-		   *dataTable,
+		   dataTable,
 		   entity,
 		   componentData) == -1)
 	{
 		return -1;
 	}
 
-	if (listContains(l, &componentType))
+	if (signatureHasComponentType(signature, componentType))
 	{
-		LOG("WARNING: Overwriting component data of %s on entity %s\n",
-			componentType.string,
-			entity.string);
+		LOG_WARNING("Overwriting component data of %s on entity %s\n",
+			componentName,
+			sceneGetEntityID(s, entity).string);
 	}
 	else
 	{
-		// Add the component type to the list
-		listPushBack(l, &componentType);
+		signatureAddComponentType(signature, componentType);
+
+		for (uint32 i = 0; i < s->numQueries; i++)
+		{
+			Query *query = s->queries[i];
+
+			if (queryHasComponentType(query, componentType)
+				&& queryMatchesEntity(query, s, entity))
+			{
+				queryAddEntity(query, entity);
+			}
+		}
 	}
 
 	return 0;
 }
 
+internal
+void moveComponent(
+	Scene *s,
+	EntityHandle entity,
+	const char *componentName,
+	void *component,
+	void *newComponent)
+{
+	// Anything which is keyed by a component pointer has to follow the
+	// component when it moves
+	if (!strcmp(componentName, "animator"))
+	{
+		moveAnimator(component, newComponent);
+	}
+	else if (!strcmp(componentName, "audio_source"))
+	{
+		moveAudioSource(component, newComponent);
+	}
+	else if (!strcmp(componentName, "particle_emitter"))
+	{
+		moveParticleEmitter(
+			sceneGetEntityID(s, entity),
+			component,
+			newComponent);
+	}
+}
+
 void sceneRemoveComponentFromEntity(
 	Scene *s,
-	UUID entity,
-	UUID componentType)
+	EntityHandle entity,
+	ComponentTypeHandle componentType)
 {
-	ComponentDataTable **table = hashMapGetData(
-		s->componentTypes,
-		&componentType);
+	ComponentDataTable *table = sceneGetComponentDataTable(s, componentType);
 
-	if (!table || !*table)
+	if (!table)
 	{
 		return;
 	}
@@ -1981,93 +1901,191 @@ void sceneRemoveComponentFromEntity(
 	//               cleanup function, but we can't have that with how
 	//               we load components.
 
+	const char *componentName = table->componentID.string;
+
 	// Check to ensure that the component has been properly freed
-	if (!strcmp(componentType.string, "transform"))
+	if (!strcmp(componentName, "transform"))
 	{
 		if (removeTransform(
 			s,
 			entity,
-			(TransformComponent*)cdtGet(*table, entity)) == -1)
+			(TransformComponent*)cdtGet(table, entity)) == -1)
 		{
 			ASSERT(false);
 		}
 	}
-	else if (!strcmp(componentType.string, "animator"))
+	else if (!strcmp(componentName, "animator"))
 	{
-		removeAnimator((AnimatorComponent*)cdtGet(*table, entity));
+		removeAnimator((AnimatorComponent*)cdtGet(table, entity));
 	}
-	else if (!strcmp(componentType.string, "rigid_body"))
+	else if (!strcmp(componentName, "rigid_body"))
 	{
-		sceneRemoveComponentFromEntity(s, entity, idFromName("collision"));
-		destroyRigidBody((RigidBodyComponent*)cdtGet(*table, entity));
+		removeRigidBody(
+			s,
+			entity,
+			(RigidBodyComponent*)cdtGet(table, entity));
 	}
-	else if (!strcmp(componentType.string, "collision"))
+	else if (!strcmp(componentName, "collision"))
 	{
 		removeCollisionComponent(
 			s,
-			(CollisionComponent*)cdtGet(*table, entity));
+			(CollisionComponent*)cdtGet(table, entity));
 	}
-	else if (!strcmp(componentType.string, "collision_tree_node"))
+	else if (!strcmp(componentName, "collision_tree_node"))
 	{
 		removeCollisionTreeNode(
 			s,
 			entity,
-			(CollisionTreeNodeComponent*)cdtGet(*table, entity));
+			(CollisionTreeNodeComponent*)cdtGet(table, entity));
 	}
-	else if (!strcmp(componentType.string, "panel"))
+	else if (!strcmp(componentName, "panel"))
 	{
-		removePanelWidgets(s, (PanelComponent*)cdtGet(*table, entity));
+		removePanelWidgets(s, (PanelComponent*)cdtGet(table, entity));
 	}
-	else if (!strcmp(componentType.string, "widget"))
+	else if (!strcmp(componentName, "widget"))
 	{
 		removeWidget(s, entity);
 	}
-	else if (!strcmp(componentType.string, "particle_emitter"))
+	else if (!strcmp(componentName, "particle_emitter"))
 	{
 		removeParticleEmitter(
-			entity,
-			(ParticleEmitterComponent*)cdtGet(*table, entity));
+			sceneGetEntityID(s, entity),
+			(ParticleEmitterComponent*)cdtGet(table, entity));
+	}
+
+	void *component = cdtGet(table, entity);
+	EntityHandle lastEntity = INVALID_HANDLE;
+	void *lastComponent = NULL;
+
+	if (component)
+	{
+		lastEntity = cdtGetIndexEntity(table, table->numComponents - 1);
+		lastComponent = cdtGetIndexData(table, table->numComponents - 1);
 	}
-	cdtRemove(*table, entity);
 
-	List *componentTypeList = hashMapGetData(s->entities, &entity);
+	cdtRemove(table, entity);
 
-	if (!componentTypeList)
+	if (component)
+	{
+		for (uint32 i = 0; i < s->numQueries; i++)
+		{
+			if (queryHasComponentType(s->queries[i], componentType))
+			{
+				queryRemoveEntity(s->queries[i], entity);
+			}
+		}
+	}
+
+	// The last component in the table was moved into the removed slot
+	if (component && component != lastComponent)
+	{
+		moveComponent(s, lastEntity, componentName, lastComponent, component);
+	}
+
+	ComponentSignature *signature = sceneGetEntitySignature(s, entity);
+
+	if (!signature)
 	{
 		return;
 	}
 
-	listRemoveData(componentTypeList, &componentType);
+	signatureRemoveComponentType(signature, componentType);
 }
 
-void sceneRemoveComponentFromAllEntities(Scene *scene, UUID componentID)
+void sceneRemoveComponentFromAllEntities(
+	Scene *scene,
+	ComponentTypeHandle componentType)
 {
-	for (HashMapIterator itr = hashMapGetIterator(scene->entities);
-		 !hashMapIteratorAtEnd(itr);
-		 hashMapMoveIterator(&itr))
+	for (InternTableIterator itr = internTableGetIterator(scene->entities);
+		 !internTableIteratorAtEnd(itr);
+		 internTableMoveIterator(&itr))
 	{
 		sceneRemoveComponentFromEntity(
 			scene,
-			*(UUID*)hashMapIteratorGetKey(itr),
-			componentID);
+			internTableIteratorGetHandle(itr),
+			componentType);
 	}
 }
 
 void *sceneGetComponentFromEntity(
 	Scene *s,
-	UUID entity,
-	UUID componentType)
+	EntityHandle entity,
+	ComponentTypeHandle componentType)
 {
-	ComponentDataTable **table = hashMapGetData(
-		s->componentTypes,
-		&componentType);
+	ComponentDataTable *table = sceneGetComponentDataTable(s, componentType);
 
-	if (!table || !*table)
+	if (!table)
 	{
 		return 0;
 	}
 
-	return cdtGet(*table, entity);
+	return cdtGet(table, entity);
+}
+
+EntityHandle sceneDeferRegisterEntity(Scene *s, UUID newEntity)
+{
+	EntityHandle entity = internTableReserve(s->entities);
+
+	if (entity != INVALID_HANDLE)
+	{
+		commandBufferRegisterEntity(s->commandBuffer, entity, newEntity);
+	}
+
+	return entity;
+}
+
+inline
+EntityHandle sceneDeferCreateEntity(Scene *s)
+{
+	// Like sceneCreateEntity, the entity only gets a UUID if it needs one
+	return internTableReserve(s->entities);
+}
+
+inline
+void sceneDeferRemoveEntity(Scene *s, EntityHandle entity)
+{
+	commandBufferRemoveEntity(s->commandBuffer, entity);
+}
+
+int32 sceneDeferAddComponentToEntity(
+	Scene *s,
+	EntityHandle entity,
+	ComponentTypeHandle componentType,
+	void *componentData)
+{
+	ComponentDataTable *table = sceneGetComponentDataTable(s, componentType);
+
+	if (!table)
+	{
+		return -1;
+	}
+
+	commandBufferAddComponentToEntity(
+		s->commandBuffer,
+		entity,
+		componentType,
+		componentData,
+		table->componentSize);
+
+	return 0;
+}
+
+inline
+void sceneDeferRemoveComponentFromEntity(
+	Scene *s,
+	EntityHandle entity,
+	ComponentTypeHandle componentType)
+{
+	commandBufferRemoveComponentFromEntity(
+		s->commandBuffer,
+		entity,
+		componentType);
+}
+
+inline
+void sceneApplyCommands(Scene *s)
+{
+	commandBufferApply(s->commandBuffer, s);
 }
 
 inline
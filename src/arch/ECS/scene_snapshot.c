@@ -0,0 +1,1427 @@
+#include "ECS/scene_snapshot.h"
+#include "ECS/component.h"
+#include "ECS/scene.h"
+
+#include "core/config.h"
+#include "core/log.h"
+
+#include "data/data_types.h"
+#include "data/hash_map.h"
+#include "data/intern_table.h"
+
+#include "file/mapped_file.h"
+
+#include <malloc.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SNAPSHOT_HASH_SEED 14695981039346656037ULL
+#define SNAPSHOT_HASH_MULTIPLIER 0x9E3779B97F4A7C15ULL
+
+extern Config config;
+
+typedef struct loaded_snapshot_table_t
+{
+	const char *name;
+	uint32 componentSize;
+	uint32 numComponents;
+	uint32 chunkSize;
+	uint32 numChunks;
+	uint32 chunkCapacity;
+	// Latest version of each chunk, and the record it's from
+	const SceneSnapshotChunk **chunks;
+	uint32 *chunkRecords;
+} LoadedSnapshotTable;
+
+internal SceneSnapshotTableState* hashSnapshotTables(
+	const SceneSnapshotCopy *copy);
+internal uint64 hashSnapshotData(const void *data, uint64 size, uint64 hash);
+internal void freeSnapshotTableStates(
+	SceneSnapshotTableState *tableStates,
+	uint32 numTables);
+internal void clearSceneSnapshotState(SceneSnapshotState *state);
+
+internal uint32 getSnapshotChunkSize(
+	const SceneSnapshotTableCopy *table,
+	uint32 chunk);
+internal void clearSceneSnapshotState(SceneSnapshotState *state)
+{
+	freeSnapshotTableStates(state->tables, state->numTables);
+	free(state->filename);
+	memset(state, 0, sizeof(SceneSnapshotState));
+}
+
+uint32 getSnapshotChunkSize(const SceneSnapshotTableCopy *table, uint32 chunk)
+{
+	return MIN(
+		1u << table->chunkShift,
+		table->numComponents - (chunk << table->chunkShift));
+}
+
+bool isSnapshotChunkUnchanged(
+	const SceneSnapshotTableState *previousTableState,
+	const SceneSnapshotTableState *tableState,
+	uint32 chunk);
+internal uint32 getSnapshotComponentDefinition(
+	const SceneSnapshotCopy *copy,
+	const char *componentName);
+internal uint32 addSnapshotString(
+	const char *string,
+	char **strings,
+	uint64 *stringsSize);
+
+internal bool readSnapshotRecord(
+	const MappedFile *file,
+	uint64 offset,
+	SceneSnapshot *snapshot,
+	SceneSnapshotRecord *record);
+internal bool isSnapshotBlockValid(
+	uint64 recordSize,
+	uint64 offset,
+	uint64 size,
+	uint64 alignment);
+
+internal LoadedSnapshotTable* getLoadedSnapshotTable(
+	LoadedSnapshotTable **tables,
+	uint32 *numTables,
+	const char *name);
+internal EntityHandle* getSnapshotRecordEntities(
+	Scene *scene,
+	const SceneSnapshot *snapshot,
+	EntityHandle **recordEntities,
+	uint32 record);
+internal char* copySnapshotString(
+	const SceneSnapshotRecord *record,
+	uint32 stringOffset);
+
+internal int32 writePadding(FILE *file, uint64 *offset, uint64 alignment);
+
+SceneSnapshotCopy* copySceneSnapshot(Scene *scene)
+{
+	SceneSnapshotCopy *copy = calloc(1, sizeof(SceneSnapshotCopy));
+
+	copy->sceneName = malloc(strlen(scene->name) + 1);
+	strcpy(copy->sceneName, scene->name);
+
+	copy->entitiesGeneration = scene->entitiesGeneration;
+	copy->numEntitySlots = scene->entities->numSlots;
+	copy->entityHandles = malloc(
+		MAX(scene->entities->count, 1) * sizeof(EntityHandle));
+	copy->entities = malloc(MAX(scene->entities->count, 1) * sizeof(UUID));
+
+	for (InternTableIterator itr = internTableGetIterator(scene->entities);
+		 !internTableIteratorAtEnd(itr);
+		 internTableMoveIterator(&itr))
+	{
+		EntityHandle entity = internTableIteratorGetHandle(itr);
+
+		copy->entityHandles[copy->numEntities] = entity;
+		copy->entities[copy->numEntities++] = sceneGetEntityID(scene, entity);
+	}
+
+	if (scene->componentDefinitions)
+	{
+		for (HashMapIterator itr =
+				 hashMapGetIterator(scene->componentDefinitions);
+			 !hashMapIteratorAtEnd(itr);
+			 hashMapMoveIterator(&itr))
+		{
+			ComponentDefinition *componentDefinition =
+				(ComponentDefinition*)hashMapIteratorGetValue(itr);
+
+			copy->numComponentDefinitions++;
+			copy->numValueDefinitions += componentDefinition->numValues;
+		}
+	}
+
+	copy->componentDefinitions = calloc(
+		MAX(copy->numComponentDefinitions, 1),
+		sizeof(SceneSnapshotComponentDefinition));
+	copy->valueDefinitions = calloc(
+		MAX(copy->numValueDefinitions, 1),
+		sizeof(SceneSnapshotValueDefinition));
+
+	uint32 numComponentDefinitions = 0;
+	uint32 numValueDefinitions = 0;
+
+	if (scene->componentDefinitions)
+	{
+		for (HashMapIterator itr =
+				 hashMapGetIterator(scene->componentDefinitions);
+			 !hashMapIteratorAtEnd(itr);
+			 hashMapMoveIterator(&itr))
+		{
+			ComponentDefinition *componentDefinition =
+				(ComponentDefinition*)hashMapIteratorGetValue(itr);
+			SceneSnapshotComponentDefinition *snapshotComponentDefinition =
+				&copy->componentDefinitions[numComponentDefinitions++];
+
+			snapshotComponentDefinition->nameOffset = addSnapshotString(
+				componentDefinition->name,
+				&copy->strings,
+				&copy->stringsSize);
+			snapshotComponentDefinition->size = componentDefinition->size;
+			snapshotComponentDefinition->firstValue = numValueDefinitions;
+			snapshotComponentDefinition->numValues =
+				componentDefinition->numValues;
+
+			for (uint32 i = 0; i < componentDefinition->numValues; i++)
+			{
+				ComponentValueDefinition *componentValueDefinition =
+					&componentDefinition->values[i];
+				SceneSnapshotValueDefinition *snapshotValueDefinition =
+					&copy->valueDefinitions[numValueDefinitions++];
+
+				snapshotValueDefinition->nameOffset = addSnapshotString(
+					componentValueDefinition->name,
+					&copy->strings,
+					&copy->stringsSize);
+				snapshotValueDefinition->type = componentValueDefinition->type;
+				snapshotValueDefinition->maxStringSize =
+					componentValueDefinition->maxStringSize;
+				snapshotValueDefinition->count =
+					componentValueDefinition->count;
+			}
+		}
+	}
+
+	copy->numTables = scene->numComponentTables;
+	copy->tables = calloc(
+		MAX(scene->numComponentTables, 1),
+		sizeof(SceneSnapshotTableCopy*));
+
+	for (uint32 i = 0; i < scene->numComponentTables; i++)
+	{
+		ComponentDataTable *table = scene->componentTables[i];
+
+		if (!table)
+		{
+			continue;
+		}
+
+		SceneSnapshotTableCopy *tableCopy =
+			malloc(sizeof(SceneSnapshotTableCopy));
+		copy->tables[i] = tableCopy;
+
+		tableCopy->componentDefinition = getSnapshotComponentDefinition(
+			copy,
+			table->componentID.string);
+		tableCopy->componentSize = table->componentSize;
+		tableCopy->numComponents = table->numComponents;
+		tableCopy->chunkShift = table->chunkShift;
+
+		tableCopy->entities = malloc(
+			MAX(table->numComponents, 1) * sizeof(EntityHandle));
+		memcpy(
+			tableCopy->entities,
+			table->entities,
+			table->numComponents * sizeof(EntityHandle));
+
+		// Chunks are dense, so the table is copied a chunk at a time
+		tableCopy->data = malloc(
+			MAX((uint64)table->numComponents * table->componentSize, 1));
+
+		uint32 numChunkComponents;
+		void *chunkData;
+
+		for (uint32 j = 0;
+			 (chunkData = cdtGetChunkData(table, j, &numChunkComponents));
+			 j++)
+		{
+			memcpy(
+				tableCopy->data +
+					((uint64)j << table->chunkShift) * table->componentSize,
+				chunkData,
+				(uint64)numChunkComponents * table->componentSize);
+		}
+	}
+
+	return copy;
+}
+
+int32 writeSceneSnapshot(
+	const SceneSnapshotCopy *copy,
+	SceneSnapshotState *state,
+	const char *filename)
+{
+	bool delta = state->numRecords > 0 &&
+		!strcmp(state->filename, filename) &&
+		state->numRecords <= config.savesConfig.maxSnapshotDeltas &&
+		state->size - state->baseSize < state->baseSize;
+
+	SceneSnapshotTableState *tableStates = hashSnapshotTables(copy);
+
+	// Deltas can't remove a whole table, so rewrite the snapshot instead
+	for (uint32 i = 0; i < state->numTables && delta; i++)
+	{
+		if (state->tables[i].numComponents > 0 &&
+			(i >= copy->numTables || !copy->tables[i]))
+		{
+			delta = false;
+		}
+	}
+
+	bool writeEntities =
+		!delta || copy->entitiesGeneration != state->entitiesGeneration;
+	bool changed = writeEntities;
+
+	for (uint32 i = 0; i < copy->numTables && !changed; i++)
+	{
+		const SceneSnapshotTableState *previousTableState =
+			i < state->numTables ? &state->tables[i] : NULL;
+
+		for (uint32 j = 0; j < tableStates[i].numChunks && !changed; j++)
+		{
+			changed = !isSnapshotChunkUnchanged(
+				previousTableState,
+				&tableStates[i],
+				j);
+		}
+
+		if (previousTableState &&
+			previousTableState->numComponents != tableStates[i].numComponents)
+		{
+			changed = true;
+		}
+	}
+
+	if (!changed)
+	{
+		LOG("Scene snapshot (%s) is up to date\n", copy->sceneName);
+		freeSnapshotTableStates(tableStates, copy->numTables);
+		return 0;
+	}
+
+	LOG("Writing %s scene snapshot (%s)...\n",
+		delta ? "delta" : "full",
+		copy->sceneName);
+
+	FILE *file = fopen(filename, delta ? "r+b" : "wb");
+
+	// The snapshot was removed since it was written, so start a new one
+	if (!file && delta)
+	{
+		freeSnapshotTableStates(tableStates, copy->numTables);
+		clearSceneSnapshotState(state);
+		return writeSceneSnapshot(copy, state, filename);
+	}
+
+	if (!file)
+	{
+		LOG("Failed to open %s\n", filename);
+		freeSnapshotTableStates(tableStates, copy->numTables);
+		return -1;
+	}
+
+	int32 error = 0;
+
+	// Deltas overwrite anything left behind by a delta which failed
+	uint64 recordOffset = delta ? state->size : 0;
+	if (fseek(file, recordOffset, SEEK_SET))
+	{
+		error = -1;
+	}
+
+	SceneSnapshotHeader header = {};
+	memcpy(header.magic, SCENE_SNAPSHOT_MAGIC, sizeof(header.magic));
+	header.version = SCENE_SNAPSHOT_VERSION;
+	header.flags = delta ? SCENE_SNAPSHOT_DELTA : 0;
+
+	if (writeEntities)
+	{
+		header.flags |= SCENE_SNAPSHOT_ENTITIES;
+	}
+
+	// The header is written again once every offset is known, until then
+	// the record has no magic and won't be read
+	SceneSnapshotHeader emptyHeader = {};
+	if (error != -1 &&
+		fwrite(&emptyHeader, sizeof(SceneSnapshotHeader), 1, file) != 1)
+	{
+		error = -1;
+	}
+
+	uint64 offset = sizeof(SceneSnapshotHeader);
+
+	header.entitiesOffset = offset;
+
+	if (writeEntities)
+	{
+		header.numEntities = copy->numEntities;
+		offset += (uint64)copy->numEntities * sizeof(UUID);
+
+		if (error != -1 && copy->numEntities > 0 && fwrite(
+			copy->entities,
+			sizeof(UUID),
+			copy->numEntities,
+			file) != copy->numEntities)
+		{
+			error = -1;
+		}
+	}
+
+	// Index of each entity in the snapshot, indexed by entity handle index.
+	// The order only changes when entities are registered or removed, which
+	// is when the entities are written again.
+	uint32 *entityIndices = malloc(
+		MAX(copy->numEntitySlots, 1) * sizeof(uint32));
+
+	for (uint32 i = 0; i < copy->numEntities; i++)
+	{
+		entityIndices[HANDLE_GET_INDEX(copy->entityHandles[i])] = i;
+	}
+
+	SceneSnapshotTable *tables = calloc(
+		MAX(copy->numTables, 1),
+		sizeof(SceneSnapshotTable));
+
+	uint32 chunksCapacity = 0;
+	SceneSnapshotChunk *chunks = NULL;
+	uint32 *chunkEntities = NULL;
+
+	for (uint32 i = 0; i < copy->numTables && error != -1; i++)
+	{
+		const SceneSnapshotTableCopy *table = copy->tables[i];
+		SceneSnapshotTableState *tableState = &tableStates[i];
+		const SceneSnapshotTableState *previousTableState =
+			delta && i < state->numTables ? &state->tables[i] : NULL;
+
+		// Component limits are part of the scene, so tables are left out
+		// until they have components
+		bool wasEmpty =
+			!previousTableState || previousTableState->numComponents == 0;
+		if (!table || (table->numComponents == 0 && wasEmpty))
+		{
+			continue;
+		}
+
+		bool tableChanged = !previousTableState ||
+			previousTableState->numComponents != table->numComponents;
+
+		for (uint32 j = 0; j < tableState->numChunks && !tableChanged; j++)
+		{
+			tableChanged = !isSnapshotChunkUnchanged(
+				previousTableState,
+				tableState,
+				j);
+		}
+
+		if (!tableChanged)
+		{
+			continue;
+		}
+
+		if (table->componentDefinition == copy->numComponentDefinitions)
+		{
+			LOG_WARNING("Unable to write the components of table %u in "
+				"scene %s without their definition\n",
+				i,
+				copy->sceneName);
+
+			// Keep the table changed until it can be written
+			free(tableState->chunkHashes);
+			memset(tableState, 0, sizeof(SceneSnapshotTableState));
+
+			continue;
+		}
+
+		SceneSnapshotTable *snapshotTable = &tables[header.numTables++];
+		snapshotTable->componentDefinition = table->componentDefinition;
+		snapshotTable->numComponents = table->numComponents;
+		snapshotTable->chunkSize = 1 << table->chunkShift;
+		snapshotTable->firstChunk = header.numChunks;
+
+		chunkEntities = realloc(
+			chunkEntities,
+			snapshotTable->chunkSize * sizeof(uint32));
+
+		for (uint32 j = 0; j < tableState->numChunks; j++)
+		{
+			if (isSnapshotChunkUnchanged(previousTableState, tableState, j))
+			{
+				continue;
+			}
+
+			if (header.numChunks == chunksCapacity)
+			{
+				chunksCapacity = MAX(chunksCapacity * 2, 16);
+				chunks = realloc(
+					chunks,
+					chunksCapacity * sizeof(SceneSnapshotChunk));
+			}
+
+			uint32 first = j << table->chunkShift;
+			uint32 numChunkComponents = getSnapshotChunkSize(table, j);
+
+			SceneSnapshotChunk *chunk = &chunks[header.numChunks++];
+			chunk->index = j;
+			chunk->numComponents = numChunkComponents;
+
+			snapshotTable->numChunks++;
+
+			for (uint32 k = 0; k < numChunkComponents; k++)
+			{
+				chunkEntities[k] = entityIndices[
+					HANDLE_GET_INDEX(table->entities[first + k])];
+			}
+
+			if (writePadding(file, &offset, SCENE_SNAPSHOT_ALIGNMENT) == -1)
+			{
+				error = -1;
+				break;
+			}
+
+			chunk->entitiesOffset = offset;
+
+			if (fwrite(
+				chunkEntities,
+				sizeof(uint32),
+				numChunkComponents,
+				file) != numChunkComponents)
+			{
+				error = -1;
+				break;
+			}
+
+			offset += (uint64)numChunkComponents * sizeof(uint32);
+
+			if (writePadding(file, &offset, SCENE_SNAPSHOT_ALIGNMENT) == -1)
+			{
+				error = -1;
+				break;
+			}
+
+			chunk->dataOffset = offset;
+
+			if (table->componentSize > 0 && fwrite(
+				table->data + (uint64)first * table->componentSize,
+				table->componentSize,
+				numChunkComponents,
+				file) != numChunkComponents)
+			{
+				error = -1;
+				break;
+			}
+
+			offset += (uint64)numChunkComponents * table->componentSize;
+		}
+	}
+
+	if (error != -1)
+	{
+		error = writePadding(file, &offset, SCENE_SNAPSHOT_ALIGNMENT);
+	}
+
+	if (error != -1)
+	{
+		header.numComponentDefinitions = copy->numComponentDefinitions;
+		header.numValueDefinitions = copy->numValueDefinitions;
+
+		header.componentDefinitionsOffset = offset;
+		header.valueDefinitionsOffset =
+			header.componentDefinitionsOffset +
+			header.numComponentDefinitions *
+				sizeof(SceneSnapshotComponentDefinition);
+		header.chunksOffset =
+			header.valueDefinitionsOffset +
+			header.numValueDefinitions * sizeof(SceneSnapshotValueDefinition);
+		header.tablesOffset =
+			header.chunksOffset + header.numChunks * sizeof(SceneSnapshotChunk);
+		header.stringsOffset =
+			header.tablesOffset + header.numTables * sizeof(SceneSnapshotTable);
+
+		offset = header.stringsOffset + copy->stringsSize;
+
+		if (fwrite(
+				copy->componentDefinitions,
+				sizeof(SceneSnapshotComponentDefinition),
+				header.numComponentDefinitions,
+				file) != header.numComponentDefinitions ||
+			fwrite(
+				copy->valueDefinitions,
+				sizeof(SceneSnapshotValueDefinition),
+				header.numValueDefinitions,
+				file) != header.numValueDefinitions ||
+			(header.numChunks > 0 && fwrite(
+				chunks,
+				sizeof(SceneSnapshotChunk),
+				header.numChunks,
+				file) != header.numChunks) ||
+			fwrite(
+				tables,
+				sizeof(SceneSnapshotTable),
+				header.numTables,
+				file) != header.numTables ||
+			(copy->stringsSize > 0 && fwrite(
+				copy->strings,
+				1,
+				copy->stringsSize,
+				file) != copy->stringsSize) ||
+			writePadding(file, &offset, SCENE_SNAPSHOT_ALIGNMENT) == -1)
+		{
+			error = -1;
+		}
+	}
+
+	if (error != -1)
+	{
+		header.size = offset;
+
+		fseek(file, recordOffset, SEEK_SET);
+		if (fwrite(&header, sizeof(SceneSnapshotHeader), 1, file) != 1)
+		{
+			error = -1;
+		}
+	}
+
+	fclose(file);
+
+	free(chunkEntities);
+	free(chunks);
+	free(tables);
+	free(entityIndices);
+
+	if (error == -1)
+	{
+		LOG("Failed to write scene snapshot to %s\n", filename);
+		freeSnapshotTableStates(tableStates, copy->numTables);
+
+		if (!delta)
+		{
+			remove(filename);
+			clearSceneSnapshotState(state);
+		}
+
+		return -1;
+	}
+
+	freeSnapshotTableStates(state->tables, state->numTables);
+
+	if (!delta)
+	{
+		free(state->filename);
+		state->filename = malloc(strlen(filename) + 1);
+		strcpy(state->filename, filename);
+
+		state->numRecords = 0;
+		state->baseSize = header.size;
+	}
+
+	state->numRecords++;
+	state->size = recordOffset + header.size;
+	state->entitiesGeneration = copy->entitiesGeneration;
+	state->numTables = copy->numTables;
+	state->tables = tableStates;
+
+	LOG("Successfully wrote scene snapshot (%s)\n", copy->sceneName);
+
+	return 0;
+}
+
+void freeSceneSnapshotCopy(SceneSnapshotCopy **copy)
+{
+	if (!*copy)
+	{
+		return;
+	}
+
+	for (uint32 i = 0; i < (*copy)->numTables; i++)
+	{
+		SceneSnapshotTableCopy *table = (*copy)->tables[i];
+		if (table)
+		{
+			free(table->entities);
+			free(table->data);
+			free(table);
+		}
+	}
+
+	free((*copy)->tables);
+	free((*copy)->strings);
+	free((*copy)->valueDefinitions);
+	free((*copy)->componentDefinitions);
+	free((*copy)->entities);
+	free((*copy)->entityHandles);
+	free((*copy)->sceneName);
+	free(*copy);
+
+	*copy = NULL;
+}
+
+int32 openSceneSnapshot(const char *filename, SceneSnapshot *snapshot)
+{
+	memset(snapshot, 0, sizeof(SceneSnapshot));
+
+	MappedFile file;
+	if (mapFile(filename, &file) == -1)
+	{
+		return -1;
+	}
+
+	const SceneSnapshotHeader *header = (SceneSnapshotHeader*)file.data;
+
+	if (file.size < sizeof(SceneSnapshotHeader) ||
+		memcmp(header->magic, SCENE_SNAPSHOT_MAGIC, sizeof(header->magic)))
+	{
+		LOG("%s is not a scene snapshot\n", filename);
+		unmapFile(&file);
+		return -1;
+	}
+
+	if (header->version != SCENE_SNAPSHOT_VERSION)
+	{
+		LOG_WARNING("%s out of date\n", filename);
+		unmapFile(&file);
+		return -1;
+	}
+
+	uint64 offset = 0;
+	uint32 recordsCapacity = 0;
+
+	while (offset < file.size)
+	{
+		SceneSnapshotRecord record = {};
+		if (!readSnapshotRecord(&file, offset, snapshot, &record))
+		{
+			if (snapshot->numRecords > 0)
+			{
+				LOG_WARNING("Ignoring the end of %s, "
+					"which was only partially written\n",
+					filename);
+				break;
+			}
+
+			LOG("Corrupt scene snapshot in %s\n", filename);
+			free(snapshot->records);
+			memset(snapshot, 0, sizeof(SceneSnapshot));
+			unmapFile(&file);
+			return -1;
+		}
+
+		if (snapshot->numRecords == recordsCapacity)
+		{
+			recordsCapacity = MAX(recordsCapacity * 2, 4);
+			snapshot->records = realloc(
+				snapshot->records,
+				recordsCapacity * sizeof(SceneSnapshotRecord));
+		}
+
+		snapshot->records[snapshot->numRecords++] = record;
+		offset += record.header->size;
+	}
+
+	snapshot->filename = malloc(strlen(filename) + 1);
+	strcpy(snapshot->filename, filename);
+	snapshot->file = file;
+	snapshot->baseSize = snapshot->records[0].header->size;
+	snapshot->size = offset;
+
+	return 0;
+}
+
+void closeSceneSnapshot(SceneSnapshot *snapshot)
+{
+	unmapFile(&snapshot->file);
+	free(snapshot->records);
+	free(snapshot->filename);
+	memset(snapshot, 0, sizeof(SceneSnapshot));
+}
+
+void loadSceneSnapshotComponentDefinitions(
+	Scene *scene,
+	const SceneSnapshot *snapshot)
+{
+	scene->componentDefinitions = createHashMap(
+		sizeof(UUID),
+		sizeof(ComponentDefinition),
+		COMPONENT_DEFINITION_BUCKETS,
+		(ComparisonOp)&strcmp);
+
+	// Every record has all of the definitions, so use the latest ones
+	const SceneSnapshotRecord *record =
+		&snapshot->records[snapshot->numRecords - 1];
+
+	for (uint32 i = 0; i < record->header->numComponentDefinitions; i++)
+	{
+		const SceneSnapshotComponentDefinition *snapshotComponentDefinition =
+			&record->componentDefinitions[i];
+
+		ComponentDefinition componentDefinition = {};
+
+		componentDefinition.name = copySnapshotString(
+			record,
+			snapshotComponentDefinition->nameOffset);
+		componentDefinition.size = snapshotComponentDefinition->size;
+		componentDefinition.numValues = snapshotComponentDefinition->numValues;
+		componentDefinition.values = calloc(
+			componentDefinition.numValues,
+			sizeof(ComponentValueDefinition));
+
+		for (uint32 j = 0; j < componentDefinition.numValues; j++)
+		{
+			const SceneSnapshotValueDefinition *snapshotValueDefinition =
+				&record->valueDefinitions[
+					snapshotComponentDefinition->firstValue + j];
+			ComponentValueDefinition *componentValueDefinition =
+				&componentDefinition.values[j];
+
+			componentValueDefinition->name = copySnapshotString(
+				record,
+				snapshotValueDefinition->nameOffset);
+			componentValueDefinition->type =
+				(DataType)snapshotValueDefinition->type;
+			componentValueDefinition->maxStringSize =
+				snapshotValueDefinition->maxStringSize;
+			componentValueDefinition->count = snapshotValueDefinition->count;
+		}
+
+		UUID componentID = idFromName(componentDefinition.name);
+		hashMapInsert(
+			scene->componentDefinitions,
+			&componentID,
+			&componentDefinition);
+	}
+}
+
+void loadSceneSnapshotEntities(Scene *scene, const SceneSnapshot *snapshot)
+{
+	const SceneSnapshotRecord *entitiesRecord = &snapshot->records[
+		snapshot->records[snapshot->numRecords - 1].entitiesRecord];
+
+	// Handles of the entities of each record which has them, the older
+	// records are only resolved if chunks which are still used refer to them
+	EntityHandle **recordEntities = calloc(
+		snapshot->numRecords,
+		sizeof(EntityHandle*));
+	EntityHandle *entities = malloc(
+		MAX(entitiesRecord->header->numEntities, 1) * sizeof(EntityHandle));
+
+	for (uint32 i = 0; i < entitiesRecord->header->numEntities; i++)
+	{
+		entities[i] = sceneRegisterEntity(scene, entitiesRecord->entities[i]);
+	}
+
+	recordEntities[entitiesRecord - snapshot->records] = entities;
+
+	// Replay the records to find the latest version of every chunk
+	uint32 numTables = 0;
+	LoadedSnapshotTable *tables = NULL;
+
+	for (uint32 i = 0; i < snapshot->numRecords; i++)
+	{
+		const SceneSnapshotRecord *record = &snapshot->records[i];
+
+		for (uint32 j = 0; j < record->header->numTables; j++)
+		{
+			const SceneSnapshotTable *table = &record->tables[j];
+			const SceneSnapshotComponentDefinition *componentDefinition =
+				&record->componentDefinitions[table->componentDefinition];
+
+			LoadedSnapshotTable *loadedTable = getLoadedSnapshotTable(
+				&tables,
+				&numTables,
+				record->strings + componentDefinition->nameOffset);
+
+			uint32 numChunks =
+				(table->numComponents + table->chunkSize - 1) /
+				table->chunkSize;
+
+			if (numChunks > loadedTable->chunkCapacity)
+			{
+				loadedTable->chunks = realloc(
+					loadedTable->chunks,
+					numChunks * sizeof(SceneSnapshotChunk*));
+				loadedTable->chunkRecords = realloc(
+					loadedTable->chunkRecords,
+					numChunks * sizeof(uint32));
+
+				memset(
+					loadedTable->chunks + loadedTable->chunkCapacity,
+					0,
+					(numChunks - loadedTable->chunkCapacity) *
+						sizeof(SceneSnapshotChunk*));
+
+				loadedTable->chunkCapacity = numChunks;
+			}
+
+			// Chunks past the end of the table are gone
+			for (uint32 k = numChunks; k < loadedTable->numChunks; k++)
+			{
+				loadedTable->chunks[k] = NULL;
+			}
+
+			loadedTable->componentSize = componentDefinition->size;
+			loadedTable->numComponents = table->numComponents;
+			loadedTable->chunkSize = table->chunkSize;
+			loadedTable->numChunks = numChunks;
+
+			for (uint32 k = 0; k < table->numChunks; k++)
+			{
+				const SceneSnapshotChunk *chunk =
+					&record->chunks[table->firstChunk + k];
+
+				loadedTable->chunks[chunk->index] = chunk;
+				loadedTable->chunkRecords[chunk->index] = i;
+			}
+		}
+	}
+
+	// Deltas only stay valid while every component ends up where it was in
+	// the snapshot, so the state is made from the snapshot's chunks
+	bool complete = true;
+
+	SceneSnapshotTableState *tableStates = calloc(
+		MAX(scene->numComponentTables, 1),
+		sizeof(SceneSnapshotTableState));
+
+	for (uint32 i = 0; i < numTables; i++)
+	{
+		LoadedSnapshotTable *loadedTable = &tables[i];
+
+		ComponentTypeHandle componentType =
+			componentTypeFromName(loadedTable->name);
+		ComponentDataTable *dataTable = sceneGetComponentDataTable(
+			scene,
+			componentType);
+
+		SceneSnapshotTableState *tableState = NULL;
+
+		if (!dataTable ||
+			dataTable->numComponents > 0 ||
+			dataTable->componentSize != loadedTable->componentSize ||
+			(1u << dataTable->chunkShift) != loadedTable->chunkSize)
+		{
+			// Tables which have since been emptied don't matter
+			complete = complete && loadedTable->numComponents == 0;
+		}
+		else
+		{
+			tableState = &tableStates[HANDLE_GET_INDEX(componentType)];
+			tableState->numComponents = loadedTable->numComponents;
+			tableState->numChunks = loadedTable->numChunks;
+			tableState->chunkHashes = calloc(
+				MAX(loadedTable->numChunks, 1),
+				sizeof(uint64));
+		}
+
+		// Adding a component can change its data, so it's copied out of the
+		// mapped snapshot first
+		uint8 *componentData = malloc(MAX(loadedTable->componentSize, 1));
+		EntityHandle *chunkEntities = malloc(
+			loadedTable->chunkSize * sizeof(EntityHandle));
+
+		for (uint32 j = 0; j < loadedTable->numChunks; j++)
+		{
+			const SceneSnapshotChunk *chunk = loadedTable->chunks[j];
+
+			if (!chunk)
+			{
+				complete = false;
+				continue;
+			}
+
+			const SceneSnapshotRecord *record =
+				&snapshot->records[loadedTable->chunkRecords[j]];
+			const uint8 *recordData = (const uint8*)record->header;
+
+			EntityHandle *recordEntityHandles = getSnapshotRecordEntities(
+				scene,
+				snapshot,
+				recordEntities,
+				record->entitiesRecord);
+			const uint32 *chunkEntityIndices =
+				(uint32*)(recordData + chunk->entitiesOffset);
+			const uint8 *chunkData = recordData + chunk->dataOffset;
+
+			for (uint32 k = 0; k < chunk->numComponents; k++)
+			{
+				EntityHandle entity =
+					recordEntityHandles[chunkEntityIndices[k]];
+				chunkEntities[k] = entity;
+
+				if (entity == INVALID_HANDLE)
+				{
+					complete = false;
+					continue;
+				}
+
+				memcpy(
+					componentData,
+					chunkData + (uint64)k * loadedTable->componentSize,
+					loadedTable->componentSize);
+
+				sceneAddComponentToEntity(
+					scene,
+					entity,
+					componentType,
+					componentData);
+
+				uint32 index = j * loadedTable->chunkSize + k;
+				if (!dataTable ||
+					dataTable->numComponents != index + 1 ||
+					cdtGetIndexEntity(dataTable, index) != entity)
+				{
+					complete = false;
+				}
+			}
+
+			if (tableState)
+			{
+				uint64 hash = hashSnapshotData(
+					chunkEntities,
+					chunk->numComponents * sizeof(EntityHandle),
+					SNAPSHOT_HASH_SEED);
+
+				tableState->chunkHashes[j] = hashSnapshotData(
+					chunkData,
+					(uint64)chunk->numComponents * loadedTable->componentSize,
+					hash);
+			}
+		}
+
+		free(chunkEntities);
+		free(componentData);
+		free(loadedTable->chunks);
+		free(loadedTable->chunkRecords);
+	}
+
+	free(tables);
+
+	for (uint32 i = 0; i < snapshot->numRecords; i++)
+	{
+		free(recordEntities[i]);
+	}
+
+	free(recordEntities);
+
+	// Components which aren't in the snapshot would never be written
+	for (uint32 i = 0; i < scene->numComponentTables; i++)
+	{
+		ComponentDataTable *dataTable = scene->componentTables[i];
+
+		if (dataTable &&
+			dataTable->numComponents != tableStates[i].numComponents)
+		{
+			complete = false;
+		}
+	}
+
+	SceneSnapshotState *state = scene->snapshotState;
+	clearSceneSnapshotState(state);
+
+	if (!complete)
+	{
+		LOG_WARNING("%s could not be loaded as it was written, "
+			"the next snapshot of %s will be written in full\n",
+			snapshot->filename,
+			scene->name);
+
+		freeSnapshotTableStates(tableStates, scene->numComponentTables);
+		return;
+	}
+
+	state->filename = malloc(strlen(snapshot->filename) + 1);
+	strcpy(state->filename, snapshot->filename);
+	state->numRecords = snapshot->numRecords;
+	state->baseSize = snapshot->baseSize;
+	state->size = snapshot->size;
+	state->entitiesGeneration = scene->entitiesGeneration;
+	state->numTables = scene->numComponentTables;
+	state->tables = tableStates;
+}
+
+void freeSceneSnapshotState(SceneSnapshotState **state)
+{
+	if (*state)
+	{
+		clearSceneSnapshotState(*state);
+		free(*state);
+	}
+
+	*state = NULL;
+}
+
+// Components are mostly written through pointers into their table, so
+// changes are found by comparing the contents of each chunk
+SceneSnapshotTableState* hashSnapshotTables(const SceneSnapshotCopy *copy)
+{
+	SceneSnapshotTableState *tableStates = calloc(
+		MAX(copy->numTables, 1),
+		sizeof(SceneSnapshotTableState));
+
+	for (uint32 i = 0; i < copy->numTables; i++)
+	{
+		const SceneSnapshotTableCopy *table = copy->tables[i];
+		SceneSnapshotTableState *tableState = &tableStates[i];
+
+		if (!table)
+		{
+			continue;
+		}
+
+		uint32 chunkSize = 1 << table->chunkShift;
+
+		tableState->numComponents = table->numComponents;
+		tableState->numChunks =
+			(table->numComponents + chunkSize - 1) >> table->chunkShift;
+		tableState->chunkHashes = malloc(
+			MAX(tableState->numChunks, 1) * sizeof(uint64));
+
+		for (uint32 j = 0; j < tableState->numChunks; j++)
+		{
+			uint32 first = j << table->chunkShift;
+			uint32 numChunkComponents = getSnapshotChunkSize(table, j);
+
+			uint64 hash = hashSnapshotData(
+				&table->entities[first],
+				numChunkComponents * sizeof(EntityHandle),
+				SNAPSHOT_HASH_SEED);
+
+			tableState->chunkHashes[j] = hashSnapshotData(
+				table->data + (uint64)first * table->componentSize,
+				(uint64)numChunkComponents * table->componentSize,
+				hash);
+		}
+	}
+
+	return tableStates;
+}
+
+uint64 hashSnapshotData(const void *data, uint64 size, uint64 hash)
+{
+	const uint8 *bytes = data;
+
+	// Mix in a word at a time, the tail a byte at a time
+	uint64 i = 0;
+	for (; i + sizeof(uint64) <= size; i += sizeof(uint64))
+	{
+		uint64 word;
+		memcpy(&word, bytes + i, sizeof(uint64));
+
+		hash = (hash ^ word) * SNAPSHOT_HASH_MULTIPLIER;
+		hash ^= hash >> 29;
+	}
+
+	for (; i < size; i++)
+	{
+		hash = (hash ^ bytes[i]) * SNAPSHOT_HASH_MULTIPLIER;
+		hash ^= hash >> 29;
+	}
+
+	return hash;
+}
+
+void freeSnapshotTableStates(
+	SceneSnapshotTableState *tableStates,
+	uint32 numTables)
+{
+	if (!tableStates)
+	{
+		return;
+	}
+
+	for (uint32 i = 0; i < numTables; i++)
+	{
+		free(tableStates[i].chunkHashes);
+	}
+
+	free(tableStates);
+}
+
+bool isSnapshotChunkUnchanged(
+	const SceneSnapshotTableState *previousTableState,
+	const SceneSnapshotTableState *tableState,
+	uint32 chunk)
+{
+	return previousTableState &&
+		chunk < previousTableState->numChunks &&
+		previousTableState->chunkHashes[chunk] ==
+			tableState->chunkHashes[chunk];
+}
+
+uint32 getSnapshotComponentDefinition(
+	const SceneSnapshotCopy *copy,
+	const char *componentName)
+{
+	for (uint32 i = 0; i < copy->numComponentDefinitions; i++)
+	{
+		if (!strcmp(
+			copy->strings + copy->componentDefinitions[i].nameOffset,
+			componentName))
+		{
+			return i;
+		}
+	}
+
+	return copy->numComponentDefinitions;
+}
+
+uint32 addSnapshotString(
+	const char *string,
+	char **strings,
+	uint64 *stringsSize)
+{
+	uint64 stringOffset = *stringsSize;
+	uint64 stringSize = strlen(string) + 1;
+
+	*strings = realloc(*strings, stringOffset + stringSize);
+	memcpy(*strings + stringOffset, string, stringSize);
+	*stringsSize += stringSize;
+
+	return stringOffset;
+}
+
+bool readSnapshotRecord(
+	const MappedFile *file,
+	uint64 offset,
+	SceneSnapshot *snapshot,
+	SceneSnapshotRecord *record)
+{
+	const uint8 *data = file->data + offset;
+	const SceneSnapshotHeader *header = (SceneSnapshotHeader*)data;
+
+	uint64 availableSize = file->size - offset;
+
+	if (offset % SCENE_SNAPSHOT_ALIGNMENT ||
+		availableSize < sizeof(SceneSnapshotHeader) ||
+		memcmp(header->magic, SCENE_SNAPSHOT_MAGIC, sizeof(header->magic)) ||
+		header->version != SCENE_SNAPSHOT_VERSION ||
+		header->size < sizeof(SceneSnapshotHeader) ||
+		header->size > availableSize)
+	{
+		return false;
+	}
+
+	// The first record is the only full one, and has to have the entities
+	bool delta = header->flags & SCENE_SNAPSHOT_DELTA;
+	if (delta != (snapshot->numRecords > 0) ||
+		(!delta && !(header->flags & SCENE_SNAPSHOT_ENTITIES)) ||
+		(!(header->flags & SCENE_SNAPSHOT_ENTITIES) &&
+		header->numEntities > 0))
+	{
+		return false;
+	}
+
+	uint64 size = header->size;
+
+	if (!isSnapshotBlockValid(
+			size,
+			header->entitiesOffset,
+			(uint64)header->numEntities * sizeof(UUID),
+			1) ||
+		!isSnapshotBlockValid(
+			size,
+			header->componentDefinitionsOffset,
+			(uint64)header->numComponentDefinitions *
+				sizeof(SceneSnapshotComponentDefinition),
+			sizeof(uint32)) ||
+		!isSnapshotBlockValid(
+			size,
+			header->valueDefinitionsOffset,
+			(uint64)header->numValueDefinitions *
+				sizeof(SceneSnapshotValueDefinition),
+			sizeof(uint32)) ||
+		!isSnapshotBlockValid(
+			size,
+			header->chunksOffset,
+			(uint64)header->numChunks * sizeof(SceneSnapshotChunk),
+			sizeof(uint64)) ||
+		!isSnapshotBlockValid(
+			size,
+			header->tablesOffset,
+			(uint64)header->numTables * sizeof(SceneSnapshotTable),
+			sizeof(uint32)) ||
+		header->stringsOffset > size ||
+		(header->stringsOffset < size && data[size - 1] != '\0'))
+	{
+		return false;
+	}
+
+	record->header = header;
+	record->entities = (UUID*)(data + header->entitiesOffset);
+	record->componentDefinitions = (SceneSnapshotComponentDefinition*)
+		(data + header->componentDefinitionsOffset);
+	record->valueDefinitions = (SceneSnapshotValueDefinition*)
+		(data + header->valueDefinitionsOffset);
+	record->chunks = (SceneSnapshotChunk*)(data + header->chunksOffset);
+	record->tables = (SceneSnapshotTable*)(data + header->tablesOffset);
+	record->strings = (char*)(data + header->stringsOffset);
+	record->entitiesRecord = header->flags & SCENE_SNAPSHOT_ENTITIES ?
+		snapshot->numRecords :
+		snapshot->records[snapshot->numRecords - 1].entitiesRecord;
+
+	uint32 numEntities = record->entitiesRecord == snapshot->numRecords ?
+		header->numEntities :
+		snapshot->records[record->entitiesRecord].header->numEntities;
+	uint64 stringsSize = size - header->stringsOffset;
+
+	for (uint32 i = 0; i < header->numComponentDefinitions; i++)
+	{
+		const SceneSnapshotComponentDefinition *componentDefinition =
+			&record->componentDefinitions[i];
+
+		if (componentDefinition->nameOffset >= stringsSize ||
+			componentDefinition->firstValue > header->numValueDefinitions ||
+			componentDefinition->numValues >
+				header->numValueDefinitions - componentDefinition->firstValue)
+		{
+			return false;
+		}
+	}
+
+	for (uint32 i = 0; i < header->numValueDefinitions; i++)
+	{
+		const SceneSnapshotValueDefinition *valueDefinition =
+			&record->valueDefinitions[i];
+
+		if (valueDefinition->nameOffset >= stringsSize ||
+			valueDefinition->type < DATA_TYPE_UINT8 ||
+			valueDefinition->type > DATA_TYPE_PTR)
+		{
+			return false;
+		}
+	}
+
+	for (uint32 i = 0; i < header->numTables; i++)
+	{
+		const SceneSnapshotTable *table = &record->tables[i];
+
+		if (table->componentDefinition >= header->numComponentDefinitions ||
+			table->chunkSize == 0 ||
+			table->firstChunk > header->numChunks ||
+			table->numChunks > header->numChunks - table->firstChunk)
+		{
+			return false;
+		}
+
+		uint32 componentSize =
+			record->componentDefinitions[table->componentDefinition].size;
+		uint64 numChunks =
+			((uint64)table->numComponents + table->chunkSize - 1) /
+			table->chunkSize;
+
+		for (uint32 j = 0; j < table->numChunks; j++)
+		{
+			const SceneSnapshotChunk *chunk =
+				&record->chunks[table->firstChunk + j];
+
+			if (chunk->index >= numChunks ||
+				chunk->numComponents != MIN(
+					table->chunkSize,
+					table->numComponents -
+						chunk->index * table->chunkSize) ||
+				!isSnapshotBlockValid(
+					size,
+					chunk->entitiesOffset,
+					(uint64)chunk->numComponents * sizeof(uint32),
+					sizeof(uint32)) ||
+				!isSnapshotBlockValid(
+					size,
+					chunk->dataOffset,
+					(uint64)chunk->numComponents * componentSize,
+					1))
+			{
+				return false;
+			}
+
+			const uint32 *chunkEntities =
+				(uint32*)(data + chunk->entitiesOffset);
+
+			for (uint32 k = 0; k < chunk->numComponents; k++)
+			{
+				if (chunkEntities[k] >= numEntities)
+				{
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+bool isSnapshotBlockValid(
+	uint64 recordSize,
+	uint64 offset,
+	uint64 size,
+	uint64 alignment)
+{
+	return offset % alignment == 0 &&
+		offset <= recordSize &&
+		size <= recordSize - offset;
+}
+
+LoadedSnapshotTable* getLoadedSnapshotTable(
+	LoadedSnapshotTable **tables,
+	uint32 *numTables,
+	const char *name)
+{
+	for (uint32 i = 0; i < *numTables; i++)
+	{
+		if (!strcmp((*tables)[i].name, name))
+		{
+			return &(*tables)[i];
+		}
+	}
+
+	*tables = realloc(*tables, (*numTables + 1) * sizeof(LoadedSnapshotTable));
+
+	LoadedSnapshotTable *table = &(*tables)[(*numTables)++];
+	memset(table, 0, sizeof(LoadedSnapshotTable));
+	table->name = name;
+
+	return table;
+}
+
+EntityHandle* getSnapshotRecordEntities(
+	Scene *scene,
+	const SceneSnapshot *snapshot,
+	EntityHandle **recordEntities,
+	uint32 record)
+{
+	if (!recordEntities[record])
+	{
+		const SceneSnapshotRecord *entitiesRecord = &snapshot->records[record];
+		uint32 numEntities = entitiesRecord->header->numEntities;
+
+		// Entities which have since been removed are INVALID_HANDLE
+		recordEntities[record] = malloc(
+			MAX(numEntities, 1) * sizeof(EntityHandle));
+
+		for (uint32 i = 0; i < numEntities; i++)
+		{
+			recordEntities[record][i] = sceneGetEntity(
+				scene,
+				entitiesRecord->entities[i]);
+		}
+	}
+
+	return recordEntities[record];
+}
+
+char* copySnapshotString(
+	const SceneSnapshotRecord *record,
+	uint32 stringOffset)
+{
+	const char *string = record->strings + stringOffset;
+
+	char *copy = malloc(strlen(string) + 1);
+	strcpy(copy, string);
+
+	return copy;
+}
+
+int32 writePadding(FILE *file, uint64 *offset, uint64 alignment)
+{
+	internal const uint8 padding[SCENE_SNAPSHOT_ALIGNMENT] = {};
+
+	uint64 paddingSize = (alignment - *offset % alignment) % alignment;
+	if (fwrite(padding, 1, paddingSize, file) != paddingSize)
+	{
+		return -1;
+	}
+
+	*offset += paddingSize;
+
+	return 0;
+}
@@ -0,0 +1,238 @@
+#include "ECS/scheduler.h"
+#include "ECS/scene.h"
+#include "ECS/system.h"
+
+#include "core/log.h"
+
+#include "data/hash_map.h"
+#include "data/list.h"
+
+#include "threading/thread_pool.h"
+
+#include <malloc.h>
+#include <pthread.h>
+
+extern HashMap systemRegistry;
+extern ThreadPool *systemThreadPool;
+
+typedef struct system_schedule_t SystemSchedule;
+
+typedef struct scheduled_system_t
+{
+	System *system;
+	bool started;
+	bool finished;
+	SystemSchedule *schedule;
+} ScheduledSystem;
+
+struct system_schedule_t
+{
+	Scene *scene;
+	real64 dt;
+	uint32 numSystems;
+	ScheduledSystem *systems;
+	// Entry (i * numSystems + j) is true if system i has to wait for system j
+	bool *dependencies;
+	uint32 numFinished;
+	pthread_mutex_t mutex;
+	pthread_cond_t finishedCondition;
+};
+
+internal
+bool runsOnMainThread(System *system)
+{
+	return !systemThreadPool
+		|| systemThreadPool->numThreads == 0
+		|| system->mainThread
+		|| !systemDeclaresAccess(system);
+}
+
+internal
+bool isSystemReady(SystemSchedule *schedule, uint32 index)
+{
+	bool *dependencies = &schedule->dependencies[index * schedule->numSystems];
+
+	for (uint32 i = 0; i < index; i++)
+	{
+		if (dependencies[i] && !schedule->systems[i].finished)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+internal
+void runScheduledSystem(void *data)
+{
+	ScheduledSystem *scheduledSystem = data;
+	SystemSchedule *schedule = scheduledSystem->schedule;
+
+	systemRun(schedule->scene, scheduledSystem->system, schedule->dt);
+
+	pthread_mutex_lock(&schedule->mutex);
+
+	scheduledSystem->finished = true;
+	schedule->numFinished++;
+
+	pthread_cond_signal(&schedule->finishedCondition);
+	pthread_mutex_unlock(&schedule->mutex);
+}
+
+internal
+void buildSchedule(
+	SystemSchedule *schedule,
+	Scene *scene,
+	List *systemNames,
+	real64 dt)
+{
+	schedule->scene = scene;
+	schedule->dt = dt;
+	schedule->numSystems = 0;
+	schedule->numFinished = 0;
+
+	uint32 maxNumSystems = 0;
+	for (ListIterator itr = listGetIterator(systemNames);
+		 !listIteratorAtEnd(itr);
+		 listMoveIterator(&itr))
+	{
+		maxNumSystems++;
+	}
+
+	schedule->systems = calloc(maxNumSystems, sizeof(ScheduledSystem));
+
+	for (ListIterator itr = listGetIterator(systemNames);
+		 !listIteratorAtEnd(itr);
+		 listMoveIterator(&itr))
+	{
+		UUID *systemName = LIST_ITERATOR_GET_ELEMENT(UUID, itr);
+		System *system = hashMapGetData(systemRegistry, systemName);
+
+		if (!system)
+		{
+			LOG("System %s doesn't exist in system registry\n",
+				systemName->string);
+			continue;
+		}
+
+		// Queries are created on first use, which can't happen on
+		// several threads at once
+		if (system->run)
+		{
+			systemGetQuery(scene, system);
+		}
+
+		ScheduledSystem *scheduledSystem =
+			&schedule->systems[schedule->numSystems++];
+		scheduledSystem->system = system;
+		scheduledSystem->schedule = schedule;
+	}
+
+	uint32 numSystems = schedule->numSystems;
+
+	schedule->dependencies = calloc(
+		numSystems * numSystems,
+		sizeof(bool));
+
+	// Systems wait for every earlier system they conflict with, so any two
+	// conflicting systems still run in the order they were listed
+	for (uint32 i = 0; i < numSystems; i++)
+	{
+		System *system = schedule->systems[i].system;
+
+		for (uint32 j = 0; j < i; j++)
+		{
+			System *previousSystem = schedule->systems[j].system;
+
+			schedule->dependencies[i * numSystems + j] =
+				systemsConflict(system, previousSystem)
+				|| (runsOnMainThread(system)
+					&& runsOnMainThread(previousSystem));
+		}
+	}
+
+	pthread_mutex_init(&schedule->mutex, NULL);
+	pthread_cond_init(&schedule->finishedCondition, NULL);
+}
+
+internal
+void freeSchedule(SystemSchedule *schedule)
+{
+	pthread_mutex_destroy(&schedule->mutex);
+	pthread_cond_destroy(&schedule->finishedCondition);
+
+	free(schedule->systems);
+	free(schedule->dependencies);
+}
+
+void schedulerRunSystems(Scene *scene, List *systemNames, real64 dt)
+{
+	SystemSchedule schedule = {};
+	buildSchedule(&schedule, scene, systemNames, dt);
+
+	pthread_mutex_lock(&schedule.mutex);
+
+	while (schedule.numFinished < schedule.numSystems)
+	{
+		ScheduledSystem *mainThreadSystem = NULL;
+
+		// Start every system which isn't waiting on another system
+		for (uint32 i = 0; i < schedule.numSystems; i++)
+		{
+			ScheduledSystem *scheduledSystem = &schedule.systems[i];
+
+			if (scheduledSystem->started || !isSystemReady(&schedule, i))
+			{
+				continue;
+			}
+
+			if (runsOnMainThread(scheduledSystem->system))
+			{
+				if (!mainThreadSystem)
+				{
+					mainThreadSystem = scheduledSystem;
+				}
+
+				continue;
+			}
+
+			scheduledSystem->started = true;
+			threadPoolAddJob(
+				systemThreadPool,
+				&runScheduledSystem,
+				scheduledSystem);
+		}
+
+		if (mainThreadSystem)
+		{
+			mainThreadSystem->started = true;
+
+			pthread_mutex_unlock(&schedule.mutex);
+
+			// Systems which don't declare their access conflict with every
+			// other system, so nothing else is running and deferred changes
+			// can be applied before they see the scene
+			if (!systemDeclaresAccess(mainThreadSystem->system))
+			{
+				sceneApplyCommands(scene);
+			}
+
+			systemRun(scene, mainThreadSystem->system, dt);
+			pthread_mutex_lock(&schedule.mutex);
+
+			mainThreadSystem->finished = true;
+			schedule.numFinished++;
+		}
+		else if (schedule.numFinished < schedule.numSystems)
+		{
+			pthread_cond_wait(&schedule.finishedCondition, &schedule.mutex);
+		}
+	}
+
+	pthread_mutex_unlock(&schedule.mutex);
+
+	freeSchedule(&schedule);
+
+	sceneApplyCommands(scene);
+}
@@ -0,0 +1,137 @@
+#include "ECS/serialization.h"
+#include "ECS/scene.h"
+
+#include "core/log.h"
+
+#include "data/data_types.h"
+#include "data/hash_map.h"
+
+#include "threading/thread_pool.h"
+
+#include <malloc.h>
+#include <pthread.h>
+#include <string.h>
+
+#define PENDING_SCENE_BUCKETS 31
+
+typedef struct serialization_job_t
+{
+	JobFunction function;
+	void *data;
+	uint32 numSceneNames;
+	UUID *sceneNames;
+} SerializationJob;
+
+internal ThreadPool *serializationThread;
+
+// Number of queued jobs which write each scene, by scene name
+internal HashMap pendingScenes;
+internal pthread_mutex_t pendingScenesMutex;
+internal pthread_cond_t pendingScenesCondition;
+
+internal void runSerializationJob(void *data);
+
+void initializeSerialization(void)
+{
+	serializationThread = createThreadPool(1);
+
+	pendingScenes = createHashMap(
+		sizeof(UUID),
+		sizeof(uint32),
+		PENDING_SCENE_BUCKETS,
+		(ComparisonOp)&strcmp);
+
+	pthread_mutex_init(&pendingScenesMutex, NULL);
+	pthread_cond_init(&pendingScenesCondition, NULL);
+}
+
+void shutdownSerialization(void)
+{
+	LOG("Waiting for scenes and saves to be written...\n");
+
+	// Queued jobs are finished before the thread exits
+	freeThreadPool(&serializationThread);
+
+	freeHashMap(&pendingScenes);
+	pthread_mutex_destroy(&pendingScenesMutex);
+	pthread_cond_destroy(&pendingScenesCondition);
+}
+
+void serializationAddJob(
+	JobFunction function,
+	void *data,
+	uint32 numSceneNames,
+	char **sceneNames)
+{
+	SerializationJob *job = malloc(sizeof(SerializationJob));
+
+	job->function = function;
+	job->data = data;
+	job->numSceneNames = numSceneNames;
+	job->sceneNames = malloc(MAX(numSceneNames, 1) * sizeof(UUID));
+
+	pthread_mutex_lock(&pendingScenesMutex);
+
+	for (uint32 i = 0; i < numSceneNames; i++)
+	{
+		job->sceneNames[i] = idFromName(sceneNames[i]);
+
+		uint32 *numJobs = hashMapGetData(pendingScenes, &job->sceneNames[i]);
+		if (numJobs)
+		{
+			(*numJobs)++;
+		}
+		else
+		{
+			uint32 numSceneJobs = 1;
+			hashMapInsert(pendingScenes, &job->sceneNames[i], &numSceneJobs);
+		}
+	}
+
+	pthread_mutex_unlock(&pendingScenesMutex);
+
+	threadPoolAddJob(serializationThread, &runSerializationJob, job);
+}
+
+void waitForSceneSerialization(const char *name)
+{
+	UUID sceneName = idFromName(name);
+
+	pthread_mutex_lock(&pendingScenesMutex);
+
+	while (hashMapGetData(pendingScenes, &sceneName))
+	{
+		pthread_cond_wait(&pendingScenesCondition, &pendingScenesMutex);
+	}
+
+	pthread_mutex_unlock(&pendingScenesMutex);
+}
+
+void waitForSerialization(void)
+{
+	threadPoolWait(serializationThread);
+}
+
+void runSerializationJob(void *data)
+{
+	SerializationJob *job = data;
+
+	job->function(job->data);
+
+	pthread_mutex_lock(&pendingScenesMutex);
+
+	for (uint32 i = 0; i < job->numSceneNames; i++)
+	{
+		uint32 *numJobs = hashMapGetData(pendingScenes, &job->sceneNames[i]);
+		if (--(*numJobs) == 0)
+		{
+			hashMapDelete(pendingScenes, &job->sceneNames[i]);
+		}
+	}
+
+	pthread_cond_broadcast(&pendingScenesCondition);
+	pthread_mutex_unlock(&pendingScenesMutex);
+
+	free(job->sceneNames);
+	free(job);
+}
@@ -1,13 +1,27 @@
 #include "ECS/system.h"
 #include "ECS/component.h"
+#include "ECS/query.h"
+#include "ECS/scene.h"
 
 #include "core/log.h"
 
 #include "data/list.h"
 #include "data/hash_map.h"
 
+#include "threading/thread_pool.h"
+
 #include <string.h>
 
+extern ThreadPool *systemThreadPool;
+
+typedef struct system_chunk_t
+{
+	Scene *scene;
+	System *system;
+	Query *query;
+	real64 dt;
+} SystemChunk;
+
 inline
 System createSystem(
 	List components,
@@ -19,6 +33,10 @@ System createSystem(
 {
 	System sys;
 	sys.componentTypes = components;
+	sys.readComponentTypes = createList(sizeof(ComponentTypeHandle));
+	sys.writeComponentTypes = createList(sizeof(ComponentTypeHandle));
+	sys.mainThread = false;
+	sys.parallel = false;
 	sys.init = init;
 	sys.begin = begin;
 	sys.run = run;
@@ -27,6 +45,92 @@ System createSystem(
 	return sys;
 }
 
+Query *systemGetQuery(Scene *scene, System *system)
+{
+	uint32 numComponentTypes = 0;
+	ComponentTypeHandle componentTypes[QUERY_MAX_COMPONENT_TYPES];
+
+	for (ListIterator itr = listGetIterator(&system->componentTypes);
+		 !listIteratorAtEnd(itr)
+			 && numComponentTypes < QUERY_MAX_COMPONENT_TYPES;
+		 listMoveIterator(&itr))
+	{
+		componentTypes[numComponentTypes++] =
+			*LIST_ITERATOR_GET_ELEMENT(ComponentTypeHandle, itr);
+	}
+
+	return sceneGetQuery(scene, numComponentTypes, componentTypes);
+}
+
+internal
+bool listsIntersect(List *a, List *b)
+{
+	for (ListIterator itr = listGetIterator(a);
+		 !listIteratorAtEnd(itr);
+		 listMoveIterator(&itr))
+	{
+		if (listContains(
+				b,
+				LIST_ITERATOR_GET_ELEMENT(ComponentTypeHandle, itr)))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+inline
+bool systemDeclaresAccess(System *system)
+{
+	return system->readComponentTypes.front
+		|| system->writeComponentTypes.front;
+}
+
+bool systemsConflict(System *a, System *b)
+{
+	if (!systemDeclaresAccess(a) || !systemDeclaresAccess(b))
+	{
+		return true;
+	}
+
+	return listsIntersect(&a->writeComponentTypes, &b->writeComponentTypes)
+		|| listsIntersect(&a->writeComponentTypes, &b->readComponentTypes)
+		|| listsIntersect(&a->readComponentTypes, &b->writeComponentTypes);
+}
+
+internal
+void runSystemChunk(uint32 first, uint32 count, void *data)
+{
+	SystemChunk *chunk = data;
+
+	for (QueryIterator itr = queryGetRangeIterator(
+			 chunk->query,
+			 chunk->scene,
+			 first,
+			 count);
+		 !queryIteratorAtEnd(itr);
+		 queryMoveIterator(&itr))
+	{
+		chunk->system->run(
+			chunk->scene,
+			queryIteratorGetEntity(itr),
+			itr.components,
+			chunk->dt);
+	}
+}
+
+internal
+inline
+bool runsInParallel(System *system)
+{
+	return system->parallel
+		&& !system->mainThread
+		&& systemDeclaresAccess(system)
+		&& systemThreadPool
+		&& systemThreadPool->numThreads > 0;
+}
+
 void systemRun(
 	Scene *scene,
 	System *system,
@@ -39,68 +143,30 @@ void systemRun(
 
 	if (system->run)
 	{
-		UUID *componentID = (UUID*)system->componentTypes.front->data;
-		ComponentDataTable **cdt = (ComponentDataTable **)hashMapGetData(
-			scene->componentTypes,
-			componentID);
+		// The scene keeps the query up to date, so every entity in it has
+		// all of the components the system needs
+		Query *query = systemGetQuery(scene, system);
+
+		ASSERT(query != 0);
 
-		if (!cdt || !*cdt)
+		SystemChunk chunk = {};
+		chunk.scene = scene;
+		chunk.system = system;
+		chunk.query = query;
+		chunk.dt = dt;
+
+		if (runsInParallel(system))
 		{
-			LOG("ERROR: Component limit for the %s component "
-				"is missing from the scene\n",
-				componentID->string);
-			ASSERT(false);
+			threadPoolParallelFor(
+				systemThreadPool,
+				query->numEntities,
+				SYSTEM_CHUNK_SIZE,
+				&runSystemChunk,
+				&chunk);
 		}
-
-		// For each entity in the first component table
-		for (ComponentDataTableIterator itr = cdtGetIterator(*cdt);
-			 !cdtIteratorAtEnd(itr);
-			 cdtMoveIterator(&itr))
+		else
 		{
-			// Check to see if it has the other component types
-			bool entityValid = true;
-
-			ListIterator litr = listGetIterator(&system->componentTypes);
-			for (listMoveIterator(&litr);
-				 !listIteratorAtEnd(litr);
-				 listMoveIterator(&litr))
-			{
-				// Get the component to check
-				componentID = LIST_ITERATOR_GET_ELEMENT(UUID, litr);
-				ComponentDataTable **table = hashMapGetData(
-					scene->componentTypes,
-					componentID);
-
-				if (!table || !*table)
-				{
-					LOG("ERROR: Component limit for the %s component "
-						"is missing from the scene\n",
-						componentID->string);
-					ASSERT(false);
-				}
-				else if (!componentID)
-				{
-					continue;
-				}
-
-				// Check if the entity exists in the table
-				void *entityData = cdtGet(*table, cdtIteratorGetUUID(itr));
-
-				if (!entityData)
-				{
-					entityValid = false;
-					break;
-				}
-			}
-
-			// Call the function
-			if (entityValid)
-			{
-				system->run(
-					scene,
-					cdtIteratorGetUUID(itr),
-					dt);
-			}
+			runSystemChunk(0, query->numEntities, &chunk);
 		}
 	}
 
@@ -113,6 +179,10 @@ void systemRun(
 void freeSystem(System *system)
 {
 	listClear(&system->componentTypes);
+	listClear(&system->readComponentTypes);
+	listClear(&system->writeComponentTypes);
+	system->mainThread = false;
+	system->parallel = false;
 	system->init = 0;
 	system->begin = 0;
 	system->run = 0;
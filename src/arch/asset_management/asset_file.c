@@ -0,0 +1,164 @@
+#include "asset_management/asset_file.h"
+
+#include "file/asset_archive.h"
+#include "file/file_types.h"
+#include "file/mapped_file.h"
+
+#include "core/log.h"
+
+#include <malloc.h>
+#include <string.h>
+#include <unistd.h>
+
+extern AssetArchive assetArchive;
+
+int32 openAssetFileArchive(const char *filename)
+{
+	return openAssetArchive(filename, &assetArchive);
+}
+
+void closeAssetFileArchive(void)
+{
+	closeAssetArchive(&assetArchive);
+}
+
+bool assetFileExists(const char *filename)
+{
+	if (getAssetArchiveEntry(&assetArchive, filename))
+	{
+		return true;
+	}
+
+	return access(filename, F_OK) != -1;
+}
+
+FILE* openAssetFile(const char *filename)
+{
+	const AssetArchiveEntry *entry = getAssetArchiveEntry(
+		&assetArchive,
+		filename);
+
+	if (!entry)
+	{
+		return fopen(filename, "rb");
+	}
+
+	if (entry->flags & ASSET_ARCHIVE_ENTRY_FOLDER)
+	{
+		return NULL;
+	}
+
+#ifndef _WIN32
+	const uint8 *data = getAssetArchiveEntryData(&assetArchive, entry);
+	if (data && entry->size > 0)
+	{
+		return fmemopen((void*)data, entry->size, "rb");
+	}
+#endif
+
+	// Compressed entries are decompressed into a temporary file, which is
+	// deleted as soon as it's closed
+	uint8 *contents = readAssetArchiveEntry(&assetArchive, entry);
+	if (!contents)
+	{
+		return NULL;
+	}
+
+	FILE *file = tmpfile();
+	if (file)
+	{
+		if (fwrite(contents, 1, entry->originalSize, file) !=
+			entry->originalSize)
+		{
+			fclose(file);
+			file = NULL;
+		}
+		else
+		{
+			rewind(file);
+		}
+	}
+
+	free(contents);
+
+	return file;
+}
+
+const uint8* readAssetFile(
+	const char *filename,
+	uint64 *size,
+	uint8 **buffer)
+{
+	*buffer = NULL;
+
+	const AssetArchiveEntry *entry = getAssetArchiveEntry(
+		&assetArchive,
+		filename);
+
+	if (entry)
+	{
+		if (entry->flags & ASSET_ARCHIVE_ENTRY_FOLDER)
+		{
+			return NULL;
+		}
+
+		*size = entry->originalSize;
+
+		const uint8 *data = getAssetArchiveEntryData(&assetArchive, entry);
+		if (data)
+		{
+			return data;
+		}
+
+		*buffer = readAssetArchiveEntry(&assetArchive, entry);
+		return *buffer;
+	}
+
+	FILE *file = fopen(filename, "rb");
+	if (!file)
+	{
+		return NULL;
+	}
+
+	fseek(file, 0, SEEK_END);
+	*size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	*buffer = malloc(MAX(*size, 1));
+	if (fread(*buffer, 1, *size, file) != *size)
+	{
+		free(*buffer);
+		*buffer = NULL;
+	}
+
+	fclose(file);
+
+	return *buffer;
+}
+
+int32 mapAssetFile(const char *filename, MappedFile *file)
+{
+	const AssetArchiveEntry *entry = getAssetArchiveEntry(
+		&assetArchive,
+		filename);
+
+	if (!entry)
+	{
+		return mapFile(filename, file);
+	}
+
+	memset(file, 0, sizeof(MappedFile));
+
+	const uint8 *data = getAssetArchiveEntryData(&assetArchive, entry);
+	if (!data || entry->size == 0 || entry->flags & ASSET_ARCHIVE_ENTRY_FOLDER)
+	{
+		LOG("Failed to map %s\n", filename);
+		return -1;
+	}
+
+	file->data = (uint8*)data;
+	file->size = entry->size;
+	file->borrowed = true;
+
+	return 0;
+}
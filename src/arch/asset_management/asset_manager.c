@@ -1,5 +1,7 @@
 #include "asset_management/asset_manager.h"
+#include "asset_management/asset_file.h"
 #include "asset_management/asset_manager_types.h"
+#include "asset_management/asset_upload.h"
 #include "asset_management/audio.h"
 #include "asset_management/cubemap.h"
 #include "asset_management/font.h"
@@ -8,22 +10,32 @@
 #include "asset_management/particle.h"
 #include "asset_management/texture.h"
 
+#include "core/config.h"
 #include "core/log.h"
 
 #include "data/data_types.h"
 #include "data/hash_map.h"
 #include "data/list.h"
 
+#include "threading/job_graph.h"
+#include "threading/promise.h"
+#include "threading/thread_pool.h"
+
 #include <string.h>
 #include <pthread.h>
 
-#define INTERNAL_ASSET_VARIABLES(Assets) \
+#define INTERNAL_ASSET_VARIABLES(assets, Assets) \
 internal List free ## Assets ## Queue; \
-internal pthread_mutex_t free ## Assets ## Mutex
+internal pthread_mutex_t free ## Assets ## Mutex; \
+\
+internal List evicted ## Assets; \
+internal uint64 assets ## Memory; \
+\
+internal List uploaded ## Assets
 
 #define ASSET_VARIABLES(assets, Assets) \
 EXTERN_ASSET_VARIABLES(assets, Assets); \
-INTERNAL_ASSET_VARIABLES(Assets)
+INTERNAL_ASSET_VARIABLES(assets, Assets)
 
 ASSET_VARIABLES(models, Models);
 ASSET_VARIABLES(textures, Textures);
@@ -33,6 +45,8 @@ ASSET_VARIABLES(audioFiles, Audio);
 ASSET_VARIABLES(particles, Particles);
 ASSET_VARIABLES(cubemaps, Cubemaps);
 
+extern Config config;
+
 extern HashMap materialFolders;
 extern pthread_mutex_t materialFoldersMutex;
 
@@ -47,19 +61,71 @@ internal bool updateAssetManagerFlag;
 internal pthread_mutex_t updateAssetManagerMutex;
 internal pthread_cond_t updateAssetManagerCondition;
 
+internal List retiredAssetMaps;
+internal pthread_mutex_t retiredAssetMapsMutex;
+
+// Total size of every asset type
+internal uint64 assetMemory;
+
+typedef struct uploaded_asset_t
+{
+	void *data;
+	uint64 batch;
+} UploadedAsset;
+
+typedef struct asset_evictor_t
+{
+	uint64 *memory;
+	uint64 *maxMemory;
+	// Evicts the front of the unused queue once its minimum lifetime is up,
+	// and returns false if it isn't
+	bool (*evictNextUnusedAsset)(uint64 tick, real64 dt);
+	// Finds the unused asset to evict first when over budget, if there is one
+	bool (*findUnusedAsset)(uint64 tick, real64 dt, UnusedAsset *unusedAsset);
+	void (*evictUnusedAsset)(uint64 tick, real64 dt, UUID *name);
+	void (*freeEvictedAssets)(void);
+} AssetEvictor;
+
 internal void* updateAssetManager(void *arg);
+internal bool evictAssetOverBudget(
+	uint8 firstAssetType,
+	uint8 numAssetTypes,
+	uint64 tick,
+	real64 dt);
+internal bool isEvictedBefore(
+	const UnusedAsset *unusedAsset,
+	const UnusedAsset *otherUnusedAsset);
+internal void publishAssets(HashMap assets, HashMap *publishedAssets);
+internal void freeRetiredAssetMaps(void);
+internal bool isOverMemoryBudget(uint64 memory, uint64 budget);
+internal bool canEvictAsset(
+	uint64 lastUsed,
+	uint64 tick,
+	real64 minLifetime,
+	real64 dt,
+	bool overBudget);
+internal void initializeAssetUsage(
+	HashMap pendingReferences,
+	List *unusedAssets,
+	UUID *name,
+	AssetUsage *usage);
+internal void completeLoadingStatePromises(AssetLoadingState *loadingState);
+internal void finishLoadingStateDependentJobs(
+	AssetLoadingState *loadingState);
 
 #define INITIALIZE_ASSET(assets, Asset, Assets, ASSET) \
 assets = createHashMap( \
 	sizeof(UUID), \
-	sizeof(Asset), \
+	sizeof(Asset*), \
 	ASSET ## _BUCKET_COUNT, \
 	(ComparisonOp)&strcmp); \
 pthread_mutex_init(&assets ## Mutex, NULL); \
 \
+published ## Assets = copyHashMap(assets); \
+\
 loading ## Assets = createHashMap( \
 	sizeof(UUID), \
-	sizeof(bool), \
+	sizeof(AssetLoadingState), \
 	LOADING_ ## ASSET ## _BUCKET_COUNT, \
 	(ComparisonOp)&strcmp); \
 pthread_mutex_init(&loading ## Assets ## Mutex, NULL); \
@@ -71,87 +137,351 @@ upload ## Assets ## Queue = createHashMap( \
 	(ComparisonOp)&strcmp); \
 pthread_mutex_init(&upload ## Assets ## Mutex, NULL); \
 \
-free ## Assets ## Queue = createList(sizeof(Asset)); \
-pthread_mutex_init(&free ## Assets ## Mutex, NULL)
+free ## Assets ## Queue = createList(sizeof(Asset*)); \
+pthread_mutex_init(&free ## Assets ## Mutex, NULL); \
+\
+evicted ## Assets = createList(sizeof(Asset*)); \
+assets ## Memory = 0; \
+\
+uploaded ## Assets = createList(sizeof(UploadedAsset)); \
+\
+unused ## Assets ## Queue = createList(sizeof(UnusedAsset)); \
+pending ## Assets ## References = createHashMap( \
+	sizeof(UUID), \
+	sizeof(uint32), \
+	LOADING_ ## ASSET ## _BUCKET_COUNT, \
+	(ComparisonOp)&strcmp)
 
 #define GET_LOADING_ASSET_COUNT(counter, Assets) \
 pthread_mutex_lock(&loading ## Assets ## Mutex); \
 counter += loading ## Assets->count; \
 pthread_mutex_unlock(&loading ## Assets ## Mutex)
 
-#define GET_UPLOAD_ASSET_COUNT(counter, Assets) \
-pthread_mutex_lock(&upload ## Assets ## Mutex); \
-counter += upload ## Assets ## Queue->count; \
-pthread_mutex_unlock(&upload ## Assets ## Mutex)
+#define CANCEL_LOADING_ASSETS(Assets) \
+pthread_mutex_lock(&loading ## Assets ## Mutex); \
+\
+for (HashMapIterator itr = hashMapGetIterator(loading ## Assets); \
+	 !hashMapIteratorAtEnd(itr); \
+	 hashMapMoveIterator(&itr)) \
+{ \
+	AssetLoadingState *loadingState = hashMapIteratorGetValue(itr); \
+	loadingState->wanted = false; \
+} \
+\
+pthread_mutex_unlock(&loading ## Assets ## Mutex)
 
-#define UPDATE_ASSET(asset, assets, Asset, Assets, ASSET, assetName) \
-pthread_mutex_lock(&assets ## Mutex); \
+// Loads which are waiting to be uploaded won't finish once the asset manager
+// thread has exited, so the jobs waiting on them are run on the asset thread
+// pool before it is freed, which releases everything they hold onto
+#define RELEASE_LOADING_ASSET_DEPENDENT_JOBS(Assets) \
+pthread_mutex_lock(&loading ## Assets ## Mutex); \
 \
-for (HashMapIterator itr = hashMapGetIterator(assets); \
-	 !hashMapIteratorAtEnd(itr);) \
+for (HashMapIterator itr = hashMapGetIterator(loading ## Assets); \
+	 !hashMapIteratorAtEnd(itr); \
+	 hashMapMoveIterator(&itr)) \
 { \
-	Asset *asset = hashMapIteratorGetValue(itr); \
+	finishLoadingStateDependentJobs(hashMapIteratorGetValue(itr)); \
+} \
 \
-	asset->lifetime -= dt; \
-	if (asset->lifetime <= 0.0) \
+pthread_mutex_unlock(&loading ## Assets ## Mutex)
+
+// Unused assets are queued roughly in the order they were last used in, so
+// only the front of the queue has to be looked at until a memory budget has
+// been exceeded. Evicted assets can't be freed until lookups can no longer find
+// them, so they're held onto until the asset map has been published again.
+#define ASSET_EVICTION_FUNCTIONS( \
+	asset, \
+	assets, \
+	Asset, \
+	Assets, \
+	ASSET, \
+	assetName) \
+internal void evict ## Asset( \
+	UnusedAsset *unused ## Asset, \
+	uint64 tick, \
+	real64 dt, \
+	bool overBudget) \
+{ \
+	Asset **asset ## Resource = hashMapGetData( \
+		assets, \
+		&unused ## Asset->name); \
+	if (!asset ## Resource) \
 	{ \
-		pthread_mutex_lock(&free ## Assets ## Mutex); \
-		listPushBack(&free ## Assets ## Queue, asset); \
-		pthread_mutex_unlock(&free ## Assets ## Mutex); \
+		return; \
+	} \
 \
-		UUID asset ## Name = asset->name; \
+	Asset *asset = *asset ## Resource; \
 \
-		hashMapMoveIterator(&itr); \
-		hashMapDelete(assets, &asset ## Name); \
+	uint64 lastUsed = __atomic_load_n( \
+		&asset->usage.lastUsed, \
+		__ATOMIC_RELAXED); \
+\
+	if (__atomic_load_n(&asset->usage.refCount, __ATOMIC_RELAXED) > 0) \
+	{ \
+		/* Releasing the last reference will queue it again */ \
+		asset->usage.queued = false; \
+	} \
+	else if (!canEvictAsset( \
+		lastUsed, \
+		tick, \
+		config.assetsConfig.min ## Asset ## Lifetime, \
+		dt, \
+		overBudget)) \
+	{ \
+		unused ## Asset->lastUsed = lastUsed; \
+		listPushBack(&unused ## Assets ## Queue, unused ## Asset); \
+	} \
+	else \
+	{ \
+		listPushBack(&evicted ## Assets, &asset); \
+		hashMapDelete(assets, &unused ## Asset->name); \
+\
+		__atomic_sub_fetch( \
+			&assets ## Memory, \
+			asset->usage.size, \
+			__ATOMIC_RELAXED); \
+		__atomic_sub_fetch( \
+			&assetMemory, \
+			asset->usage.size, \
+			__ATOMIC_RELAXED); \
 \
 		ASSET_LOG( \
 			ASSET, \
-			asset ## Name.string, \
+			unused ## Asset->name.string, \
 			"%s queued to be freed (%s)\n", \
 			assetName, \
-			asset ## Name.string); \
+			unused ## Asset->name.string); \
 		ASSET_LOG( \
 			ASSET, \
-			asset ## Name.string, \
+			unused ## Asset->name.string, \
 			"%s Count: %d\n", \
 			assetName, \
 			assets->count); \
-		ASSET_LOG_COMMIT(ASSET, asset ## Name.string); \
+		ASSET_LOG_COMMIT(ASSET, unused ## Asset->name.string); \
 	} \
-	else \
+} \
+\
+internal bool evictNextUnused ## Asset(uint64 tick, real64 dt) \
+{ \
+	pthread_mutex_lock(&assets ## Mutex); \
+\
+	if (!unused ## Assets ## Queue.front) \
 	{ \
-		hashMapMoveIterator(&itr); \
+		pthread_mutex_unlock(&assets ## Mutex); \
+		return false; \
 	} \
+\
+	UnusedAsset unused ## Asset = \
+		*(UnusedAsset*)unused ## Assets ## Queue.front->data; \
+	if (!canEvictAsset( \
+		unused ## Asset.lastUsed, \
+		tick, \
+		config.assetsConfig.min ## Asset ## Lifetime, \
+		dt, \
+		false)) \
+	{ \
+		pthread_mutex_unlock(&assets ## Mutex); \
+		return false; \
+	} \
+\
+	listPopFront(&unused ## Assets ## Queue); \
+	evict ## Asset(&unused ## Asset, tick, dt, false); \
+\
+	pthread_mutex_unlock(&assets ## Mutex); \
+\
+	return true; \
 } \
 \
-pthread_mutex_unlock(&assets ## Mutex)
+internal bool findUnused ## Asset( \
+	uint64 tick, \
+	real64 dt, \
+	UnusedAsset *unusedAsset) \
+{ \
+	bool found = false; \
+\
+	pthread_mutex_lock(&assets ## Mutex); \
+\
+	for (ListIterator listItr = listGetIterator(&unused ## Assets ## Queue); \
+		 !listIteratorAtEnd(listItr); \
+		 listMoveIterator(&listItr)) \
+	{ \
+		UnusedAsset *unused ## Asset = \
+			LIST_ITERATOR_GET_ELEMENT(UnusedAsset, listItr); \
+		if (canEvictAsset(unused ## Asset->lastUsed, tick, 0.0, dt, true) && \
+			(!found || \
+			 isEvictedBefore(unused ## Asset, unusedAsset))) \
+		{ \
+			*unusedAsset = *unused ## Asset; \
+			found = true; \
+		} \
+	} \
+\
+	pthread_mutex_unlock(&assets ## Mutex); \
+\
+	return found; \
+} \
+\
+internal void evictUnused ## Asset(uint64 tick, real64 dt, UUID *name) \
+{ \
+	pthread_mutex_lock(&assets ## Mutex); \
+\
+	for (ListIterator listItr = listGetIterator(&unused ## Assets ## Queue); \
+		 !listIteratorAtEnd(listItr); \
+		 listMoveIterator(&listItr)) \
+	{ \
+		UnusedAsset unused ## Asset = \
+			*LIST_ITERATOR_GET_ELEMENT(UnusedAsset, listItr); \
+		if (!strcmp(unused ## Asset.name.string, name->string)) \
+		{ \
+			listRemove(&unused ## Assets ## Queue, &listItr); \
+			evict ## Asset(&unused ## Asset, tick, dt, true); \
+			break; \
+		} \
+	} \
+\
+	pthread_mutex_unlock(&assets ## Mutex); \
+} \
+\
+internal void freeEvicted ## Assets(void) \
+{ \
+	if (!evicted ## Assets.front) \
+	{ \
+		return; \
+	} \
+\
+	pthread_mutex_lock(&assets ## Mutex); \
+	publishAssets(assets, &published ## Assets); \
+	pthread_mutex_unlock(&assets ## Mutex); \
+\
+	pthread_mutex_lock(&free ## Assets ## Mutex); \
+\
+	for (ListIterator listItr = listGetIterator(&evicted ## Assets); \
+		 !listIteratorAtEnd(listItr); \
+		 listMoveIterator(&listItr)) \
+	{ \
+		listPushBack( \
+			&free ## Assets ## Queue, \
+			LIST_ITERATOR_GET_ELEMENT(Asset*, listItr)); \
+	} \
+\
+	pthread_mutex_unlock(&free ## Assets ## Mutex); \
+\
+	listClear(&evicted ## Assets); \
+}
 
+// Uploaded assets are added to the asset map straight away so that they aren't
+// loaded again, but lookups don't find them until they've become resident.
+// Loading threads can insert into the upload queue while it's unlocked for the
+// upload, which can move every asset in it, so each asset is copied out of the
+// queue first and iteration starts over once the queue has been locked again.
 #define UPLOAD_ASSET(asset, assets, Asset, Assets, assetName, uploadFunction) \
+List uploaded ## Assets ## Names = createList(sizeof(UUID)); \
+\
 pthread_mutex_lock(&upload ## Assets ## Mutex); \
 \
 for (HashMapIterator itr = hashMapGetIterator(upload ## Assets ## Queue); \
-	 !hashMapIteratorAtEnd(itr);) \
+	 !hashMapIteratorAtEnd(itr); \
+	 itr = hashMapGetIterator(upload ## Assets ## Queue)) \
 { \
-	Asset *asset = hashMapIteratorGetValue(itr); \
+	/* Whatever doesn't fit into this frame's budget is left for the next */ \
+	uint64 asset ## UploadSize = get ## Asset ## Size( \
+		hashMapIteratorGetValue(itr)); \
+	if (!canUploadAsset(asset ## UploadSize)) \
+	{ \
+		break; \
+	} \
+\
+	Asset *asset = malloc(sizeof(Asset)); \
+	*asset = *(Asset*)hashMapIteratorGetValue(itr); \
+	UUID asset ## Name = asset->name; \
 \
 	pthread_mutex_unlock(&upload ## Assets ## Mutex); \
 	uploadFunction; \
 	pthread_mutex_lock(&upload ## Assets ## Mutex); \
 \
-	UUID asset ## Name = asset->name; \
+	asset->usage.size = get ## Asset ## Size(asset); \
+	asset->usage.resident = false; \
+\
+	UploadedAsset uploaded ## Asset; \
+	uploaded ## Asset.data = asset; \
+	uploaded ## Asset.batch = finishAssetUpload(asset ## UploadSize); \
 \
 	pthread_mutex_lock(&assets ## Mutex); \
 \
-	hashMapInsert(assets, &asset ## Name, asset); \
+	listPushBack(&uploaded ## Assets, &uploaded ## Asset); \
+	hashMapInsert(assets, &asset ## Name, &asset); \
 	LOG("%s Count: %d\n", assetName, assets->count); \
+\
+	uint64 assets ## MemoryUsed = __atomic_add_fetch( \
+		&assets ## Memory, \
+		asset->usage.size, \
+		__ATOMIC_RELAXED); \
+	__atomic_add_fetch( \
+		&assetMemory, \
+		asset->usage.size, \
+		__ATOMIC_RELAXED); \
+	LOG("%s Memory: %llu bytes\n", assetName, assets ## MemoryUsed); \
 \
 	pthread_mutex_unlock(&assets ## Mutex); \
 \
-	hashMapMoveIterator(&itr); \
-	hashMapDelete(upload ## Assets ## Queue, &asset ## Name ); \
+	listPushBack(&uploaded ## Assets ## Names, &asset ## Name); \
+\
+	hashMapDelete(upload ## Assets ## Queue, &asset ## Name); \
+} \
+\
+pthread_mutex_unlock(&upload ## Assets ## Mutex); \
+\
+/* Publishing once per upload keeps the number of map copies down */ \
+if (uploaded ## Assets ## Names.front) \
+{ \
+	pthread_mutex_lock(&assets ## Mutex); \
+	publishAssets(assets, &published ## Assets); \
+	pthread_mutex_unlock(&assets ## Mutex); \
+} \
+\
+/* FINISH_LOADING_ASSET takes the loading mutex before the upload mutex, */ \
+/* so loads can't be finished while the upload mutex is held */ \
+pthread_mutex_lock(&loading ## Assets ## Mutex); \
+\
+for (ListIterator listItr = listGetIterator(&uploaded ## Assets ## Names); \
+	 !listIteratorAtEnd(listItr); \
+	 listMoveIterator(&listItr)) \
+{ \
+	finishLoadingAsset( \
+		loading ## Assets, \
+		LIST_ITERATOR_GET_ELEMENT(UUID, listItr)); \
+} \
+\
+pthread_mutex_unlock(&loading ## Assets ## Mutex); \
+\
+listClear(&uploaded ## Assets ## Names)
+
+// Batches finish in the order they were uploaded in
+#define MAKE_ASSETS_RESIDENT(asset, assets, Asset, Assets) \
+pthread_mutex_lock(&assets ## Mutex); \
+\
+while (uploaded ## Assets.front) \
+{ \
+	UploadedAsset *uploaded ## Asset = \
+		(UploadedAsset*)uploaded ## Assets.front->data; \
+	if (!hasAssetUploadFinished(uploaded ## Asset->batch)) \
+	{ \
+		break; \
+	} \
+\
+	Asset *asset = uploaded ## Asset->data; \
+\
+	initializeAssetUsage( \
+		pending ## Assets ## References, \
+		&unused ## Assets ## Queue, \
+		&asset->name, \
+		&asset->usage); \
+	__atomic_store_n(&asset->usage.resident, true, __ATOMIC_RELEASE); \
+\
+	listPopFront(&uploaded ## Assets); \
 } \
 \
-pthread_mutex_unlock(&upload ## Assets ## Mutex)
+pthread_mutex_unlock(&assets ## Mutex)
 
 #define FREE_ASSET(asset, Asset, Assets) \
 pthread_mutex_lock(&free ## Assets ## Mutex); \
@@ -159,10 +489,11 @@ pthread_mutex_lock(&free ## Assets ## Mutex); \
 for (ListIterator listItr = listGetIterator(&free ## Assets ## Queue); \
 	 !listIteratorAtEnd(listItr);) \
 { \
-	Asset *asset = LIST_ITERATOR_GET_ELEMENT(Asset, listItr); \
+	Asset *asset = *LIST_ITERATOR_GET_ELEMENT(Asset*, listItr); \
 \
 	pthread_mutex_unlock(&free ## Assets ## Mutex); \
 	free ## Asset ## Data(asset); \
+	free(asset); \
 	pthread_mutex_lock(&free ## Assets ## Mutex); \
 \
 	listRemove(&free ## Assets ## Queue, &listItr); \
@@ -175,8 +506,8 @@ for (ListIterator listItr = listGetIterator(&free ## Assets ## Queue); \
 	 !listIteratorAtEnd(listItr); \
 	 listMoveIterator(&listItr)) \
 { \
-	Asset *asset = LIST_ITERATOR_GET_ELEMENT(Asset, listItr); \
-	hashMapInsert(assets, &asset->name, asset); \
+	Asset *asset = *LIST_ITERATOR_GET_ELEMENT(Asset*, listItr); \
+	hashMapInsert(assets, &asset->name, &asset); \
 } \
 \
 listClear(&free ## Assets ## Queue); \
@@ -186,27 +517,111 @@ for (HashMapIterator itr = hashMapGetIterator(upload ## Assets ## Queue); \
 	 !hashMapIteratorAtEnd(itr); \
 	 hashMapMoveIterator(&itr)) \
 { \
-	Asset *asset = hashMapIteratorGetValue(itr); \
-	hashMapInsert(assets, &asset->name, asset); \
+	free ## Asset ## Data(hashMapIteratorGetValue(itr)); \
 } \
 \
 freeHashMap(&upload ## Assets ## Queue); \
 pthread_mutex_destroy(&upload ## Assets ## Mutex); \
 \
+for (HashMapIterator itr = hashMapGetIterator(loading ## Assets); \
+	 !hashMapIteratorAtEnd(itr); \
+	 hashMapMoveIterator(&itr)) \
+{ \
+	AssetLoadingState *loadingState = hashMapIteratorGetValue(itr); \
+	completeLoadingStatePromises(loadingState); \
+\
+	/* Dependent jobs were released before the asset thread pool was freed */ \
+	listClear(&loadingState->dependentJobs); \
+} \
+\
 freeHashMap(&loading ## Assets); \
 pthread_mutex_destroy(&loading ## Assets ## Mutex); \
 \
+listClear(&unused ## Assets ## Queue); \
+freeHashMap(&pending ## Assets ## References); \
+\
+/* Assets which haven't become resident yet are still in the asset map */ \
+listClear(&uploaded ## Assets); \
+\
+/* The asset manager thread frees the evicted assets before it exits */ \
+\
 for (HashMapIterator itr = hashMapGetIterator(assets); \
 	 !hashMapIteratorAtEnd(itr); \
 	 hashMapMoveIterator(&itr)) \
 { \
-	free ## Asset ## Data(hashMapIteratorGetValue(itr)); \
+	Asset *asset = *(Asset**)hashMapIteratorGetValue(itr); \
+	free ## Asset ## Data(asset); \
+	free(asset); \
 } \
 \
+freeHashMap(&published ## Assets); \
 freeHashMap(&assets); \
 pthread_mutex_destroy(&assets ## Mutex)
 
+ASSET_EVICTION_FUNCTIONS(model, models, Model, Models, MODEL, "Model");
+ASSET_EVICTION_FUNCTIONS(
+	texture,
+	textures,
+	Texture,
+	Textures,
+	TEXTURE,
+	"Texture");
+ASSET_EVICTION_FUNCTIONS(font, fonts, Font, Fonts, FONT, "Font");
+ASSET_EVICTION_FUNCTIONS(image, images, Image, Images, IMAGE, "Image");
+ASSET_EVICTION_FUNCTIONS(
+	audio,
+	audioFiles,
+	AudioFile,
+	Audio,
+	AUDIO,
+	"Audio");
+ASSET_EVICTION_FUNCTIONS(
+	particle,
+	particles,
+	Particle,
+	Particles,
+	PARTICLE,
+	"Particle");
+ASSET_EVICTION_FUNCTIONS(
+	cubemap,
+	cubemaps,
+	Cubemap,
+	Cubemaps,
+	CUBEMAP,
+	"Cubemap");
+
+#define NUM_ASSET_TYPES 7
+
+#define ASSET_EVICTOR(assets, Asset, Assets) \
+{ \
+	&assets ## Memory, \
+	&config.assetsConfig.max ## Asset ## Memory, \
+	&evictNextUnused ## Asset, \
+	&findUnused ## Asset, \
+	&evictUnused ## Asset, \
+	&freeEvicted ## Assets \
+}
+
+internal const AssetEvictor assetEvictors[NUM_ASSET_TYPES] = {
+	ASSET_EVICTOR(models, Model, Models),
+	ASSET_EVICTOR(textures, Texture, Textures),
+	ASSET_EVICTOR(fonts, Font, Fonts),
+	ASSET_EVICTOR(images, Image, Images),
+	ASSET_EVICTOR(audioFiles, AudioFile, Audio),
+	ASSET_EVICTOR(particles, Particle, Particles),
+	ASSET_EVICTOR(cubemaps, Cubemap, Cubemaps)
+};
+
 void initializeAssetManager(real64 *dt) {
+	// Without an archive every asset is loaded from its loose file
+	if (config.assetsConfig.archive)
+	{
+		openAssetFileArchive(config.assetsConfig.archive);
+	}
+
+	retiredAssetMaps = createList(sizeof(HashMap));
+	pthread_mutex_init(&retiredAssetMapsMutex, NULL);
+
 	INITIALIZE_ASSET(models, Model, Models, MODELS);
 	INITIALIZE_ASSET(textures, Texture, Textures, TEXTURES);
 	INITIALIZE_ASSET(fonts, Font, Fonts, FONTS);
@@ -222,13 +637,12 @@ void initializeAssetManager(real64 *dt) {
 		(ComparisonOp)&strcmp);
 	pthread_mutex_init(&materialFoldersMutex, NULL);
 
-	assetThreadCount = 0;
-	pthread_mutex_init(&assetThreadsMutex, NULL);
-	pthread_cond_init(&assetThreadsCondition, NULL);
+	assetThreadPool = createThreadPool(config.assetsConfig.maxThreadCount);
 
-	totalThreadCount = 0;
-	pthread_mutex_init(&totalThreadsMutex, NULL);
-	pthread_cond_init(&totalThreadsCondition, NULL);
+	initializeAssetUploads();
+
+	assetManagerTick = 0;
+	assetMemory = 0;
 
 	assetManagerIsShutdown = false;
 	pthread_mutex_init(&assetManagerShutdownMutex, NULL);
@@ -247,32 +661,22 @@ uint32 getNumLoadingAssets(void)
 {
 	uint32 numLoadingAssets = 0;
 
+	// Assets are loading until they've been uploaded
 	GET_LOADING_ASSET_COUNT(numLoadingAssets, Models);
-	GET_UPLOAD_ASSET_COUNT(numLoadingAssets, Models);
-
 	GET_LOADING_ASSET_COUNT(numLoadingAssets, Textures);
-	GET_UPLOAD_ASSET_COUNT(numLoadingAssets, Textures);
-
 	GET_LOADING_ASSET_COUNT(numLoadingAssets, Fonts);
-	GET_UPLOAD_ASSET_COUNT(numLoadingAssets, Fonts);
-
 	GET_LOADING_ASSET_COUNT(numLoadingAssets, Images);
-	GET_UPLOAD_ASSET_COUNT(numLoadingAssets, Images);
-
 	GET_LOADING_ASSET_COUNT(numLoadingAssets, Audio);
-	GET_UPLOAD_ASSET_COUNT(numLoadingAssets, Audio);
-
 	GET_LOADING_ASSET_COUNT(numLoadingAssets, Particles);
-	GET_UPLOAD_ASSET_COUNT(numLoadingAssets, Particles);
-
 	GET_LOADING_ASSET_COUNT(numLoadingAssets, Cubemaps);
-	GET_UPLOAD_ASSET_COUNT(numLoadingAssets, Cubemaps);
 
 	return numLoadingAssets;
 }
 
 void setUpdateAssetManagerFlag(void)
 {
+	__atomic_add_fetch(&assetManagerTick, 1, __ATOMIC_RELAXED);
+
 	pthread_mutex_lock(&updateAssetManagerMutex);
 	updateAssetManagerFlag = true;
 	pthread_mutex_unlock(&updateAssetManagerMutex);
@@ -295,19 +699,29 @@ void* updateAssetManager(void *arg)
 
 		pthread_mutex_unlock(&exitAssetManagerMutex);
 
-		UPDATE_ASSET(model, models, Model, Models, MODEL, "Model");
-		UPDATE_ASSET(texture, textures, Texture, Textures, TEXTURE, "Texture");
-		UPDATE_ASSET(font, fonts, Font, Fonts, FONT, "Font");
-		UPDATE_ASSET(image, images, Image, Images, IMAGE, "Image");
-		UPDATE_ASSET(audio, audioFiles, AudioFile, Audio, AUDIO, "Audio");
-		UPDATE_ASSET(
-			particle,
-			particles,
-			Particle,
-			Particles,
-			PARTICLE,
-			"Particle");
-		UPDATE_ASSET(cubemap, cubemaps, Cubemap, Cubemaps, CUBEMAP, "Cubemap");
+		uint64 tick = __atomic_load_n(&assetManagerTick, __ATOMIC_RELAXED);
+
+		for (uint8 i = 0; i < NUM_ASSET_TYPES; i++)
+		{
+			const AssetEvictor *evictor = &assetEvictors[i];
+
+			while (evictor->evictNextUnusedAsset(tick, dt));
+
+			while (isOverMemoryBudget(
+				__atomic_load_n(evictor->memory, __ATOMIC_RELAXED),
+				*evictor->maxMemory) &&
+				evictAssetOverBudget(i, 1, tick, dt));
+		}
+
+		while (isOverMemoryBudget(
+			__atomic_load_n(&assetMemory, __ATOMIC_RELAXED),
+			config.assetsConfig.maxMemory) &&
+			evictAssetOverBudget(0, NUM_ASSET_TYPES, tick, dt));
+
+		for (uint8 i = 0; i < NUM_ASSET_TYPES; i++)
+		{
+			assetEvictors[i].freeEvictedAssets();
+		}
 
 		pthread_mutex_lock(&updateAssetManagerMutex);
 
@@ -326,15 +740,113 @@ void* updateAssetManager(void *arg)
 	EXIT_THREAD(NULL);
 }
 
+bool evictAssetOverBudget(
+	uint8 firstAssetType,
+	uint8 numAssetTypes,
+	uint64 tick,
+	real64 dt)
+{
+	int32 assetType = -1;
+	UnusedAsset unusedAsset = {};
+
+	for (uint8 i = firstAssetType; i < firstAssetType + numAssetTypes; i++)
+	{
+		UnusedAsset nextUnusedAsset;
+		if (assetEvictors[i].findUnusedAsset(tick, dt, &nextUnusedAsset) &&
+			(assetType == -1 ||
+			 isEvictedBefore(&nextUnusedAsset, &unusedAsset)))
+		{
+			assetType = i;
+			unusedAsset = nextUnusedAsset;
+		}
+	}
+
+	if (assetType == -1)
+	{
+		return false;
+	}
+
+	// The asset is only queued again if it turns out to have been used since
+	assetEvictors[assetType].evictUnusedAsset(tick, dt, &unusedAsset.name);
+
+	return true;
+}
+
+bool isEvictedBefore(
+	const UnusedAsset *unusedAsset,
+	const UnusedAsset *otherUnusedAsset)
+{
+	if (unusedAsset->priority != otherUnusedAsset->priority)
+	{
+		return unusedAsset->priority < otherUnusedAsset->priority;
+	}
+
+	return unusedAsset->lastUsed < otherUnusedAsset->lastUsed;
+}
+
+void publishAssets(HashMap assets, HashMap *publishedAssets)
+{
+	HashMap retiredAssets = __atomic_exchange_n(
+		publishedAssets,
+		copyHashMap(assets),
+		__ATOMIC_ACQ_REL);
+
+	// Lookups which started before the swap may still be reading the old map
+	pthread_mutex_lock(&retiredAssetMapsMutex);
+	listPushBack(&retiredAssetMaps, &retiredAssets);
+	pthread_mutex_unlock(&retiredAssetMapsMutex);
+}
+
+void freeRetiredAssetMaps(void)
+{
+	pthread_mutex_lock(&retiredAssetMapsMutex);
+
+	for (ListIterator itr = listGetIterator(&retiredAssetMaps);
+		 !listIteratorAtEnd(itr);
+		 listMoveIterator(&itr))
+	{
+		freeHashMap(LIST_ITERATOR_GET_ELEMENT(HashMap, itr));
+	}
+
+	listClear(&retiredAssetMaps);
+
+	pthread_mutex_unlock(&retiredAssetMapsMutex);
+}
+
+bool isOverMemoryBudget(uint64 memory, uint64 budget)
+{
+	return budget > 0 && memory > budget;
+}
+
+bool canEvictAsset(
+	uint64 lastUsed,
+	uint64 tick,
+	real64 minLifetime,
+	real64 dt,
+	bool overBudget)
+{
+	// The asset may have been used after the tick was read, and assets used
+	// on the previous tick are likely to be used on this one as well
+	if (tick <= lastUsed + 1)
+	{
+		return false;
+	}
+
+	// Being over budget doesn't wait for the minimum lifetime to be up
+	return overBudget || (tick - lastUsed) * dt >= minLifetime;
+}
+
 void uploadAssets(void)
 {
-	UPLOAD_ASSET(
-		model,
-		models,
-		Model,
-		Models,
-		"Model",
-		uploadModelToGPU(model));
+	beginAssetUploads();
+
+	MAKE_ASSETS_RESIDENT(model, models, Model, Models);
+	MAKE_ASSETS_RESIDENT(texture, textures, Texture, Textures);
+	MAKE_ASSETS_RESIDENT(font, fonts, Font, Fonts);
+	MAKE_ASSETS_RESIDENT(image, images, Image, Images);
+	MAKE_ASSETS_RESIDENT(audio, audioFiles, AudioFile, Audio);
+	MAKE_ASSETS_RESIDENT(particle, particles, Particle, Particles);
+	MAKE_ASSETS_RESIDENT(cubemap, cubemaps, Cubemap, Cubemaps);
 
 	UPLOAD_ASSET(
 		texture,
@@ -351,6 +863,16 @@ void uploadAssets(void)
 			true,
 			false));
 
+	// Models are only queued once their textures have been loaded, so
+	// uploading textures first means models never appear without them
+	UPLOAD_ASSET(
+		model,
+		models,
+		Model,
+		Models,
+		"Model",
+		uploadModelToGPU(model));
+
 	UPLOAD_ASSET(
 		font,
 		fonts,
@@ -404,10 +926,16 @@ void uploadAssets(void)
 		Cubemaps,
 		"Cubemap",
 		uploadCubemapToGPU(cubemap));
+
+	endAssetUploads();
 }
 
 void freeAssets(void)
 {
+	// Nothing looks assets up while they're being freed, so nothing can be
+	// using the retired maps anymore either
+	freeRetiredAssetMaps();
+
 	FREE_ASSET(model, Model, Models);
 	FREE_ASSET(texture, Texture, Textures);
 	FREE_ASSET(font, Font, Fonts);
@@ -423,6 +951,15 @@ void shutdownAssetManager(void)
 	assetManagerIsShutdown = true;
 	pthread_mutex_unlock(&assetManagerShutdownMutex);
 
+	// Loads which haven't been started yet are dropped instead of waited on
+	CANCEL_LOADING_ASSETS(Models);
+	CANCEL_LOADING_ASSETS(Textures);
+	CANCEL_LOADING_ASSETS(Fonts);
+	CANCEL_LOADING_ASSETS(Images);
+	CANCEL_LOADING_ASSETS(Audio);
+	CANCEL_LOADING_ASSETS(Particles);
+	CANCEL_LOADING_ASSETS(Cubemaps);
+
 	pthread_mutex_lock(&exitAssetManagerMutex);
 	exitAssetManagerThread = true;
 	pthread_mutex_unlock(&exitAssetManagerMutex);
@@ -436,20 +973,16 @@ void shutdownAssetManager(void)
 	pthread_mutex_destroy(&updateAssetManagerMutex);
 	pthread_cond_destroy(&updateAssetManagerCondition);
 
-	pthread_mutex_lock(&totalThreadsMutex);
-
-	while (totalThreadCount > 0)
-	{
-		pthread_cond_wait(&totalThreadsCondition, &totalThreadsMutex);
-	}
-
-	pthread_mutex_unlock(&totalThreadsMutex);
-
-	pthread_mutex_destroy(&totalThreadsMutex);
-	pthread_cond_destroy(&totalThreadsCondition);
+	RELEASE_LOADING_ASSET_DEPENDENT_JOBS(Models);
+	RELEASE_LOADING_ASSET_DEPENDENT_JOBS(Textures);
+	RELEASE_LOADING_ASSET_DEPENDENT_JOBS(Fonts);
+	RELEASE_LOADING_ASSET_DEPENDENT_JOBS(Images);
+	RELEASE_LOADING_ASSET_DEPENDENT_JOBS(Audio);
+	RELEASE_LOADING_ASSET_DEPENDENT_JOBS(Particles);
+	RELEASE_LOADING_ASSET_DEPENDENT_JOBS(Cubemaps);
 
-	pthread_mutex_destroy(&assetThreadsMutex);
-	pthread_cond_destroy(&assetThreadsCondition);
+	// Worker threads finish every queued job, including the released ones
+	freeThreadPool(&assetThreadPool);
 
 	pthread_mutex_destroy(&assetManagerShutdownMutex);
 
@@ -461,6 +994,8 @@ void shutdownAssetManager(void)
 	DESTROY_ASSET(particle, particles, Particle, Particles);
 	DESTROY_ASSET(cubemap, cubemaps, Cubemap, Cubemaps);
 
+	shutdownAssetUploads();
+
 	for (HashMapIterator itr = hashMapGetIterator(materialFolders);
 		 !hashMapIteratorAtEnd(itr);
 		 hashMapMoveIterator(&itr))
@@ -478,4 +1013,157 @@ void shutdownAssetManager(void)
 
 	freeHashMap(&materialFolders);
 	pthread_mutex_destroy(&materialFoldersMutex);
-}
\ No newline at end of file
+
+	freeRetiredAssetMaps();
+	pthread_mutex_destroy(&retiredAssetMapsMutex);
+
+	closeAssetFileArchive();
+}
+
+void addAssetPromise(AssetLoadingState *loadingState, Promise *promise)
+{
+	if (promise)
+	{
+		listPushBack(&loadingState->promises, &promise);
+	}
+}
+
+void completeAssetPromise(Promise *promise)
+{
+	if (promise)
+	{
+		pComplete(promise, NULL);
+	}
+}
+
+void addAssetDependentJob(AssetLoadingState *loadingState, JobNode *job)
+{
+	if (job)
+	{
+		jobNodeAddDependency(job);
+		listPushBack(&loadingState->dependentJobs, &job);
+	}
+}
+
+void finishLoadingAsset(HashMap loadingAssets, UUID *name)
+{
+	AssetLoadingState *loadingState = hashMapGetData(loadingAssets, name);
+	if (loadingState)
+	{
+		completeLoadingStatePromises(loadingState);
+		finishLoadingStateDependentJobs(loadingState);
+		hashMapDelete(loadingAssets, name);
+	}
+}
+
+void completeLoadingStatePromises(AssetLoadingState *loadingState)
+{
+	for (ListIterator itr = listGetIterator(&loadingState->promises);
+		 !listIteratorAtEnd(itr);
+		 listMoveIterator(&itr))
+	{
+		completeAssetPromise(*LIST_ITERATOR_GET_ELEMENT(Promise*, itr));
+	}
+
+	listClear(&loadingState->promises);
+}
+
+void finishLoadingStateDependentJobs(AssetLoadingState *loadingState)
+{
+	for (ListIterator itr = listGetIterator(&loadingState->dependentJobs);
+		 !listIteratorAtEnd(itr);
+		 listMoveIterator(&itr))
+	{
+		jobNodeFinishDependency(*LIST_ITERATOR_GET_ELEMENT(JobNode*, itr));
+	}
+
+	listClear(&loadingState->dependentJobs);
+}
+
+void useAsset(AssetUsage *usage)
+{
+	__atomic_store_n(
+		&usage->lastUsed,
+		__atomic_load_n(&assetManagerTick, __ATOMIC_RELAXED),
+		__ATOMIC_RELAXED);
+}
+
+void addPendingAssetReference(HashMap pendingReferences, UUID *name)
+{
+	uint32 *refCount = hashMapGetData(pendingReferences, name);
+	if (refCount)
+	{
+		(*refCount)++;
+	}
+	else
+	{
+		uint32 firstReference = 1;
+		hashMapInsert(pendingReferences, name, &firstReference);
+	}
+}
+
+void removePendingAssetReference(HashMap pendingReferences, UUID *name)
+{
+	uint32 *refCount = hashMapGetData(pendingReferences, name);
+	if (!refCount)
+	{
+		LOG_WARNING("%s released without being acquired\n", name->string);
+	}
+	else if (--(*refCount) == 0)
+	{
+		hashMapDelete(pendingReferences, name);
+	}
+}
+
+void releaseAssetUsage(List *unusedAssets, UUID *name, AssetUsage *usage)
+{
+	if (__atomic_load_n(&usage->refCount, __ATOMIC_RELAXED) == 0)
+	{
+		LOG_WARNING("%s released without being acquired\n", name->string);
+		return;
+	}
+
+	// Assets are only queued once they've become resident
+	if (__atomic_sub_fetch(&usage->refCount, 1, __ATOMIC_RELAXED) == 0 &&
+		usage->resident)
+	{
+		useAsset(usage);
+		queueUnusedAsset(unusedAssets, name, usage);
+	}
+}
+
+void queueUnusedAsset(List *unusedAssets, UUID *name, AssetUsage *usage)
+{
+	if (!usage->queued)
+	{
+		UnusedAsset unusedAsset;
+		unusedAsset.name = *name;
+		unusedAsset.lastUsed = usage->lastUsed;
+		unusedAsset.priority = usage->priority;
+
+		listPushBack(unusedAssets, &unusedAsset);
+		usage->queued = true;
+	}
+}
+
+void initializeAssetUsage(
+	HashMap pendingReferences,
+	List *unusedAssets,
+	UUID *name,
+	AssetUsage *usage)
+{
+	// Non-resident assets can already have been acquired through the asset map
+	uint32 *refCount = hashMapGetData(pendingReferences, name);
+	if (refCount)
+	{
+		usage->refCount += *refCount;
+		hashMapDelete(pendingReferences, name);
+	}
+
+	useAsset(usage);
+
+	if (usage->refCount == 0)
+	{
+		queueUnusedAsset(unusedAssets, name, usage);
+	}
+}
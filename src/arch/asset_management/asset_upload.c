@@ -0,0 +1,171 @@
+#include "asset_management/asset_upload.h"
+#include "asset_management/upload_scheduler.h"
+
+#include "core/config.h"
+#include "core/log.h"
+
+#include <GLFW/glfw3.h>
+
+#include <string.h>
+
+extern Config config;
+
+internal AssetUploadScheduler assetUploadScheduler;
+
+internal GLuint stagingBuffer;
+internal uint8 *stagingData;
+
+internal real64 getUploadTime(void);
+internal void* createUploadFence(void);
+internal bool isUploadFenceSignalled(void *fence);
+internal void deleteUploadFence(void *fence);
+
+internal const AssetUploadBackend glUploadBackend = {
+	&getUploadTime,
+	&createUploadFence,
+	&isUploadFenceSignalled,
+	&deleteUploadFence
+};
+
+void initializeAssetUploads(void)
+{
+	stagingBuffer = 0;
+	stagingData = NULL;
+
+	uint64 stagingSize = config.assetsConfig.stagingBufferSize;
+
+	if (stagingSize > 0 && GLEW_ARB_buffer_storage)
+	{
+		GLbitfield flags =
+			GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		glGenBuffers(1, &stagingBuffer);
+		glBindBuffer(GL_COPY_READ_BUFFER, stagingBuffer);
+		glBufferStorage(GL_COPY_READ_BUFFER, stagingSize, NULL, flags);
+		stagingData = glMapBufferRange(
+			GL_COPY_READ_BUFFER,
+			0,
+			stagingSize,
+			flags);
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+		if (!stagingData)
+		{
+			LOG("Failed to map the asset staging buffer\n");
+			glDeleteBuffers(1, &stagingBuffer);
+			stagingBuffer = 0;
+		}
+	}
+
+	// Without a staging buffer assets are uploaded straight from memory
+	initializeUploadScheduler(
+		&assetUploadScheduler,
+		&glUploadBackend,
+		config.assetsConfig.maxFrameUploadTime,
+		config.assetsConfig.maxFrameUploadSize,
+		stagingData ? stagingSize : 0);
+}
+
+void shutdownAssetUploads(void)
+{
+	freeUploadScheduler(&assetUploadScheduler);
+
+	if (stagingBuffer)
+	{
+		glBindBuffer(GL_COPY_READ_BUFFER, stagingBuffer);
+		glUnmapBuffer(GL_COPY_READ_BUFFER);
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+		glDeleteBuffers(1, &stagingBuffer);
+	}
+
+	stagingBuffer = 0;
+	stagingData = NULL;
+}
+
+void beginAssetUploads(void)
+{
+	beginUploadFrame(&assetUploadScheduler);
+}
+
+bool canUploadAsset(uint64 size)
+{
+	return canScheduleUpload(&assetUploadScheduler, size);
+}
+
+uint64 finishAssetUpload(uint64 size)
+{
+	return scheduleUpload(&assetUploadScheduler, size);
+}
+
+void endAssetUploads(void)
+{
+	endUploadFrame(&assetUploadScheduler);
+}
+
+bool hasAssetUploadFinished(uint64 batch)
+{
+	return isUploadBatchFinished(&assetUploadScheduler, batch);
+}
+
+const void* stageAssetData(GLenum target, const void *data, uint64 size)
+{
+	uint64 offset;
+	if (!stagingData ||
+		!allocateUploadStagingMemory(&assetUploadScheduler, size, &offset))
+	{
+		return data;
+	}
+
+	memcpy(stagingData + offset, data, size);
+	glBindBuffer(target, stagingBuffer);
+
+	return (const void*)offset;
+}
+
+void unstageAssetData(GLenum target)
+{
+	glBindBuffer(target, 0);
+}
+
+void uploadAssetBufferData(GLenum target, const void *data, uint64 size)
+{
+	const void *stagedData = stageAssetData(GL_COPY_READ_BUFFER, data, size);
+	if (stagedData == data)
+	{
+		glBufferData(target, size, data, GL_STATIC_DRAW);
+		return;
+	}
+
+	glBufferData(target, size, NULL, GL_STATIC_DRAW);
+	glCopyBufferSubData(
+		GL_COPY_READ_BUFFER,
+		target,
+		(GLintptr)stagedData,
+		0,
+		size);
+
+	unstageAssetData(GL_COPY_READ_BUFFER);
+}
+
+real64 getUploadTime(void)
+{
+	return glfwGetTime();
+}
+
+void* createUploadFence(void)
+{
+	return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+bool isUploadFenceSignalled(void *fence)
+{
+	// Flushing makes sure the fence is signalled eventually
+	GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+	return result != GL_TIMEOUT_EXPIRED;
+}
+
+void deleteUploadFence(void *fence)
+{
+	glDeleteSync(fence);
+}
@@ -1,7 +1,9 @@
 #include "asset_management/asset_manager.h"
+#include "asset_management/asset_file.h"
 #include "asset_management/audio.h"
 
 #include "audio/audio.h"
+#include "audio/audio_stream.h"
 
 #include "core/log.h"
 #include "core/config.h"
@@ -42,52 +44,39 @@ void loadAudio(const char *name)
 	char *audioName = calloc(1, strlen(name) + 1);
 	strcpy(audioName, name);
 
-	bool skip = false;
-
 	UUID nameID = idFromName(name);
 
 	pthread_mutex_lock(&audioFilesMutex);
-	AudioFile *audioResource = hashMapGetData(audioFiles, &nameID);
+	AudioFile **audioResource = hashMapGetData(audioFiles, &nameID);
 
 	if (!audioResource)
 	{
 		pthread_mutex_unlock(&audioFilesMutex);
-		pthread_mutex_lock(&loadingAudioMutex);
-
-		if (hashMapGetData(loadingAudio, &nameID))
-		{
-			skip = true;
-		}
-
-		pthread_mutex_unlock(&loadingAudioMutex);
-
-		if (!skip)
-		{
-			pthread_mutex_lock(&uploadAudioMutex);
 
-			if (hashMapGetData(uploadAudioQueue, &nameID))
-			{
-				skip = true;
-			}
-
-			pthread_mutex_unlock(&uploadAudioMutex);
-		}
-
-		if (!skip)
-		{
-			START_ACQUISITION_THREAD(audio, Audio, Audio, audioName, nameID);
-			return;
-		}
+		QUEUE_ACQUISITION_JOB(
+			Audio,
+			Audio,
+			audioName,
+			nameID,
+			DEFAULT_ASSET_PRIORITY,
+			NULL,
+			NULL);
+		return;
 	}
 	else
 	{
 		pthread_mutex_unlock(&audioFilesMutex);
 	}
 
-	free(audioName);
+	freeAudioThreadArgs(audioName);
 }
 
-ACQUISITION_THREAD(Audio);
+ACQUISITION_JOB(Audio, Audio);
+
+void freeAudioThreadArgs(void *arg)
+{
+	free(arg);
+}
 
 void* loadAudioThread(void *arg)
 {
@@ -113,22 +102,62 @@ void* loadAudioThread(void *arg)
 		AudioFile audio = {};
 
 		audio.name = audioName;
-		audio.lifetime = config.assetsConfig.minAudioFileLifetime;
 
 		char *filename = getFullFilePath(
 			name,
 			"ogg",
 			"resources/audio");
 
-		audio.size = stb_vorbis_decode_filename(
-			filename,
-			&audio.channels,
-			&audio.sample_rate,
-			&audio.data);
+		uint64 fileSize;
+		uint8 *buffer;
+		const uint8 *fileData = readAssetFile(filename, &fileSize, &buffer);
 
 		free(filename);
 
-		if (audio.size == -1)
+		int32 vorbisError = 0;
+		stb_vorbis *decoder = fileData ? stb_vorbis_open_memory(
+			fileData,
+			fileSize,
+			&vorbisError,
+			NULL) : NULL;
+
+		if (!decoder)
+		{
+			audio.size = -1;
+		}
+		else if (stb_vorbis_stream_length_in_seconds(decoder) >=
+			MIN_STREAMED_AUDIO_DURATION)
+		{
+			stb_vorbis_info info = stb_vorbis_get_info(decoder);
+
+			audio.channels = info.channels;
+			audio.sample_rate = info.sample_rate;
+			audio.streamed = true;
+
+			// Streamed audio keeps its encoded data until it's freed
+			audio.encodedData = fileData;
+			audio.encodedSize = fileSize;
+			audio.encodedBuffer = buffer;
+			buffer = NULL;
+		}
+		else
+		{
+			audio.size = stb_vorbis_decode_memory(
+				fileData,
+				fileSize,
+				&audio.channels,
+				&audio.sample_rate,
+				&audio.data);
+		}
+
+		if (decoder)
+		{
+			stb_vorbis_close(decoder);
+		}
+
+		free(buffer);
+
+		if (audio.size < 0)
 		{
 			ASSET_LOG(
 				AUDIO,
@@ -163,9 +192,7 @@ void* loadAudioThread(void *arg)
 
 	ASSET_LOG_COMMIT(AUDIO, name);
 
-	pthread_mutex_lock(&loadingAudioMutex);
-	hashMapDelete(loadingAudio, &audioName);
-	pthread_mutex_unlock(&loadingAudioMutex);
+	FINISH_LOADING_ASSET(Audio, audioName);
 
 	free(name);
 
@@ -174,6 +201,12 @@ void* loadAudioThread(void *arg)
 
 int32 uploadAudioToSoundCard(AudioFile *audio)
 {
+	// Streamed audio is only transferred onto the sound card while it plays
+	if (audio->streamed)
+	{
+		return AL_NO_ERROR;
+	}
+
 	LOG("Transferring audio (%s) onto sound card...\n", audio->name.string);
 
 	alGetError();
@@ -208,14 +241,51 @@ GET_ASSET_FUNCTION(
 	audio,
 	audioFiles,
 	AudioFile,
+	Audio,
 	getAudio(const char *name),
 	idFromName(name));
 
+ACQUIRE_ASSET_FUNCTION(
+	audio,
+	audioFiles,
+	AudioFile,
+	Audio,
+	acquireAudio(const char *name),
+	idFromName(name));
+
+RELEASE_ASSET_FUNCTION(
+	audio,
+	audioFiles,
+	AudioFile,
+	Audio,
+	releaseAudio(const char *name),
+	idFromName(name));
+
+uint64 getAudioFileSize(const AudioFile *audio)
+{
+	if (audio->streamed)
+	{
+		// Encoded data borrowed from the asset archive isn't resident
+		return audio->encodedBuffer ? audio->encodedSize : 0;
+	}
+
+	// The decoded samples are kept around after they've been transferred
+	return (uint64)audio->size * sizeof(int16) * audio->channels * 2;
+}
+
 void freeAudioFileData(AudioFile *audio)
 {
 	LOG("Freeing audio (%s)...\n", audio->name.string);
 
-	free(audio->data);
+	if (audio->streamed)
+	{
+		stopAudioFileStreams(audio->name);
+		free(audio->encodedBuffer);
+	}
+	else
+	{
+		free(audio->data);
+	}
 
 	LOG("Successfully freed audio (%s)\n", audio->name.string);
 }
\ No newline at end of file
@@ -0,0 +1,665 @@
+#include "asset_management/cooked_texture.h"
+#include "asset_management/asset_file.h"
+
+#include "core/log.h"
+
+#include "file/utilities.h"
+
+#include <stb/stb_image.h>
+
+#include <malloc.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <dirent.h>
+
+#define COOKED_TEXTURE_NUM_COMPONENTS 4
+
+#define BLOCK_SIZE 4
+#define NUM_BLOCK_PIXELS (BLOCK_SIZE * BLOCK_SIZE)
+
+#define NUM_SOURCE_FILE_FORMATS 6
+internal const char* sourceFileFormats[NUM_SOURCE_FILE_FORMATS] = {
+	"tga", "png", "jpg", "bmp", "gif", "psd"
+};
+
+internal uint8* downsampleMipLevel(
+	const uint8 *pixels,
+	uint32 width,
+	uint32 height);
+
+internal void compressMipLevel(
+	const uint8 *pixels,
+	uint32 width,
+	uint32 height,
+	TextureFormat format,
+	uint8 *output);
+internal void encodeColorBlock(uint8 block[NUM_BLOCK_PIXELS][4], uint8 *output);
+internal void encodeChannelBlock(
+	uint8 block[NUM_BLOCK_PIXELS][4],
+	uint32 channel,
+	uint8 *output);
+
+internal uint16 packRGB565(const uint8 *color);
+internal void unpackRGB565(uint16 packedColor, uint8 *color);
+
+internal bool isSourceTextureFile(const char *filename);
+
+int32 cookTexture(
+	const char *filename,
+	const char *cookedFilename,
+	TextureFormat format)
+{
+	LOG("Cooking %s...\n", filename);
+
+	int32 width;
+	int32 height;
+	int32 numComponents;
+
+	uint8 *levelPixels[MAX_TEXTURE_MIP_LEVELS];
+	levelPixels[0] = stbi_load(
+		filename,
+		&width,
+		&height,
+		&numComponents,
+		COOKED_TEXTURE_NUM_COMPONENTS);
+
+	if (!levelPixels[0])
+	{
+		LOG("Failed to load %s\n", filename);
+		return -1;
+	}
+
+	CookedTextureHeader header = {};
+	memcpy(header.magic, COOKED_TEXTURE_MAGIC, sizeof(header.magic));
+	header.version = COOKED_TEXTURE_FILE_VERSION;
+	header.width = width;
+	header.height = height;
+	header.numComponents = COOKED_TEXTURE_NUM_COMPONENTS;
+	header.format = format;
+	header.dataOffset = sizeof(CookedTextureHeader);
+
+	uint64 dataSize = 0;
+	for (uint32 i = 0; i < MAX_TEXTURE_MIP_LEVELS; i++)
+	{
+		TextureMipLevel *mipLevel = &header.mipLevels[i];
+
+		if (i == 0)
+		{
+			mipLevel->width = width;
+			mipLevel->height = height;
+		}
+		else
+		{
+			TextureMipLevel *previousMipLevel = &header.mipLevels[i - 1];
+
+			levelPixels[i] = downsampleMipLevel(
+				levelPixels[i - 1],
+				previousMipLevel->width,
+				previousMipLevel->height);
+
+			mipLevel->width = MAX(previousMipLevel->width / 2, 1);
+			mipLevel->height = MAX(previousMipLevel->height / 2, 1);
+		}
+
+		mipLevel->offset = dataSize;
+		mipLevel->size = getTextureMipLevelSize(
+			format,
+			COOKED_TEXTURE_NUM_COMPONENTS,
+			mipLevel->width,
+			mipLevel->height);
+
+		dataSize += mipLevel->size;
+		header.numMipLevels++;
+
+		if (mipLevel->width == 1 && mipLevel->height == 1)
+		{
+			break;
+		}
+	}
+
+	uint8 *data = malloc(dataSize);
+	for (uint32 i = 0; i < header.numMipLevels; i++)
+	{
+		TextureMipLevel *mipLevel = &header.mipLevels[i];
+
+		if (format == TEXTURE_FORMAT_UNCOMPRESSED)
+		{
+			memcpy(data + mipLevel->offset, levelPixels[i], mipLevel->size);
+		}
+		else
+		{
+			compressMipLevel(
+				levelPixels[i],
+				mipLevel->width,
+				mipLevel->height,
+				format,
+				data + mipLevel->offset);
+		}
+
+		free(levelPixels[i]);
+	}
+
+	int32 error = 0;
+
+	FILE *file = fopen(cookedFilename, "wb");
+	if (file)
+	{
+		if (fwrite(&header, sizeof(CookedTextureHeader), 1, file) != 1 ||
+			fwrite(data, 1, dataSize, file) != dataSize)
+		{
+			error = -1;
+		}
+
+		fclose(file);
+	}
+	else
+	{
+		error = -1;
+	}
+
+	free(data);
+
+	if (error == -1)
+	{
+		LOG("Failed to write %s\n", cookedFilename);
+		remove(cookedFilename);
+		return -1;
+	}
+
+	LOG("Successfully cooked %s into %s (%d mip levels)\n",
+		filename,
+		cookedFilename,
+		header.numMipLevels);
+
+	return 0;
+}
+
+int32 cookTextures(const char *folder, TextureFormat format)
+{
+	DIR *dir = opendir(folder);
+	if (!dir)
+	{
+		LOG("Failed to open %s\n", folder);
+		return -1;
+	}
+
+	int32 error = 0;
+
+	struct dirent *dirEntry = readdir(dir);
+	while (dirEntry && error != -1)
+	{
+		if (strcmp(dirEntry->d_name, ".") && strcmp(dirEntry->d_name, ".."))
+		{
+			char *path = getFullFilePath(dirEntry->d_name, NULL, folder);
+
+			struct stat info;
+			stat(path, &info);
+
+			if (S_ISDIR(info.st_mode))
+			{
+				error = cookTextures(path, format);
+			}
+			else if (S_ISREG(info.st_mode) && isSourceTextureFile(path))
+			{
+				char *textureFilename = removeExtension(path);
+				char *cookedFilename = malloc(
+					strlen(textureFilename) +
+					strlen(COOKED_TEXTURE_EXTENSION) + 2);
+				sprintf(
+					cookedFilename,
+					"%s.%s",
+					textureFilename,
+					COOKED_TEXTURE_EXTENSION);
+
+				error = cookTexture(path, cookedFilename, format);
+
+				free(cookedFilename);
+				free(textureFilename);
+			}
+
+			free(path);
+		}
+
+		dirEntry = readdir(dir);
+	}
+
+	closedir(dir);
+
+	return error;
+}
+
+int32 loadCookedTextureData(
+	const char *filename,
+	int32 numComponents,
+	TextureData *data)
+{
+	uint64 size;
+	uint8 *buffer;
+	const uint8 *fileData = readAssetFile(filename, &size, &buffer);
+
+	if (!fileData)
+	{
+		return -1;
+	}
+
+	const CookedTextureHeader *header = (CookedTextureHeader*)fileData;
+
+	if (size < sizeof(CookedTextureHeader) ||
+		memcmp(header->magic, COOKED_TEXTURE_MAGIC, sizeof(header->magic)))
+	{
+		LOG("%s is not a cooked texture\n", filename);
+		free(buffer);
+		return -1;
+	}
+
+	if (header->version != COOKED_TEXTURE_FILE_VERSION)
+	{
+		LOG_WARNING("%s out of date\n", filename);
+		free(buffer);
+		return -1;
+	}
+
+	if (header->numComponents != numComponents)
+	{
+		LOG("%s was cooked with %d components instead of %d\n",
+			filename,
+			header->numComponents,
+			numComponents);
+		free(buffer);
+		return -1;
+	}
+
+	uint64 dataSize = size - header->dataOffset;
+
+	bool valid =
+		header->dataOffset >= sizeof(CookedTextureHeader) &&
+		header->dataOffset <= size &&
+		header->format <= TEXTURE_FORMAT_BC5 &&
+		header->numMipLevels > 0 &&
+		header->numMipLevels <= MAX_TEXTURE_MIP_LEVELS &&
+		header->width > 0 &&
+		header->height > 0;
+
+	// Mip levels are stored one after another, from largest to smallest
+	uint64 offset = 0;
+	for (uint32 i = 0; valid && i < header->numMipLevels; i++)
+	{
+		const TextureMipLevel *mipLevel = &header->mipLevels[i];
+
+		uint32 width = i == 0 ?
+			header->width : MAX(header->mipLevels[i - 1].width / 2, 1);
+		uint32 height = i == 0 ?
+			header->height : MAX(header->mipLevels[i - 1].height / 2, 1);
+
+		valid =
+			mipLevel->width == width &&
+			mipLevel->height == height &&
+			mipLevel->size == getTextureMipLevelSize(
+				header->format,
+				header->numComponents,
+				width,
+				height) &&
+			mipLevel->offset == offset &&
+			mipLevel->size <= dataSize - offset;
+
+		offset += mipLevel->size;
+	}
+
+	if (!valid)
+	{
+		LOG("%s is corrupt\n", filename);
+		free(buffer);
+		return -1;
+	}
+
+	data->width = header->width;
+	data->height = header->height;
+	data->numComponents = header->numComponents;
+	data->format = header->format;
+	data->numMipLevels = header->numMipLevels;
+	memcpy(
+		data->mipLevels,
+		header->mipLevels,
+		header->numMipLevels * sizeof(TextureMipLevel));
+
+	// Reuse the file's buffer when there is one, so loose files are only
+	// ever read once
+	if (buffer)
+	{
+		memmove(buffer, buffer + header->dataOffset, dataSize);
+		data->data = buffer;
+	}
+	else
+	{
+		data->data = malloc(MAX(dataSize, 1));
+		memcpy(data->data, fileData + header->dataOffset, dataSize);
+	}
+
+	return 0;
+}
+
+uint64 getTextureMipLevelSize(
+	TextureFormat format,
+	uint32 numComponents,
+	uint32 width,
+	uint32 height)
+{
+	uint64 numBlocks =
+		(uint64)((width + BLOCK_SIZE - 1) / BLOCK_SIZE) *
+		((height + BLOCK_SIZE - 1) / BLOCK_SIZE);
+
+	switch (format)
+	{
+		case TEXTURE_FORMAT_BC1:
+			return numBlocks * 8;
+		case TEXTURE_FORMAT_BC3:
+		case TEXTURE_FORMAT_BC5:
+			return numBlocks * 16;
+		default:
+			break;
+	}
+
+	return (uint64)width * height * numComponents;
+}
+
+uint8* downsampleMipLevel(
+	const uint8 *pixels,
+	uint32 width,
+	uint32 height)
+{
+	uint32 mipWidth = MAX(width / 2, 1);
+	uint32 mipHeight = MAX(height / 2, 1);
+
+	uint8 *mipPixels = malloc(
+		mipWidth * mipHeight * COOKED_TEXTURE_NUM_COMPONENTS);
+
+	uint32 stride = width * COOKED_TEXTURE_NUM_COMPONENTS;
+
+	// Odd sizes repeat the last row or column instead of reading past it
+	for (uint32 y = 0; y < mipHeight; y++)
+	{
+		const uint8 *row0 = pixels + MIN(y * 2, height - 1) * stride;
+		const uint8 *row1 = pixels + MIN(y * 2 + 1, height - 1) * stride;
+
+		for (uint32 x = 0; x < mipWidth; x++)
+		{
+			uint32 x0 = MIN(x * 2, width - 1) * COOKED_TEXTURE_NUM_COMPONENTS;
+			uint32 x1 =
+				MIN(x * 2 + 1, width - 1) * COOKED_TEXTURE_NUM_COMPONENTS;
+
+			uint8 *mipPixel =
+				mipPixels + (y * mipWidth + x) * COOKED_TEXTURE_NUM_COMPONENTS;
+
+			for (uint32 i = 0; i < COOKED_TEXTURE_NUM_COMPONENTS; i++)
+			{
+				uint32 sum =
+					row0[x0 + i] + row0[x1 + i] + row1[x0 + i] + row1[x1 + i];
+				mipPixel[i] = (sum + 2) / 4;
+			}
+		}
+	}
+
+	return mipPixels;
+}
+
+void compressMipLevel(
+	const uint8 *pixels,
+	uint32 width,
+	uint32 height,
+	TextureFormat format,
+	uint8 *output)
+{
+	for (uint32 blockY = 0; blockY < height; blockY += BLOCK_SIZE)
+	{
+		for (uint32 blockX = 0; blockX < width; blockX += BLOCK_SIZE)
+		{
+			// Blocks which hang over the edge repeat the edge pixels
+			uint8 block[NUM_BLOCK_PIXELS][4];
+			for (uint32 i = 0; i < NUM_BLOCK_PIXELS; i++)
+			{
+				uint32 x = MIN(blockX + i % BLOCK_SIZE, width - 1);
+				uint32 y = MIN(blockY + i / BLOCK_SIZE, height - 1);
+
+				memcpy(
+					block[i],
+					pixels + (y * width + x) * COOKED_TEXTURE_NUM_COMPONENTS,
+					4);
+			}
+
+			switch (format)
+			{
+				case TEXTURE_FORMAT_BC1:
+					encodeColorBlock(block, output);
+					output += 8;
+					break;
+				case TEXTURE_FORMAT_BC3:
+					encodeChannelBlock(block, 3, output);
+					encodeColorBlock(block, output + 8);
+					output += 16;
+					break;
+				case TEXTURE_FORMAT_BC5:
+					encodeChannelBlock(block, 0, output);
+					encodeChannelBlock(block, 1, output + 8);
+					output += 16;
+					break;
+				default:
+					break;
+			}
+		}
+	}
+}
+
+void encodeColorBlock(uint8 block[NUM_BLOCK_PIXELS][4], uint8 *output)
+{
+	uint8 minColor[3] = { 255, 255, 255 };
+	uint8 maxColor[3] = { 0, 0, 0 };
+
+	for (uint32 i = 0; i < NUM_BLOCK_PIXELS; i++)
+	{
+		for (uint32 j = 0; j < 3; j++)
+		{
+			minColor[j] = MIN(minColor[j], block[i][j]);
+			maxColor[j] = MAX(maxColor[j], block[i][j]);
+		}
+	}
+
+	// Insetting the bounding box keeps outliers from stretching the palette
+	for (uint32 i = 0; i < 3; i++)
+	{
+		uint8 inset = (maxColor[i] - minColor[i]) >> 4;
+		minColor[i] += inset;
+		maxColor[i] -= inset;
+	}
+
+	// The endpoints sit on the box diagonal which best follows the colors, so
+	// channels which fall while the widest one rises are flipped
+	uint32 axis = 0;
+	for (uint32 i = 1; i < 3; i++)
+	{
+		if (maxColor[i] - minColor[i] > maxColor[axis] - minColor[axis])
+		{
+			axis = i;
+		}
+	}
+
+	for (uint32 i = 0; i < 3; i++)
+	{
+		if (i == axis)
+		{
+			continue;
+		}
+
+		int32 covariance = 0;
+		for (uint32 j = 0; j < NUM_BLOCK_PIXELS; j++)
+		{
+			covariance +=
+				(2 * block[j][axis] - minColor[axis] - maxColor[axis]) *
+				(2 * block[j][i] - minColor[i] - maxColor[i]);
+		}
+
+		if (covariance < 0)
+		{
+			uint8 value = minColor[i];
+			minColor[i] = maxColor[i];
+			maxColor[i] = value;
+		}
+	}
+
+	uint16 color0 = packRGB565(maxColor);
+	uint16 color1 = packRGB565(minColor);
+
+	// The four color palette is only used while color0 > color1
+	if (color0 < color1)
+	{
+		uint16 color = color0;
+		color0 = color1;
+		color1 = color;
+	}
+
+	uint8 palette[4][3];
+	unpackRGB565(color0, palette[0]);
+	unpackRGB565(color1, palette[1]);
+
+	for (uint32 i = 0; i < 3; i++)
+	{
+		palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+		palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+	}
+
+	uint32 indices = 0;
+	if (color0 != color1)
+	{
+		for (uint32 i = 0; i < NUM_BLOCK_PIXELS; i++)
+		{
+			uint32 bestIndex = 0;
+			uint32 bestDistance = UINT32_MAX;
+
+			for (uint32 j = 0; j < 4; j++)
+			{
+				uint32 distance = 0;
+				for (uint32 k = 0; k < 3; k++)
+				{
+					int32 difference = block[i][k] - palette[j][k];
+					distance += difference * difference;
+				}
+
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					bestIndex = j;
+				}
+			}
+
+			indices |= bestIndex << (i * 2);
+		}
+	}
+
+	output[0] = color0 & 0xff;
+	output[1] = color0 >> 8;
+	output[2] = color1 & 0xff;
+	output[3] = color1 >> 8;
+
+	for (uint32 i = 0; i < 4; i++)
+	{
+		output[4 + i] = (indices >> (i * 8)) & 0xff;
+	}
+}
+
+void encodeChannelBlock(
+	uint8 block[NUM_BLOCK_PIXELS][4],
+	uint32 channel,
+	uint8 *output)
+{
+	uint8 minValue = 255;
+	uint8 maxValue = 0;
+
+	for (uint32 i = 0; i < NUM_BLOCK_PIXELS; i++)
+	{
+		minValue = MIN(minValue, block[i][channel]);
+		maxValue = MAX(maxValue, block[i][channel]);
+	}
+
+	// With value0 > value1 the palette interpolates six values in between
+	uint8 palette[8];
+	palette[0] = maxValue;
+	palette[1] = minValue;
+
+	for (uint32 i = 2; i < 8; i++)
+	{
+		palette[i] = ((8 - i) * maxValue + (i - 1) * minValue) / 7;
+	}
+
+	uint64 indices = 0;
+	if (maxValue != minValue)
+	{
+		for (uint32 i = 0; i < NUM_BLOCK_PIXELS; i++)
+		{
+			uint64 bestIndex = 0;
+			uint32 bestDistance = UINT32_MAX;
+
+			for (uint32 j = 0; j < 8; j++)
+			{
+				int32 difference = block[i][channel] - palette[j];
+				uint32 distance = difference * difference;
+
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					bestIndex = j;
+				}
+			}
+
+			indices |= bestIndex << (i * 3);
+		}
+	}
+
+	output[0] = maxValue;
+	output[1] = minValue;
+
+	for (uint32 i = 0; i < 6; i++)
+	{
+		output[2 + i] = (indices >> (i * 8)) & 0xff;
+	}
+}
+
+uint16 packRGB565(const uint8 *color)
+{
+	return ((color[0] * 31 + 127) / 255) << 11 |
+		((color[1] * 63 + 127) / 255) << 5 |
+		((color[2] * 31 + 127) / 255);
+}
+
+void unpackRGB565(uint16 packedColor, uint8 *color)
+{
+	uint8 red = (packedColor >> 11) & 0x1f;
+	uint8 green = (packedColor >> 5) & 0x3f;
+	uint8 blue = packedColor & 0x1f;
+
+	color[0] = (red << 3) | (red >> 2);
+	color[1] = (green << 2) | (green >> 4);
+	color[2] = (blue << 3) | (blue >> 2);
+}
+
+bool isSourceTextureFile(const char *filename)
+{
+	char *extension = getExtension(filename);
+	if (!extension)
+	{
+		return false;
+	}
+
+	bool sourceTextureFile = false;
+	for (uint32 i = 0; i < NUM_SOURCE_FILE_FORMATS; i++)
+	{
+		if (!strcmp(extension, sourceFileFormats[i]))
+		{
+			sourceTextureFile = true;
+			break;
+		}
+	}
+
+	free(extension);
+
+	return sourceTextureFile;
+}
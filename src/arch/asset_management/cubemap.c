@@ -1,4 +1,5 @@
 #include "asset_management/asset_manager.h"
+#include "asset_management/asset_file.h"
 #include "asset_management/cubemap.h"
 #include "asset_management/texture.h"
 
@@ -15,7 +16,6 @@
 #include "renderer/renderer_utilities.h"
 
 #include <pthread.h>
-#include <unistd.h>
 
 const char *cubemapFaceNames[6] = { "+x", "-x", "+y", "-y", "+z", "-z" };
 
@@ -46,55 +46,37 @@ void loadCubemap(const char *name)
 	char *cubemapName = calloc(1, strlen(name) + 1);
 	strcpy(cubemapName, name);
 
-	bool skip = false;
-
 	UUID nameID = idFromName(name);
 
 	pthread_mutex_lock(&cubemapsMutex);
 	if (!hashMapGetData(cubemaps, &nameID))
 	{
 		pthread_mutex_unlock(&cubemapsMutex);
-		pthread_mutex_lock(&loadingCubemapsMutex);
-
-		if (hashMapGetData(loadingCubemaps, &nameID))
-		{
-			skip = true;
-		}
-
-		pthread_mutex_unlock(&loadingCubemapsMutex);
-
-		if (!skip)
-		{
-			pthread_mutex_lock(&uploadCubemapsMutex);
-
-			if (hashMapGetData(uploadCubemapsQueue, &nameID))
-			{
-				skip = true;
-			}
 
-			pthread_mutex_unlock(&uploadCubemapsMutex);
-		}
-
-		if (!skip)
-		{
-			START_ACQUISITION_THREAD(
-				cubemap,
-				Cubemap,
-				Cubemaps,
-				cubemapName,
-				nameID);
-			return;
-		}
+		QUEUE_ACQUISITION_JOB(
+			Cubemap,
+			Cubemaps,
+			cubemapName,
+			nameID,
+			DEFAULT_ASSET_PRIORITY,
+			NULL,
+			NULL);
+		return;
 	}
 	else
 	{
 		pthread_mutex_unlock(&cubemapsMutex);
 	}
 
-	free(cubemapName);
+	freeCubemapThreadArgs(cubemapName);
 }
 
-ACQUISITION_THREAD(Cubemap);
+ACQUISITION_JOB(Cubemap, Cubemaps);
+
+void freeCubemapThreadArgs(void *arg)
+{
+	free(arg);
+}
 
 void* loadCubemapThread(void *arg)
 {
@@ -116,7 +98,6 @@ void* loadCubemapThread(void *arg)
 		Cubemap cubemap = {};
 
 		cubemap.name = idFromName(name);
-		cubemap.lifetime = config.assetsConfig.minCubemapLifetime;
 
 		error = loadEnvironmentMap(cubemapFolder, &cubemap);
 
@@ -161,9 +142,7 @@ void* loadCubemapThread(void *arg)
 
 		ASSET_LOG_COMMIT(CUBEMAP, name);
 
-		pthread_mutex_lock(&loadingCubemapsMutex);
-		hashMapDelete(loadingCubemaps, &nameID);
-		pthread_mutex_unlock(&loadingCubemapsMutex);
+		FINISH_LOADING_ASSET(Cubemaps, nameID);
 	}
 
 	free(cubemapFolder);
@@ -203,9 +182,48 @@ GET_ASSET_FUNCTION(
 	cubemap,
 	cubemaps,
 	Cubemap,
+	Cubemaps,
 	getCubemap(const char *name),
 	idFromName(name));
 
+ACQUIRE_ASSET_FUNCTION(
+	cubemap,
+	cubemaps,
+	Cubemap,
+	Cubemaps,
+	acquireCubemap(const char *name),
+	idFromName(name));
+
+RELEASE_ASSET_FUNCTION(
+	cubemap,
+	cubemaps,
+	Cubemap,
+	Cubemaps,
+	releaseCubemap(const char *name),
+	idFromName(name));
+
+uint64 getCubemapSize(const Cubemap *cubemap)
+{
+	uint64 size = 0;
+
+	for (uint8 i = 0; i < 6; i++)
+	{
+		size += getHDRTextureDataSize(&cubemap->cubemapData[i]);
+		size += getHDRTextureDataSize(&cubemap->irradianceData[i]);
+	}
+
+	for (uint8 i = 0; i < 5; i++)
+	{
+		for (uint8 j = 0; j < 6; j++)
+		{
+			size += getHDRTextureDataSize(&cubemap->prefilterData[i][j]);
+		}
+	}
+
+	// Every face is kept around after it has been uploaded
+	return size * 2;
+}
+
 void freeCubemapData(Cubemap *cubemap)
 {
 	LOG("Freeing cubemap (%s)...\n", cubemap->name.string);
@@ -234,7 +252,7 @@ void freeCubemapData(Cubemap *cubemap)
 char* getCubemapFolder(const char *name)
 {
 	char *folder = getFullFilePath(name, NULL, "resources/cubemaps");
-	if (access(folder, F_OK) != -1)
+	if (assetFileExists(folder))
 	{
 		return folder;
 	}
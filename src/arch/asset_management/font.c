@@ -1,4 +1,5 @@
 #include "asset_management/asset_manager.h"
+#include "asset_management/asset_file.h"
 #include "asset_management/font.h"
 
 #include "core/log.h"
@@ -21,6 +22,8 @@
 #define NK_IMPLEMENTATION
 #include <nuklear/nuklear.h>
 
+#include <malloc.h>
+#include <string.h>
 #include <pthread.h>
 
 typedef struct font_thread_args_t
@@ -30,8 +33,6 @@ typedef struct font_thread_args_t
 	bool autoScaling;
 } FontThreadArgs;
 
-extern Config config;
-
 EXTERN_ASSET_VARIABLES(fonts, Fonts);
 EXTERN_ASSET_MANAGER_VARIABLES;
 
@@ -57,51 +58,40 @@ void loadFont(const char *name, real32 size, bool autoScaling)
 	arg->size = size;
 	arg->autoScaling = autoScaling;
 
-	bool skip = false;
-
 	UUID fontName = getFontName(name, size, autoScaling);
 
 	pthread_mutex_lock(&fontsMutex);
 	if (!hashMapGetData(fonts, &fontName))
 	{
 		pthread_mutex_unlock(&fontsMutex);
-		pthread_mutex_lock(&loadingFontsMutex);
-
-		if (hashMapGetData(loadingFonts, &fontName))
-		{
-			skip = true;
-		}
-
-		pthread_mutex_unlock(&loadingFontsMutex);
-
-		if (!skip)
-		{
-			pthread_mutex_lock(&uploadFontsMutex);
 
-			if (hashMapGetData(uploadFontsQueue, &fontName))
-			{
-				skip = true;
-			}
-
-			pthread_mutex_unlock(&uploadFontsMutex);
-		}
-
-		if (!skip)
-		{
-			START_ACQUISITION_THREAD(font, Font, Fonts, arg, fontName);
-			return;
-		}
+		QUEUE_ACQUISITION_JOB(
+			Font,
+			Fonts,
+			arg,
+			fontName,
+			DEFAULT_ASSET_PRIORITY,
+			NULL,
+			NULL);
+		return;
 	}
 	else
 	{
 		pthread_mutex_unlock(&fontsMutex);
 	}
 
-	free(arg->name);
-	free(arg);
+	freeFontThreadArgs(arg);
 }
 
-ACQUISITION_THREAD(Font);
+ACQUISITION_JOB(Font, Fonts);
+
+void freeFontThreadArgs(void *arg)
+{
+	FontThreadArgs *threadArgs = arg;
+
+	free(threadArgs->name);
+	free(threadArgs);
+}
 
 void* loadFontThread(void *arg)
 {
@@ -123,21 +113,41 @@ void* loadFontThread(void *arg)
 	Font font = {};
 
 	font.name = fontName;
-	font.lifetime = config.assetsConfig.minFontLifetime;
 
 	nk_font_atlas_init_default(&font.atlas);
 	nk_font_atlas_begin(&font.atlas);
 
 	char *filename = getFullFilePath(name, "ttf", "resources/fonts");
 
-	font.font = nk_font_atlas_add_from_file(
-		&font.atlas,
-		filename,
-		getFontPixelSize(size, autoScaling),
-		NULL);
+	uint64 fileSize;
+	uint8 *buffer;
+	const uint8 *fileData = readAssetFile(filename, &fileSize, &buffer);
 
 	free(filename);
 
+	// The atlas takes ownership of the font data, just like it does when
+	// loading the font itself, so data borrowed from the archive is copied
+	if (fileData && !buffer)
+	{
+		buffer = malloc(fileSize);
+		memcpy(buffer, fileData, fileSize);
+	}
+
+	if (buffer && fileSize > 0)
+	{
+		struct nk_font_config fontConfig = nk_font_config(
+			getFontPixelSize(size, autoScaling));
+		fontConfig.ttf_blob = buffer;
+		fontConfig.ttf_size = fileSize;
+		fontConfig.ttf_data_owned_by_atlas = 1;
+
+		font.font = nk_font_atlas_add(&font.atlas, &fontConfig);
+	}
+	else
+	{
+		free(buffer);
+	}
+
 	if (!font.font)
 	{
 		error = -1;
@@ -174,9 +184,7 @@ void* loadFontThread(void *arg)
 
 	ASSET_LOG_COMMIT(FONT, fontName.string);
 
-	pthread_mutex_lock(&loadingFontsMutex);
-	hashMapDelete(loadingFonts, &fontName);
-	pthread_mutex_unlock(&loadingFontsMutex);
+	FINISH_LOADING_ASSET(Fonts, fontName);
 
 	free(arg);
 	free(name);
@@ -226,9 +234,32 @@ GET_ASSET_FUNCTION(
 	font,
 	fonts,
 	Font,
+	Fonts,
 	getFont(const char *name, real32 size, bool autoScaling),
 	getFontName(name, size, autoScaling));
 
+ACQUIRE_ASSET_FUNCTION(
+	font,
+	fonts,
+	Font,
+	Fonts,
+	acquireFont(const char *name, real32 size, bool autoScaling),
+	getFontName(name, size, autoScaling));
+
+RELEASE_ASSET_FUNCTION(
+	font,
+	fonts,
+	Font,
+	Fonts,
+	releaseFont(const char *name, real32 size, bool autoScaling),
+	getFontName(name, size, autoScaling));
+
+uint64 getFontSize(const Font *font)
+{
+	// The atlas keeps its own copy of the texture it baked
+	return (uint64)font->textureWidth * font->textureHeight * 4 * 2;
+}
+
 void freeFontData(Font *font)
 {
 	LOG("Freeing font (%s)...\n", font->name.string);
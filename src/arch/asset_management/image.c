@@ -45,51 +45,40 @@ void loadImage(const char *name, bool textureFiltering)
 
 	arg->textureFiltering = textureFiltering;
 
-	bool skip = false;
-
 	UUID nameID = idFromName(name);
 
 	pthread_mutex_lock(&imagesMutex);
 	if (!hashMapGetData(images, &nameID))
 	{
 		pthread_mutex_unlock(&imagesMutex);
-		pthread_mutex_lock(&loadingImagesMutex);
-
-		if (hashMapGetData(loadingImages, &nameID))
-		{
-			skip = true;
-		}
-
-		pthread_mutex_unlock(&loadingImagesMutex);
-
-		if (!skip)
-		{
-			pthread_mutex_lock(&uploadImagesMutex);
-
-			if (hashMapGetData(uploadImagesQueue, &nameID))
-			{
-				skip = true;
-			}
 
-			pthread_mutex_unlock(&uploadImagesMutex);
-		}
-
-		if (!skip)
-		{
-			START_ACQUISITION_THREAD(image, Image, Images, arg, nameID);
-			return;
-		}
+		QUEUE_ACQUISITION_JOB(
+			Image,
+			Images,
+			arg,
+			nameID,
+			DEFAULT_ASSET_PRIORITY,
+			NULL,
+			NULL);
+		return;
 	}
 	else
 	{
 		pthread_mutex_unlock(&imagesMutex);
 	}
 
-	free(arg->name);
-	free(arg);
+	freeImageThreadArgs(arg);
 }
 
-ACQUISITION_THREAD(Image);
+ACQUISITION_JOB(Image, Images);
+
+void freeImageThreadArgs(void *arg)
+{
+	ImageThreadArgs *threadArgs = arg;
+
+	free(threadArgs->name);
+	free(threadArgs);
+}
 
 void* loadImageThread(void *arg)
 {
@@ -123,7 +112,6 @@ void* loadImageThread(void *arg)
 		Image image = {};
 
 		image.name = idFromName(name);
-		image.lifetime = config.assetsConfig.minImageLifetime;
 		image.textureFiltering = textureFiltering;
 
 		error = loadTextureData(
@@ -149,9 +137,7 @@ void* loadImageThread(void *arg)
 
 		ASSET_LOG_COMMIT(IMAGE, name);
 
-		pthread_mutex_lock(&loadingImagesMutex);
-		hashMapDelete(loadingImages, &nameID);
-		pthread_mutex_unlock(&loadingImagesMutex);
+		FINISH_LOADING_ASSET(Images, nameID);
 	}
 
 	free(fullFilename);
@@ -166,9 +152,31 @@ GET_ASSET_FUNCTION(
 	image,
 	images,
 	Image,
+	Images,
 	getImage(const char *name),
 	idFromName(name));
 
+ACQUIRE_ASSET_FUNCTION(
+	image,
+	images,
+	Image,
+	Images,
+	acquireImage(const char *name),
+	idFromName(name));
+
+RELEASE_ASSET_FUNCTION(
+	image,
+	images,
+	Image,
+	Images,
+	releaseImage(const char *name),
+	idFromName(name));
+
+uint64 getImageSize(const Image *image)
+{
+	return getTextureDataSize(&image->data);
+}
+
 void freeImageData(Image *image)
 {
 	LOG("Freeing image (%s)...\n", image->name.string);
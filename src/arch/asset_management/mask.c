@@ -1,3 +1,4 @@
+#include "asset_management/asset_manager.h"
 #include "asset_management/asset_manager_types.h"
 #include "asset_management/mask.h"
 #include "asset_management/material.h"
@@ -13,13 +14,17 @@
 #include <malloc.h>
 #include <string.h>
 
-void loadMask(Mask *mask, FILE *file, const char *modelName)
+void loadMask(
+	Mask *mask,
+	FILE *file,
+	const char *modelName,
+	JobNode *dependentJob)
 {
 	ASSET_LOG(MODEL, modelName, "Loading masks...\n");
 
-	loadMaterial(&mask->collectionMaterial, file, modelName);
-	loadMaterial(&mask->grungeMaterial, file, modelName);
-	loadMaterial(&mask->wearMaterial, file, modelName);
+	loadMaterial(&mask->collectionMaterial, file, modelName, dependentJob);
+	loadMaterial(&mask->grungeMaterial, file, modelName, dependentJob);
+	loadMaterial(&mask->wearMaterial, file, modelName, dependentJob);
 	fread(&mask->opacity, sizeof(real32), 1, file);
 
 	ASSET_LOG(MODEL, modelName, "Successfully loaded masks\n");
@@ -29,7 +34,8 @@ int32 loadMaskTexture(
 	const char *masksFolder,
 	Model *model,
 	char suffix,
-	UUID *textureName)
+	UUID *textureName,
+	JobNode *dependentJob)
 {
 	memset(textureName, 0, sizeof(UUID));
 	sprintf(textureName->string, "%s_%c", model->name.string, suffix);
@@ -43,7 +49,11 @@ int32 loadMaskTexture(
 
 	if (fullFilename)
 	{
-		loadTexture(fullFilename, textureName->string);
+		queueTexture(
+			fullFilename,
+			textureName->string,
+			dependentJob ? dependentJob->priority : DEFAULT_ASSET_PRIORITY,
+			dependentJob);
 		free(fullFilename);
 	}
 	else
@@ -1,3 +1,4 @@
+#include "asset_management/asset_manager.h"
 #include "asset_management/material.h"
 #include "asset_management/texture.h"
 
@@ -23,7 +24,11 @@ internal const char materialComponentCharacters[] = {
 	'a', 'b', 'e', 'h', 'm', 'n', 'r'
 };
 
-int32 loadMaterial(Material *material, FILE *file, const char *modelName)
+int32 loadMaterial(
+	Material *material,
+	FILE *file,
+	const char *modelName,
+	JobNode *dependentJob)
 {
 	for (uint32 i = 0; i < MATERIAL_COMPONENT_TYPE_COUNT; i++)
 	{
@@ -54,7 +59,8 @@ int32 loadMaterial(Material *material, FILE *file, const char *modelName)
 			if (loadMaterialComponentTexture(
 				material->name,
 				materialComponentType,
-				&materialComponent->texture) == -1)
+				&materialComponent->texture,
+				dependentJob) == -1)
 			{
 				return -1;
 			}
@@ -92,7 +98,8 @@ int32 createMaterial(UUID name, Material *material)
 		if (loadMaterialComponentTexture(
 			material->name,
 			materialComponentType,
-			&materialComponent->texture) == -1)
+			&materialComponent->texture,
+			NULL) == -1)
 		{
 			return -1;
 		}
@@ -198,13 +205,17 @@ void loadMaterialFolders(UUID name)
 int32 loadMaterialComponentTexture(
 	UUID materialName,
 	MaterialComponentType materialComponentType,
-	UUID *textureName)
+	UUID *textureName,
+	JobNode *dependentJob)
 {
 	memset(textureName, 0, sizeof(UUID));
 
+	// Other models' jobs can insert into the map, which moves its lists
+	pthread_mutex_lock(&materialFoldersMutex);
 	List materialFoldersList = *(List*)hashMapGetData(
 		materialFolders,
 		&materialName);
+	pthread_mutex_unlock(&materialFoldersMutex);
 
 	char *fullFilename = NULL;
 	for (ListIterator itr = listGetIterator(&materialFoldersList);
@@ -244,7 +255,11 @@ int32 loadMaterialComponentTexture(
 
 	if (fullFilename)
 	{
-		loadTexture(fullFilename, textureName->string);
+		queueTexture(
+			fullFilename,
+			textureName->string,
+			dependentJob ? dependentJob->priority : DEFAULT_ASSET_PRIORITY,
+			dependentJob);
 		free(fullFilename);
 	}
 
@@ -1,4 +1,5 @@
 #include "asset_management/asset_manager_types.h"
+#include "asset_management/asset_upload.h"
 #include "asset_management/mesh.h"
 
 #include "core/log.h"
@@ -6,37 +7,6 @@
 #include <malloc.h>
 #include <stddef.h>
 
-void loadMesh(Mesh *mesh, FILE *file, const char *modelName)
-{
-	if (modelName)
-	{
-		ASSET_LOG(MODEL, modelName, "Loading mesh...\n");
-	}
-	else
-	{
-		LOG("Loading mesh...\n");
-	}
-
-	fread(&mesh->numVertices, sizeof(uint32), 1, file);
-
-	mesh->vertices = calloc(mesh->numVertices, sizeof(Vertex));
-	fread(mesh->vertices, mesh->numVertices, sizeof(Vertex), file);
-
-	fread(&mesh->numIndices, sizeof(uint32), 1, file);
-
-	mesh->indices = calloc(mesh->numIndices, sizeof(uint32));
-	fread(mesh->indices, mesh->numIndices, sizeof(uint32), file);
-
-	if (modelName)
-	{
-		ASSET_LOG(MODEL, modelName, "Successfully loaded mesh\n");
-	}
-	else
-	{
-		LOG("Successfully loaded mesh\n");
-	}
-}
-
 void uploadMeshToGPU(Mesh *mesh, const char *name)
 {
 	LOG("Transferring mesh (%s) onto GPU...\n", name);
@@ -47,11 +17,10 @@ void uploadMeshToGPU(Mesh *mesh, const char *name)
 	uint32 bufferIndex = 0;
 
 	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
-	glBufferData(
+	uploadAssetBufferData(
 		GL_ARRAY_BUFFER,
-		sizeof(Vertex) * mesh->numVertices,
 		mesh->vertices,
-		GL_STATIC_DRAW);
+		sizeof(Vertex) * mesh->numVertices);
 
 	glBindVertexArray(mesh->vertexArray);
 
@@ -124,16 +93,21 @@ void uploadMeshToGPU(Mesh *mesh, const char *name)
 	glGenBuffers(1, &mesh->indexBuffer);
 
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
-	glBufferData(
+	uploadAssetBufferData(
 		GL_ELEMENT_ARRAY_BUFFER,
-		sizeof(uint32) * mesh->numIndices,
 		mesh->indices,
-		GL_STATIC_DRAW);
+		sizeof(uint32) * mesh->numIndices);
 
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
-	free(mesh->vertices);
-	free(mesh->indices);
+	if (!mesh->mapped)
+	{
+		free(mesh->vertices);
+		free(mesh->indices);
+	}
+
+	mesh->vertices = NULL;
+	mesh->indices = NULL;
 
 	LOG("Successfully transferred mesh (%s) onto GPU\n", name);
 	LOG("Vertex Count: %d\n", mesh->numVertices);
@@ -142,6 +116,13 @@ void uploadMeshToGPU(Mesh *mesh, const char *name)
 
 void freeMesh(Mesh *mesh)
 {
+	// Meshes which were never uploaded still own their vertices and indices
+	if (!mesh->mapped)
+	{
+		free(mesh->vertices);
+		free(mesh->indices);
+	}
+
 	glBindVertexArray(mesh->vertexArray);
 	glDeleteBuffers(1, &mesh->vertexBuffer);
 	glDeleteBuffers(1, &mesh->indexBuffer);
@@ -0,0 +1,137 @@
+#include "asset_management/mesh_file.h"
+
+#include "core/log.h"
+
+#include <malloc.h>
+#include <string.h>
+
+uint8 readMeshFileHeader(FILE *file)
+{
+	uint8 meshBinaryFileVersion = 0;
+	fread(&meshBinaryFileVersion, sizeof(uint8), 1, file);
+
+	if (meshBinaryFileVersion >= ALIGNED_MESH_BINARY_FILE_VERSION)
+	{
+		fseek(file, MESH_FILE_ALIGNMENT, SEEK_SET);
+	}
+
+	return meshBinaryFileVersion;
+}
+
+void loadMesh(Mesh *mesh, FILE *file, const char *modelName)
+{
+	if (modelName)
+	{
+		ASSET_LOG(MODEL, modelName, "Loading mesh...\n");
+	}
+	else
+	{
+		LOG("Loading mesh...\n");
+	}
+
+	fread(&mesh->numVertices, sizeof(uint32), 1, file);
+
+	mesh->vertices = calloc(mesh->numVertices, sizeof(Vertex));
+	fread(mesh->vertices, mesh->numVertices, sizeof(Vertex), file);
+
+	fread(&mesh->numIndices, sizeof(uint32), 1, file);
+
+	mesh->indices = calloc(mesh->numIndices, sizeof(uint32));
+	fread(mesh->indices, mesh->numIndices, sizeof(uint32), file);
+
+	mesh->mapped = false;
+
+	if (modelName)
+	{
+		ASSET_LOG(MODEL, modelName, "Successfully loaded mesh\n");
+	}
+	else
+	{
+		LOG("Successfully loaded mesh\n");
+	}
+}
+
+int32 loadMappedMesh(
+	Mesh *mesh,
+	const MappedFile *file,
+	uint64 *offset,
+	const char *modelName)
+{
+	if (modelName)
+	{
+		ASSET_LOG(MODEL, modelName, "Loading mapped mesh...\n");
+	}
+	else
+	{
+		LOG("Loading mapped mesh...\n");
+	}
+
+	int32 error = 0;
+
+	uint64 position = *offset;
+
+	if (position % MESH_FILE_ALIGNMENT != 0 ||
+		position + sizeof(uint32) > file->size)
+	{
+		error = -1;
+	}
+	else
+	{
+		mesh->numVertices = *(uint32*)(file->data + position);
+		position += sizeof(uint32);
+
+		mesh->vertices = (Vertex*)(file->data + position);
+		position += (uint64)mesh->numVertices * sizeof(Vertex);
+
+		if (position + sizeof(uint32) > file->size)
+		{
+			error = -1;
+		}
+		else
+		{
+			mesh->numIndices = *(uint32*)(file->data + position);
+			position += sizeof(uint32);
+
+			mesh->indices = (uint32*)(file->data + position);
+			position += (uint64)mesh->numIndices * sizeof(uint32);
+
+			if (position > file->size)
+			{
+				error = -1;
+			}
+		}
+	}
+
+	if (error == -1)
+	{
+		memset(mesh, 0, sizeof(Mesh));
+
+		if (modelName)
+		{
+			ASSET_LOG(
+				MODEL,
+				modelName,
+				"Mesh file is truncated or misaligned\n");
+		}
+		else
+		{
+			LOG("Mesh file is truncated or misaligned\n");
+		}
+
+		return -1;
+	}
+
+	mesh->mapped = true;
+	*offset = position;
+
+	if (modelName)
+	{
+		ASSET_LOG(MODEL, modelName, "Successfully loaded mapped mesh\n");
+	}
+	else
+	{
+		LOG("Successfully loaded mapped mesh\n");
+	}
+
+	return 0;
+}
\ No newline at end of file
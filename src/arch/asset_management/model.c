@@ -1,14 +1,17 @@
 #include "asset_management/asset_manager.h"
+#include "asset_management/asset_file.h"
 #include "asset_management/model.h"
 #include "asset_management/material.h"
 #include "asset_management/mask.h"
 #include "asset_management/mesh.h"
+#include "asset_management/mesh_file.h"
 #include "asset_management/animation.h"
 #include "asset_management/texture.h"
 
 #include "core/log.h"
 #include "core/config.h"
 
+#include "file/mapped_file.h"
 #include "file/utilities.h"
 
 #include "data/data_types.h"
@@ -16,8 +19,26 @@
 
 #include "ECS/scene.h"
 
+#include "threading/job_graph.h"
+
 #include <pthread.h>
 
+typedef struct model_thread_args_t
+{
+	char *name;
+	int32 priority;
+} ModelThreadArgs;
+
+typedef struct model_job_data_t
+{
+	char *name;
+	Model model;
+	FILE *assetFile;
+	FILE *meshFile;
+	int32 error;
+	int32 meshError;
+} ModelJobData;
+
 #define ASSET_BINARY_FILE_VERSION 1
 
 extern Config config;
@@ -27,23 +48,34 @@ EXTERN_ASSET_MANAGER_VARIABLES;
 
 INTERNAL_ASSET_THREAD_VARIABLES(Model);
 
+internal void loadModelMeshes(void *data);
+internal void finishModelLoad(void *data);
+
 internal int32 loadSubset(
 	Subset *subset,
 	FILE *assetFile,
-	FILE *meshFile,
-	const char *modelName);
+	const char *modelName,
+	JobNode *modelJob);
 
 void loadModel(const char *name)
+{
+	queueModel(name, DEFAULT_ASSET_PRIORITY, NULL);
+}
+
+void queueModel(const char *name, int32 priority, Promise *promise)
 {
 	if (strlen(name) == 0)
 	{
+		completeAssetPromise(promise);
 		return;
 	}
 
-	char *modelName = calloc(1, strlen(name) + 1);
-	strcpy(modelName, name);
+	ModelThreadArgs *arg = malloc(sizeof(ModelThreadArgs));
+
+	arg->name = calloc(1, strlen(name) + 1);
+	strcpy(arg->name, name);
 
-	bool skip = false;
+	arg->priority = priority;
 
 	UUID nameID = idFromName(name);
 
@@ -51,62 +83,64 @@ void loadModel(const char *name)
 	if (!hashMapGetData(models, &nameID))
 	{
 		pthread_mutex_unlock(&modelsMutex);
-		pthread_mutex_lock(&loadingModelsMutex);
-
-		if (hashMapGetData(loadingModels, &nameID))
-		{
-			skip = true;
-		}
 
-		pthread_mutex_unlock(&loadingModelsMutex);
-
-		if (!skip)
-		{
-			pthread_mutex_lock(&uploadModelsMutex);
-
-			if (hashMapGetData(uploadModelsQueue, &nameID))
-			{
-				skip = 1;
-			}
-
-			pthread_mutex_unlock(&uploadModelsMutex);
-		}
-
-		if (!skip)
-		{
-			START_ACQUISITION_THREAD(model, Model, Models, modelName, nameID);
-			return;
-		}
+		QUEUE_ACQUISITION_JOB(
+			Model,
+			Models,
+			arg,
+			nameID,
+			priority,
+			promise,
+			NULL);
+		return;
 	}
 	else
 	{
 		pthread_mutex_unlock(&modelsMutex);
 	}
 
-	free(modelName);
+	completeAssetPromise(promise);
+	freeModelThreadArgs(arg);
 }
 
-ACQUISITION_THREAD(Model);
+void cancelModelLoad(const char *name)
+{
+	UUID nameID = idFromName(name);
+	CANCEL_LOADING_ASSET(Models, nameID);
+}
+
+ACQUISITION_JOB(Model, Models);
+
+void freeModelThreadArgs(void *arg)
+{
+	ModelThreadArgs *threadArgs = arg;
+
+	free(threadArgs->name);
+	free(threadArgs);
+}
 
 void* loadModelThread(void *arg)
 {
 	int32 error = 0;
 
-	char *name = arg;
+	ModelThreadArgs *threadArgs = arg;
+	char *name = threadArgs->name;
+	int32 priority = threadArgs->priority;
 
-	UUID modelName = idFromName(name);
+	ModelJobData *jobData = calloc(1, sizeof(ModelJobData));
+	jobData->name = name;
 
-	Model model = {};
+	Model *model = &jobData->model;
 
 	ASSET_LOG(MODEL, name, "Loading model (%s)...\n", name);
 
-	model.name = modelName;
-	model.lifetime = config.assetsConfig.minModelLifetime;
+	model->name = idFromName(name);
+	model->usage.priority = priority;
 
 	char *modelFolder = getFullFilePath(name, NULL, "resources/models");
 
 	char *assetFilename = getFullFilePath(name, "asset", modelFolder);
-	FILE *assetFile = fopen(assetFilename, "rb");
+	FILE *assetFile = openAssetFile(assetFilename);
 
 	if (assetFile)
 	{
@@ -124,17 +158,18 @@ void* loadModelThread(void *arg)
 		error = -1;
 	}
 
+	FILE *meshFile = NULL;
+
 	if (error != -1)
 	{
 		char *meshFilename = getFullFilePath(name, "mesh", modelFolder);
-		FILE *meshFile = fopen(meshFilename, "rb");
+		meshFile = openAssetFile(meshFilename);
 
 		if (meshFile)
 		{
-			uint8 meshBinaryFileVersion;
-			fread(&meshBinaryFileVersion, sizeof(uint8), 1, meshFile);
+			uint8 meshBinaryFileVersion = readMeshFileHeader(meshFile);
 
-			if (meshBinaryFileVersion < MESH_BINARY_FILE_VERSION)
+			if (meshBinaryFileVersion < MIN_MESH_BINARY_FILE_VERSION)
 			{
 				ASSET_LOG(
 					MODEL,
@@ -143,101 +178,179 @@ void* loadModelThread(void *arg)
 					meshFilename);
 				error = -1;
 			}
+			else if (meshBinaryFileVersion >=
+				ALIGNED_MESH_BINARY_FILE_VERSION)
+			{
+				// Falls back to copying the meshes if the file can't be mapped
+				mapAssetFile(meshFilename, &model->meshFile);
+			}
 		}
 		else
 		{
 			error = -1;
 		}
 
-		if (error != -1)
+		if (error == -1)
 		{
-			fread(&model.numSubsets, sizeof(uint32), 1, assetFile);
-			model.subsets = calloc(model.numSubsets, sizeof(Subset));
+			ASSET_LOG(MODEL, name, "Failed to open %s\n", meshFilename);
+		}
 
-			for (uint32 i = 0; i < model.numSubsets; i++)
-			{
-				model.subsets[i].name = readStringAsUUID(assetFile);
-			}
+		free(meshFilename);
+	}
+	else
+	{
+		ASSET_LOG(MODEL, name, "Failed to open %s\n", assetFilename);
+		error = -1;
+	}
 
-			char *masksFolder = getFullFilePath(
-				"masks",
-				NULL,
-				modelFolder);
+	free(assetFilename);
 
+	jobData->assetFile = assetFile;
+	jobData->meshFile = meshFile;
+
+	// The model is only finished once its meshes and every one of its
+	// textures have been loaded, so that it is uploaded as a whole
+	JobNode *modelJob = createJobNode(
+		assetThreadPool,
+		&finishModelLoad,
+		jobData,
+		priority,
+		NULL);
+
+	if (error != -1)
+	{
+		fread(&model->numSubsets, sizeof(uint32), 1, assetFile);
+		model->subsets = calloc(model->numSubsets, sizeof(Subset));
+
+		for (uint32 i = 0; i < model->numSubsets; i++)
+		{
+			model->subsets[i].name = readStringAsUUID(assetFile);
+		}
+
+		// Meshes and animations only come from the mesh file, so they are
+		// read alongside the materials in the asset file
+		startJobNode(
+			createJobNode(
+				assetThreadPool,
+				&loadModelMeshes,
+				jobData,
+				priority,
+				modelJob));
+
+		char *masksFolder = getFullFilePath(
+			"masks",
+			NULL,
+			modelFolder);
+
+		error = loadMaskTexture(
+			masksFolder,
+			model,
+			'm',
+			&model->materialTexture,
+			modelJob);
+
+		if (error != -1)
+		{
 			error = loadMaskTexture(
 				masksFolder,
-				&model,
-				'm',
-				&model.materialTexture);
-
-			if (error != -1)
-			{
-				error = loadMaskTexture(
-					masksFolder,
-					&model,
-					'o',
-					&model.opacityTexture);
-			}
+				model,
+				'o',
+				&model->opacityTexture,
+				modelJob);
+		}
 
-			free(masksFolder);
+		free(masksFolder);
 
-			if (error != -1)
+		if (error != -1)
+		{
+			for (uint32 i = 0; i < model->numSubsets; i++)
 			{
-				for (uint32 i = 0; i < model.numSubsets; i++)
-				{
-					error = loadSubset(
-						&model.subsets[i],
-						assetFile,
-						meshFile,
-						name);
-
-					if (error == -1)
-					{
-						break;
-					}
-				}
+				error = loadSubset(
+					&model->subsets[i],
+					assetFile,
+					name,
+					modelJob);
 
-				if (error != -1)
+				if (error == -1)
 				{
-					error = loadAnimations(
-						&model.numAnimations,
-						&model.animations,
-						&model.skeleton,
-						meshFile);
+					break;
 				}
 			}
 		}
-		else
-		{
-			ASSET_LOG(MODEL, name, "Failed to open %s\n", meshFilename);
-			error = -1;
-		}
+	}
 
-		if (meshFile)
+	free(modelFolder);
+
+	jobData->error = error;
+	startJobNode(modelJob);
+
+	free(threadArgs);
+
+	EXIT_LOADING_THREAD;
+}
+
+void loadModelMeshes(void *data)
+{
+	ModelJobData *jobData = data;
+	Model *model = &jobData->model;
+
+	if (model->meshFile.data)
+	{
+		uint64 offset = ftell(jobData->meshFile);
+
+		for (uint32 i = 0; i < model->numSubsets; i++)
 		{
-			fclose(meshFile);
+			if (loadMappedMesh(
+				&model->subsets[i].mesh,
+				&model->meshFile,
+				&offset,
+				jobData->name) == -1)
+			{
+				jobData->meshError = -1;
+				return;
+			}
 		}
 
-		free(meshFilename);
+		// Animations are still read from the file itself
+		fseek(jobData->meshFile, offset, SEEK_SET);
 	}
 	else
 	{
-		ASSET_LOG(MODEL, name, "Failed to open %s\n", assetFilename);
-		error = -1;
+		for (uint32 i = 0; i < model->numSubsets; i++)
+		{
+			loadMesh(
+				&model->subsets[i].mesh,
+				jobData->meshFile,
+				jobData->name);
+		}
 	}
 
-	if (assetFile)
+	jobData->meshError = loadAnimations(
+		&model->numAnimations,
+		&model->animations,
+		&model->skeleton,
+		jobData->meshFile);
+}
+
+void finishModelLoad(void *data)
+{
+	ModelJobData *jobData = data;
+	char *name = jobData->name;
+
+	if (jobData->assetFile)
 	{
-		fclose(assetFile);
+		fclose(jobData->assetFile);
 	}
 
-	free(assetFilename);
-	free(modelFolder);
+	if (jobData->meshFile)
+	{
+		fclose(jobData->meshFile);
+	}
 
-	if (error != -1)
+	if (jobData->error != -1 && jobData->meshError != -1)
 	{
 		pthread_mutex_lock(&uploadModelsMutex);
-		hashMapInsert(uploadModelsQueue, &modelName, &model);
+		hashMapInsert(uploadModelsQueue, &jobData->model.name, &jobData->model);
 		pthread_mutex_unlock(&uploadModelsMutex);
 
 		ASSET_LOG(
@@ -248,18 +361,16 @@ void* loadModelThread(void *arg)
 	}
 	else
 	{
+		unmapFile(&jobData->model.meshFile);
 		ASSET_LOG(MODEL, name, "Failed to load model (%s)\n", name);
 	}
 
 	ASSET_LOG_COMMIT(MODEL, name);
 
-	pthread_mutex_lock(&loadingModelsMutex);
-	hashMapDelete(loadingModels, &modelName);
-	pthread_mutex_unlock(&loadingModelsMutex);
+	FINISH_LOADING_ASSET(Models, jobData->model.name);
 
 	free(name);
-
-	EXIT_LOADING_THREAD;
+	free(jobData);
 }
 
 void uploadModelToGPU(Model *model)
@@ -272,6 +383,8 @@ void uploadModelToGPU(Model *model)
 		uploadMeshToGPU(&subset->mesh, subset->name.string);
 	}
 
+	unmapFile(&model->meshFile);
+
 	LOG("Successfully transferred model (%s) onto GPU\n", model->name.string);
 }
 
@@ -279,9 +392,56 @@ GET_ASSET_FUNCTION(
 	model,
 	models,
 	Model,
+	Models,
 	getModel(const char *name),
 	idFromName(name));
 
+ACQUIRE_ASSET_FUNCTION(
+	model,
+	models,
+	Model,
+	Models,
+	acquireModel(const char *name),
+	idFromName(name));
+
+RELEASE_ASSET_FUNCTION(
+	model,
+	models,
+	Model,
+	Models,
+	releaseModel(const char *name),
+	idFromName(name));
+
+uint64 getModelSize(const Model *model)
+{
+	uint64 size = model->numSubsets * sizeof(Subset);
+
+	for (uint32 i = 0; i < model->numSubsets; i++)
+	{
+		const Mesh *mesh = &model->subsets[i].mesh;
+		size += mesh->numVertices * sizeof(Vertex);
+		size += mesh->numIndices * sizeof(uint32);
+	}
+
+	size += model->skeleton.numBoneOffsets * sizeof(BoneOffset);
+
+	for (uint32 i = 0; i < model->numAnimations; i++)
+	{
+		const Animation *animation = &model->animations[i];
+		size += sizeof(Animation) + animation->numBones * sizeof(Bone);
+
+		for (uint32 j = 0; j < animation->numBones; j++)
+		{
+			const Bone *bone = &animation->bones[j];
+			size += bone->numPositionKeyFrames * sizeof(Vec3KeyFrame);
+			size += bone->numRotationKeyFrames * sizeof(QuaternionKeyFrame);
+			size += bone->numScaleKeyFrames * sizeof(Vec3KeyFrame);
+		}
+	}
+
+	return size;
+}
+
 void freeModelData(Model *model)
 {
 	LOG("Freeing model (%s)...\n", model->name.string);
@@ -292,6 +452,7 @@ void freeModelData(Model *model)
 	}
 
 	free(model->subsets);
+	unmapFile(&model->meshFile);
 
 	freeAnimations(
 		model->numAnimations,
@@ -309,10 +470,12 @@ void swapMeshMaterial(
 	UUID name = idFromName(modelName);
 
 	pthread_mutex_lock(&modelsMutex);
-	Model *model = hashMapGetData(models, &name);
+	Model **modelResource = hashMapGetData(models, &name);
 
-	if (model)
+	if (modelResource)
 	{
+		Model *model = *modelResource;
+
 		for (uint32 i = 0; i < model->numSubsets; i++)
 		{
 			Subset *subset = &model->subsets[i];
@@ -333,8 +496,8 @@ void swapMeshMaterial(
 int32 loadSubset(
 	Subset *subset,
 	FILE *assetFile,
-	FILE *meshFile,
-	const char *modelName)
+	const char *modelName,
+	JobNode *modelJob)
 {
 	ASSET_LOG(
 		MODEL,
@@ -342,13 +505,16 @@ int32 loadSubset(
 		"Loading subset (%s)...\n",
 		subset->name.string);
 
-	if (loadMaterial(&subset->material, assetFile, modelName) == -1)
+	if (loadMaterial(
+		&subset->material,
+		assetFile,
+		modelName,
+		modelJob) == -1)
 	{
 		return -1;
 	}
 
-	loadMask(&subset->mask, assetFile, modelName);
-	loadMesh(&subset->mesh, meshFile, modelName);
+	loadMask(&subset->mask, assetFile, modelName, modelJob);
 
 	ASSET_LOG(
 		MODEL,
@@ -24,8 +24,6 @@ typedef struct particle_thread_args_t
 	bool textureFiltering;
 } ParticleThreadArgs;
 
-extern Config config;
-
 EXTERN_ASSET_VARIABLES(particles, Particles);
 EXTERN_ASSET_MANAGER_VARIABLES;
 
@@ -55,56 +53,40 @@ void loadParticle(
 	arg->columns = columns;
 	arg->textureFiltering = textureFiltering;
 
-	bool skip = false;
-
 	UUID nameID = idFromName(name);
 
 	pthread_mutex_lock(&particlesMutex);
 	if (!hashMapGetData(particles, &nameID))
 	{
 		pthread_mutex_unlock(&particlesMutex);
-		pthread_mutex_lock(&loadingParticlesMutex);
-
-		if (hashMapGetData(loadingParticles, &nameID))
-		{
-			skip = true;
-		}
 
-		pthread_mutex_unlock(&loadingParticlesMutex);
-
-		if (!skip)
-		{
-			pthread_mutex_lock(&uploadParticlesMutex);
-
-			if (hashMapGetData(uploadParticlesQueue, &nameID))
-			{
-				skip = true;
-			}
-
-			pthread_mutex_unlock(&uploadParticlesMutex);
-		}
-
-		if (!skip)
-		{
-			START_ACQUISITION_THREAD(
-				particle,
-				Particle,
-				Particles,
-				arg,
-				nameID);
-			return;
-		}
+		QUEUE_ACQUISITION_JOB(
+			Particle,
+			Particles,
+			arg,
+			nameID,
+			DEFAULT_ASSET_PRIORITY,
+			NULL,
+			NULL);
+		return;
 	}
 	else
 	{
 		pthread_mutex_unlock(&particlesMutex);
 	}
 
-	free(arg->name);
-	free(arg);
+	freeParticleThreadArgs(arg);
 }
 
-ACQUISITION_THREAD(Particle);
+ACQUISITION_JOB(Particle, Particles);
+
+void freeParticleThreadArgs(void *arg)
+{
+	ParticleThreadArgs *threadArgs = arg;
+
+	free(threadArgs->name);
+	free(threadArgs);
+}
 
 void* loadParticleThread(void *arg)
 {
@@ -145,7 +127,6 @@ void* loadParticleThread(void *arg)
 		Particle particle = {};
 
 		particle.name = idFromName(name);
-		particle.lifetime = config.assetsConfig.minParticleLifetime;
 		particle.textureFiltering = textureFiltering;
 		particle.numSprites = numSprites == 0 ? 1 : numSprites;
 		particle.spriteUVs = malloc(numSprites * sizeof(kmVec2));
@@ -208,9 +189,7 @@ void* loadParticleThread(void *arg)
 
 		ASSET_LOG_COMMIT(PARTICLE, name);
 
-		pthread_mutex_lock(&loadingParticlesMutex);
-		hashMapDelete(loadingParticles, &nameID);
-		pthread_mutex_unlock(&loadingParticlesMutex);
+		FINISH_LOADING_ASSET(Particles, nameID);
 	}
 
 	free(fullFilename);
@@ -225,9 +204,32 @@ GET_ASSET_FUNCTION(
 	particle,
 	particles,
 	Particle,
+	Particles,
 	getParticle(const char *name),
 	idFromName(name));
 
+ACQUIRE_ASSET_FUNCTION(
+	particle,
+	particles,
+	Particle,
+	Particles,
+	acquireParticle(const char *name),
+	idFromName(name));
+
+RELEASE_ASSET_FUNCTION(
+	particle,
+	particles,
+	Particle,
+	Particles,
+	releaseParticle(const char *name),
+	idFromName(name));
+
+uint64 getParticleSize(const Particle *particle)
+{
+	return getTextureDataSize(&particle->data) +
+		particle->numSprites * sizeof(kmVec2);
+}
+
 void freeParticleData(Particle *particle)
 {
 	LOG("Freeing particle (%s)...\n", particle->name.string);
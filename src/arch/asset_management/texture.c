@@ -1,4 +1,7 @@
 #include "asset_management/asset_manager.h"
+#include "asset_management/asset_file.h"
+#include "asset_management/asset_upload.h"
+#include "asset_management/cooked_texture.h"
 #include "asset_management/texture.h"
 
 #include "core/config.h"
@@ -8,6 +11,8 @@
 
 #include "ECS/scene.h"
 
+#include "file/utilities.h"
+
 #include "renderer/renderer_utilities.h"
 
 #define STBI_NO_PIC
@@ -17,28 +22,44 @@
 #include <stb/stb_image.h>
 
 #include <string.h>
-#include <unistd.h>
 #include <pthread.h>
 
-#define NUM_TEXTURE_FILE_FORMATS 6
+// Cooked textures are preferred over their source images
+#define NUM_TEXTURE_FILE_FORMATS 7
 internal const char* textureFileFormats[NUM_TEXTURE_FILE_FORMATS] = {
-	"tga", "png", "jpg", "bmp", "gif", "psd"
+	COOKED_TEXTURE_EXTENSION, "tga", "png", "jpg", "bmp", "gif", "psd"
 };
 
 typedef struct texture_thread_args_t
 {
 	char *filename;
 	char *name;
+	int32 priority;
 } TextureThreadArgs;
 
 extern Config config;
 
+internal int32 uploadTextureMipLevels(
+	const char *type,
+	TextureData *data,
+	const uint8 *pixels,
+	GLenum format);
+
 EXTERN_ASSET_VARIABLES(textures, Textures);
 EXTERN_ASSET_MANAGER_VARIABLES;
 
 INTERNAL_ASSET_THREAD_VARIABLES(Texture);
 
 void loadTexture(const char *filename, const char *name)
+{
+	queueTexture(filename, name, DEFAULT_ASSET_PRIORITY, NULL);
+}
+
+void queueTexture(
+	const char *filename,
+	const char *name,
+	int32 priority,
+	JobNode *dependentJob)
 {
 	if (strlen(filename) == 0 || strlen(name) == 0)
 	{
@@ -53,7 +74,7 @@ void loadTexture(const char *filename, const char *name)
 	arg->name = calloc(1, strlen(name) + 1);
 	strcpy(arg->name, name);
 
-	bool skip = false;
+	arg->priority = priority;
 
 	UUID nameID = idFromName(name);
 
@@ -61,44 +82,35 @@ void loadTexture(const char *filename, const char *name)
 	if (!hashMapGetData(textures, &nameID))
 	{
 		pthread_mutex_unlock(&texturesMutex);
-		pthread_mutex_lock(&loadingTexturesMutex);
-
-		if (hashMapGetData(loadingTextures, &nameID))
-		{
-			skip = true;
-		}
-
-		pthread_mutex_unlock(&loadingTexturesMutex);
-
-		if (!skip)
-		{
-			pthread_mutex_lock(&uploadTexturesMutex);
 
-			if (hashMapGetData(uploadTexturesQueue, &nameID))
-			{
-				skip = true;
-			}
-
-			pthread_mutex_unlock(&uploadTexturesMutex);
-		}
-
-		if (!skip)
-		{
-			START_ACQUISITION_THREAD(texture, Texture, Textures, arg, nameID);
-			return;
-		}
+		QUEUE_ACQUISITION_JOB(
+			Texture,
+			Textures,
+			arg,
+			nameID,
+			priority,
+			NULL,
+			dependentJob);
+		return;
 	}
 	else
 	{
 		pthread_mutex_unlock(&texturesMutex);
 	}
 
-	free(arg->filename);
-	free(arg->name);
-	free(arg);
+	freeTextureThreadArgs(arg);
 }
 
-ACQUISITION_THREAD(Texture);
+ACQUISITION_JOB(Texture, Textures);
+
+void freeTextureThreadArgs(void *arg)
+{
+	TextureThreadArgs *threadArgs = arg;
+
+	free(threadArgs->filename);
+	free(threadArgs->name);
+	free(threadArgs);
+}
 
 void* loadTextureThread(void *arg)
 {
@@ -125,7 +137,7 @@ void* loadTextureThread(void *arg)
 	Texture texture = {};
 
 	texture.name = nameID;
-	texture.lifetime = config.assetsConfig.minTextureLifetime;
+	texture.usage.priority = threadArgs->priority;
 
 	error = loadTextureData(
 		ASSET_LOG_TYPE_TEXTURE,
@@ -150,9 +162,7 @@ void* loadTextureThread(void *arg)
 
 	ASSET_LOG_COMMIT(TEXTURE, name);
 
-	pthread_mutex_lock(&loadingTexturesMutex);
-	hashMapDelete(loadingTextures, &nameID);
-	pthread_mutex_unlock(&loadingTexturesMutex);
+	FINISH_LOADING_ASSET(Textures, nameID);
 
 	free(arg);
 	free(filename);
@@ -169,14 +179,36 @@ int32 loadTextureData(
 	int32 numComponents,
 	TextureData *data)
 {
-	data->data = stbi_load(
-		filename,
-		&data->width,
-		&data->height,
-		&data->numComponents,
-		numComponents);
+	data->data = NULL;
+	data->format = TEXTURE_FORMAT_UNCOMPRESSED;
+	data->numMipLevels = 0;
 
-	data->numComponents = numComponents;
+	char *extension = getExtension(filename);
+
+	if (extension && !strcmp(extension, COOKED_TEXTURE_EXTENSION))
+	{
+		loadCookedTextureData(filename, numComponents, data);
+	}
+	else
+	{
+		uint64 size;
+		uint8 *buffer;
+		const uint8 *fileData = readAssetFile(filename, &size, &buffer);
+
+		data->data = fileData ? stbi_load_from_memory(
+			fileData,
+			size,
+			&data->width,
+			&data->height,
+			&data->numComponents,
+			numComponents) : NULL;
+
+		free(buffer);
+
+		data->numComponents = numComponents;
+	}
+
+	free(extension);
 
 	if (!data->data)
 	{
@@ -208,12 +240,19 @@ int32 loadHDRTextureData(
 	bool verticalFlip,
 	HDRTextureData *data)
 {
-	data->data = stbi_loadf(
-		filename,
+	uint64 size;
+	uint8 *buffer;
+	const uint8 *fileData = readAssetFile(filename, &size, &buffer);
+
+	data->data = fileData ? stbi_loadf_from_memory(
+		fileData,
+		size,
 		&data->width,
 		&data->height,
 		&data->numComponents,
-		numComponents);
+		numComponents) : NULL;
+
+	free(buffer);
 
 	data->numComponents = numComponents;
 
@@ -276,25 +315,58 @@ int32 uploadTextureToGPU(
 			break;
 	}
 
-	glTexImage2D(
-		GL_TEXTURE_2D,
-		0,
-		format,
-		data->width,
-		data->height,
-		0,
-		format,
-		GL_UNSIGNED_BYTE,
-		data->data);
+	int32 error = 0;
+
+	uint64 size = data->numMipLevels > 0 ?
+		getTextureDataSize(data) :
+		(uint64)data->width * data->height * data->numComponents;
+	const uint8 *pixels = stageAssetData(
+		GL_PIXEL_UNPACK_BUFFER,
+		data->data,
+		size);
+
+	if (data->numMipLevels > 0)
+	{
+		error = uploadTextureMipLevels(type, data, pixels, format);
+	}
+	else
+	{
+		glTexImage2D(
+			GL_TEXTURE_2D,
+			0,
+			format,
+			data->width,
+			data->height,
+			0,
+			format,
+			GL_UNSIGNED_BYTE,
+			pixels);
+	}
+
+	unstageAssetData(GL_PIXEL_UNPACK_BUFFER);
 
 	free(data->data);
 	data->data = NULL;
 
-	int32 error = logGLError(false, "Failed to transfer %s onto GPU", type);
+	if (error != -1)
+	{
+		error = logGLError(false, "Failed to transfer %s onto GPU", type);
+	}
 
 	if (error != -1)
 	{
-		glGenerateMipmap(GL_TEXTURE_2D);
+		if (data->numMipLevels > 0)
+		{
+			glTexParameteri(
+				GL_TEXTURE_2D,
+				GL_TEXTURE_MAX_LEVEL,
+				data->numMipLevels - 1);
+		}
+		else
+		{
+			glGenerateMipmap(GL_TEXTURE_2D);
+		}
+
 		glTexParameteri(
 			GL_TEXTURE_2D,
 			GL_TEXTURE_MIN_FILTER,
@@ -329,20 +401,130 @@ int32 uploadTextureToGPU(
 	return error;
 }
 
+int32 uploadTextureMipLevels(
+	const char *type,
+	TextureData *data,
+	const uint8 *pixels,
+	GLenum format)
+{
+	GLenum compressedFormat = 0;
+	switch (data->format)
+	{
+		case TEXTURE_FORMAT_BC1:
+			compressedFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+			break;
+		case TEXTURE_FORMAT_BC3:
+			compressedFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			break;
+		case TEXTURE_FORMAT_BC5:
+			compressedFormat = GL_COMPRESSED_RG_RGTC2;
+			break;
+		default:
+			break;
+	}
+
+	if ((data->format == TEXTURE_FORMAT_BC1 ||
+		data->format == TEXTURE_FORMAT_BC3) &&
+		!GLEW_EXT_texture_compression_s3tc)
+	{
+		LOG("Failed to transfer %s onto GPU: S3TC isn't supported\n", type);
+		return -1;
+	}
+
+	for (uint32 i = 0; i < data->numMipLevels; i++)
+	{
+		TextureMipLevel *mipLevel = &data->mipLevels[i];
+
+		if (compressedFormat)
+		{
+			glCompressedTexImage2D(
+				GL_TEXTURE_2D,
+				i,
+				compressedFormat,
+				mipLevel->width,
+				mipLevel->height,
+				0,
+				mipLevel->size,
+				pixels + mipLevel->offset);
+		}
+		else
+		{
+			glTexImage2D(
+				GL_TEXTURE_2D,
+				i,
+				format,
+				mipLevel->width,
+				mipLevel->height,
+				0,
+				format,
+				GL_UNSIGNED_BYTE,
+				pixels + mipLevel->offset);
+		}
+	}
+
+	return 0;
+}
+
 GET_ASSET_FUNCTION(
 	texture,
 	textures,
 	Texture,
+	Textures,
 	getTexture(const char *name),
 	idFromName(name));
 
+ACQUIRE_ASSET_FUNCTION(
+	texture,
+	textures,
+	Texture,
+	Textures,
+	acquireTexture(const char *name),
+	idFromName(name));
+
+RELEASE_ASSET_FUNCTION(
+	texture,
+	textures,
+	Texture,
+	Textures,
+	releaseTexture(const char *name),
+	idFromName(name));
+
+uint64 getTextureSize(const Texture *texture)
+{
+	return getTextureDataSize(&texture->data);
+}
+
+uint64 getTextureDataSize(const TextureData *data)
+{
+	if (data->numMipLevels > 0)
+	{
+		uint64 size = 0;
+		for (uint32 i = 0; i < data->numMipLevels; i++)
+		{
+			size += data->mipLevels[i].size;
+		}
+
+		return size;
+	}
+
+	// The rest of the mip chain adds another third onto the base level
+	uint64 size = (uint64)data->width * data->height * data->numComponents;
+	return size + size / 3;
+}
+
+uint64 getHDRTextureDataSize(const HDRTextureData *data)
+{
+	return (uint64)data->width * data->height * data->numComponents *
+		sizeof(real32);
+}
+
 char* getFullTextureFilename(const char *filename)
 {
 	char *fullFilename = malloc(strlen(filename) + 5);
 	for (uint32 i = 0; i < NUM_TEXTURE_FILE_FORMATS; i++)
 	{
 		sprintf(fullFilename, "%s.%s", filename, textureFileFormats[i]);
-		if (access(fullFilename, F_OK) != -1)
+		if (assetFileExists(fullFilename))
 		{
 			return fullFilename;
 		}
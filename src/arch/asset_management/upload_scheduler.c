@@ -0,0 +1,164 @@
+#include "asset_management/upload_scheduler.h"
+
+#include "data/list.h"
+
+void initializeUploadScheduler(
+	AssetUploadScheduler *scheduler,
+	const AssetUploadBackend *backend,
+	real64 maxFrameTime,
+	uint64 maxFrameSize,
+	uint64 stagingSize)
+{
+	scheduler->backend = backend;
+	scheduler->maxFrameTime = maxFrameTime;
+	scheduler->maxFrameSize = maxFrameSize;
+
+	scheduler->frameStartTime = 0.0;
+	scheduler->frameSize = 0;
+	scheduler->numFrameUploads = 0;
+	scheduler->frameBudgetSpent = false;
+
+	scheduler->batch = 1;
+	scheduler->finishedBatch = 0;
+	scheduler->pendingBatches = createList(sizeof(AssetUploadBatch));
+
+	scheduler->stagingSize =
+		stagingSize - stagingSize % UPLOAD_STAGING_ALIGNMENT;
+	scheduler->stagingHead = 0;
+	scheduler->stagingTail = 0;
+	scheduler->stagingFenced = 0;
+}
+
+void freeUploadScheduler(AssetUploadScheduler *scheduler)
+{
+	for (ListIterator itr = listGetIterator(&scheduler->pendingBatches);
+		 !listIteratorAtEnd(itr);
+		 listMoveIterator(&itr))
+	{
+		scheduler->backend->deleteFence(
+			LIST_ITERATOR_GET_ELEMENT(AssetUploadBatch, itr)->fence);
+	}
+
+	listClear(&scheduler->pendingBatches);
+}
+
+void beginUploadFrame(AssetUploadScheduler *scheduler)
+{
+	// Batches are fenced in order, so they also finish in order
+	while (scheduler->pendingBatches.front)
+	{
+		AssetUploadBatch *batch =
+			(AssetUploadBatch*)scheduler->pendingBatches.front->data;
+		if (!scheduler->backend->isFenceSignalled(batch->fence))
+		{
+			break;
+		}
+
+		scheduler->backend->deleteFence(batch->fence);
+
+		scheduler->finishedBatch = batch->id;
+		scheduler->stagingTail = batch->stagingEnd;
+
+		listPopFront(&scheduler->pendingBatches);
+	}
+
+	scheduler->frameStartTime = scheduler->backend->getTime();
+	scheduler->frameSize = 0;
+	scheduler->numFrameUploads = 0;
+	scheduler->frameBudgetSpent = false;
+}
+
+bool canScheduleUpload(AssetUploadScheduler *scheduler, uint64 size)
+{
+	if (scheduler->frameBudgetSpent)
+	{
+		return false;
+	}
+
+	if (scheduler->numFrameUploads == 0)
+	{
+		return true;
+	}
+
+	if ((scheduler->maxFrameSize > 0 &&
+		 scheduler->frameSize + size > scheduler->maxFrameSize) ||
+		(scheduler->maxFrameTime > 0.0 &&
+		 scheduler->backend->getTime() - scheduler->frameStartTime >=
+			scheduler->maxFrameTime))
+	{
+		scheduler->frameBudgetSpent = true;
+		return false;
+	}
+
+	return true;
+}
+
+uint64 scheduleUpload(AssetUploadScheduler *scheduler, uint64 size)
+{
+	scheduler->frameSize += size;
+	scheduler->numFrameUploads++;
+
+	return scheduler->batch;
+}
+
+void endUploadFrame(AssetUploadScheduler *scheduler)
+{
+	if (scheduler->numFrameUploads == 0 &&
+		scheduler->stagingHead == scheduler->stagingFenced)
+	{
+		return;
+	}
+
+	AssetUploadBatch batch;
+	batch.id = scheduler->batch++;
+	batch.fence = scheduler->backend->createFence();
+	batch.stagingEnd = scheduler->stagingHead;
+
+	listPushBack(&scheduler->pendingBatches, &batch);
+
+	scheduler->stagingFenced = scheduler->stagingHead;
+}
+
+bool isUploadBatchFinished(AssetUploadScheduler *scheduler, uint64 batch)
+{
+	return batch <= scheduler->finishedBatch;
+}
+
+bool allocateUploadStagingMemory(
+	AssetUploadScheduler *scheduler,
+	uint64 size,
+	uint64 *offset)
+{
+	uint64 alignedSize = size + UPLOAD_STAGING_ALIGNMENT - 1;
+	alignedSize -= alignedSize % UPLOAD_STAGING_ALIGNMENT;
+
+	if (alignedSize == 0 || alignedSize > scheduler->stagingSize)
+	{
+		return false;
+	}
+
+	// Allocations never wrap around the end of the staging memory
+	uint64 start = scheduler->stagingHead;
+	uint64 headOffset = start % scheduler->stagingSize;
+
+	if (headOffset + alignedSize > scheduler->stagingSize)
+	{
+		start += scheduler->stagingSize - headOffset;
+
+		// The memory skipped over is free straight away if none is in use
+		if (scheduler->stagingTail == scheduler->stagingHead)
+		{
+			scheduler->stagingTail = start;
+		}
+	}
+
+	if (start + alignedSize - scheduler->stagingTail > scheduler->stagingSize)
+	{
+		return false;
+	}
+
+	scheduler->stagingHead = start + alignedSize;
+	*offset = start % scheduler->stagingSize;
+
+	return true;
+}
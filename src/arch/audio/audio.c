@@ -1,6 +1,7 @@
 #include "defines.h"
 
 #include "audio/audio.h"
+#include "audio/audio_stream.h"
 
 #include "components/audio_source.h"
 
@@ -98,6 +99,21 @@ int32 initAudio(void)
 		return -1;
 	}
 
+	if (initAudioStreams() == -1)
+	{
+		alDeleteSources(NUM_AUDIO_SRC, g_Sources);
+		alDeleteBuffers(NUM_AUDIO_BUFF, g_Buffers);
+
+		free(g_Buffers);
+		free(g_Sources);
+
+		alcMakeContextCurrent(NULL);
+		alcDestroyContext(context);
+		alcCloseDevice(device);
+
+		return -1;
+	}
+
 	return 0;
 }
 
@@ -119,6 +135,7 @@ void setListenerScene(const char *name)
 void shutdownAudio(void)
 {
 	stopAllAudio();
+	shutdownAudioStreams();
 
 	alDeleteBuffers(NUM_AUDIO_BUFF, g_Buffers);
 	free(g_Buffers);
@@ -0,0 +1,348 @@
+#include "audio/audio_stream.h"
+#include "audio/audio.h"
+
+#include "core/log.h"
+
+#define STB_VORBIS_HEADER_ONLY
+#include <stb/stb_vorbis.c>
+
+#include <AL/al.h>
+
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+typedef struct audio_stream_t
+{
+	bool active;
+	UUID name;
+	stb_vorbis *decoder;
+	ALenum format;
+	int32 channels;
+	int32 sampleRate;
+	bool looping;
+	// Set once the decoder has run out of samples for good
+	bool finished;
+	ALuint buffers[NUM_AUDIO_STREAM_BUFFERS];
+} AudioStream;
+
+extern ALuint *g_Sources;
+
+internal AudioStream audioStreams[NUM_AUDIO_SRC];
+internal pthread_mutex_t audioStreamsMutex;
+
+// Only ever used while audioStreamsMutex is locked
+internal int16 audioStreamSamples[AUDIO_STREAM_BUFFER_FRAMES * 2];
+
+internal pthread_t audioStreamThread;
+internal bool exitAudioStreamThread;
+
+internal void* streamAudio(void *arg);
+internal void updateAudioStream(uint32 sourceID);
+internal bool fillAudioStreamBuffer(AudioStream *stream, ALuint buffer);
+internal void closeAudioStream(uint32 sourceID);
+
+int32 initAudioStreams(void)
+{
+	memset(audioStreams, 0, sizeof(audioStreams));
+
+	alGetError();
+
+	for (uint32 i = 0; i < NUM_AUDIO_SRC; i++)
+	{
+		alGenBuffers(NUM_AUDIO_STREAM_BUFFERS, audioStreams[i].buffers);
+	}
+
+	ALenum errorCode = alGetError();
+	if (errorCode != AL_NO_ERROR)
+	{
+		LOG("alGenBuffers has errored: %s\n", alGetString(errorCode));
+
+		for (uint32 i = 0; i < NUM_AUDIO_SRC; i++)
+		{
+			alDeleteBuffers(NUM_AUDIO_STREAM_BUFFERS, audioStreams[i].buffers);
+		}
+
+		return -1;
+	}
+
+	pthread_mutex_init(&audioStreamsMutex, NULL);
+
+	exitAudioStreamThread = false;
+	pthread_create(&audioStreamThread, NULL, &streamAudio, NULL);
+
+	return 0;
+}
+
+void shutdownAudioStreams(void)
+{
+	pthread_mutex_lock(&audioStreamsMutex);
+	exitAudioStreamThread = true;
+	pthread_mutex_unlock(&audioStreamsMutex);
+
+	pthread_join(audioStreamThread, NULL);
+
+	stopAllAudioStreams();
+
+	for (uint32 i = 0; i < NUM_AUDIO_SRC; i++)
+	{
+		alDeleteBuffers(NUM_AUDIO_STREAM_BUFFERS, audioStreams[i].buffers);
+	}
+
+	pthread_mutex_destroy(&audioStreamsMutex);
+}
+
+int32 playAudioStream(uint32 sourceID, const AudioFile *audio, bool looping)
+{
+	pthread_mutex_lock(&audioStreamsMutex);
+
+	closeAudioStream(sourceID);
+
+	AudioStream *stream = &audioStreams[sourceID];
+
+	int32 error = 0;
+	stream->decoder = stb_vorbis_open_memory(
+		audio->encodedData,
+		audio->encodedSize,
+		&error,
+		NULL);
+
+	if (!stream->decoder)
+	{
+		LOG("Failed to stream audio (%s)\n", audio->name.string);
+		pthread_mutex_unlock(&audioStreamsMutex);
+		return -1;
+	}
+
+	stream->active = true;
+	stream->name = audio->name;
+	stream->format = audio->format;
+	stream->channels = audio->format == AL_FORMAT_MONO16 ? 1 : 2;
+	stream->sampleRate = audio->sample_rate;
+	stream->looping = looping;
+	stream->finished = false;
+
+	ALuint source = g_Sources[sourceID];
+
+	alSourceRewind(source);
+	alSourcei(source, AL_BUFFER, 0);
+	alSourcei(source, AL_LOOPING, AL_FALSE);
+
+	for (uint32 i = 0; i < NUM_AUDIO_STREAM_BUFFERS; i++)
+	{
+		if (!fillAudioStreamBuffer(stream, stream->buffers[i]))
+		{
+			break;
+		}
+
+		alSourceQueueBuffers(source, 1, &stream->buffers[i]);
+	}
+
+	alSourcePlay(source);
+
+	pthread_mutex_unlock(&audioStreamsMutex);
+
+	return 0;
+}
+
+void stopAudioStream(uint32 sourceID)
+{
+	pthread_mutex_lock(&audioStreamsMutex);
+	closeAudioStream(sourceID);
+	pthread_mutex_unlock(&audioStreamsMutex);
+}
+
+void stopAudioFileStreams(UUID name)
+{
+	pthread_mutex_lock(&audioStreamsMutex);
+
+	for (uint32 i = 0; i < NUM_AUDIO_SRC; i++)
+	{
+		if (audioStreams[i].active &&
+			!strcmp(audioStreams[i].name.string, name.string))
+		{
+			closeAudioStream(i);
+		}
+	}
+
+	pthread_mutex_unlock(&audioStreamsMutex);
+}
+
+void stopAllAudioStreams(void)
+{
+	pthread_mutex_lock(&audioStreamsMutex);
+
+	for (uint32 i = 0; i < NUM_AUDIO_SRC; i++)
+	{
+		closeAudioStream(i);
+	}
+
+	pthread_mutex_unlock(&audioStreamsMutex);
+}
+
+bool isAudioStreamActive(uint32 sourceID)
+{
+	pthread_mutex_lock(&audioStreamsMutex);
+	bool active = audioStreams[sourceID].active;
+	pthread_mutex_unlock(&audioStreamsMutex);
+
+	return active;
+}
+
+void setAudioSourceLooping(uint32 sourceID, bool looping)
+{
+	pthread_mutex_lock(&audioStreamsMutex);
+
+	AudioStream *stream = &audioStreams[sourceID];
+	if (stream->active)
+	{
+		stream->looping = looping;
+	}
+	else
+	{
+		alSourcei(g_Sources[sourceID], AL_LOOPING, looping);
+	}
+
+	pthread_mutex_unlock(&audioStreamsMutex);
+}
+
+void* streamAudio(void *arg)
+{
+	struct timespec updateInterval;
+	updateInterval.tv_sec = 0;
+	updateInterval.tv_nsec = AUDIO_STREAM_UPDATE_INTERVAL * 1000000000;
+
+	while (true)
+	{
+		pthread_mutex_lock(&audioStreamsMutex);
+
+		if (exitAudioStreamThread)
+		{
+			pthread_mutex_unlock(&audioStreamsMutex);
+			break;
+		}
+
+		for (uint32 i = 0; i < NUM_AUDIO_SRC; i++)
+		{
+			if (audioStreams[i].active)
+			{
+				updateAudioStream(i);
+			}
+		}
+
+		pthread_mutex_unlock(&audioStreamsMutex);
+
+		nanosleep(&updateInterval, NULL);
+	}
+
+	EXIT_THREAD(NULL);
+}
+
+void updateAudioStream(uint32 sourceID)
+{
+	AudioStream *stream = &audioStreams[sourceID];
+	ALuint source = g_Sources[sourceID];
+
+	ALint numProcessedBuffers = 0;
+	alGetSourcei(source, AL_BUFFERS_PROCESSED, &numProcessedBuffers);
+
+	for (ALint i = 0; i < numProcessedBuffers; i++)
+	{
+		ALuint buffer;
+		alSourceUnqueueBuffers(source, 1, &buffer);
+
+		if (fillAudioStreamBuffer(stream, buffer))
+		{
+			alSourceQueueBuffers(source, 1, &buffer);
+		}
+	}
+
+	ALint numQueuedBuffers = 0;
+	alGetSourcei(source, AL_BUFFERS_QUEUED, &numQueuedBuffers);
+
+	if (numQueuedBuffers == 0)
+	{
+		closeAudioStream(sourceID);
+		return;
+	}
+
+	// The source stops by itself if it plays every buffer before they could be
+	// refilled
+	ALint state = 0;
+	alGetSourcei(source, AL_SOURCE_STATE, &state);
+
+	if (state == AL_STOPPED)
+	{
+		alSourcePlay(source);
+	}
+}
+
+bool fillAudioStreamBuffer(AudioStream *stream, ALuint buffer)
+{
+	if (stream->finished)
+	{
+		return false;
+	}
+
+	int32 numFrames = 0;
+	bool rewound = false;
+
+	while (numFrames < AUDIO_STREAM_BUFFER_FRAMES)
+	{
+		int32 numDecodedFrames = stb_vorbis_get_samples_short_interleaved(
+			stream->decoder,
+			stream->channels,
+			audioStreamSamples + numFrames * stream->channels,
+			(AUDIO_STREAM_BUFFER_FRAMES - numFrames) * stream->channels);
+
+		if (numDecodedFrames > 0)
+		{
+			numFrames += numDecodedFrames;
+			rewound = false;
+		}
+		else if (stream->looping && !rewound)
+		{
+			stb_vorbis_seek_start(stream->decoder);
+			rewound = true;
+		}
+		else
+		{
+			stream->finished = true;
+			break;
+		}
+	}
+
+	if (numFrames == 0)
+	{
+		return false;
+	}
+
+	alBufferData(
+		buffer,
+		stream->format,
+		audioStreamSamples,
+		numFrames * stream->channels * sizeof(int16),
+		stream->sampleRate);
+
+	return true;
+}
+
+void closeAudioStream(uint32 sourceID)
+{
+	AudioStream *stream = &audioStreams[sourceID];
+	if (!stream->active)
+	{
+		return;
+	}
+
+	ALuint source = g_Sources[sourceID];
+
+	// Detaching the buffer clears the source's queue
+	alSourceStop(source);
+	alSourcei(source, AL_BUFFER, 0);
+
+	stb_vorbis_close(stream->decoder);
+
+	stream->active = false;
+	stream->decoder = NULL;
+}
@@ -2,13 +2,24 @@
 
 #include "data/data_types.h"
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 
 #include "ECS/scene.h"
+#include "ECS/component.h"
 
 HashMap skeletonsMap;
 
+internal ComponentTypeHandle transformComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle jointComponentID = INVALID_HANDLE;
+
 internal void loadSkeleton(HashMap skeleton, Scene *scene, UUID joint);
 
+void initializeAnimationComponent(void)
+{
+	transformComponentID = componentTypeFromName("transform");
+	jointComponentID = componentTypeFromName("joint");
+}
+
 void addSkeleton(Scene *scene, UUID skeletonID)
 {
 	HashMap *skeletons = hashMapGetData(skeletonsMap, &scene);
@@ -26,16 +37,15 @@ void addSkeleton(Scene *scene, UUID skeletonID)
 
 void loadSkeleton(HashMap skeleton, Scene *scene, UUID joint)
 {
-	UUID transformComponentID = idFromName("transform");
-	UUID jointComponentID = idFromName("joint");
+	EntityHandle jointEntity = sceneGetEntity(scene, joint);
 
 	JointComponent *jointComponent = sceneGetComponentFromEntity(
 		scene,
-		joint,
+		jointEntity,
 		jointComponentID);
 	TransformComponent *transform = sceneGetComponentFromEntity(
 		scene,
-		joint,
+		jointEntity,
 		transformComponentID);
 
 	if (!transform)
@@ -46,8 +56,7 @@ void loadSkeleton(HashMap skeleton, Scene *scene, UUID joint)
 	if (jointComponent)
 	{
 		JointTransform jointTransform;
-		jointTransform.uuid = joint;
-		jointTransform.transform = transform;
+		jointTransform.entity = jointEntity;
 
 		UUID name = idFromName(jointComponent->name);
 		hashMapInsert(skeleton, &name, &jointTransform);
@@ -59,7 +68,7 @@ void loadSkeleton(HashMap skeleton, Scene *scene, UUID joint)
 	{
 		transform = sceneGetComponentFromEntity(
 			scene,
-			child,
+			sceneGetEntity(scene, child),
 			transformComponentID);
 
 		if (transform)
@@ -88,5 +97,5 @@ void removeSkeleton(Scene *scene, UUID skeletonID)
 		}
 	}
 
-	sceneRemoveEntity(scene, skeletonID);
+	sceneRemoveEntity(scene, sceneGetEntity(scene, skeletonID));
 }
\ No newline at end of file
@@ -67,13 +67,13 @@ AnimationReference* setCurrentAnimationReference(
 		return NULL;
 	}
 
-	Model model = getModel(modelComponent->name);
-	if (strlen(model.name.string) == 0)
+	Model *model = getModel(modelComponent->name);
+	if (!model)
 	{
 		return NULL;
 	}
 
-	animationReference->currentAnimation = getAnimation(&model, name);
+	animationReference->currentAnimation = getAnimation(model, name);
 	if (!animationReference->currentAnimation)
 	{
 		resetAnimator(animator, animationReference);
@@ -127,4 +127,25 @@ void removeAnimator(AnimatorComponent *animator)
 	{
 		hashMapDelete(animationReferences, &animator);
 	}
+}
+
+void moveAnimator(
+	AnimatorComponent *animator,
+	AnimatorComponent *newAnimator)
+{
+	if (!animationReferences)
+	{
+		return;
+	}
+
+	AnimationReference *animationReference = hashMapGetData(
+		animationReferences,
+		&animator);
+
+	if (animationReference)
+	{
+		AnimationReference reference = *animationReference;
+		hashMapDelete(animationReferences, &animator);
+		hashMapInsert(animationReferences, &newAnimator, &reference);
+	}
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "asset_management/audio.h"
 
 #include "audio/audio.h"
+#include "audio/audio_stream.h"
 
 #include "components/audio_source.h"
 
@@ -29,8 +30,8 @@ void playSoundAtSource(
 {
 	loadAudio(soundName);
 
-	AudioFile audioData = getAudio(soundName);
-	if (strlen(audioData.name.string) == 0)
+	AudioFile *audioData = getAudio(soundName);
+	if (!audioData)
 	{
 		if (playAudioQueue && !hashMapGetData(playAudioQueue, &audioSource))
 		{
@@ -42,17 +43,32 @@ void playSoundAtSource(
 	}
 	else
 	{
-		strcpy(audioSource->currentAudio, soundName);
-
-		alSourceRewind(g_Sources[audioSource->id]);
+		playAudioFileAtSource(audioSource, audioData);
+	}
+}
 
-		alSourcei(
-			g_Sources[audioSource->id],
-			AL_BUFFER,
-			g_Buffers[audioData.id]);
+void playAudioFileAtSource(
+	AudioSourceComponent *audioSource,
+	const AudioFile *audio)
+{
+	strcpy(audioSource->currentAudio, audio->name.string);
 
-		alSourcePlay(g_Sources[audioSource->id]);
+	if (audio->streamed)
+	{
+		playAudioStream(audioSource->id, audio, audioSource->looping);
+		return;
 	}
+
+	stopAudioStream(audioSource->id);
+
+	alSourceRewind(g_Sources[audioSource->id]);
+
+	alSourcei(
+		g_Sources[audioSource->id],
+		AL_BUFFER,
+		g_Buffers[audio->id]);
+
+	alSourcePlay(g_Sources[audioSource->id]);
 }
 
 // void queueSoundAtSource(
@@ -92,6 +108,7 @@ void resumeSoundAtSource(AudioSourceComponent *audioSource)
 
 void stopSoundAtSource(AudioSourceComponent *audioSource)
 {
+	stopAudioStream(audioSource->id);
 	alSourceStop(g_Sources[audioSource->id]);
 
 	if (playAudioQueue)
@@ -114,7 +131,27 @@ bool isSourceActive(AudioSourceComponent *audioSource)
 		return true;
 	}
 
-	return false;
+	// A stream which ran out of buffers is only stopped until it's refilled
+	return isAudioStreamActive(audioSource->id);
+}
+
+void moveAudioSource(
+	AudioSourceComponent *audioSource,
+	AudioSourceComponent *newAudioSource)
+{
+	if (!playAudioQueue)
+	{
+		return;
+	}
+
+	PlayAudioQueueData *audio = hashMapGetData(playAudioQueue, &audioSource);
+
+	if (audio)
+	{
+		PlayAudioQueueData queuedAudio = *audio;
+		hashMapDelete(playAudioQueue, &audioSource);
+		hashMapInsert(playAudioQueue, &newAudioSource, &queuedAudio);
+	}
 }
 
 void pauseAllAudio(void)
@@ -124,6 +161,7 @@ void pauseAllAudio(void)
 
 void stopAllAudio(void)
 {
+	stopAllAudioStreams();
 	alSourceStopv(NUM_AUDIO_SRC, g_Sources);
 
 	if (playAudioQueue)
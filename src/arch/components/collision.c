@@ -1,6 +1,17 @@
 #include "components/collision.h"
 
+#include "data/intern_table.h"
+
 #include "ECS/scene.h"
+#include "ECS/component.h"
+
+internal ComponentTypeHandle collisionTreeNodeComponentID = INVALID_HANDLE;
+
+void initializeCollisionComponent(void)
+{
+	collisionTreeNodeComponentID = componentTypeFromName(
+		"collision_tree_node");
+}
 
 void removeCollisionComponent(Scene *scene, CollisionComponent *coll)
 {
@@ -10,15 +21,17 @@ void removeCollisionComponent(Scene *scene, CollisionComponent *coll)
 	}
 
 	CollisionTreeNodeComponent *node = NULL;
-	UUID collisionTreeNodeID = idFromName("collision_tree_node");
 	UUID currentCollider = coll->collisionTree;
 	UUID nextCollider = {};
 	while (currentCollider.string[0] != 0)
 	{
+		EntityHandle currentColliderEntity = sceneGetEntity(
+			scene,
+			currentCollider);
 		node = (CollisionTreeNodeComponent *)sceneGetComponentFromEntity(
 			scene,
-			currentCollider,
-			collisionTreeNodeID);
+			currentColliderEntity,
+			collisionTreeNodeComponentID);
 
 		if (!node)
 		{
@@ -26,7 +39,7 @@ void removeCollisionComponent(Scene *scene, CollisionComponent *coll)
 		}
 
 		nextCollider = node->nextCollider;
-		sceneRemoveEntity(scene, currentCollider);
+		sceneRemoveEntity(scene, currentColliderEntity);
 		currentCollider = nextCollider;
 	}
 }
\ No newline at end of file
@@ -1,34 +1,43 @@
 #include "components/collision_tree_node.h"
 
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 
 #include "ECS/scene.h"
 #include "ECS/component.h"
 
 #include <ode/ode.h>
 
+internal ComponentTypeHandle collisionComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle nodeComponentID = INVALID_HANDLE;
+
+void initializeCollisionTreeNodeComponent(void)
+{
+	collisionComponentID = componentTypeFromName("collision");
+	nodeComponentID = componentTypeFromName("collision_tree_node");
+}
+
 void removeCollisionTreeNode(
 	Scene *scene,
-	UUID entity,
+	EntityHandle entity,
 	CollisionTreeNodeComponent *node)
 {
-	UUID collisionComponentID = idFromName("collision");
-	UUID nodeComponentID = idFromName("collision_tree_node");
 	UUID emptyID = idFromName("");
+	UUID entityID = sceneGetEntityID(scene, entity);
 
 	CollisionComponent *collisionComponent = sceneGetComponentFromEntity(
 		scene,
-		node->collisionVolume,
+		sceneGetEntity(scene, node->collisionVolume),
 		collisionComponentID);
 
 	UUID nodeID = collisionComponent->collisionTree;
 
 	CollisionTreeNodeComponent *nodeComponent = sceneGetComponentFromEntity(
 		scene,
-		nodeID,
+		sceneGetEntity(scene, nodeID),
 		nodeComponentID);
 
-	if (!strcmp(entity.string, nodeID.string))
+	if (!strcmp(entityID.string, nodeID.string))
 	{
 		collisionComponent->collisionTree = emptyID;
 		if (nodeComponent)
@@ -45,11 +54,11 @@ void removeCollisionTreeNode(
 			nodeID = nodeComponent->nextCollider;
 			nodeComponent = sceneGetComponentFromEntity(
 				scene,
-				nodeID,
+				sceneGetEntity(scene, nodeID),
 				nodeComponentID);
 
 			if (!strcmp(
-				entity.string,
+				entityID.string,
 				previousNodeComponent->nextCollider.string))
 			{
 				previousNodeComponent->nextCollider = emptyID;
@@ -1,6 +1,16 @@
 #include "components/panel.h"
 
+#include "data/intern_table.h"
+
 #include "ECS/scene.h"
+#include "ECS/component.h"
+
+internal ComponentTypeHandle widgetComponentID = INVALID_HANDLE;
+
+void initializePanelComponent(void)
+{
+	widgetComponentID = componentTypeFromName("widget");
+}
 
 void removePanelWidgets(Scene *scene, PanelComponent *panel)
 {
@@ -8,16 +18,16 @@ void removePanelWidgets(Scene *scene, PanelComponent *panel)
 
 	do
 	{
+		EntityHandle widgetEntity = sceneGetEntity(scene, entity);
 		WidgetComponent *widget = sceneGetComponentFromEntity(
 			scene,
-			entity,
-			idFromName("widget"));
+			widgetEntity,
+			widgetComponentID);
 
 		if (widget)
 		{
-			UUID widgetID = entity;
 			entity = widget->nextWidget;
-			sceneRemoveEntity(scene, widgetID);
+			sceneRemoveEntity(scene, widgetEntity);
 		}
 		else
 		{
@@ -213,4 +213,35 @@ void removeParticleEmitter(
 			hashMapDelete(particleEmitters, &particleEmitterReference);
 		}
 	}
+}
+
+void moveParticleEmitter(
+	UUID entity,
+	ParticleEmitterComponent *particleEmitter,
+	ParticleEmitterComponent *newParticleEmitter)
+{
+	if (!particleEmitters)
+	{
+		return;
+	}
+
+	ParticleEmitterReference particleEmitterReference;
+	particleEmitterReference.entity = entity;
+	particleEmitterReference.particleEmitter = particleEmitter;
+
+	ParticleList *particleList = hashMapGetData(
+		particleEmitters,
+		&particleEmitterReference);
+
+	if (particleList)
+	{
+		ParticleList movedParticleList = *particleList;
+		hashMapDelete(particleEmitters, &particleEmitterReference);
+
+		particleEmitterReference.particleEmitter = newParticleEmitter;
+		hashMapInsert(
+			particleEmitters,
+			&particleEmitterReference,
+			&movedParticleList);
+	}
 }
\ No newline at end of file
@@ -1,29 +1,53 @@
 #include "components/rigid_body.h"
 #include "components/transform.h"
 
+#include "data/intern_table.h"
+
+#include "ECS/component.h"
+
 #include "core/log.h"
 
 #include <ode/ode.h>
 
-void registerRigidBody(Scene *scene, UUID entity)
+internal ComponentTypeHandle rigidBodyComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle collisionComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle transformComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle boxComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle sphereComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle capsuleComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle collisionTreeNodeComponentID = INVALID_HANDLE;
+
+void initializeRigidBodyComponent(void)
+{
+	rigidBodyComponentID = componentTypeFromName("rigid_body");
+	collisionComponentID = componentTypeFromName("collision");
+	transformComponentID = componentTypeFromName("transform");
+	boxComponentID = componentTypeFromName("box");
+	sphereComponentID = componentTypeFromName("sphere");
+	capsuleComponentID = componentTypeFromName("capsule");
+	collisionTreeNodeComponentID = componentTypeFromName(
+		"collision_tree_node");
+}
+
+void registerRigidBody(Scene *scene, EntityHandle entity)
 {
 	RigidBodyComponent *body = sceneGetComponentFromEntity(
 		scene,
 		entity,
-		idFromName("rigid_body"));
+		rigidBodyComponentID);
 	CollisionComponent *coll = sceneGetComponentFromEntity(
 		scene,
 		entity,
-		idFromName("collision"));
+		collisionComponentID);
 	TransformComponent *trans = sceneGetComponentFromEntity(
 		scene,
 		entity,
-		idFromName("transform"));
+		transformComponentID);
 
 	if (kmQuaternionLengthSq(&trans->globalRotation) == 0.0f)
 	{
-		LOG("ERROR: Rotation with a magnitude of 0 on entity: %s\n",
-			entity.string);
+		LOG_ERROR("Rotation with a magnitude of 0 on entity: %s\n",
+			sceneGetEntityID(scene, entity).string);
 		ASSERT(false);
 	}
 
@@ -42,7 +66,7 @@ void registerRigidBody(Scene *scene, UUID entity)
 internal
 void updateCollisionGeom(
 	Scene *scene,
-	UUID entity,
+	EntityHandle entity,
 	TransformComponent *bodyTrans,
 	TransformComponent *trans,
 	CollisionTreeNodeComponent *node)
@@ -79,7 +103,10 @@ void updateCollisionGeom(
 	switch (node->type)
 	{
 		case COLLISION_GEOM_TYPE_BOX:
-			box = sceneGetComponentFromEntity(scene, entity, idFromName("box"));
+			box = sceneGetComponentFromEntity(
+				scene,
+				entity,
+				boxComponentID);
 			dGeomBoxSetLengths(
 				node->geomID,
 				box->bounds.x * trans->globalScale.x * 2,
@@ -90,14 +117,14 @@ void updateCollisionGeom(
 			sphere = sceneGetComponentFromEntity(
 				scene,
 				entity,
-				idFromName("sphere"));
+				sphereComponentID);
 			dGeomSphereSetRadius(node->geomID, sphere->radius * maxScale);
 			break;
 		case COLLISION_GEOM_TYPE_CAPSULE:
 			capsule = sceneGetComponentFromEntity(
 				scene,
 				entity,
-				idFromName("capsule"));
+				capsuleComponentID);
 			dGeomCapsuleSetParams(
 				node->geomID,
 				capsule->radius * maxScale,
@@ -116,44 +143,44 @@ void updateCollisionGeoms(
 {
 	CollisionTreeNodeComponent *node = 0;
 	TransformComponent *trans = 0;
-	UUID collisionTreeNodeComponentID = idFromName("collision_tree_node");
-	UUID transformComponentID = idFromName("transform");
 
 	// Walk the tree of collision geometry
 	for (UUID currentCollider = coll->collisionTree;
 		 strcmp(currentCollider.string, "");
 		 currentCollider = node->nextCollider)
 	{
+		EntityHandle colliderEntity = sceneGetEntity(scene, currentCollider);
+
 		trans = sceneGetComponentFromEntity(
 			scene,
-			currentCollider,
+			colliderEntity,
 			transformComponentID);
 
 		node = sceneGetComponentFromEntity(
 			scene,
-			currentCollider,
+			colliderEntity,
 			collisionTreeNodeComponentID);
 
 		// Add each piece of collision geometry as a different geom
-		updateCollisionGeom(scene, currentCollider, bodyTrans, trans, node);
+		updateCollisionGeom(scene, colliderEntity, bodyTrans, trans, node);
 	}
 }
 
 internal
 void createCollisionGeom(
 	Scene *scene,
-	UUID entity,
+	EntityHandle entity,
 	TransformComponent *bodyTrans,
 	RigidBodyComponent *body)
 {
 	CollisionTreeNodeComponent *node = sceneGetComponentFromEntity(
 		scene,
 		entity,
-		idFromName("collision_tree_node"));
+		collisionTreeNodeComponentID);
 	TransformComponent *trans = sceneGetComponentFromEntity(
 		scene,
 		entity,
-		idFromName("transform"));
+		transformComponentID);
 
 	ASSERT(node && "Collision tree pointed to a node with no node structure");
 
@@ -174,7 +201,7 @@ void createCollisionGeom(
 		BoxComponent *box = sceneGetComponentFromEntity(
 			scene,
 			entity,
-			idFromName("box"));
+			boxComponentID);
 
 		node->geomID = dCreateBox(
 			body->spaceID,
@@ -188,7 +215,7 @@ void createCollisionGeom(
 		SphereComponent *sphere = sceneGetComponentFromEntity(
 			scene,
 			entity,
-			idFromName("sphere"));
+			sphereComponentID);
 
 		node->geomID = dCreateSphere(body->spaceID, sphere->radius * maxScale);
 	} break;
@@ -197,7 +224,7 @@ void createCollisionGeom(
 		CapsuleComponent *capsule = sceneGetComponentFromEntity(
 			scene,
 			entity,
-			idFromName("capsule"));
+			capsuleComponentID);
 
 		node->geomID = dCreateCapsule(
 			body->spaceID,
@@ -214,8 +241,9 @@ void createCollisionGeom(
 	dGeomSetBody(node->geomID, body->bodyID);
 
 	// TODO: Store the index in the component data table, instead of the uuid
+	UUID entityID = sceneGetEntityID(scene, entity);
 	void *userData = calloc(1, sizeof(UUID));
-	memcpy(userData, &entity, sizeof(UUID));
+	memcpy(userData, &entityID, sizeof(UUID));
 	dGeomSetData(node->geomID, userData);
 
 	updateCollisionGeom(scene, entity, bodyTrans, trans, node);
@@ -228,20 +256,21 @@ void createCollisionGeoms(
 	CollisionComponent *coll)
 {
 	CollisionTreeNodeComponent *node = 0;
-	UUID collisionTreeNodeID = idFromName("collision_tree_node");
 
 	// Walk the tree of collision geometry
 	for (UUID currentCollider = coll->collisionTree;
 		 strcmp(currentCollider.string, "");
 		 currentCollider = node->nextCollider)
 	{
+		EntityHandle colliderEntity = sceneGetEntity(scene, currentCollider);
+
 		// Add each piece of collision geometry as a different geom
-		createCollisionGeom(scene, currentCollider, bodyTrans, body);
+		createCollisionGeom(scene, colliderEntity, bodyTrans, body);
 
 		node = sceneGetComponentFromEntity(
 			scene,
-			currentCollider,
-			collisionTreeNodeID);
+			colliderEntity,
+			collisionTreeNodeComponentID);
 	}
 }
 
@@ -446,6 +475,15 @@ void updateRigidBodyPosition(
 	}
 }
 
+void removeRigidBody(
+	Scene *scene,
+	EntityHandle entity,
+	RigidBodyComponent *body)
+{
+	sceneRemoveComponentFromEntity(scene, entity, collisionComponentID);
+	destroyRigidBody(body);
+}
+
 void destroyRigidBody(RigidBodyComponent *body)
 {
 	dSpaceDestroy(body->spaceID);
@@ -1,17 +1,25 @@
 #include "components/transform.h"
 #include "components/rigid_body.h"
 
+#include "data/intern_table.h"
+
+#include "ECS/component.h"
+
 #include "core/log.h"
 
 #include "math/math.h"
 
 #include <kazmath/mat3.h>
 
+internal ComponentTypeHandle transformComponentID = INVALID_HANDLE;
+
+void initializeTransformComponent(void)
+{
+	transformComponentID = componentTypeFromName("transform");
+}
+
 internal
-void markDirtyHelper(
-	Scene *scene,
-	UUID *transformComponentID,
-	TransformComponent *trans)
+void markDirtyHelper(Scene *scene, TransformComponent *trans)
 {
 	if (trans)
 	{
@@ -25,30 +33,22 @@ void markDirtyHelper(
 		{
 			child = sceneGetComponentFromEntity(
 				scene,
-				currentChild,
-				*transformComponentID);
+				sceneGetEntity(scene, currentChild),
+				transformComponentID);
 
-			markDirtyHelper(
-				scene,
-				transformComponentID,
-				child);
+			markDirtyHelper(scene, child);
 		}
 	}
 }
 
-void tMarkDirty(Scene *scene, UUID entityID)
+void tMarkDirty(Scene *scene, EntityHandle entityID)
 {
-	UUID transformComponentID = idFromName("transform");
-
 	TransformComponent *trans =
 		sceneGetComponentFromEntity(scene, entityID, transformComponentID);
 
 	if (trans)
 	{
-		markDirtyHelper(
-			scene,
-			&transformComponentID,
-			trans);
+		markDirtyHelper(scene, trans);
 	}
 }
 
@@ -280,8 +280,8 @@ void applyParentTransform(Scene *scene, TransformComponent *outTransform)
 	{
 		TransformComponent *parentTransform = sceneGetComponentFromEntity(
 			scene,
-			outTransform->parent,
-			idFromName("transform"));
+			sceneGetEntity(scene, outTransform->parent),
+			transformComponentID);
 
 		if (parentTransform->dirty)
 		{
@@ -299,9 +299,38 @@ void applyParentTransform(Scene *scene, TransformComponent *outTransform)
 	outTransform->dirty = false;
 }
 
-int32 removeTransform(Scene *scene, UUID entity, TransformComponent *transform)
+void applyChildTransforms(
+	Scene *scene,
+	ComponentTypeHandle transformType,
+	TransformComponent *transform)
 {
-	UUID transformComponentID = idFromName("transform");
+	TransformComponent *child = 0;
+
+	for (UUID currentChild = transform->firstChild;
+		 strcmp(currentChild.string, "");
+		 currentChild = child->nextSibling)
+	{
+		child = sceneGetComponentFromEntity(
+			scene,
+			sceneGetEntity(scene, currentChild),
+			transformType);
+
+		if (child->dirty)
+		{
+			tConcatenateTransforms(transform, child);
+			child->dirty = false;
+		}
+
+		applyChildTransforms(scene, transformType, child);
+	}
+}
+
+int32 removeTransform(
+	Scene *scene,
+	EntityHandle entity,
+	TransformComponent *transform)
+{
+	UUID entityID = sceneGetEntityID(scene, entity);
 
 	UUID child = transform->firstChild;
 	UUID sibling = {};
@@ -309,47 +338,54 @@ int32 removeTransform(Scene *scene, UUID entity, TransformComponent *transform)
 	// Loop through all the children and delete them
 	while (child.string[0] != 0)
 	{
+		EntityHandle childEntity = sceneGetEntity(scene, child);
 		TransformComponent *transformComponent = sceneGetComponentFromEntity(
 			scene,
-			child,
+			childEntity,
 			transformComponentID);
 
 		sibling = transformComponent->nextSibling;
 
-		sceneRemoveEntity(scene, child);
+		sceneRemoveEntity(scene, childEntity);
 		child = sibling;
 	}
 
+	// Removing the children may have moved this transform in the table
+	transform = sceneGetComponentFromEntity(
+		scene,
+		entity,
+		transformComponentID);
+
 	if (transform->parent.string[0] != 0)
 	{
 		transform = sceneGetComponentFromEntity(
 			scene,
-			transform->parent,
+			sceneGetEntity(scene, transform->parent),
 			transformComponentID);
 
 		if (!transform)
 		{
-			LOG("ERROR: Failed to remove invalid transform component "
+			LOG_ERROR("Failed to remove invalid transform component "
 				"from entity: %s\n",
-				entity.string);
+				entityID.string);
 			return -1;
 		}
 
 		TransformComponent *previousTransform = transform;
 		transform = sceneGetComponentFromEntity(
 			scene,
-			transform->firstChild,
+			sceneGetEntity(scene, transform->firstChild),
 			transformComponentID);
 
 		if (!transform)
 		{
-			LOG("ERROR: Failed to remove invalid transform component "
+			LOG_ERROR("Failed to remove invalid transform component "
 				"from entity: %s\n",
-				entity.string);
+				entityID.string);
 			return -1;
 		}
 
-		if (!strcmp(entity.string, previousTransform->firstChild.string))
+		if (!strcmp(entityID.string, previousTransform->firstChild.string))
 		{
 			previousTransform->firstChild = transform->nextSibling;
 		}
@@ -361,18 +397,18 @@ int32 removeTransform(Scene *scene, UUID entity, TransformComponent *transform)
 				sibling = transform->nextSibling;
 				transform = sceneGetComponentFromEntity(
 					scene,
-					sibling,
+					sceneGetEntity(scene, sibling),
 					transformComponentID);
 
 				if (!transform)
 				{
-					LOG("ERROR: Failed to remove invalid transform component "
+					LOG_ERROR("Failed to remove invalid transform component "
 						"from entity: %s\n",
-						entity.string);
+						entityID.string);
 					return -1;
 				}
 
-				if (!strcmp(entity.string, sibling.string))
+				if (!strcmp(entityID.string, sibling.string))
 				{
 					previousTransform->nextSibling = transform->nextSibling;
 					break;
@@ -2,19 +2,27 @@
 #include "components/component_types.h"
 
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 
 #include "ECS/scene.h"
 #include "ECS/component.h"
 
-void removeWidget(Scene *scene, UUID entity)
+internal ComponentTypeHandle panelComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle widgetComponentID = INVALID_HANDLE;
+
+void initializeWidgetComponent(void)
+{
+	panelComponentID = componentTypeFromName("panel");
+	widgetComponentID = componentTypeFromName("widget");
+}
+
+void removeWidget(Scene *scene, EntityHandle entity)
 {
-	UUID panelComponentID = idFromName("panel");
-	UUID widgetComponentID = idFromName("widget");
+	ComponentDataTable *panelComponents = sceneGetComponentDataTable(
+		scene,
+		panelComponentID);
 
-	ComponentDataTable *panelComponents =
-		*(ComponentDataTable**)hashMapGetData(
-				scene->componentTypes,
-				&panelComponentID);
+	UUID entityID = sceneGetEntityID(scene, entity);
 
 	bool removed = false;
 
@@ -27,10 +35,10 @@ void removeWidget(Scene *scene, UUID entity)
 
 		WidgetComponent *widgetComponent = sceneGetComponentFromEntity(
 			scene,
-			widgetID,
+			sceneGetEntity(scene, widgetID),
 			widgetComponentID);
 
-		if (!strcmp(entity.string, widgetID.string))
+		if (!strcmp(entityID.string, widgetID.string))
 		{
 			panelComponent->firstWidget = idFromName("");
 			if (widgetComponent)
@@ -49,11 +57,11 @@ void removeWidget(Scene *scene, UUID entity)
 				widgetID = widgetComponent->nextWidget;
 				widgetComponent = sceneGetComponentFromEntity(
 					scene,
-					widgetID,
+					sceneGetEntity(scene, widgetID),
 					widgetComponentID);
 
 				if (!strcmp(
-					entity.string,
+					entityID.string,
 					previousWidgetComponent->nextWidget.string))
 				{
 					previousWidgetComponent->nextWidget = idFromName("");
@@ -7,9 +7,61 @@
 #include "file/utilities.h"
 
 #include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <malloc.h>
 #include <string.h>
 #include <pthread.h>
+#include <time.h>
+
+// Longest conversion specification which can be deferred
+#define MAX_LOG_CONVERSION_LENGTH 32
+
+typedef enum log_destination_e
+{
+	LOG_DESTINATION_ENGINE = 0,
+	LOG_DESTINATION_ASSET_MANAGER
+} LogDestination;
+
+typedef struct log_entry_t
+{
+	// Queue position of the entry plus one once its message can be written
+	uint64 sequence;
+	LogDestination destination;
+	// Format of a deferred message, whose arguments are copied into data
+	const char *format;
+	// Messages which don't fit into data are allocated
+	char *message;
+	uint8 data[LOG_MESSAGE_SIZE];
+} LogEntry;
+
+typedef enum log_argument_type_e
+{
+	// Conversions like %% which don't take an argument
+	LOG_ARGUMENT_NONE = 0,
+	LOG_ARGUMENT_INT,
+	LOG_ARGUMENT_LONG,
+	LOG_ARGUMENT_LONG_LONG,
+	LOG_ARGUMENT_INTMAX,
+	LOG_ARGUMENT_SIZE,
+	LOG_ARGUMENT_PTRDIFF,
+	LOG_ARGUMENT_DOUBLE,
+	LOG_ARGUMENT_LONG_DOUBLE,
+	LOG_ARGUMENT_STRING,
+	LOG_ARGUMENT_POINTER,
+	// Conversions which can't be deferred
+	LOG_ARGUMENT_INVALID
+} LogArgumentType;
+
+typedef struct log_conversion_t
+{
+	// Number of characters in the conversion specification, from its %
+	uint32 length;
+	// Width and precision which are passed as int arguments
+	bool argumentWidth;
+	bool argumentPrecision;
+	LogArgumentType type;
+} LogConversion;
 
 #define CREATE_ASSET_LOG(asset) \
 internal HashMap asset ## Log; \
@@ -43,9 +95,59 @@ pthread_mutex_destroy(&asset ## LogMutex)
 #define PARTICLES_LOG_BUCKET_COUNT 521
 #define CUBEMAPS_LOG_BUCKET_COUNT 5
 
-internal pthread_mutex_t assetLogMutex;
+// Bounded queue which any thread can add messages to without locking, and
+// which only the log thread takes them from
+internal LogEntry *logQueue;
+internal uint64 logEnqueuePosition;
+internal uint64 logDequeuePosition;
+// Messages before this queue position have been written and flushed
+internal uint64 logFlushedPosition;
+internal uint64 numDroppedLogMessages;
+
+internal bool logRunning;
+internal bool exitLogThread;
+internal pthread_t logThread;
+
+internal FILE *engineLogFile;
+internal FILE *assetManagerLogFile;
+
+internal void* writeLogMessages(void *arg);
+internal uint32 writeQueuedLogMessages(void);
+internal void closeLogFiles(void);
+
+internal void queueLogMessage(
+	LogDestination destination,
+	const char *format,
+	bool deferFormatting,
+	va_list args);
+internal void queueLogText(LogDestination destination, char *text);
+internal LogEntry* claimLogEntry(uint64 *position);
+internal void publishLogEntry(LogEntry *entry, uint64 position);
+
+internal const char* getLogFilename(LogDestination destination);
+internal void writeLogMessageNow(
+	LogDestination destination,
+	const char *format,
+	va_list args);
+internal void formatLogMessage(
+	LogEntry *entry,
+	const char *format,
+	va_list args);
 
-internal FILE *assetLogFile;
+internal LogConversion parseLogConversion(const char *specification);
+internal bool captureLogArguments(
+	const char *format,
+	va_list args,
+	uint8 *data);
+internal bool storeLogArgument(
+	uint8 *data,
+	uint32 *size,
+	const void *value,
+	uint32 valueSize);
+internal void writeDeferredLogMessage(
+	FILE *file,
+	const char *format,
+	const uint8 *data);
 
 internal HashMap getAssetLog(AssetLogType type);
 internal pthread_mutex_t* getAssetLogMutex(AssetLogType type);
@@ -57,6 +159,116 @@ internal void addAssetLogBuffer(
 	char *logBuffer);
 internal void removeAssetLogBuffer(AssetLogType type, const char *name);
 
+void initializeLog(void)
+{
+	logQueue = calloc(LOG_QUEUE_SIZE, sizeof(LogEntry));
+
+	for (uint32 i = 0; i < LOG_QUEUE_SIZE; i++)
+	{
+		logQueue[i].sequence = i;
+	}
+
+	logEnqueuePosition = 0;
+	logDequeuePosition = 0;
+	logFlushedPosition = 0;
+	numDroppedLogMessages = 0;
+
+	const char *engineFilename = getLogFilename(LOG_DESTINATION_ENGINE);
+	engineLogFile = engineFilename ? fopen(engineFilename, "a") : stdout;
+	if (!engineLogFile)
+	{
+		engineLogFile = stdout;
+	}
+
+	assetManagerLogFile = fopen(
+		getLogFilename(LOG_DESTINATION_ASSET_MANAGER),
+		"a");
+	if (!assetManagerLogFile)
+	{
+		assetManagerLogFile = stdout;
+	}
+
+	exitLogThread = false;
+	if (pthread_create(&logThread, NULL, &writeLogMessages, NULL))
+	{
+		// logRunning stays false, so messages are written straight away
+		closeLogFiles();
+		LOG_ERROR("Failed to start the log thread\n");
+		return;
+	}
+
+	__atomic_store_n(&logRunning, true, __ATOMIC_RELEASE);
+}
+
+void flushLog(void)
+{
+	struct timespec waitInterval;
+	waitInterval.tv_sec = 0;
+	waitInterval.tv_nsec = 1000000;
+
+	uint64 position = __atomic_load_n(&logEnqueuePosition, __ATOMIC_ACQUIRE);
+
+	while (__atomic_load_n(&logRunning, __ATOMIC_ACQUIRE) &&
+		__atomic_load_n(&logFlushedPosition, __ATOMIC_ACQUIRE) < position)
+	{
+		nanosleep(&waitInterval, NULL);
+	}
+}
+
+void shutdownLog(void)
+{
+	if (!__atomic_load_n(&logRunning, __ATOMIC_ACQUIRE))
+	{
+		return;
+	}
+
+	// Messages are written straight away from now on, the thread writes
+	// everything which was queued before it exits
+	__atomic_store_n(&logRunning, false, __ATOMIC_RELEASE);
+	__atomic_store_n(&exitLogThread, true, __ATOMIC_RELEASE);
+	pthread_join(logThread, NULL);
+
+	closeLogFiles();
+}
+
+void closeLogFiles(void)
+{
+	if (engineLogFile != stdout)
+	{
+		fclose(engineLogFile);
+	}
+
+	if (assetManagerLogFile != stdout)
+	{
+		fclose(assetManagerLogFile);
+	}
+
+	engineLogFile = NULL;
+	assetManagerLogFile = NULL;
+
+	free(logQueue);
+	logQueue = NULL;
+}
+
+void logMessage(LogLevel level, const char *format, ...)
+{
+	if (level < config.logConfig.level)
+	{
+		return;
+	}
+
+	va_list args;
+	va_start(args, format);
+
+	queueLogMessage(
+		LOG_DESTINATION_ENGINE,
+		format,
+		config.logConfig.deferFormatting,
+		args);
+
+	va_end(args);
+}
+
 void initializeAssetLog(void)
 {
 	INITIALIZE_ASSET_LOG(models, MODELS);
@@ -66,22 +278,22 @@ void initializeAssetLog(void)
 	INITIALIZE_ASSET_LOG(audio, AUDIO);
 	INITIALIZE_ASSET_LOG(particles, PARTICLES);
 	INITIALIZE_ASSET_LOG(cubemaps, CUBEMAPS);
-
-	pthread_mutex_init(&assetLogMutex, NULL);
 }
 
 void logFunction(const char *format, ...)
 {
-	va_list args;
-    va_start(args, format);
+	if (LOG_LEVEL_INFO < config.logConfig.level)
+	{
+		return;
+	}
 
-	char *message = malloc(strlen(format) + 4096);
-	vsprintf(message, format, args);
-    va_end(args);
+	va_list args;
+	va_start(args, format);
 
-	LOG("%s", message);
+	// The format isn't known to outlive the call, so it can't be deferred
+	queueLogMessage(LOG_DESTINATION_ENGINE, format, false, args);
 
-	free(message);
+	va_end(args);
 }
 
 void assetLogWrite(
@@ -127,15 +339,8 @@ void assetLogCommit(AssetLogType type, const char *name)
 	char **logBuffer = getAssetLogBuffer(type, name);
 	if (logBuffer && *logBuffer)
 	{
-		pthread_mutex_lock(&assetLogMutex);
-
-		assetLogFile = fopen(ASSET_LOG_FILE_NAME, "a");
-		fprintf(assetLogFile, "%s", *logBuffer);
-		fclose(assetLogFile);
-
-		pthread_mutex_unlock(&assetLogMutex);
-
-		free(*logBuffer);
+		// The log thread writes and frees the buffer
+		queueLogText(LOG_DESTINATION_ASSET_MANAGER, *logBuffer);
 		removeAssetLogBuffer(type, name);
 	}
 
@@ -151,8 +356,6 @@ void shutdownAssetLog(void)
 	FREE_ASSET_LOG(audio);
 	FREE_ASSET_LOG(particles);
 	FREE_ASSET_LOG(cubemaps);
-
-	pthread_mutex_destroy(&assetLogMutex);
 }
 
 HashMap getAssetLog(AssetLogType type)
@@ -238,4 +441,668 @@ void removeAssetLogBuffer(AssetLogType type, const char *name)
 		UUID nameID = idFromName(name);
 		hashMapDelete(logBuffers, &nameID);
 	}
-}
\ No newline at end of file
+}
+
+void* writeLogMessages(void *arg)
+{
+	struct timespec flushInterval;
+	flushInterval.tv_sec = 0;
+	flushInterval.tv_nsec = LOG_FLUSH_INTERVAL * 1000000000;
+
+	while (true)
+	{
+		bool exit = __atomic_load_n(&exitLogThread, __ATOMIC_ACQUIRE);
+
+		if (writeQueuedLogMessages() == 0)
+		{
+			if (exit)
+			{
+				break;
+			}
+
+			nanosleep(&flushInterval, NULL);
+		}
+	}
+
+	EXIT_THREAD(NULL);
+}
+
+uint32 writeQueuedLogMessages(void)
+{
+	uint32 numMessages = 0;
+
+	while (true)
+	{
+		LogEntry *entry = &logQueue[logDequeuePosition & (LOG_QUEUE_SIZE - 1)];
+
+		if (__atomic_load_n(&entry->sequence, __ATOMIC_ACQUIRE) !=
+			logDequeuePosition + 1)
+		{
+			break;
+		}
+
+		FILE *file = entry->destination == LOG_DESTINATION_ASSET_MANAGER ?
+			assetManagerLogFile : engineLogFile;
+
+		if (entry->format)
+		{
+			writeDeferredLogMessage(file, entry->format, entry->data);
+		}
+		else if (entry->message)
+		{
+			fputs(entry->message, file);
+			free(entry->message);
+		}
+		else
+		{
+			fputs((const char*)entry->data, file);
+		}
+
+		// The entry can be claimed again once the queue has wrapped around
+		__atomic_store_n(
+			&entry->sequence,
+			logDequeuePosition + LOG_QUEUE_SIZE,
+			__ATOMIC_RELEASE);
+
+		logDequeuePosition++;
+		numMessages++;
+	}
+
+	uint64 numDroppedMessages = __atomic_exchange_n(
+		&numDroppedLogMessages,
+		0,
+		__ATOMIC_RELAXED);
+
+	if (numDroppedMessages > 0)
+	{
+		fprintf(
+			engineLogFile,
+			"WARNING: %llu log messages were dropped\n",
+			numDroppedMessages);
+	}
+
+	if (numMessages > 0)
+	{
+		fflush(engineLogFile);
+		fflush(assetManagerLogFile);
+	}
+
+	__atomic_store_n(
+		&logFlushedPosition,
+		logDequeuePosition,
+		__ATOMIC_RELEASE);
+
+	return numMessages;
+}
+
+void queueLogMessage(
+	LogDestination destination,
+	const char *format,
+	bool deferFormatting,
+	va_list args)
+{
+	if (!__atomic_load_n(&logRunning, __ATOMIC_ACQUIRE))
+	{
+		writeLogMessageNow(destination, format, args);
+		return;
+	}
+
+	uint64 position;
+	LogEntry *entry = claimLogEntry(&position);
+
+	if (!entry)
+	{
+		return;
+	}
+
+	entry->destination = destination;
+	entry->format = NULL;
+	entry->message = NULL;
+
+	if (deferFormatting)
+	{
+		va_list deferredArgs;
+		va_copy(deferredArgs, args);
+
+		if (captureLogArguments(format, deferredArgs, entry->data))
+		{
+			entry->format = format;
+		}
+
+		va_end(deferredArgs);
+	}
+
+	if (!entry->format)
+	{
+		formatLogMessage(entry, format, args);
+	}
+
+	publishLogEntry(entry, position);
+}
+
+void queueLogText(LogDestination destination, char *text)
+{
+	if (!__atomic_load_n(&logRunning, __ATOMIC_ACQUIRE))
+	{
+		const char *filename = getLogFilename(destination);
+		FILE *file = filename ? fopen(filename, "a") : stdout;
+
+		if (file)
+		{
+			fputs(text, file);
+
+			if (file != stdout)
+			{
+				fclose(file);
+			}
+		}
+
+		free(text);
+		return;
+	}
+
+	uint64 position;
+	LogEntry *entry = claimLogEntry(&position);
+
+	if (!entry)
+	{
+		free(text);
+		return;
+	}
+
+	entry->destination = destination;
+	entry->format = NULL;
+	entry->message = text;
+
+	publishLogEntry(entry, position);
+}
+
+LogEntry* claimLogEntry(uint64 *position)
+{
+	*position = __atomic_load_n(&logEnqueuePosition, __ATOMIC_RELAXED);
+
+	while (true)
+	{
+		LogEntry *entry = &logQueue[*position & (LOG_QUEUE_SIZE - 1)];
+		uint64 sequence = __atomic_load_n(&entry->sequence, __ATOMIC_ACQUIRE);
+
+		if (sequence == *position)
+		{
+			if (__atomic_compare_exchange_n(
+				&logEnqueuePosition,
+				position,
+				*position + 1,
+				true,
+				__ATOMIC_RELAXED,
+				__ATOMIC_RELAXED))
+			{
+				return entry;
+			}
+		}
+		else if (sequence < *position)
+		{
+			// The log thread hasn't written the entry's last message yet, so
+			// the queue is full. Waiting for it could mean waiting for disk.
+			__atomic_add_fetch(&numDroppedLogMessages, 1, __ATOMIC_RELAXED);
+			return NULL;
+		}
+		else
+		{
+			*position = __atomic_load_n(
+				&logEnqueuePosition,
+				__ATOMIC_RELAXED);
+		}
+	}
+}
+
+void publishLogEntry(LogEntry *entry, uint64 position)
+{
+	__atomic_store_n(&entry->sequence, position + 1, __ATOMIC_RELEASE);
+}
+
+const char* getLogFilename(LogDestination destination)
+{
+	if (destination == LOG_DESTINATION_ASSET_MANAGER)
+	{
+		return ASSET_LOG_FILE_NAME;
+	}
+
+	return LOG_FILE_NAME;
+}
+
+void writeLogMessageNow(
+	LogDestination destination,
+	const char *format,
+	va_list args)
+{
+	const char *filename = getLogFilename(destination);
+
+	if (!filename)
+	{
+		vprintf(format, args);
+		return;
+	}
+
+	FILE *file = fopen(filename, "a");
+
+	if (file)
+	{
+		vfprintf(file, format, args);
+		fclose(file);
+	}
+}
+
+void formatLogMessage(LogEntry *entry, const char *format, va_list args)
+{
+	va_list messageArgs;
+	va_copy(messageArgs, args);
+
+	int32 length = vsnprintf(
+		(char*)entry->data,
+		LOG_MESSAGE_SIZE,
+		format,
+		messageArgs);
+
+	va_end(messageArgs);
+
+	if (length < 0)
+	{
+		entry->data[0] = '\0';
+	}
+	else if (length >= LOG_MESSAGE_SIZE)
+	{
+		entry->message = malloc(length + 1);
+		vsnprintf(entry->message, length + 1, format, args);
+	}
+}
+
+LogConversion parseLogConversion(const char *specification)
+{
+	LogConversion conversion = {};
+
+	const char *character = specification + 1;
+	bool hasPrecision = false;
+
+	while (*character && strchr("-+ #0", *character))
+	{
+		character++;
+	}
+
+	if (*character == '*')
+	{
+		conversion.argumentWidth = true;
+		character++;
+	}
+	else
+	{
+		while (*character >= '0' && *character <= '9')
+		{
+			character++;
+		}
+	}
+
+	if (*character == '.')
+	{
+		hasPrecision = true;
+		character++;
+
+		if (*character == '*')
+		{
+			conversion.argumentPrecision = true;
+			character++;
+		}
+		else
+		{
+			while (*character >= '0' && *character <= '9')
+			{
+				character++;
+			}
+		}
+	}
+
+	// Integers shorter than an int are promoted to one
+	LogArgumentType integerType = LOG_ARGUMENT_INT;
+	bool longDouble = false;
+	bool hasLength = true;
+
+	if (!strncmp(character, "hh", 2) || !strncmp(character, "ll", 2))
+	{
+		integerType = character[0] == 'l' ?
+			LOG_ARGUMENT_LONG_LONG : LOG_ARGUMENT_INT;
+		character += 2;
+	}
+	else
+	{
+		switch (*character)
+		{
+			case 'h':
+				integerType = LOG_ARGUMENT_INT;
+				break;
+			case 'l':
+				integerType = LOG_ARGUMENT_LONG;
+				break;
+			case 'j':
+				integerType = LOG_ARGUMENT_INTMAX;
+				break;
+			case 'z':
+				integerType = LOG_ARGUMENT_SIZE;
+				break;
+			case 't':
+				integerType = LOG_ARGUMENT_PTRDIFF;
+				break;
+			case 'L':
+				longDouble = true;
+				break;
+			default:
+				hasLength = false;
+				break;
+		}
+
+		if (hasLength)
+		{
+			character++;
+		}
+	}
+
+	switch (*character)
+	{
+		case '%':
+			conversion.type = LOG_ARGUMENT_NONE;
+			break;
+		case 'd':
+		case 'i':
+		case 'u':
+		case 'o':
+		case 'x':
+		case 'X':
+			conversion.type = longDouble ?
+				LOG_ARGUMENT_INVALID : integerType;
+			break;
+		case 'f':
+		case 'F':
+		case 'e':
+		case 'E':
+		case 'g':
+		case 'G':
+		case 'a':
+		case 'A':
+			conversion.type = longDouble ?
+				LOG_ARGUMENT_LONG_DOUBLE : LOG_ARGUMENT_DOUBLE;
+			break;
+		// Wide characters and strings aren't deferred
+		case 'c':
+			conversion.type = hasLength ?
+				LOG_ARGUMENT_INVALID : LOG_ARGUMENT_INT;
+			break;
+		// Strings with a precision don't have to be terminated, so they can't
+		// be copied safely
+		case 's':
+			conversion.type = hasLength || hasPrecision ?
+				LOG_ARGUMENT_INVALID : LOG_ARGUMENT_STRING;
+			break;
+		case 'p':
+			conversion.type = hasLength ?
+				LOG_ARGUMENT_INVALID : LOG_ARGUMENT_POINTER;
+			break;
+		default:
+			conversion.type = LOG_ARGUMENT_INVALID;
+			break;
+	}
+
+	if (*character)
+	{
+		character++;
+	}
+
+	conversion.length = character - specification;
+
+	if (conversion.length > MAX_LOG_CONVERSION_LENGTH)
+	{
+		conversion.type = LOG_ARGUMENT_INVALID;
+	}
+
+	return conversion;
+}
+
+bool captureLogArguments(const char *format, va_list args, uint8 *data)
+{
+	uint32 size = 0;
+
+	for (const char *specification = strchr(format, '%');
+		 specification;
+		 specification = strchr(specification, '%'))
+	{
+		LogConversion conversion = parseLogConversion(specification);
+		specification += conversion.length;
+
+		bool stored = true;
+
+		if (conversion.argumentWidth)
+		{
+			int32 width = va_arg(args, int);
+			stored = storeLogArgument(data, &size, &width, sizeof(width));
+		}
+
+		if (stored && conversion.argumentPrecision)
+		{
+			int32 precision = va_arg(args, int);
+			stored = storeLogArgument(
+				data,
+				&size,
+				&precision,
+				sizeof(precision));
+		}
+
+		if (!stored)
+		{
+			return false;
+		}
+
+		switch (conversion.type)
+		{
+			case LOG_ARGUMENT_NONE:
+				break;
+			case LOG_ARGUMENT_INT:
+			{
+				int value = va_arg(args, int);
+				stored = storeLogArgument(data, &size, &value, sizeof(value));
+				break;
+			}
+			case LOG_ARGUMENT_LONG:
+			{
+				long value = va_arg(args, long);
+				stored = storeLogArgument(data, &size, &value, sizeof(value));
+				break;
+			}
+			case LOG_ARGUMENT_LONG_LONG:
+			{
+				long long value = va_arg(args, long long);
+				stored = storeLogArgument(data, &size, &value, sizeof(value));
+				break;
+			}
+			case LOG_ARGUMENT_INTMAX:
+			{
+				intmax_t value = va_arg(args, intmax_t);
+				stored = storeLogArgument(data, &size, &value, sizeof(value));
+				break;
+			}
+			case LOG_ARGUMENT_SIZE:
+			{
+				size_t value = va_arg(args, size_t);
+				stored = storeLogArgument(data, &size, &value, sizeof(value));
+				break;
+			}
+			case LOG_ARGUMENT_PTRDIFF:
+			{
+				ptrdiff_t value = va_arg(args, ptrdiff_t);
+				stored = storeLogArgument(data, &size, &value, sizeof(value));
+				break;
+			}
+			case LOG_ARGUMENT_DOUBLE:
+			{
+				double value = va_arg(args, double);
+				stored = storeLogArgument(data, &size, &value, sizeof(value));
+				break;
+			}
+			case LOG_ARGUMENT_LONG_DOUBLE:
+			{
+				long double value = va_arg(args, long double);
+				stored = storeLogArgument(data, &size, &value, sizeof(value));
+				break;
+			}
+			case LOG_ARGUMENT_STRING:
+			{
+				// Strings are copied, since they may not outlive the call
+				const char *value = va_arg(args, const char*);
+				if (!value)
+				{
+					value = "(null)";
+				}
+
+				uint32 length = strlen(value) + 1;
+				stored = storeLogArgument(data, &size, &length, sizeof(length))
+					&& storeLogArgument(data, &size, value, length);
+				break;
+			}
+			case LOG_ARGUMENT_POINTER:
+			{
+				void *value = va_arg(args, void*);
+				stored = storeLogArgument(data, &size, &value, sizeof(value));
+				break;
+			}
+			default:
+				stored = false;
+				break;
+		}
+
+		if (!stored)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool storeLogArgument(
+	uint8 *data,
+	uint32 *size,
+	const void *value,
+	uint32 valueSize)
+{
+	if (valueSize > LOG_MESSAGE_SIZE - *size)
+	{
+		return false;
+	}
+
+	memcpy(data + *size, value, valueSize);
+	*size += valueSize;
+
+	return true;
+}
+
+void writeDeferredLogMessage(
+	FILE *file,
+	const char *format,
+	const uint8 *data)
+{
+	uint32 offset = 0;
+
+	const char *text = format;
+	const char *specification = strchr(text, '%');
+
+	while (specification)
+	{
+		fwrite(text, 1, specification - text, file);
+
+		LogConversion conversion = parseLogConversion(specification);
+
+		// The captured width and precision are written into the conversion
+		// specification in place of their stars
+		char conversionFormat[MAX_LOG_CONVERSION_LENGTH * 2];
+		uint32 conversionFormatLength = 0;
+
+		for (uint32 i = 0; i < conversion.length; i++)
+		{
+			char character = specification[i];
+
+			if (character != '*')
+			{
+				conversionFormat[conversionFormatLength++] = character;
+				continue;
+			}
+
+			int32 value;
+			memcpy(&value, data + offset, sizeof(value));
+			offset += sizeof(value);
+
+			bool precision = i > 0 && specification[i - 1] == '.';
+
+			if (precision && value < 0)
+			{
+				// A negative precision is the same as leaving it out
+				conversionFormatLength--;
+			}
+			else
+			{
+				conversionFormatLength += sprintf(
+					conversionFormat + conversionFormatLength,
+					"%d",
+					value);
+			}
+		}
+
+		conversionFormat[conversionFormatLength] = '\0';
+
+		switch (conversion.type)
+		{
+			case LOG_ARGUMENT_NONE:
+				fputc('%', file);
+				break;
+#define WRITE_LOG_ARGUMENT(type) \
+			{ \
+				type value; \
+				memcpy(&value, data + offset, sizeof(value)); \
+				offset += sizeof(value); \
+				fprintf(file, conversionFormat, value); \
+				break; \
+			}
+			case LOG_ARGUMENT_INT:
+				WRITE_LOG_ARGUMENT(int)
+			case LOG_ARGUMENT_LONG:
+				WRITE_LOG_ARGUMENT(long)
+			case LOG_ARGUMENT_LONG_LONG:
+				WRITE_LOG_ARGUMENT(long long)
+			case LOG_ARGUMENT_INTMAX:
+				WRITE_LOG_ARGUMENT(intmax_t)
+			case LOG_ARGUMENT_SIZE:
+				WRITE_LOG_ARGUMENT(size_t)
+			case LOG_ARGUMENT_PTRDIFF:
+				WRITE_LOG_ARGUMENT(ptrdiff_t)
+			case LOG_ARGUMENT_DOUBLE:
+				WRITE_LOG_ARGUMENT(double)
+			case LOG_ARGUMENT_LONG_DOUBLE:
+				WRITE_LOG_ARGUMENT(long double)
+			case LOG_ARGUMENT_POINTER:
+				WRITE_LOG_ARGUMENT(void*)
+#undef WRITE_LOG_ARGUMENT
+			case LOG_ARGUMENT_STRING:
+			{
+				uint32 length;
+				memcpy(&length, data + offset, sizeof(length));
+				offset += sizeof(length);
+
+				fprintf(file, conversionFormat, (const char*)data + offset);
+				offset += length;
+				break;
+			}
+			default:
+				break;
+		}
+
+		text = specification + conversion.length;
+		specification = strchr(text, '%');
+	}
+
+	fputs(text, file);
+}
@@ -1,171 +1,409 @@
 #include "data/hash_map.h"
 #include "data/data_types.h"
-#include "data/list.h"
 
 #include "core/log.h"
 
-#ifndef _WIN32
-#include <alloca.h>
-#endif
 #include <malloc.h>
 #include <string.h>
 
-typedef struct hash_map_storage_t
+#define HASH_MAP_MIN_CAPACITY 8
+#define HASH_MAP_MAX_INITIAL_CAPACITY 1024
+
+#define CONTROL_EMPTY 0x80
+#define CONTROL_DELETED 0xFE
+
+#define SLOT_NOT_FOUND 0xFFFFFFFF
+
+#define ALIGN_SIZE(size) (((size) + 7) & ~7)
+
+internal void resizeHashMap(HashMap map, uint32 capacity);
+
+internal
+inline
+uint8 *getSlot(HashMap map, uint32 slot)
+{
+	return map->slots + (uint64)slot * map->slotSizeBytes;
+}
+
+internal
+inline
+uint64 *getSlotHash(HashMap map, uint32 slot)
 {
-	uint64 hash;
-	uint8 data[];
-} HashMapStorage;
+	return (uint64*)getSlot(map, slot);
+}
+
+internal
+inline
+uint8 *getSlotKey(HashMap map, uint32 slot)
+{
+	return getSlot(map, slot) + sizeof(uint64);
+}
+
+internal
+inline
+uint8 getControlHash(uint64 keyHash)
+{
+	return (uint8)(keyHash >> 57);
+}
+
+internal
+inline
+bool isSlotFull(HashMap map, uint32 slot)
+{
+	return !(map->control[slot] & CONTROL_EMPTY);
+}
+
+internal
+uint32 getInitialCapacity(uint32 bucketCount)
+{
+	uint32 capacity = HASH_MAP_MIN_CAPACITY;
+	while (capacity < bucketCount && capacity < HASH_MAP_MAX_INITIAL_CAPACITY)
+	{
+		capacity <<= 1;
+	}
+
+	return capacity;
+}
 
 HashMap createHashMap(
 	uint32 keySize,
 	uint32 valueSize,
 	uint32 bucketCount,
 	ComparisonOp comparison)
+{
+	return createHashMapWithHashFunction(
+		keySize,
+		valueSize,
+		bucketCount,
+		comparison,
+		&hashString);
+}
+
+HashMap createHashMapWithHashFunction(
+	uint32 keySize,
+	uint32 valueSize,
+	uint32 bucketCount,
+	ComparisonOp comparison,
+	HashFunction hashFunction)
 {
 	ASSERT(comparison);
+	ASSERT(hashFunction);
 
-	uint32 mapSize =
-		sizeof(struct hash_map_t)
-		+ (sizeof(HashMapBucket) * bucketCount);
-	HashMap map = malloc(mapSize);
+	HashMap map = malloc(sizeof(struct hash_map_t));
 
 	ASSERT(map != 0);
 
+	map->comparison = comparison;
+	map->hashFunction = hashFunction;
 	map->keySizeBytes = keySize;
 	map->valueSizeBytes = valueSize;
-	map->bucketCount = bucketCount;
-	map->comparison = comparison;
+	map->valueOffset = ALIGN_SIZE(keySize);
+	map->slotSizeBytes =
+		sizeof(uint64)
+		+ map->valueOffset
+		+ ALIGN_SIZE(valueSize);
+	map->capacity = 0;
 	map->count = 0;
+	map->numDeleted = 0;
+	map->control = NULL;
+	map->slots = NULL;
 
-	for (uint32 i = 0; i < map->bucketCount; ++i)
-	{
-		map->buckets[i] = createList(
-			sizeof(HashMapStorage)
-			+ map->keySizeBytes
-			+ map->valueSizeBytes);
-	}
+	resizeHashMap(map, getInitialCapacity(bucketCount));
 
 	return map;
 }
 
 void freeHashMap(HashMap *map)
 {
-	hashMapClear(*map);
+	free((*map)->control);
+	free((*map)->slots);
 	free(*map);
 	*map = NULL;
 }
 
-internal
-uint64 hash(unsigned char *str)
+HashMap copyHashMap(HashMap map)
 {
-	unsigned long hash = 5381;
-	int c;
+	HashMap copy = malloc(sizeof(struct hash_map_t));
+
+	ASSERT(copy != 0);
+
+	*copy = *map;
+
+	copy->control = malloc(map->capacity);
+	copy->slots = malloc((uint64)map->capacity * map->slotSizeBytes);
 
-	while ((c = *str++))
+	ASSERT(copy->control != 0);
+	ASSERT(copy->slots != 0);
+
+	memcpy(copy->control, map->control, map->capacity);
+	memcpy(
+		copy->slots,
+		map->slots,
+		(uint64)map->capacity * map->slotSizeBytes);
+
+	return copy;
+}
+
+uint64 hashString(void *key, uint32 keySize)
+{
+	uint8 *str = key;
+	uint64 hash = 5381;
+
+	for (uint32 i = 0; i < keySize && str[i]; i++)
 	{
-		hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
+		hash = ((hash << 5) + hash) + str[i]; /* hash * 33 + c */
 	}
 
 	return hash;
 }
 
-void hashMapPush(HashMap map, void *key, void *value)
+uint64 hashBytes(void *key, uint32 keySize)
 {
-	uint64 keyHash = hash(key);
-	uint32 bucketIndex = keyHash % map->bucketCount;
+	uint8 *bytes = key;
+	uint64 hash = 14695981039346656037ULL;
+
+	for (uint32 i = 0; i < keySize; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
 
-	HashMapStorage *storage = alloca(
-		sizeof(HashMapStorage)
-		+ map->keySizeBytes
-		+ map->valueSizeBytes);
+	return hash;
+}
 
-	ASSERT(storage != 0);
+internal
+uint64 getKeyHash(HashMap map, void *key)
+{
+	uint64 hash = map->hashFunction(key, map->keySizeBytes);
 
-	storage->hash = keyHash;
-	memcpy(storage->data, key, map->keySizeBytes);
-	memcpy(storage->data + map->keySizeBytes, value, map->valueSizeBytes);
+	// Spread the bits so that both the slot index and control hash are usable
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
 
-	listPushFront(&map->buckets[bucketIndex], storage);
-	map->count++;
+	return hash;
 }
 
-void hashMapInsert(HashMap map, void *key, void *value)
+internal
+uint32 findSlot(HashMap map, void *key, uint64 keyHash, uint32 startSlot)
 {
-	hashMapDelete(map, key);
-	hashMapPush(map, key, value);
+	uint32 mask = map->capacity - 1;
+	uint8 controlHash = getControlHash(keyHash);
+
+	for (uint32 slot = startSlot;; slot = (slot + 1) & mask)
+	{
+		uint8 control = map->control[slot];
+
+		if (control == CONTROL_EMPTY)
+		{
+			break;
+		}
+
+		if (control == controlHash
+			&& *getSlotHash(map, slot) == keyHash
+			&& !map->comparison(getSlotKey(map, slot), key))
+		{
+			return slot;
+		}
+	}
+
+	return SLOT_NOT_FOUND;
 }
 
-void *hashMapGetData(HashMap map, void *key)
+internal
+uint32 findFreeSlot(HashMap map, uint64 keyHash)
+{
+	uint32 mask = map->capacity - 1;
+	uint32 slot = keyHash & mask;
+
+	while (isSlotFull(map, slot))
+	{
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+internal
+void resizeHashMap(HashMap map, uint32 capacity)
 {
-	uint64 keyHash = hash(key);
-	uint32 bucketIndex = keyHash % map->bucketCount;
+	uint8 *oldControl = map->control;
+	uint8 *oldSlots = map->slots;
+	uint32 oldCapacity = map->capacity;
+
+	map->capacity = capacity;
+	map->control = malloc(capacity);
+	map->slots = malloc((uint64)capacity * map->slotSizeBytes);
+
+	ASSERT(map->control != 0);
+	ASSERT(map->slots != 0);
+
+	memset(map->control, CONTROL_EMPTY, capacity);
 
-	for (ListIterator itr = listGetIterator(&map->buckets[bucketIndex]);
-		 !listIteratorAtEnd(itr);
-		 listMoveIterator(&itr))
+	// Stored hashes let every entry move without calling the hash function
+	for (uint32 i = 0; i < oldCapacity; i++)
 	{
-		if (!map->comparison(
-				LIST_ITERATOR_GET_ELEMENT(HashMapStorage, itr)->data,
-				key))
+		if (!(oldControl[i] & CONTROL_EMPTY))
 		{
-			return LIST_ITERATOR_GET_ELEMENT(HashMapStorage, itr)->data
-				+ map->keySizeBytes;
+			uint8 *oldSlot = oldSlots + (uint64)i * map->slotSizeBytes;
+			uint64 keyHash = *(uint64*)oldSlot;
+			uint32 slot = findFreeSlot(map, keyHash);
+
+			map->control[slot] = oldControl[i];
+			memcpy(getSlot(map, slot), oldSlot, map->slotSizeBytes);
 		}
 	}
 
+	map->numDeleted = 0;
+
+	free(oldControl);
+	free(oldSlots);
+}
+
+internal
+void reserveSlot(HashMap map)
+{
+	// Keep the load (including tombstones) at or below 7/8
+	if ((map->count + map->numDeleted + 1) * 8 <= map->capacity * 7)
+	{
+		return;
+	}
+
+	// Only grow if live entries need the room, otherwise drop tombstones
+	if ((map->count + 1) * 16 > map->capacity * 7)
+	{
+		resizeHashMap(map, map->capacity << 1);
+	}
+	else
+	{
+		resizeHashMap(map, map->capacity);
+	}
+}
+
+internal
+void insertSlot(HashMap map, uint64 keyHash, void *key, void *value)
+{
+	reserveSlot(map);
+
+	uint32 slot = findFreeSlot(map, keyHash);
+
+	if (map->control[slot] == CONTROL_DELETED)
+	{
+		map->numDeleted--;
+	}
+
+	map->control[slot] = getControlHash(keyHash);
+	*getSlotHash(map, slot) = keyHash;
+	memcpy(getSlotKey(map, slot), key, map->keySizeBytes);
+	memcpy(
+		getSlotKey(map, slot) + map->valueOffset,
+		value,
+		map->valueSizeBytes);
+
+	map->count++;
+}
+
+internal
+void removeSlot(HashMap map, uint32 slot)
+{
+	uint32 mask = map->capacity - 1;
+
+	// A slot followed by an empty slot ends no probe sequence
+	if (map->control[(slot + 1) & mask] == CONTROL_EMPTY)
+	{
+		map->control[slot] = CONTROL_EMPTY;
+	}
+	else
+	{
+		map->control[slot] = CONTROL_DELETED;
+		map->numDeleted++;
+	}
+
+	map->count--;
+}
+
+void hashMapPush(HashMap map, void *key, void *value)
+{
+	insertSlot(map, getKeyHash(map, key), key, value);
+}
+
+void hashMapInsert(HashMap map, void *key, void *value)
+{
+	uint64 keyHash = getKeyHash(map, key);
+	uint32 slot = findSlot(
+		map,
+		key,
+		keyHash,
+		keyHash & (map->capacity - 1));
+
+	if (slot != SLOT_NOT_FOUND)
+	{
+		memcpy(getSlotKey(map, slot), key, map->keySizeBytes);
+		memcpy(
+			getSlotKey(map, slot) + map->valueOffset,
+			value,
+			map->valueSizeBytes);
+	}
+	else
+	{
+		insertSlot(map, keyHash, key, value);
+	}
+}
+
+void *hashMapGetData(HashMap map, void *key)
+{
+	uint64 keyHash = getKeyHash(map, key);
+	uint32 slot = findSlot(
+		map,
+		key,
+		keyHash,
+		keyHash & (map->capacity - 1));
+
+	if (slot != SLOT_NOT_FOUND)
+	{
+		return getSlotKey(map, slot) + map->valueOffset;
+	}
+
 	return NULL;
 }
 
 void hashMapPopKey(HashMap map, void *key)
 {
-	uint64 keyHash = hash(key);
-	uint32 bucketIndex = keyHash % map->bucketCount;
-
-	for (ListIterator itr = listGetIterator(&map->buckets[bucketIndex]);
-		 !listIteratorAtEnd(itr);
-		 listMoveIterator(&itr))
+	uint64 keyHash = getKeyHash(map, key);
+	uint32 slot = findSlot(
+		map,
+		key,
+		keyHash,
+		keyHash & (map->capacity - 1));
+
+	if (slot != SLOT_NOT_FOUND)
 	{
-		if (!map->comparison(
-			LIST_ITERATOR_GET_ELEMENT(HashMapStorage, itr)->data,
-			key))
-		{
-			listRemove(&map->buckets[bucketIndex], &itr);
-			map->count--;
-			break;
-		}
+		removeSlot(map, slot);
 	}
 }
 
 void hashMapDelete(HashMap map, void *key)
 {
-	uint64 keyHash = hash(key);
-	uint32 bucketIndex = keyHash % map->bucketCount;
+	uint64 keyHash = getKeyHash(map, key);
+	uint32 mask = map->capacity - 1;
 
-	for (ListIterator itr = listGetIterator(&map->buckets[bucketIndex]);
-		 !listIteratorAtEnd(itr);)
+	// Keys added with hashMapPush may appear more than once
+	for (uint32 slot = findSlot(map, key, keyHash, keyHash & mask);
+		 slot != SLOT_NOT_FOUND;
+		 slot = findSlot(map, key, keyHash, (slot + 1) & mask))
 	{
-		if (!map->comparison(
-			LIST_ITERATOR_GET_ELEMENT(HashMapStorage, itr)->data,
-			key))
-		{
-			listRemove(&map->buckets[bucketIndex], &itr);
-			map->count--;
-		}
-		else
-		{
-			listMoveIterator(&itr);
-		}
+		removeSlot(map, slot);
 	}
 }
 
 void hashMapClear(HashMap map)
 {
-	for (uint32 i = 0; i < map->bucketCount; ++i)
-	{
-		listClear(&map->buckets[i]);
-	}
+	memset(map->control, CONTROL_EMPTY, map->capacity);
 
 	map->count = 0;
+	map->numDeleted = 0;
 }
 
 HashMapIterator hashMapGetIterator(HashMap map)
@@ -173,20 +411,12 @@ HashMapIterator hashMapGetIterator(HashMap map)
 	HashMapIterator ret = {};
 
 	ret.map = map;
-	ret.bucket = 0;
-	ret.itr = listGetIterator(&map->buckets[ret.bucket]);
-	while (listIteratorAtEnd(ret.itr))
+	ret.slot = 0;
+
+	// Find the first occupied slot
+	while (ret.slot < map->capacity && !isSlotFull(map, ret.slot))
 	{
-		// move the iterator if the iterator is at a valid bucket index
-		if (++ret.bucket < ret.map->bucketCount)
-		{
-			ret.itr = listGetIterator(&ret.map->buckets[ret.bucket]);
-		}
-		// break the loop if the iterator is past the end of the hashmap
-		else
-		{
-			break;
-		}
+		ret.slot++;
 	}
 
 	return ret;
@@ -195,67 +425,44 @@ HashMapIterator hashMapGetIterator(HashMap map)
 void hashMapMoveIterator(HashMapIterator *itr)
 {
 	// Return if the iterator is already at the end
-	if (itr->bucket >= itr->map->bucketCount)
+	if (itr->slot >= itr->map->capacity)
 	{
 		return;
 	}
 
-	// If the iterator can move in the current bucket
-	if (!listIteratorAtEnd(itr->itr))
+	do
 	{
-		// Move the iterator
-		listMoveIterator(&itr->itr);
-	}
-
-	/*
-	 * If the iterator has to go to the next bucket,
-	 * find the next non-empty bucket
-	 */
-	while (listIteratorAtEnd(itr->itr))
-	{
-		// move the iterator if the iterator is at a valid bucket index
-		if (++itr->bucket < itr->map->bucketCount)
-		{
-			itr->itr = listGetIterator(&itr->map->buckets[itr->bucket]);
-		}
-		// break the loop if the iterator is past the end of the hashmap
-		else
-		{
-			break;
-		}
-	}
+		itr->slot++;
+	} while (itr->slot < itr->map->capacity
+			 && !isSlotFull(itr->map, itr->slot));
 }
 
 inline
 int32 hashMapIteratorAtEnd(HashMapIterator itr)
 {
-	return itr.bucket >= itr.map->bucketCount;
+	return itr.slot >= itr.map->capacity;
 }
 
 inline
 void *hashMapIteratorGetKey(HashMapIterator itr)
 {
-	return LIST_ITERATOR_GET_ELEMENT(HashMapStorage, itr.itr)->data;
+	return getSlotKey(itr.map, itr.slot);
 }
 
 inline
 void *hashMapIteratorGetValue(HashMapIterator itr)
 {
-	return LIST_ITERATOR_GET_ELEMENT(HashMapStorage, itr.itr)->data
-		+ itr.map->keySizeBytes;
+	return getSlotKey(itr.map, itr.slot) + itr.map->valueOffset;
 }
 
 void hashMapFMap(HashMap map, HashMapFunctorFn fn, ClosureData *data)
 {
-	for (uint32 bucket = 0; bucket < map->bucketCount; ++bucket)
+	for (uint32 slot = 0; slot < map->capacity; slot++)
 	{
-		for (ListIterator itr = listGetIterator(&map->buckets[bucket]);
-			 !listIteratorAtEnd(itr);
-			 listMoveIterator(&itr))
+		if (isSlotFull(map, slot))
 		{
-			HashMapStorage *element =
-				LIST_ITERATOR_GET_ELEMENT(HashMapStorage, itr);
-			fn(element->data, element->data + map->keySizeBytes, data);
+			uint8 *key = getSlotKey(map, slot);
+			fn(key, key + map->valueOffset, data);
 		}
 	}
 }
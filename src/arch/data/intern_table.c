@@ -0,0 +1,445 @@
+#include "data/intern_table.h"
+#include "data/data_types.h"
+#include "data/hash_map.h"
+
+#include "core/log.h"
+
+#include <malloc.h>
+#include <string.h>
+
+#define INTERN_TABLE_MIN_CAPACITY 8
+#define INTERN_TABLE_MAX_INITIAL_CAPACITY 1024
+
+// The last index is never used so that INVALID_HANDLE is never valid
+#define INTERN_TABLE_MAX_CAPACITY HANDLE_INDEX_MASK
+
+// Marks the end of the free list, since the last index is never used
+#define INTERN_TABLE_FREE_LIST_END HANDLE_INDEX_MASK
+
+internal
+inline
+Handle makeHandle(uint32 index, uint32 generation)
+{
+	return ((Handle)generation << HANDLE_INDEX_BITS) | index;
+}
+
+internal
+inline
+InternTableSlot *getValidSlot(InternTable table, Handle handle)
+{
+	uint32 index = HANDLE_GET_INDEX(handle);
+
+	if (index >= table->numSlots)
+	{
+		return NULL;
+	}
+
+	InternTableSlot *slot = &table->slots[index];
+
+	if (!slot->used || slot->generation != HANDLE_GET_GENERATION(handle))
+	{
+		return NULL;
+	}
+
+	return slot;
+}
+
+internal
+void resizeInternTable(InternTable table, uint32 capacity)
+{
+	table->slots = realloc(table->slots, capacity * sizeof(InternTableSlot));
+
+	ASSERT(table->slots != 0);
+
+	if (table->valueSizeBytes > 0)
+	{
+		table->values = realloc(
+			table->values,
+			(uint64)capacity * table->valueSizeBytes);
+
+		ASSERT(table->values != 0);
+	}
+
+	table->capacity = capacity;
+}
+
+InternTable createInternTable(uint32 valueSize, uint32 capacity)
+{
+	InternTable table = calloc(1, sizeof(struct intern_table_t));
+
+	ASSERT(table != 0);
+
+	capacity = MIN(
+		MAX(capacity, INTERN_TABLE_MIN_CAPACITY),
+		INTERN_TABLE_MAX_INITIAL_CAPACITY);
+
+	table->idToHandle = createHashMap(
+		sizeof(UUID),
+		sizeof(Handle),
+		capacity,
+		(ComparisonOp)&strcmp);
+	table->valueSizeBytes = valueSize;
+	table->firstFree = INTERN_TABLE_FREE_LIST_END;
+
+	resizeInternTable(table, capacity);
+
+	return table;
+}
+
+void freeInternTable(InternTable *table)
+{
+	freeHashMap(&(*table)->idToHandle);
+	free((*table)->slots);
+	free((*table)->values);
+	free(*table);
+	*table = NULL;
+}
+
+internal
+Handle allocateHandle(InternTable table)
+{
+	uint32 index = table->firstFree;
+
+	// The free list is empty, so use a new slot at the end of the table
+	if (index == INTERN_TABLE_FREE_LIST_END)
+	{
+		// The slots right after the used ones belong to the reserved handles
+		internTableCommitReserved(table);
+
+		if (table->numSlots >= INTERN_TABLE_MAX_CAPACITY)
+		{
+			LOG_ERROR("Unable to allocate a handle, "
+				"all %d handles are in use\n",
+				INTERN_TABLE_MAX_CAPACITY);
+			return INVALID_HANDLE;
+		}
+
+		if (table->numSlots >= table->capacity)
+		{
+			resizeInternTable(
+				table,
+				MIN((uint64)table->capacity << 1, INTERN_TABLE_MAX_CAPACITY));
+		}
+
+		index = table->numSlots++;
+		table->slots[index].generation = 0;
+	}
+	else
+	{
+		table->firstFree = table->slots[index].nextFree;
+	}
+
+	InternTableSlot *slot = &table->slots[index];
+
+	strcpy(slot->id.string, "");
+	slot->used = true;
+
+	if (table->valueSizeBytes > 0)
+	{
+		memset(
+			table->values + (uint64)index * table->valueSizeBytes,
+			0,
+			table->valueSizeBytes);
+	}
+
+	table->count++;
+
+	return makeHandle(index, slot->generation);
+}
+
+Handle internTableInsert(InternTable table, UUID id)
+{
+	Handle *existingHandle = hashMapGetData(table->idToHandle, &id);
+
+	if (existingHandle)
+	{
+		return *existingHandle;
+	}
+
+	Handle handle = allocateHandle(table);
+
+	if (handle != INVALID_HANDLE)
+	{
+		table->slots[HANDLE_GET_INDEX(handle)].id = id;
+		hashMapInsert(table->idToHandle, &id, &handle);
+	}
+
+	return handle;
+}
+
+inline
+Handle internTableInsertAnonymous(InternTable table)
+{
+	return allocateHandle(table);
+}
+
+Handle internTableReserve(InternTable table)
+{
+	uint64 index = (uint64)table->numSlots + __atomic_fetch_add(
+		&table->numReserved,
+		1,
+		__ATOMIC_RELAXED);
+
+	if (index >= INTERN_TABLE_MAX_CAPACITY)
+	{
+		LOG_ERROR("Unable to reserve a handle, "
+			"all %d handles are in use\n",
+			INTERN_TABLE_MAX_CAPACITY);
+		return INVALID_HANDLE;
+	}
+
+	// Slots past numSlots have never been used, so their generation is 0
+	return makeHandle(index, 0);
+}
+
+void internTableCommitReserved(InternTable table)
+{
+	if (table->numReserved == 0)
+	{
+		return;
+	}
+
+	uint32 numSlots = MIN(
+		(uint64)table->numSlots + table->numReserved,
+		INTERN_TABLE_MAX_CAPACITY);
+
+	if (numSlots > table->capacity)
+	{
+		uint64 capacity = table->capacity;
+		while (capacity < numSlots)
+		{
+			capacity <<= 1;
+		}
+
+		resizeInternTable(table, MIN(capacity, INTERN_TABLE_MAX_CAPACITY));
+	}
+
+	for (uint32 i = table->numSlots; i < numSlots; i++)
+	{
+		InternTableSlot *slot = &table->slots[i];
+
+		strcpy(slot->id.string, "");
+		slot->generation = 0;
+		slot->used = true;
+	}
+
+	if (table->valueSizeBytes > 0)
+	{
+		memset(
+			table->values + (uint64)table->numSlots * table->valueSizeBytes,
+			0,
+			(uint64)(numSlots - table->numSlots) * table->valueSizeBytes);
+	}
+
+	table->count += numSlots - table->numSlots;
+	table->numSlots = numSlots;
+	table->numReserved = 0;
+}
+
+int32 internTableSetID(InternTable table, Handle handle, UUID id)
+{
+	InternTableSlot *slot = getValidSlot(table, handle);
+
+	if (!slot)
+	{
+		return -1;
+	}
+
+	Handle *existingHandle = hashMapGetData(table->idToHandle, &id);
+
+	if (existingHandle)
+	{
+		if (*existingHandle != handle)
+		{
+			LOG_ERROR("Unable to intern %s twice\n", id.string);
+			return -1;
+		}
+
+		return 0;
+	}
+
+	if (strcmp(slot->id.string, ""))
+	{
+		hashMapDelete(table->idToHandle, &slot->id);
+	}
+
+	slot->id = id;
+	hashMapInsert(table->idToHandle, &id, &handle);
+
+	return 0;
+}
+
+void internTableRemove(InternTable table, Handle handle)
+{
+	InternTableSlot *slot = getValidSlot(table, handle);
+
+	if (!slot)
+	{
+		return;
+	}
+
+	if (strcmp(slot->id.string, ""))
+	{
+		hashMapDelete(table->idToHandle, &slot->id);
+	}
+
+	slot->used = false;
+	slot->generation++;
+
+	// Reusing the slot again would wrap its generation around
+	if (slot->generation != MAX_HANDLE_GENERATION)
+	{
+		slot->nextFree = table->firstFree;
+		table->firstFree = HANDLE_GET_INDEX(handle);
+	}
+
+	table->count--;
+}
+
+void internTableClear(InternTable table)
+{
+	// Reserved handles are cleared along with everything else
+	internTableCommitReserved(table);
+
+	// The free list is rebuilt from the last slot down, so that it starts at
+	// the first slot and leaves out the retired slots
+	table->firstFree = INTERN_TABLE_FREE_LIST_END;
+
+	for (uint32 i = table->numSlots; i-- > 0;)
+	{
+		InternTableSlot *slot = &table->slots[i];
+
+		if (slot->used)
+		{
+			slot->used = false;
+			slot->generation++;
+		}
+
+		if (slot->generation != MAX_HANDLE_GENERATION)
+		{
+			slot->nextFree = table->firstFree;
+			table->firstFree = i;
+		}
+	}
+
+	hashMapClear(table->idToHandle);
+
+	table->count = 0;
+}
+
+Handle internTableGetHandle(InternTable table, UUID id)
+{
+	Handle *handle = hashMapGetData(table->idToHandle, &id);
+
+	if (handle)
+	{
+		return *handle;
+	}
+
+	return INVALID_HANDLE;
+}
+
+inline
+bool internTableIsValid(InternTable table, Handle handle)
+{
+	return getValidSlot(table, handle) != NULL;
+}
+
+UUID *internTableGetID(InternTable table, Handle handle)
+{
+	InternTableSlot *slot = getValidSlot(table, handle);
+
+	if (slot)
+	{
+		return &slot->id;
+	}
+
+	return NULL;
+}
+
+Handle internTableGetIndexHandle(InternTable table, uint32 index)
+{
+	if (index >= table->numSlots || !table->slots[index].used)
+	{
+		return INVALID_HANDLE;
+	}
+
+	return makeHandle(index, table->slots[index].generation);
+}
+
+void *internTableGetData(InternTable table, Handle handle)
+{
+	if (table->valueSizeBytes == 0 || !getValidSlot(table, handle))
+	{
+		return NULL;
+	}
+
+	return table->values
+		+ (uint64)HANDLE_GET_INDEX(handle) * table->valueSizeBytes;
+}
+
+InternTableIterator internTableGetIterator(InternTable table)
+{
+	InternTableIterator itr = {};
+
+	itr.table = table;
+	itr.index = 0;
+
+	// Find the first used slot
+	while (itr.index < table->numSlots && !table->slots[itr.index].used)
+	{
+		itr.index++;
+	}
+
+	return itr;
+}
+
+void internTableMoveIterator(InternTableIterator *itr)
+{
+	// Return if the iterator is already at the end
+	if (itr->index >= itr->table->numSlots)
+	{
+		return;
+	}
+
+	do
+	{
+		itr->index++;
+	} while (itr->index < itr->table->numSlots
+			 && !itr->table->slots[itr->index].used);
+}
+
+inline
+int32 internTableIteratorAtEnd(InternTableIterator itr)
+{
+	return itr.index >= itr.table->numSlots;
+}
+
+inline
+Handle internTableIteratorGetHandle(InternTableIterator itr)
+{
+	return makeHandle(itr.index, itr.table->slots[itr.index].generation);
+}
+
+inline
+UUID *internTableIteratorGetID(InternTableIterator itr)
+{
+	return &itr.table->slots[itr.index].id;
+}
+
+inline
+void *internTableIteratorGetData(InternTableIterator itr)
+{
+	if (itr.table->valueSizeBytes == 0)
+	{
+		return NULL;
+	}
+
+	return itr.table->values
+		+ (uint64)itr.index * itr.table->valueSizeBytes;
+}
+
+int32 compareHandles(void *a, void *b)
+{
+	return *(Handle*)a != *(Handle*)b;
+}
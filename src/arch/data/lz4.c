@@ -0,0 +1,254 @@
+#include "data/lz4.h"
+
+#include <string.h>
+
+#define MIN_MATCH_LENGTH 4
+#define MAX_MATCH_OFFSET 65535
+
+// The format requires the last 5 bytes to be literals, and the last match to
+// start at least 12 bytes before the end of the block
+#define LAST_LITERALS 5
+#define MATCH_FIND_LIMIT 12
+
+#define HASH_TABLE_BITS 12
+#define HASH_TABLE_SIZE (1 << HASH_TABLE_BITS)
+
+internal uint32 read32(const uint8 *data);
+internal uint32 hashSequence(uint32 sequence);
+
+internal uint8* writeLength(uint8 *destination, uint64 length);
+internal uint8* writeSequence(
+	uint8 *destination,
+	const uint8 *literals,
+	uint64 numLiterals,
+	uint32 offset,
+	uint64 matchLength);
+
+uint64 lz4Compress(
+	const uint8 *source,
+	uint64 sourceSize,
+	uint8 *destination,
+	uint64 destinationSize)
+{
+	if (destinationSize < LZ4_COMPRESS_BOUND(sourceSize))
+	{
+		return 0;
+	}
+
+	// Positions are stored off by one so that 0 means the slot is empty
+	uint32 hashTable[HASH_TABLE_SIZE];
+	memset(hashTable, 0, sizeof(hashTable));
+
+	uint8 *output = destination;
+
+	uint64 anchor = 0;
+	uint64 position = 0;
+
+	if (sourceSize > MATCH_FIND_LIMIT)
+	{
+		uint64 matchFindLimit = sourceSize - MATCH_FIND_LIMIT;
+		uint64 matchLengthLimit = sourceSize - LAST_LITERALS;
+
+		while (position < matchFindLimit)
+		{
+			uint32 sequence = read32(source + position);
+			uint32 hash = hashSequence(sequence);
+
+			uint64 reference = hashTable[hash];
+			hashTable[hash] = position + 1;
+
+			if (reference == 0 ||
+				position - (reference - 1) > MAX_MATCH_OFFSET ||
+				read32(source + reference - 1) != sequence)
+			{
+				position++;
+				continue;
+			}
+
+			reference--;
+
+			uint64 matchLength = MIN_MATCH_LENGTH;
+			while (position + matchLength < matchLengthLimit &&
+				source[reference + matchLength] ==
+				source[position + matchLength])
+			{
+				matchLength++;
+			}
+
+			output = writeSequence(
+				output,
+				source + anchor,
+				position - anchor,
+				position - reference,
+				matchLength);
+
+			position += matchLength;
+			anchor = position;
+		}
+	}
+
+	return writeSequence(
+		output,
+		source + anchor,
+		sourceSize - anchor,
+		0,
+		0) - destination;
+}
+
+int32 lz4Decompress(
+	const uint8 *source,
+	uint64 sourceSize,
+	uint8 *destination,
+	uint64 destinationSize)
+{
+	const uint8 *input = source;
+	const uint8 *inputEnd = source + sourceSize;
+
+	uint64 position = 0;
+
+	while (input < inputEnd)
+	{
+		uint8 token = *input++;
+
+		uint64 numLiterals = token >> 4;
+		if (numLiterals == 15)
+		{
+			uint8 byte;
+			do
+			{
+				if (input == inputEnd)
+				{
+					return -1;
+				}
+
+				byte = *input++;
+				numLiterals += byte;
+			} while (byte == 255);
+		}
+
+		if (numLiterals > (uint64)(inputEnd - input) ||
+			numLiterals > destinationSize - position)
+		{
+			return -1;
+		}
+
+		memcpy(destination + position, input, numLiterals);
+		input += numLiterals;
+		position += numLiterals;
+
+		// The last sequence has no match
+		if (input == inputEnd)
+		{
+			break;
+		}
+
+		if (inputEnd - input < 2)
+		{
+			return -1;
+		}
+
+		uint64 offset = input[0] | (input[1] << 8);
+		input += 2;
+
+		if (offset == 0 || offset > position)
+		{
+			return -1;
+		}
+
+		uint64 matchLength = token & 0xf;
+		if (matchLength == 15)
+		{
+			uint8 byte;
+			do
+			{
+				if (input == inputEnd)
+				{
+					return -1;
+				}
+
+				byte = *input++;
+				matchLength += byte;
+			} while (byte == 255);
+		}
+
+		matchLength += MIN_MATCH_LENGTH;
+
+		if (matchLength > destinationSize - position)
+		{
+			return -1;
+		}
+
+		// Matches may overlap the bytes they produce, so copy bytewise
+		for (uint64 i = 0; i < matchLength; i++)
+		{
+			destination[position + i] = destination[position - offset + i];
+		}
+
+		position += matchLength;
+	}
+
+	return position == destinationSize ? 0 : -1;
+}
+
+uint32 read32(const uint8 *data)
+{
+	uint32 value;
+	memcpy(&value, data, sizeof(uint32));
+	return value;
+}
+
+uint32 hashSequence(uint32 sequence)
+{
+	return (sequence * 2654435761U) >> (32 - HASH_TABLE_BITS);
+}
+
+uint8* writeLength(uint8 *destination, uint64 length)
+{
+	while (length >= 255)
+	{
+		*destination++ = 255;
+		length -= 255;
+	}
+
+	*destination++ = length;
+
+	return destination;
+}
+
+uint8* writeSequence(
+	uint8 *destination,
+	const uint8 *literals,
+	uint64 numLiterals,
+	uint32 offset,
+	uint64 matchLength)
+{
+	uint8 *token = destination++;
+	*token = MIN(numLiterals, 15) << 4;
+
+	if (numLiterals >= 15)
+	{
+		destination = writeLength(destination, numLiterals - 15);
+	}
+
+	memcpy(destination, literals, numLiterals);
+	destination += numLiterals;
+
+	// A zero offset marks the final, literal only sequence
+	if (offset == 0)
+	{
+		return destination;
+	}
+
+	*destination++ = offset & 0xff;
+	*destination++ = offset >> 8;
+
+	matchLength -= MIN_MATCH_LENGTH;
+	*token |= MIN(matchLength, 15);
+
+	if (matchLength >= 15)
+	{
+		destination = writeLength(destination, matchLength - 15);
+	}
+
+	return destination;
+}
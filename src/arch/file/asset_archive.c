@@ -0,0 +1,555 @@
+#include "file/asset_archive.h"
+#include "file/file_types.h"
+#include "file/mapped_file.h"
+#include "file/utilities.h"
+
+#include "core/log.h"
+
+#include "data/data_types.h"
+#include "data/hash_map.h"
+#include "data/list.h"
+#include "data/lz4.h"
+
+#include <malloc.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <dirent.h>
+
+// Compression has to save at least 1 / MIN_COMPRESSION_SAVING of the file
+#define MIN_COMPRESSION_SAVING 8
+
+typedef struct packed_asset_t
+{
+	char *path;
+	bool folder;
+} PackedAsset;
+
+// Meshes are mapped in place, so they can't be compressed
+internal const char *uncompressedExtensions[] = {
+	"mesh"
+};
+
+internal uint32 numUncompressedExtensions =
+	sizeof(uncompressedExtensions) / sizeof(char*);
+
+internal int32 collectPackedAssets(
+	const char *folder,
+	const char *archiveFilename,
+	List *assets);
+internal void freePackedAssets(List *assets);
+
+internal uint8* readPackedAsset(const char *path, uint64 *size);
+internal bool canCompressPackedAsset(const char *path);
+
+internal int32 writePadding(FILE *file, uint64 *offset, uint64 alignment);
+internal uint64 hashAssetPath(const char *path);
+
+int32 packAssetArchive(
+	const char *folder,
+	const char *filename,
+	bool compress)
+{
+	LOG("Packing %s into %s...\n", folder, filename);
+
+	List assets = createList(sizeof(PackedAsset));
+	if (collectPackedAssets(folder, filename, &assets) == -1)
+	{
+		freePackedAssets(&assets);
+		return -1;
+	}
+
+	FILE *file = fopen(filename, "wb");
+	if (!file)
+	{
+		LOG("Failed to open %s\n", filename);
+		freePackedAssets(&assets);
+		return -1;
+	}
+
+	AssetArchiveHeader header = {};
+	memcpy(header.magic, ASSET_ARCHIVE_MAGIC, sizeof(header.magic));
+	header.version = ASSET_ARCHIVE_VERSION;
+	header.numEntries = listGetSize(&assets);
+
+	// Keep the table at most half full so probe sequences stay short
+	header.numSlots = 1;
+	while (header.numSlots < header.numEntries * 2)
+	{
+		header.numSlots *= 2;
+	}
+
+	AssetArchiveEntry *entries = calloc(
+		header.numSlots,
+		sizeof(AssetArchiveEntry));
+
+	uint64 pathsSize = 0;
+	for (ListIterator itr = listGetIterator(&assets);
+		 !listIteratorAtEnd(itr);
+		 listMoveIterator(&itr))
+	{
+		pathsSize +=
+			strlen(LIST_ITERATOR_GET_ELEMENT(PackedAsset, itr)->path) + 1;
+	}
+
+	char *paths = malloc(pathsSize);
+	uint32 pathOffset = 0;
+
+	// The header is written last, once all of the offsets are known
+	fwrite(&header, sizeof(AssetArchiveHeader), 1, file);
+	uint64 offset = sizeof(AssetArchiveHeader);
+
+	int32 error = 0;
+
+	for (ListIterator itr = listGetIterator(&assets);
+		 !listIteratorAtEnd(itr);
+		 listMoveIterator(&itr))
+	{
+		PackedAsset *asset = LIST_ITERATOR_GET_ELEMENT(PackedAsset, itr);
+
+		uint64 hash = hashAssetPath(asset->path);
+		uint32 slot = hash & (header.numSlots - 1);
+		while (entries[slot].flags & ASSET_ARCHIVE_ENTRY_USED)
+		{
+			slot = (slot + 1) & (header.numSlots - 1);
+		}
+
+		AssetArchiveEntry *entry = &entries[slot];
+		entry->hash = hash;
+		entry->pathOffset = pathOffset;
+		entry->flags = ASSET_ARCHIVE_ENTRY_USED;
+
+		strcpy(paths + pathOffset, asset->path);
+		pathOffset += strlen(asset->path) + 1;
+
+		if (asset->folder)
+		{
+			entry->flags |= ASSET_ARCHIVE_ENTRY_FOLDER;
+			continue;
+		}
+
+		uint64 size;
+		uint8 *data = readPackedAsset(asset->path, &size);
+		if (!data)
+		{
+			error = -1;
+			break;
+		}
+
+		uint8 *compressedData = NULL;
+		uint64 compressedSize = 0;
+
+		if (compress && canCompressPackedAsset(asset->path))
+		{
+			compressedData = malloc(LZ4_COMPRESS_BOUND(size));
+			compressedSize = lz4Compress(
+				data,
+				size,
+				compressedData,
+				LZ4_COMPRESS_BOUND(size));
+
+			if (compressedSize == 0 ||
+				compressedSize > size - size / MIN_COMPRESSION_SAVING)
+			{
+				free(compressedData);
+				compressedData = NULL;
+			}
+		}
+
+		if (writePadding(file, &offset, ASSET_ARCHIVE_ALIGNMENT) == -1)
+		{
+			free(compressedData);
+			free(data);
+			error = -1;
+			break;
+		}
+
+		entry->offset = offset;
+		entry->originalSize = size;
+
+		if (compressedData)
+		{
+			entry->size = compressedSize;
+			entry->compression = ASSET_ARCHIVE_COMPRESSION_LZ4;
+		}
+		else
+		{
+			entry->size = size;
+			entry->compression = ASSET_ARCHIVE_COMPRESSION_NONE;
+		}
+
+		if (fwrite(
+			compressedData ? compressedData : data,
+			1,
+			entry->size,
+			file) != entry->size)
+		{
+			LOG("Failed to write %s to %s\n", asset->path, filename);
+			free(compressedData);
+			free(data);
+			error = -1;
+			break;
+		}
+
+		offset += entry->size;
+
+		free(compressedData);
+		free(data);
+	}
+
+	if (error != -1)
+	{
+		error = writePadding(file, &offset, sizeof(uint64));
+	}
+
+	if (error != -1)
+	{
+		header.entriesOffset = offset;
+		header.pathsOffset =
+			offset + header.numSlots * sizeof(AssetArchiveEntry);
+
+		if (fwrite(
+				entries,
+				sizeof(AssetArchiveEntry),
+				header.numSlots,
+				file) != header.numSlots ||
+			fwrite(paths, 1, pathsSize, file) != pathsSize)
+		{
+			LOG("Failed to write the table of contents to %s\n", filename);
+			error = -1;
+		}
+	}
+
+	if (error != -1)
+	{
+		fseek(file, 0, SEEK_SET);
+		if (fwrite(&header, sizeof(AssetArchiveHeader), 1, file) != 1)
+		{
+			LOG("Failed to write the header of %s\n", filename);
+			error = -1;
+		}
+	}
+
+	fclose(file);
+
+	free(paths);
+	free(entries);
+	freePackedAssets(&assets);
+
+	if (error == -1)
+	{
+		remove(filename);
+		return -1;
+	}
+
+	LOG("Successfully packed %s into %s\n", folder, filename);
+
+	return 0;
+}
+
+int32 openAssetArchive(const char *filename, AssetArchive *archive)
+{
+	memset(archive, 0, sizeof(AssetArchive));
+
+	MappedFile file;
+	if (mapFile(filename, &file) == -1)
+	{
+		return -1;
+	}
+
+	const AssetArchiveHeader *header = (AssetArchiveHeader*)file.data;
+
+	if (file.size < sizeof(AssetArchiveHeader) ||
+		memcmp(header->magic, ASSET_ARCHIVE_MAGIC, sizeof(header->magic)))
+	{
+		LOG("%s is not an asset archive\n", filename);
+		unmapFile(&file);
+		return -1;
+	}
+
+	if (header->version != ASSET_ARCHIVE_VERSION)
+	{
+		LOG("Unsupported asset archive version in %s\n", filename);
+		unmapFile(&file);
+		return -1;
+	}
+
+	uint64 entriesSize = (uint64)header->numSlots * sizeof(AssetArchiveEntry);
+
+	if (header->numSlots == 0 ||
+		(header->numSlots & (header->numSlots - 1)) ||
+		header->numEntries > header->numSlots ||
+		header->entriesOffset % sizeof(uint64) ||
+		header->entriesOffset > file.size ||
+		entriesSize > file.size - header->entriesOffset ||
+		header->pathsOffset < header->entriesOffset + entriesSize ||
+		header->pathsOffset > file.size ||
+		(header->pathsOffset < file.size &&
+		file.data[file.size - 1] != '\0'))
+	{
+		LOG("Corrupt table of contents in %s\n", filename);
+		unmapFile(&file);
+		return -1;
+	}
+
+	const AssetArchiveEntry *entries =
+		(AssetArchiveEntry*)(file.data + header->entriesOffset);
+	uint64 pathsSize = file.size - header->pathsOffset;
+
+	for (uint32 i = 0; i < header->numSlots; i++)
+	{
+		const AssetArchiveEntry *entry = &entries[i];
+		if (!(entry->flags & ASSET_ARCHIVE_ENTRY_USED))
+		{
+			continue;
+		}
+
+		if (entry->pathOffset >= pathsSize ||
+			entry->offset > header->entriesOffset ||
+			entry->size > header->entriesOffset - entry->offset ||
+			entry->compression > ASSET_ARCHIVE_COMPRESSION_LZ4 ||
+			(entry->compression == ASSET_ARCHIVE_COMPRESSION_NONE &&
+			entry->size != entry->originalSize))
+		{
+			LOG("Corrupt entry in %s\n", filename);
+			unmapFile(&file);
+			return -1;
+		}
+	}
+
+	archive->file = file;
+	archive->header = header;
+	archive->entries = entries;
+	archive->paths = (char*)(file.data + header->pathsOffset);
+
+	LOG("Opened asset archive %s (%d entries)\n",
+		filename,
+		header->numEntries);
+
+	return 0;
+}
+
+void closeAssetArchive(AssetArchive *archive)
+{
+	unmapFile(&archive->file);
+	memset(archive, 0, sizeof(AssetArchive));
+}
+
+const AssetArchiveEntry* getAssetArchiveEntry(
+	const AssetArchive *archive,
+	const char *path)
+{
+	if (!archive->header)
+	{
+		return NULL;
+	}
+
+	uint64 hash = hashAssetPath(path);
+	uint32 mask = archive->header->numSlots - 1;
+
+	for (uint32 i = 0, slot = hash & mask;
+		 i < archive->header->numSlots;
+		 i++, slot = (slot + 1) & mask)
+	{
+		const AssetArchiveEntry *entry = &archive->entries[slot];
+		if (!(entry->flags & ASSET_ARCHIVE_ENTRY_USED))
+		{
+			break;
+		}
+
+		if (entry->hash == hash &&
+			!strcmp(archive->paths + entry->pathOffset, path))
+		{
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+const uint8* getAssetArchiveEntryData(
+	const AssetArchive *archive,
+	const AssetArchiveEntry *entry)
+{
+	if (entry->compression != ASSET_ARCHIVE_COMPRESSION_NONE)
+	{
+		return NULL;
+	}
+
+	return archive->file.data + entry->offset;
+}
+
+uint8* readAssetArchiveEntry(
+	const AssetArchive *archive,
+	const AssetArchiveEntry *entry)
+{
+	const uint8 *data = archive->file.data + entry->offset;
+
+	// Always allocate at least a byte so empty files aren't mistaken for errors
+	uint8 *contents = malloc(MAX(entry->originalSize, 1));
+
+	switch (entry->compression)
+	{
+		case ASSET_ARCHIVE_COMPRESSION_NONE:
+			memcpy(contents, data, entry->size);
+			break;
+		case ASSET_ARCHIVE_COMPRESSION_LZ4:
+			if (lz4Decompress(
+				data,
+				entry->size,
+				contents,
+				entry->originalSize) == -1)
+			{
+				LOG("Failed to decompress %s\n",
+					archive->paths + entry->pathOffset);
+				free(contents);
+				return NULL;
+			}
+
+			break;
+		default:
+			break;
+	}
+
+	return contents;
+}
+
+int32 collectPackedAssets(
+	const char *folder,
+	const char *archiveFilename,
+	List *assets)
+{
+	DIR *dir = opendir(folder);
+	if (!dir)
+	{
+		LOG("Failed to open %s\n", folder);
+		return -1;
+	}
+
+	struct dirent *dirEntry = readdir(dir);
+	while (dirEntry)
+	{
+		if (strcmp(dirEntry->d_name, ".") && strcmp(dirEntry->d_name, ".."))
+		{
+			PackedAsset asset;
+			asset.path = getFullFilePath(dirEntry->d_name, NULL, folder);
+
+			struct stat info;
+			if (stat(asset.path, &info) == -1 ||
+				!strcmp(asset.path, archiveFilename))
+			{
+				free(asset.path);
+			}
+			else if (S_ISDIR(info.st_mode))
+			{
+				asset.folder = true;
+				listPushBack(assets, &asset);
+
+				if (collectPackedAssets(
+					asset.path,
+					archiveFilename,
+					assets) == -1)
+				{
+					closedir(dir);
+					return -1;
+				}
+			}
+			else if (S_ISREG(info.st_mode))
+			{
+				asset.folder = false;
+				listPushBack(assets, &asset);
+			}
+			else
+			{
+				free(asset.path);
+			}
+		}
+
+		dirEntry = readdir(dir);
+	}
+
+	closedir(dir);
+
+	return 0;
+}
+
+void freePackedAssets(List *assets)
+{
+	for (ListIterator itr = listGetIterator(assets);
+		 !listIteratorAtEnd(itr);
+		 listMoveIterator(&itr))
+	{
+		free(LIST_ITERATOR_GET_ELEMENT(PackedAsset, itr)->path);
+	}
+
+	listClear(assets);
+}
+
+uint8* readPackedAsset(const char *path, uint64 *size)
+{
+	FILE *file = fopen(path, "rb");
+	if (!file)
+	{
+		LOG("Failed to open %s\n", path);
+		return NULL;
+	}
+
+	fseek(file, 0, SEEK_END);
+	*size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	uint8 *data = malloc(MAX(*size, 1));
+	if (fread(data, 1, *size, file) != *size)
+	{
+		LOG("Failed to read %s\n", path);
+		free(data);
+		data = NULL;
+	}
+
+	fclose(file);
+
+	return data;
+}
+
+bool canCompressPackedAsset(const char *path)
+{
+	char *extension = getExtension(path);
+	if (!extension)
+	{
+		return true;
+	}
+
+	bool compress = true;
+	for (uint32 i = 0; i < numUncompressedExtensions; i++)
+	{
+		if (!strcmp(extension, uncompressedExtensions[i]))
+		{
+			compress = false;
+			break;
+		}
+	}
+
+	free(extension);
+
+	return compress;
+}
+
+int32 writePadding(FILE *file, uint64 *offset, uint64 alignment)
+{
+	internal const uint8 padding[ASSET_ARCHIVE_ALIGNMENT] = {};
+
+	uint64 paddingSize = (alignment - *offset % alignment) % alignment;
+	if (fwrite(padding, 1, paddingSize, file) != paddingSize)
+	{
+		return -1;
+	}
+
+	*offset += paddingSize;
+
+	return 0;
+}
+
+uint64 hashAssetPath(const char *path)
+{
+	return hashBytes((void*)path, strlen(path));
+}
@@ -0,0 +1,136 @@
+#include "file/mapped_file.h"
+#include "file/file_types.h"
+
+#include "core/log.h"
+
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+int32 mapFile(const char *filename, MappedFile *file)
+{
+	memset(file, 0, sizeof(MappedFile));
+
+#ifdef _WIN32
+	HANDLE fileHandle = CreateFileA(
+		filename,
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		NULL,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		NULL);
+
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		LOG("Failed to open %s\n", filename);
+		return -1;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(fileHandle, &size) || size.QuadPart == 0)
+	{
+		LOG("Failed to map %s\n", filename);
+		CloseHandle(fileHandle);
+		return -1;
+	}
+
+	HANDLE mappingHandle = CreateFileMappingA(
+		fileHandle,
+		NULL,
+		PAGE_READONLY,
+		0,
+		0,
+		NULL);
+
+	uint8 *data = mappingHandle ?
+		MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : NULL;
+
+	if (!data)
+	{
+		LOG("Failed to map %s\n", filename);
+
+		if (mappingHandle)
+		{
+			CloseHandle(mappingHandle);
+		}
+
+		CloseHandle(fileHandle);
+		return -1;
+	}
+
+	file->data = data;
+	file->size = size.QuadPart;
+	file->fileHandle = fileHandle;
+	file->mappingHandle = mappingHandle;
+#else
+	int32 fileDescriptor = open(filename, O_RDONLY);
+
+	if (fileDescriptor == -1)
+	{
+		LOG("Failed to open %s\n", filename);
+		return -1;
+	}
+
+	struct stat fileStatus;
+	if (fstat(fileDescriptor, &fileStatus) == -1 || fileStatus.st_size == 0)
+	{
+		LOG("Failed to map %s\n", filename);
+		close(fileDescriptor);
+		return -1;
+	}
+
+	void *data = mmap(
+		NULL,
+		fileStatus.st_size,
+		PROT_READ,
+		MAP_PRIVATE,
+		fileDescriptor,
+		0);
+
+	// The mapping stays valid after the file has been closed
+	close(fileDescriptor);
+
+	if (data == MAP_FAILED)
+	{
+		LOG("Failed to map %s\n", filename);
+		return -1;
+	}
+
+	file->data = data;
+	file->size = fileStatus.st_size;
+#endif
+
+	return 0;
+}
+
+void unmapFile(MappedFile *file)
+{
+	if (!file->data)
+	{
+		return;
+	}
+
+	if (file->borrowed)
+	{
+		memset(file, 0, sizeof(MappedFile));
+		return;
+	}
+
+#ifdef _WIN32
+	UnmapViewOfFile(file->data);
+	CloseHandle(file->mappingHandle);
+	CloseHandle(file->fileHandle);
+#else
+	munmap(file->data, file->size);
+#endif
+
+	memset(file, 0, sizeof(MappedFile));
+}
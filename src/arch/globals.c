@@ -8,6 +8,10 @@
 
 #include "data/data_types.h"
 
+#include "file/file_types.h"
+
+#include "threading/threading_types.h"
+
 #include <luajit-2.0/lua.h>
 
 #include <pthread.h>
@@ -17,12 +21,16 @@ Config config;
 #define CREATE_ASSET(assets, Assets) \
 HashMap assets; \
 pthread_mutex_t assets ## Mutex; \
+HashMap published ## Assets; \
 \
 HashMap loading ## Assets; \
 pthread_mutex_t loading ## Assets ## Mutex; \
 \
 HashMap upload ## Assets ## Queue; \
-pthread_mutex_t upload ## Assets ## Mutex
+pthread_mutex_t upload ## Assets ## Mutex; \
+\
+List unused ## Assets ## Queue; \
+HashMap pending ## Assets ## References
 
 CREATE_ASSET(models, Models);
 CREATE_ASSET(textures, Textures);
@@ -35,13 +43,10 @@ CREATE_ASSET(cubemaps, Cubemaps);
 HashMap materialFolders;
 pthread_mutex_t materialFoldersMutex;
 
-uint32 assetThreadCount;
-pthread_mutex_t assetThreadsMutex;
-pthread_cond_t assetThreadsCondition;
+ThreadPool *assetThreadPool;
+AssetArchive assetArchive;
 
-uint32 totalThreadCount;
-pthread_mutex_t totalThreadsMutex;
-pthread_cond_t totalThreadsCondition;
+uint64 assetManagerTick;
 
 bool assetManagerIsShutdown;
 pthread_mutex_t assetManagerShutdownMutex;
@@ -61,6 +66,12 @@ int32 viewportHeight;
 // Maps from system names as UUIDs to System structures
 HashMap systemRegistry;
 
+// Worker threads which run systems alongside the main thread
+ThreadPool *systemThreadPool;
+
+// Interns component type UUIDs as component type handles
+InternTable componentTypeRegistry;
+
 // List of scene pointers which will have systems run on them
 List activeScenes;
 
@@ -83,10 +83,10 @@ int32 setMaterialUniform(Uniform *uniform, Material *material)
 
 	for (uint8 i = 0; i < MATERIAL_COMPONENT_TYPE_COUNT; i++)
 	{
-		Texture texture = getTexture(material->components[i].texture.string);
-		if (strlen(texture.name.string) > 0)
+		Texture *texture = getTexture(material->components[i].texture.string);
+		if (texture)
 		{
-			textureHandles[i] = texture.handle;
+			textureHandles[i] = texture->handle;
 		}
 	}
 
@@ -124,10 +124,10 @@ int32 setBindlessTextureUniform(Uniform *uniform, UUID name)
 {
 	GLuint64 textureHandle = 0;
 
-	Texture texture = getTexture(name.string);
-	if (strlen(texture.name.string) > 0)
+	Texture *texture = getTexture(name.string);
+	if (texture)
 	{
-		textureHandle = texture.handle;
+		textureHandle = texture->handle;
 	}
 
 	return setUniform(*uniform, 1, &textureHandle);
@@ -175,11 +175,11 @@ void activateTextures(
 
 void activateTexture(UUID name, GLint *textureIndex)
 {
-	Texture texture = getTexture(name.string);
-	if (strlen(texture.name.string) > 0)
+	Texture *texture = getTexture(name.string);
+	if (texture)
 	{
 		glActiveTexture(GL_TEXTURE0 + *textureIndex);
-		glBindTexture(GL_TEXTURE_2D, texture.id);
+		glBindTexture(GL_TEXTURE_2D, texture->id);
 	}
 
 	(*textureIndex)++;
@@ -0,0 +1,75 @@
+#include "threading/job_graph.h"
+#include "threading/thread_pool.h"
+#include "threading/threading_types.h"
+
+#include "core/log.h"
+
+#include <malloc.h>
+
+internal
+void runJobNode(void *data)
+{
+	JobNode *node = data;
+
+	if (node->function)
+	{
+		node->function(node->data);
+	}
+
+	if (node->parent)
+	{
+		jobNodeFinishDependency(node->parent);
+	}
+
+	free(node);
+}
+
+JobNode *createJobNode(
+	ThreadPool *pool,
+	JobFunction function,
+	void *data,
+	int32 priority,
+	JobNode *parent)
+{
+	JobNode *node = malloc(sizeof(JobNode));
+
+	ASSERT(node != 0);
+
+	node->pool = pool;
+	node->function = function;
+	node->data = data;
+	node->priority = priority;
+	node->numDependencies = 1;
+	node->parent = parent;
+
+	if (parent)
+	{
+		jobNodeAddDependency(parent);
+	}
+
+	return node;
+}
+
+void startJobNode(JobNode *node)
+{
+	jobNodeFinishDependency(node);
+}
+
+void jobNodeAddDependency(JobNode *node)
+{
+	__atomic_add_fetch(&node->numDependencies, 1, __ATOMIC_RELAXED);
+}
+
+void jobNodeFinishDependency(JobNode *node)
+{
+	if (__atomic_sub_fetch(&node->numDependencies, 1, __ATOMIC_ACQ_REL) > 0)
+	{
+		return;
+	}
+
+	threadPoolAddPriorityJob(
+		node->pool,
+		&runJobNode,
+		node,
+		node->priority);
+}
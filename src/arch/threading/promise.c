@@ -9,6 +9,11 @@ Promise *pCreate(void)
 {
 	Promise *ret = malloc(sizeof(Promise));
 
+	ASSERT(ret != 0);
+
+	ret->pData = NULL;
+	ret->isDone = 0;
+
 	pthread_mutex_init(&ret->mut, NULL);
 	pthread_cond_init(&ret->cond, NULL);
 
@@ -32,17 +37,27 @@ Promise *pReturn(void *pData)
 
 Promise *pBind(Promise **p, Promise *(*fn)(void *pData))
 {
-	pthread_mutex_lock(&(*p)->mut);
+	Promise *ret = fn(pAwait(*p));
 
-	pthread_cond_wait(&(*p)->cond, &(*p)->mut);
+	freePromise(p);
 
-	Promise *ret = fn((*p)->pData);
+	return ret;
+}
 
-	pthread_mutex_unlock(&(*p)->mut);
+void *pAwait(Promise *p)
+{
+	pthread_mutex_lock(&p->mut);
 
-	freePromise(p);
+	while (!p->isDone)
+	{
+		pthread_cond_wait(&p->cond, &p->mut);
+	}
 
-	return ret;
+	void *pData = p->pData;
+
+	pthread_mutex_unlock(&p->mut);
+
+	return pData;
 }
 
 void pComplete(Promise *p, void *pData)
@@ -52,7 +67,7 @@ void pComplete(Promise *p, void *pData)
 	p->pData = pData;
 	p->isDone = 1;
 
-	pthread_cond_signal(&p->cond);
+	pthread_cond_broadcast(&p->cond);
 
 	pthread_mutex_unlock(&p->mut);
 }
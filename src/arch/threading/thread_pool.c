@@ -0,0 +1,363 @@
+#include "threading/thread_pool.h"
+#include "threading/threading_types.h"
+
+#include "core/log.h"
+
+#include <malloc.h>
+
+typedef struct parallel_for_t
+{
+	uint32 count;
+	uint32 chunkSize;
+	ParallelForFunction function;
+	void *data;
+	// First item which hasn't been claimed by a thread yet
+	uint32 nextItem;
+	uint32 numFinishedItems;
+	// Helper jobs may run after the caller has returned, so the last thread
+	// to let go of the parallel for frees it
+	uint32 numReferences;
+	pthread_mutex_t mutex;
+	pthread_cond_t finishedCondition;
+} ParallelFor;
+
+internal
+bool jobRunsBefore(const Job *a, const Job *b)
+{
+	if (a->priority != b->priority)
+	{
+		return a->priority > b->priority;
+	}
+
+	// Compare the difference so that wrapping sequence numbers stay in order
+	return (int32)(a->sequence - b->sequence) < 0;
+}
+
+internal
+void pushJob(ThreadPool *pool, Job job)
+{
+	uint32 i = pool->numJobs++;
+
+	while (i > 0)
+	{
+		uint32 parent = (i - 1) / 2;
+		if (!jobRunsBefore(&job, &pool->jobs[parent]))
+		{
+			break;
+		}
+
+		pool->jobs[i] = pool->jobs[parent];
+		i = parent;
+	}
+
+	pool->jobs[i] = job;
+}
+
+internal
+Job popJob(ThreadPool *pool)
+{
+	Job job = pool->jobs[0];
+	Job last = pool->jobs[--pool->numJobs];
+
+	uint32 i = 0;
+	while (true)
+	{
+		uint32 child = 2 * i + 1;
+		if (child >= pool->numJobs)
+		{
+			break;
+		}
+
+		if (child + 1 < pool->numJobs &&
+			jobRunsBefore(&pool->jobs[child + 1], &pool->jobs[child]))
+		{
+			child++;
+		}
+
+		if (!jobRunsBefore(&pool->jobs[child], &last))
+		{
+			break;
+		}
+
+		pool->jobs[i] = pool->jobs[child];
+		i = child;
+	}
+
+	pool->jobs[i] = last;
+
+	return job;
+}
+
+internal
+void *runWorkerThread(void *arg)
+{
+	ThreadPool *pool = arg;
+
+	pthread_mutex_lock(&pool->mutex);
+
+	while (true)
+	{
+		while (pool->numJobs == 0 && !pool->shutdown)
+		{
+			pthread_cond_wait(&pool->jobCondition, &pool->mutex);
+		}
+
+		if (pool->numJobs == 0)
+		{
+			break;
+		}
+
+		Job job = popJob(pool);
+
+		pthread_mutex_unlock(&pool->mutex);
+
+		job.function(job.data);
+
+		pthread_mutex_lock(&pool->mutex);
+
+		if (--pool->numUnfinishedJobs == 0)
+		{
+			pthread_cond_broadcast(&pool->finishedCondition);
+		}
+	}
+
+	pthread_mutex_unlock(&pool->mutex);
+
+	return NULL;
+}
+
+ThreadPool *createThreadPool(uint32 numThreads)
+{
+	ThreadPool *pool = calloc(1, sizeof(ThreadPool));
+
+	ASSERT(pool != 0);
+
+	pool->jobCapacity = THREAD_POOL_MIN_JOB_CAPACITY;
+	pool->jobs = malloc(pool->jobCapacity * sizeof(Job));
+
+	ASSERT(pool->jobs != 0);
+
+	pthread_mutex_init(&pool->mutex, NULL);
+	pthread_cond_init(&pool->jobCondition, NULL);
+	pthread_cond_init(&pool->finishedCondition, NULL);
+
+	pool->threads = malloc(numThreads * sizeof(pthread_t));
+
+	for (uint32 i = 0; i < numThreads; i++)
+	{
+		if (pthread_create(
+			&pool->threads[i],
+			NULL,
+			&runWorkerThread,
+			pool))
+		{
+			LOG_WARNING("Only able to create %d of %d worker threads\n",
+				i,
+				numThreads);
+			break;
+		}
+
+		pool->numThreads++;
+	}
+
+	return pool;
+}
+
+void freeThreadPool(ThreadPool **pool)
+{
+	pthread_mutex_lock(&(*pool)->mutex);
+	(*pool)->shutdown = true;
+	pthread_cond_broadcast(&(*pool)->jobCondition);
+	pthread_mutex_unlock(&(*pool)->mutex);
+
+	// Worker threads finish every queued job before exiting
+	for (uint32 i = 0; i < (*pool)->numThreads; i++)
+	{
+		pthread_join((*pool)->threads[i], NULL);
+	}
+
+	pthread_mutex_destroy(&(*pool)->mutex);
+	pthread_cond_destroy(&(*pool)->jobCondition);
+	pthread_cond_destroy(&(*pool)->finishedCondition);
+
+	free((*pool)->threads);
+	free((*pool)->jobs);
+	free(*pool);
+	*pool = NULL;
+}
+
+void threadPoolAddJob(ThreadPool *pool, JobFunction function, void *data)
+{
+	threadPoolAddPriorityJob(pool, function, data, 0);
+}
+
+void threadPoolAddPriorityJob(
+	ThreadPool *pool,
+	JobFunction function,
+	void *data,
+	int32 priority)
+{
+	if (pool->numThreads == 0)
+	{
+		function(data);
+		return;
+	}
+
+	pthread_mutex_lock(&pool->mutex);
+
+	if (pool->numJobs == pool->jobCapacity)
+	{
+		pool->jobCapacity *= 2;
+		pool->jobs = realloc(pool->jobs, pool->jobCapacity * sizeof(Job));
+
+		ASSERT(pool->jobs != 0);
+	}
+
+	Job job;
+	job.function = function;
+	job.data = data;
+	job.priority = priority;
+	job.sequence = pool->nextSequence++;
+
+	pushJob(pool, job);
+	pool->numUnfinishedJobs++;
+
+	pthread_cond_signal(&pool->jobCondition);
+	pthread_mutex_unlock(&pool->mutex);
+}
+
+void threadPoolWait(ThreadPool *pool)
+{
+	pthread_mutex_lock(&pool->mutex);
+
+	while (pool->numUnfinishedJobs > 0)
+	{
+		pthread_cond_wait(&pool->finishedCondition, &pool->mutex);
+	}
+
+	pthread_mutex_unlock(&pool->mutex);
+}
+
+internal
+void runParallelForChunks(ParallelFor *parallelFor)
+{
+	uint32 numItems = 0;
+
+	while (true)
+	{
+		uint32 first = __atomic_fetch_add(
+			&parallelFor->nextItem,
+			parallelFor->chunkSize,
+			__ATOMIC_RELAXED);
+
+		if (first >= parallelFor->count)
+		{
+			break;
+		}
+
+		uint32 count = MIN(
+			parallelFor->chunkSize,
+			parallelFor->count - first);
+
+		parallelFor->function(first, count, parallelFor->data);
+		numItems += count;
+	}
+
+	if (numItems == 0)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&parallelFor->mutex);
+
+	parallelFor->numFinishedItems += numItems;
+	if (parallelFor->numFinishedItems == parallelFor->count)
+	{
+		pthread_cond_signal(&parallelFor->finishedCondition);
+	}
+
+	pthread_mutex_unlock(&parallelFor->mutex);
+}
+
+internal
+void releaseParallelFor(ParallelFor *parallelFor)
+{
+	if (__atomic_sub_fetch(
+		&parallelFor->numReferences,
+		1,
+		__ATOMIC_ACQ_REL) > 0)
+	{
+		return;
+	}
+
+	pthread_mutex_destroy(&parallelFor->mutex);
+	pthread_cond_destroy(&parallelFor->finishedCondition);
+
+	free(parallelFor);
+}
+
+internal
+void runParallelForJob(void *data)
+{
+	ParallelFor *parallelFor = data;
+
+	runParallelForChunks(parallelFor);
+	releaseParallelFor(parallelFor);
+}
+
+void threadPoolParallelFor(
+	ThreadPool *pool,
+	uint32 count,
+	uint32 chunkSize,
+	ParallelForFunction function,
+	void *data)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	chunkSize = MAX(chunkSize, 1);
+
+	uint32 numChunks = (count - 1) / chunkSize + 1;
+	uint32 numHelpers = MIN(pool->numThreads, numChunks - 1);
+
+	if (numHelpers == 0)
+	{
+		function(0, count, data);
+		return;
+	}
+
+	ParallelFor *parallelFor = calloc(1, sizeof(ParallelFor));
+
+	ASSERT(parallelFor != 0);
+
+	parallelFor->count = count;
+	parallelFor->chunkSize = chunkSize;
+	parallelFor->function = function;
+	parallelFor->data = data;
+	parallelFor->numReferences = numHelpers + 1;
+
+	pthread_mutex_init(&parallelFor->mutex, NULL);
+	pthread_cond_init(&parallelFor->finishedCondition, NULL);
+
+	for (uint32 i = 0; i < numHelpers; i++)
+	{
+		threadPoolAddJob(pool, &runParallelForJob, parallelFor);
+	}
+
+	runParallelForChunks(parallelFor);
+
+	pthread_mutex_lock(&parallelFor->mutex);
+
+	while (parallelFor->numFinishedItems < parallelFor->count)
+	{
+		pthread_cond_wait(
+			&parallelFor->finishedCondition,
+			&parallelFor->mutex);
+	}
+
+	pthread_mutex_unlock(&parallelFor->mutex);
+
+	releaseParallelFor(parallelFor);
+}
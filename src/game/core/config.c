@@ -20,6 +20,8 @@ internal void initializeDefaultConfig(void);
 internal cJSON* getConfigObject(cJSON *json, const char *key);
 
 internal bool cJSONToBool(cJSON *boolObject);
+internal LogLevel cJSONToLogLevel(cJSON *levelObject);
+internal uint64 cJSONToMemorySize(cJSON *megabytesObject);
 
 int32 loadConfig(void)
 {
@@ -100,6 +102,17 @@ int32 loadConfig(void)
 		}
 	}
 
+	// Systems Config
+
+	GET_CONFIG_ITEM(numWorkerThreads, "systems.worker_thread_count")
+	{
+		if (numWorkerThreads->valueint >= 0)
+		{
+			config.systemsConfig.numWorkerThreads =
+				numWorkerThreads->valueint;
+		}
+	}
+
 	// Graphics Config
 
 	GET_CONFIG_ITEM(graphicsBackgroundColor, "graphics.background_color")
@@ -274,6 +287,68 @@ int32 loadConfig(void)
 			minCubemapLifetime->valuedouble;
 	}
 
+	GET_CONFIG_ITEM(maxMemory, "assets.memory_budgets.total")
+	{
+		config.assetsConfig.maxMemory = cJSONToMemorySize(maxMemory);
+	}
+
+	GET_CONFIG_ITEM(maxAudioFileMemory, "assets.memory_budgets.audio")
+	{
+		config.assetsConfig.maxAudioFileMemory =
+			cJSONToMemorySize(maxAudioFileMemory);
+	}
+
+	GET_CONFIG_ITEM(maxFontMemory, "assets.memory_budgets.fonts")
+	{
+		config.assetsConfig.maxFontMemory = cJSONToMemorySize(maxFontMemory);
+	}
+
+	GET_CONFIG_ITEM(maxImageMemory, "assets.memory_budgets.images")
+	{
+		config.assetsConfig.maxImageMemory = cJSONToMemorySize(maxImageMemory);
+	}
+
+	GET_CONFIG_ITEM(maxTextureMemory, "assets.memory_budgets.textures")
+	{
+		config.assetsConfig.maxTextureMemory =
+			cJSONToMemorySize(maxTextureMemory);
+	}
+
+	GET_CONFIG_ITEM(maxModelMemory, "assets.memory_budgets.models")
+	{
+		config.assetsConfig.maxModelMemory = cJSONToMemorySize(maxModelMemory);
+	}
+
+	GET_CONFIG_ITEM(maxParticleMemory, "assets.memory_budgets.particles")
+	{
+		config.assetsConfig.maxParticleMemory =
+			cJSONToMemorySize(maxParticleMemory);
+	}
+
+	GET_CONFIG_ITEM(maxCubemapMemory, "assets.memory_budgets.cubemaps")
+	{
+		config.assetsConfig.maxCubemapMemory =
+			cJSONToMemorySize(maxCubemapMemory);
+	}
+
+	GET_CONFIG_ITEM(maxFrameUploadTime, "assets.uploads.time_budget")
+	{
+		config.assetsConfig.maxFrameUploadTime =
+			maxFrameUploadTime->valuedouble / 1000.0;
+	}
+
+	GET_CONFIG_ITEM(maxFrameUploadSize, "assets.uploads.size_budget")
+	{
+		config.assetsConfig.maxFrameUploadSize =
+			cJSONToMemorySize(maxFrameUploadSize);
+	}
+
+	GET_CONFIG_ITEM(stagingBufferSize, "assets.uploads.staging_buffer_size")
+	{
+		config.assetsConfig.stagingBufferSize =
+			cJSONToMemorySize(stagingBufferSize);
+	}
+
 	GET_CONFIG_ITEM(maxThreadCount, "assets.maximum_thread_count")
 	{
 		if (maxThreadCount->valueint >= 1)
@@ -282,6 +357,19 @@ int32 loadConfig(void)
 		}
 	}
 
+	GET_CONFIG_ITEM(archive, "assets.archive")
+	{
+		free(config.assetsConfig.archive);
+		config.assetsConfig.archive = NULL;
+
+		if (archive->valuestring && strlen(archive->valuestring) > 0)
+		{
+			config.assetsConfig.archive = malloc(
+				strlen(archive->valuestring) + 1);
+			strcpy(config.assetsConfig.archive, archive->valuestring);
+		}
+	}
+
 	// Log Config
 
 	GET_CONFIG_ITEM(engineFile, "log.files.engine")
@@ -310,6 +398,16 @@ int32 loadConfig(void)
 		strcpy(config.logConfig.luaFile, luaFile->valuestring);
 	}
 
+	GET_CONFIG_ITEM(logLevel, "log.level")
+	{
+		config.logConfig.level = cJSONToLogLevel(logLevel);
+	}
+
+	GET_CONFIG_ITEM(deferLogFormatting, "log.deferred_formatting")
+	{
+		config.logConfig.deferFormatting = cJSONToBool(deferLogFormatting);
+	}
+
 	// Saves Config
 
 	GET_CONFIG_ITEM(removeJSONScenes, "saves.remove_json_scenes")
@@ -317,9 +415,13 @@ int32 loadConfig(void)
 		config.savesConfig.removeJSONScenes = cJSONToBool(removeJSONScenes);
 	}
 
-	GET_CONFIG_ITEM(removeJSONEntities, "saves.remove_json_entities")
+	GET_CONFIG_ITEM(maxSnapshotDeltas, "saves.max_snapshot_deltas")
 	{
-		config.savesConfig.removeJSONEntities = cJSONToBool(removeJSONEntities);
+		int32 maxDeltas = maxSnapshotDeltas->valueint;
+		if (maxDeltas >= 0)
+		{
+			config.savesConfig.maxSnapshotDeltas = maxDeltas;
+		}
 	}
 
 	// JSON Config
@@ -338,6 +440,7 @@ void freeConfig(void)
 {
 	free(config.windowConfig.title);
 	free(config.windowConfig.icon);
+	free(config.assetsConfig.archive);
 	free(config.logConfig.engineFile);
 	free(config.logConfig.assetManagerFile);
 	free(config.logConfig.luaFile);
@@ -358,6 +461,8 @@ void initializeDefaultConfig(void)
 
 	config.physicsConfig.fps = 60;
 
+	config.systemsConfig.numWorkerThreads = 3;
+
 	kmVec3Fill(&config.graphicsConfig.backgroundColor, 0.0f, 0.0f, 0.0f);
 	config.graphicsConfig.pbr = true;
 	config.graphicsConfig.shadowMapResolution = 4096;
@@ -386,7 +491,19 @@ void initializeDefaultConfig(void)
 	config.assetsConfig.minModelLifetime = 60.0;
 	config.assetsConfig.minParticleLifetime = 60.0;
 	config.assetsConfig.minCubemapLifetime = 60.0;
+	config.assetsConfig.maxMemory = 0;
+	config.assetsConfig.maxAudioFileMemory = 0;
+	config.assetsConfig.maxFontMemory = 0;
+	config.assetsConfig.maxImageMemory = 0;
+	config.assetsConfig.maxTextureMemory = 0;
+	config.assetsConfig.maxModelMemory = 0;
+	config.assetsConfig.maxParticleMemory = 0;
+	config.assetsConfig.maxCubemapMemory = 0;
+	config.assetsConfig.maxFrameUploadTime = 0.004;
+	config.assetsConfig.maxFrameUploadSize = 0;
+	config.assetsConfig.stagingBufferSize = 64 * 1024 * 1024;
 	config.assetsConfig.maxThreadCount = 4;
+	config.assetsConfig.archive = NULL;
 
 	config.logConfig.engineFile = malloc(11);
 	strcpy(config.logConfig.engineFile, "engine.log");
@@ -394,9 +511,11 @@ void initializeDefaultConfig(void)
 	strcpy(config.logConfig.assetManagerFile, "asset_manager.log");
 	config.logConfig.luaFile = malloc(8);
 	strcpy(config.logConfig.luaFile, "lua.log");
+	config.logConfig.level = LOG_LEVEL_DEBUG;
+	config.logConfig.deferFormatting = true;
 
 	config.savesConfig.removeJSONScenes = true;
-	config.savesConfig.removeJSONEntities = true;
+	config.savesConfig.maxSnapshotDeltas = 16;
 
 	config.jsonConfig.formatted = true;
 }
@@ -428,4 +547,47 @@ cJSON* getConfigObject(cJSON *json, const char *key)
 bool cJSONToBool(cJSON *boolObject)
 {
 	return cJSON_IsTrue(boolObject) ? true : false;
+}
+
+uint64 cJSONToMemorySize(cJSON *megabytesObject)
+{
+	if (megabytesObject->valuedouble <= 0.0)
+	{
+		return 0;
+	}
+
+	return megabytesObject->valuedouble * 1024.0 * 1024.0;
+}
+
+LogLevel cJSONToLogLevel(cJSON *levelObject)
+{
+	const char *level = cJSON_GetStringValue(levelObject);
+
+	if (level)
+	{
+		if (!strcmp(level, "debug"))
+		{
+			return LOG_LEVEL_DEBUG;
+		}
+		else if (!strcmp(level, "info"))
+		{
+			return LOG_LEVEL_INFO;
+		}
+		else if (!strcmp(level, "warning"))
+		{
+			return LOG_LEVEL_WARNING;
+		}
+		else if (!strcmp(level, "error"))
+		{
+			return LOG_LEVEL_ERROR;
+		}
+		else if (!strcmp(level, "none"))
+		{
+			return LOG_LEVEL_NONE;
+		}
+	}
+
+	LOG_WARNING("Unknown log level, logging everything\n");
+
+	return LOG_LEVEL_DEBUG;
 }
\ No newline at end of file
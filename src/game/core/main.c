@@ -1,10 +1,18 @@
 #include "defines.h"
 
 #include "asset_management/asset_manager.h"
+#include "asset_management/cooked_texture.h"
 
 #include "audio/audio.h"
 
 #include "components/component_types.h"
+#include "components/animation.h"
+#include "components/collision.h"
+#include "components/collision_tree_node.h"
+#include "components/panel.h"
+#include "components/rigid_body.h"
+#include "components/transform.h"
+#include "components/widget.h"
 
 #include "core/log.h"
 #include "core/config.h"
@@ -14,12 +22,20 @@
 #include "data/data_types.h"
 #include "data/list.h"
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 
 #include "ECS/ecs_types.h"
 #include "ECS/scene.h"
+#include "ECS/component.h"
+#include "ECS/entity_loader.h"
+#include "ECS/save.h"
+#include "ECS/serialization.h"
 
+#include "file/asset_archive.h"
 #include "file/utilities.h"
 
+#include "threading/thread_pool.h"
+
 #include "systems.h"
 
 #include <GL/glew.h>
@@ -36,6 +52,7 @@
 
 #include <time.h>
 #include <stdlib.h>
+#include <string.h>
 
 extern Config config;
 extern int32 viewportWidth;
@@ -53,11 +70,16 @@ extern List savedScenes;
 extern uint32 postProcessingSystemRefCount;
 extern GLuint screenFramebufferMSAA;
 
+internal void initializeComponents(void);
 internal void update(real64 dt, bool skipLoadedThisFrame);
 internal void draw(GLFWwindow *window, real64 frameTime);
 
 extern Scene *listenerScene;
 
+extern ThreadPool *systemThreadPool;
+
+internal ComponentTypeHandle cameraComponentID = INVALID_HANDLE;
+
 int32 main(int32 argc, char *argv[])
 {
 	if (loadConfig() == -1)
@@ -65,6 +87,82 @@ int32 main(int32 argc, char *argv[])
 		LOG("Using default configuration\n");
 	}
 
+	// ghoti --pack-assets <archive> [--uncompressed] packs resources/ into an
+	// archive for assets.archive to point at, without starting the engine
+	if (argc >= 3 && !strcmp(argv[1], "--pack-assets"))
+	{
+		bool compress = !(argc >= 4 && !strcmp(argv[3], "--uncompressed"));
+		int32 error = packAssetArchive("resources", argv[2], compress);
+
+		freeConfig();
+		return error == -1 ? 1 : 0;
+	}
+
+	// ghoti --cook-textures <folder> [bc1|bc3|bc5] cooks every image below
+	// folder into a .tex file, which is loaded instead of the image
+	if (argc >= 3 && !strcmp(argv[1], "--cook-textures"))
+	{
+		TextureFormat format = TEXTURE_FORMAT_UNCOMPRESSED;
+		int32 error = 0;
+
+		if (argc >= 4)
+		{
+			if (!strcmp(argv[3], "bc1"))
+			{
+				format = TEXTURE_FORMAT_BC1;
+			}
+			else if (!strcmp(argv[3], "bc3"))
+			{
+				format = TEXTURE_FORMAT_BC3;
+			}
+			else if (!strcmp(argv[3], "bc5"))
+			{
+				format = TEXTURE_FORMAT_BC5;
+			}
+			else
+			{
+				LOG("Unknown texture format %s\n", argv[3]);
+				error = -1;
+			}
+		}
+
+		if (error != -1)
+		{
+			error = cookTextures(argv[2], format);
+		}
+
+		freeConfig();
+		return error == -1 ? 1 : 0;
+	}
+
+	// ghoti --benchmark-entities <folder> [count] writes count generated
+	// entity files into folder and logs how long loading them takes
+	if (argc >= 3 && !strcmp(argv[1], "--benchmark-entities"))
+	{
+		uint32 numEntities = argc >= 4 ? strtoul(argv[3], NULL, 10) : 20000;
+
+		dInitODE();
+
+		initializeComponents();
+		systemThreadPool = createThreadPool(
+			config.systemsConfig.numWorkerThreads);
+		initializeSerialization();
+
+		int32 error = benchmarkEntityLoading(
+			argv[2],
+			numEntities,
+			systemThreadPool);
+
+		shutdownSerialization();
+		freeThreadPool(&systemThreadPool);
+
+		freeComponentTypes();
+		dCloseODE();
+
+		freeConfig();
+		return error == -1 ? 1 : 0;
+	}
+
 	srand(time(0));
 
 	if (LOG_FILE_NAME)
@@ -75,6 +173,7 @@ int32 main(int32 argc, char *argv[])
 	remove(ASSET_LOG_FILE_NAME);
 	remove(config.logConfig.luaFile);
 
+	initializeLog();
 	initializeAssetLog();
 
 	GLFWwindow *window = initWindow(
@@ -84,6 +183,7 @@ int32 main(int32 argc, char *argv[])
 
 	if (!window)
 	{
+		shutdownLog();
 		freeConfig();
 		return -1;
 	}
@@ -91,6 +191,7 @@ int32 main(int32 argc, char *argv[])
 	int32 err = initInput(window);
 	if (err)
 	{
+		shutdownLog();
 		freeConfig();
 		freeWindow(window);
 		return err;
@@ -98,6 +199,7 @@ int32 main(int32 argc, char *argv[])
 
 	if (initAudio() == -1)
 	{
+		shutdownLog();
 		freeConfig();
 		freeWindow(window);
 		shutdownInput();
@@ -126,7 +228,11 @@ int32 main(int32 argc, char *argv[])
 		config.graphicsConfig.backgroundColor.z,
 		1.0f);
 
+	initializeComponents();
 	initSystems();
+	systemThreadPool = createThreadPool(
+		config.systemsConfig.numWorkerThreads);
+	initializeSerialization();
 
 	deleteFolder(RUNTIME_STATE_DIR, false, &logFunction);
 
@@ -162,6 +268,7 @@ int32 main(int32 argc, char *argv[])
 
 		lua_close(L);
 		freeWindow(window);
+		shutdownLog();
 		freeConfig();
 		return 1;
 	}
@@ -191,6 +298,7 @@ int32 main(int32 argc, char *argv[])
 		while (accumulator >= dt && !glfwWindowShouldClose(window))
 		{
 			update(dt, false);
+			updateSaves();
 
 			if (loadingSave)
 			{
@@ -299,6 +407,11 @@ int32 main(int32 argc, char *argv[])
 		freeScene(&scene);
 	}
 
+	// Saves which are still being written finish before the runtime state
+	// they're copied from is deleted
+	shutdownSerialization();
+	updateSaves();
+
 	deleteFolder(RUNTIME_STATE_DIR, false, &logFunction);
 
 	if (L)
@@ -310,18 +423,36 @@ int32 main(int32 argc, char *argv[])
 	listClear(&unloadedScenes);
 	listClear(&savedScenes);
 
+	freeThreadPool(&systemThreadPool);
 	freeSystems();
+	freeComponentTypes();
 	shutdownAssetManager();
 	dCloseODE();
 	shutdownInput();
 	shutdownAudio();
 	freeWindow(window);
 	shutdownAssetLog();
+	shutdownLog();
 	freeConfig();
 
 	return 0;
 }
 
+void initializeComponents(void)
+{
+	initializeComponentTypes();
+
+	initializeTransformComponent();
+	initializeRigidBodyComponent();
+	initializeCollisionComponent();
+	initializeCollisionTreeNodeComponent();
+	initializePanelComponent();
+	initializeWidgetComponent();
+	initializeAnimationComponent();
+
+	cameraComponentID = componentTypeFromName("camera");
+}
+
 void update(real64 dt, bool skipLoadedThisFrame)
 {
 	int32 luaError = 0;
@@ -422,8 +553,8 @@ void draw(GLFWwindow *window, real64 frameTime)
 
 		CameraComponent *camera = sceneGetComponentFromEntity(
 			scene,
-			scene->mainCamera,
-			idFromName("camera"));
+			scene->mainCameraEntity,
+			cameraComponentID);
 		if (camera)
 		{
 			camera->aspectRatio = aspectRatio;
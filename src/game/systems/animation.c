@@ -11,6 +11,7 @@
 
 #include "data/data_types.h"
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 #include "data/list.h"
 
 #include "ECS/ecs_types.h"
@@ -21,10 +22,11 @@
 
 uint32 animationSystemRefCount = 0;
 
-internal UUID modelComponentID = {};
-internal UUID animationComponentID = {};
-internal UUID animatorComponentID = {};
-internal UUID nextAnimationComponentID = {};
+internal ComponentTypeHandle modelComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle animationComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle animatorComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle nextAnimationComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle transformComponentID = INVALID_HANDLE;
 
 #define SKELETONS_MAP_BUCKET_COUNT 7
 #define SKELETONS_BUCKET_COUNT 2003
@@ -41,6 +43,10 @@ internal kmVec3 getCurrentPosition(Bone *bone, real64 time);
 internal kmQuaternion getCurrentRotation(Bone *bone, real64 time);
 internal kmVec3 getCurrentScale(Bone *bone, real64 time);
 
+internal TransformComponent *getJointTransform(
+	Scene *scene,
+	JointTransform *jointTransform);
+
 internal int32 ptrcmp(void *a, void *b)
 {
 	return *(uint64*)a != *(uint64*)b;
@@ -50,17 +56,19 @@ internal void initAnimationSystem(Scene *scene)
 {
 	if (animationSystemRefCount == 0)
 	{
-		skeletonsMap = createHashMap(
+		skeletonsMap = createHashMapWithHashFunction(
 			sizeof(Scene*),
 			sizeof(HashMap),
 			SKELETONS_MAP_BUCKET_COUNT,
-			(ComparisonOp)&ptrcmp);
+			(ComparisonOp)&ptrcmp,
+			&hashBytes);
 
-		animationReferences = createHashMap(
+		animationReferences = createHashMapWithHashFunction(
 			sizeof(AnimatorComponent*),
 			sizeof(AnimationReference),
 			ANIMATIONS_BUCKET_COUNT,
-			(ComparisonOp)&ptrcmp);
+			(ComparisonOp)&ptrcmp,
+			&hashBytes);
 	}
 
 	skeletons = createHashMap(
@@ -71,9 +79,9 @@ internal void initAnimationSystem(Scene *scene)
 	hashMapInsert(skeletonsMap, &scene, &skeletons);
 
 	ComponentDataTable *animationComponents =
-		*(ComponentDataTable**)hashMapGetData(
-				scene->componentTypes,
-				&animationComponentID);
+		sceneGetComponentDataTable(
+				scene,
+				animationComponentID);
 
 	for (ComponentDataTableIterator itr = cdtGetIterator(animationComponents);
 		 !cdtIteratorAtEnd(itr);
@@ -92,16 +100,14 @@ internal void beginAnimationSystem(Scene *scene, real64 dt)
 	skeletons = *(HashMap*)hashMapGetData(skeletonsMap, &scene);
 }
 
-internal void runAnimationSystem(Scene *scene, UUID entityID, real64 dt)
+internal void runAnimationSystem(
+	Scene *scene,
+	EntityHandle entityID,
+	void **components,
+	real64 dt)
 {
-	AnimatorComponent *animator = sceneGetComponentFromEntity(
-		scene,
-		entityID,
-		animatorComponentID);
-	AnimationComponent *animationComponent = sceneGetComponentFromEntity(
-		scene,
-		entityID,
-		animationComponentID);
+	AnimatorComponent *animator = components[0];
+	AnimationComponent *animationComponent = components[1];
 	NextAnimationComponent *nextAnimation = sceneGetComponentFromEntity(
 		scene,
 		entityID,
@@ -193,19 +199,17 @@ internal void runAnimationSystem(Scene *scene, UUID entityID, real64 dt)
 		Bone *bone = &animationReference->currentAnimation->bones[i];
 
 		JointTransform *jointTransform = hashMapGetData(*skeleton, &bone->name);
-		if (jointTransform)
+		TransformComponent *transform = getJointTransform(
+			scene,
+			jointTransform);
+
+		if (transform)
 		{
-			jointTransform->transform->position = getCurrentPosition(
-				bone,
-				animator->time);
-			jointTransform->transform->rotation = getCurrentRotation(
-				bone,
-				animator->time);
-			jointTransform->transform->scale = getCurrentScale(
-				bone,
-				animator->time);
-
-			tMarkDirty(scene, jointTransform->uuid);
+			transform->position = getCurrentPosition(bone, animator->time);
+			transform->rotation = getCurrentRotation(bone, animator->time);
+			transform->scale = getCurrentScale(bone, animator->time);
+
+			tMarkDirty(scene, jointTransform->entity);
 		}
 	}
 
@@ -226,8 +230,11 @@ internal void runAnimationSystem(Scene *scene, UUID entityID, real64 dt)
 				JointTransform *jointTransform = hashMapGetData(
 					*skeleton,
 					&bone->name);
+				TransformComponent *transform = getJointTransform(
+					scene,
+					jointTransform);
 
-				if (jointTransform)
+				if (transform)
 				{
 					kmVec3 position = getCurrentPosition(
 						bone,
@@ -240,22 +247,22 @@ internal void runAnimationSystem(Scene *scene, UUID entityID, real64 dt)
 						animator->previousAnimationTime);
 
 					kmVec3Lerp(
-						&jointTransform->transform->position,
+						&transform->position,
 						&position,
-						&jointTransform->transform->position,
+						&transform->position,
 						t);
 					quaternionSlerp(
-						&jointTransform->transform->rotation,
+						&transform->rotation,
 						&rotation,
-						&jointTransform->transform->rotation,
+						&transform->rotation,
 						t);
 					kmVec3Lerp(
-						&jointTransform->transform->scale,
+						&transform->scale,
 						&scale,
-						&jointTransform->transform->scale,
+						&transform->scale,
 						t);
 
-					tMarkDirty(scene, jointTransform->uuid);
+					tMarkDirty(scene, jointTransform->entity);
 				}
 			}
 		}
@@ -318,16 +325,26 @@ System createAnimationSystem(void)
 {
 	System system = {};
 
-	modelComponentID = idFromName("model");
-	animationComponentID = idFromName("animation");
-	animatorComponentID = idFromName("animator");
-	nextAnimationComponentID = idFromName("next_animation");
+	modelComponentID = componentTypeFromName("model");
+	animationComponentID = componentTypeFromName("animation");
+	animatorComponentID = componentTypeFromName("animator");
+	nextAnimationComponentID = componentTypeFromName("next_animation");
+	transformComponentID = componentTypeFromName("transform");
 
-	system.componentTypes = createList(sizeof(UUID));
+	system.componentTypes = createList(sizeof(ComponentTypeHandle));
 	listPushFront(&system.componentTypes, &modelComponentID);
 	listPushFront(&system.componentTypes, &animationComponentID);
 	listPushFront(&system.componentTypes, &animatorComponentID);
 
+	system.readComponentTypes = createList(sizeof(ComponentTypeHandle));
+	listPushFront(&system.readComponentTypes, &modelComponentID);
+	listPushFront(&system.readComponentTypes, &animationComponentID);
+
+	system.writeComponentTypes = createList(sizeof(ComponentTypeHandle));
+	listPushFront(&system.writeComponentTypes, &transformComponentID);
+	listPushFront(&system.writeComponentTypes, &nextAnimationComponentID);
+	listPushFront(&system.writeComponentTypes, &animatorComponentID);
+
 	system.init = &initAnimationSystem;
 	system.begin = &beginAnimationSystem;
 	system.run = &runAnimationSystem;
@@ -434,4 +451,19 @@ kmVec3 getCurrentScale(Bone *bone, real64 time)
 	kmVec3Lerp(&scale, &keyFrameA->value, &keyFrameB->value, t);
 
 	return scale;
+}
+
+TransformComponent *getJointTransform(
+	Scene *scene,
+	JointTransform *jointTransform)
+{
+	if (!jointTransform)
+	{
+		return NULL;
+	}
+
+	return sceneGetComponentFromEntity(
+		scene,
+		jointTransform->entity,
+		transformComponentID);
 }
\ No newline at end of file
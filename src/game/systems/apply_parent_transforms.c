@@ -3,6 +3,7 @@
 #include "data/data_types.h"
 #include "data/list.h"
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 
 #include "ECS/ecs_types.h"
 #include "ECS/scene.h"
@@ -18,16 +19,16 @@
 
 #include <string.h>
 
-internal UUID transformComponentID = {};
+internal ComponentTypeHandle transformComponentID = INVALID_HANDLE;
 
 internal
 void initApplyParentTransformsSystem(Scene *scene)
 {
-	ComponentDataTable **table = hashMapGetData(
-		scene->componentTypes,
-		&transformComponentID);
+	ComponentDataTable *table = sceneGetComponentDataTable(
+		scene,
+		transformComponentID);
 
-	for (ComponentDataTableIterator itr = cdtGetIterator(*table);
+	for (ComponentDataTableIterator itr = cdtGetIterator(table);
 		 !cdtIteratorAtEnd(itr);
 		 cdtMoveIterator(&itr))
 	{
@@ -41,32 +42,47 @@ void initApplyParentTransformsSystem(Scene *scene)
 }
 
 internal
-void runApplyParentTransformsSystem(Scene *scene, UUID entityID, real64 dt)
+void runApplyParentTransformsSystem(
+	Scene *scene,
+	EntityHandle entityID,
+	void **components,
+	real64 dt)
 {
-	// Get the parent
-	// If the parent is a thing, then get its global transform
-	// Apply the parent's global transform to this guy
+	TransformComponent *transform = components[0];
 
-	TransformComponent *transform = sceneGetComponentFromEntity(
-		scene,
-		entityID,
-		transformComponentID);
+	// Children are updated by the root of their hierarchy, so that each
+	// hierarchy is only ever touched by one thread
+	if (strlen(transform->parent.string) > 0)
+	{
+		return;
+	}
 
 	if (transform->dirty)
 	{
 		applyParentTransform(scene, transform);
 	}
+
+	applyChildTransforms(scene, transformComponentID, transform);
 }
 
 System createApplyParentTransformsSystem(void)
 {
-	transformComponentID = idFromName("transform");
+	transformComponentID = componentTypeFromName("transform");
 
-	System applyParentTransforms;
+	System applyParentTransforms = {};
 
-	applyParentTransforms.componentTypes = createList(sizeof(UUID));
+	applyParentTransforms.componentTypes = createList(
+		sizeof(ComponentTypeHandle));
 	listPushFront(&applyParentTransforms.componentTypes, &transformComponentID);
 
+	applyParentTransforms.writeComponentTypes = createList(
+		sizeof(ComponentTypeHandle));
+	listPushFront(
+		&applyParentTransforms.writeComponentTypes,
+		&transformComponentID);
+
+	applyParentTransforms.parallel = true;
+
 	applyParentTransforms.init = &initApplyParentTransformsSystem;
 	applyParentTransforms.begin = 0;
 	applyParentTransforms.run = &runApplyParentTransformsSystem;
@@ -5,9 +5,11 @@
 #include "asset_management/audio.h"
 
 #include "audio/audio.h"
+#include "audio/audio_stream.h"
 
 #include "data/data_types.h"
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 #include "data/list.h"
 
 #include "ECS/ecs_types.h"
@@ -19,10 +21,10 @@
 
 #include <AL/al.h>
 
-internal UUID transformComponentID = {};
-internal UUID rigidBodyComponentID = {};
-internal UUID audioManagerComponentID = {};
-internal UUID audioSourceComponentID = {};
+internal ComponentTypeHandle transformComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle rigidBodyComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle audioManagerComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle audioSourceComponentID = INVALID_HANDLE;
 
 internal uint32 audioSystemRefCount = 0;
 
@@ -30,7 +32,6 @@ internal uint32 audioSystemRefCount = 0;
 
 extern HashMap playAudioQueue;
 extern Scene *listenerScene;
-extern ALuint *g_Buffers;
 extern ALuint *g_Sources;
 
 internal int32 ptrcmp(void *a, void *b)
@@ -43,11 +44,12 @@ void initAudioSystem(Scene *scene)
 {
 	if (audioSystemRefCount == 0)
 	{
-		playAudioQueue = createHashMap(
+		playAudioQueue = createHashMapWithHashFunction(
 			sizeof(AudioSourceComponent*),
 			sizeof(PlayAudioQueueData),
 			PLAY_AUDIO_BUCKET_COUNT,
-			(ComparisonOp)&ptrcmp);
+			(ComparisonOp)&ptrcmp,
+			&hashBytes);
 
 		if (!listenerScene)
 		{
@@ -56,7 +58,7 @@ void initAudioSystem(Scene *scene)
 
 		TransformComponent * camTrans = sceneGetComponentFromEntity(
 			scene,
-			listenerScene->mainCamera,
+			sceneGetEntity(scene, listenerScene->mainCamera),
 			transformComponentID);
 
 		ALfloat listenerPos[3]={};
@@ -87,7 +89,7 @@ void initAudioSystem(Scene *scene)
 
 		RigidBodyComponent * camRigid = sceneGetComponentFromEntity(
 			scene,
-			listenerScene->mainCamera,
+			sceneGetEntity(scene, listenerScene->mainCamera),
 			rigidBodyComponentID);
 
 		ALfloat listenerVel[3]={};
@@ -122,20 +124,10 @@ void beginAudioSystem(Scene *scene, real64 dt)
 
 		bool remove = false;
 
-		AudioFile audioData = getAudio(audio->name.string);
-		if (strlen(audioData.name.string) > 0)
+		AudioFile *audioData = getAudio(audio->name.string);
+		if (audioData)
 		{
-			strcpy(audioSource->currentAudio, audio->name.string);
-
-			alSourceRewind(g_Sources[audioSource->id]);
-
-			alSourcei(
-				g_Sources[audioSource->id],
-				AL_BUFFER,
-				g_Buffers[audioData.id]);
-
-			alSourcePlay(g_Sources[audioSource->id]);
-
+			playAudioFileAtSource(audioSource, audioData);
 			remove = true;
 		}
 		else if (audio->timer < 0.0)
@@ -160,13 +152,13 @@ void beginAudioSystem(Scene *scene, real64 dt)
 
 	uint32 sourceID = 0;
 	for (ComponentDataTableIterator itr = cdtGetIterator(
-			 *(ComponentDataTable **)hashMapGetData(
-				 scene->componentTypes,
-				 &audioSourceComponentID));
+			 sceneGetComponentDataTable(
+				 scene,
+				 audioSourceComponentID));
 		 !cdtIteratorAtEnd(itr) && sourceID < NUM_AUDIO_SRC;
 		 cdtMoveIterator(&itr), sourceID++)
 	{
-		UUID entityID = cdtIteratorGetUUID(itr);
+		EntityHandle entityID = cdtIteratorGetEntity(itr);
 
 		sourceComp = (AudioSourceComponent *)cdtIteratorGetData(itr);
 
@@ -207,7 +199,9 @@ void beginAudioSystem(Scene *scene, real64 dt)
 		alSourcefv(g_Sources[sourceID], AL_VELOCITY, sourceVel);
 		alSourcei(g_Sources[sourceID], AL_LOOPING, AL_FALSE);
 
-		if (!strcmp(entityID.string, listenerScene->mainCamera.string))
+		if (!strcmp(
+			sceneGetEntityID(scene, entityID).string,
+			listenerScene->mainCamera.string))
 		{
 			ALfloat	listenerOri[6]={0,0,0, 0,1,0};
 
@@ -238,7 +232,11 @@ void beginAudioSystem(Scene *scene, real64 dt)
 }
 
 internal
-void runAudioSystem(Scene *scene, UUID entityID, real64 dt)
+void runAudioSystem(
+	Scene *scene,
+	EntityHandle entityID,
+	void **components,
+	real64 dt)
 {
 	if (audioSystemRefCount == 0 || !listenerScene)
 	{
@@ -249,16 +247,13 @@ void runAudioSystem(Scene *scene, UUID entityID, real64 dt)
 	TransformComponent * transformComp;
 	RigidBodyComponent * rigidBodyComp;
 
-	sourceComp = sceneGetComponentFromEntity(
-		scene,
-		entityID,
-		audioSourceComponentID);
+	sourceComp = components[0];
 
 	uint32 sourceID = sourceComp->id;
 
 	alSourcef(g_Sources[sourceID], AL_PITCH, sourceComp->pitch);
 	alSourcef(g_Sources[sourceID], AL_GAIN, sourceComp->gain);
-	alSourcef(g_Sources[sourceID], AL_LOOPING, sourceComp->looping);
+	setAudioSourceLooping(sourceID, sourceComp->looping);
 
 	transformComp = sceneGetComponentFromEntity(
 		scene,
@@ -291,7 +286,9 @@ void runAudioSystem(Scene *scene, UUID entityID, real64 dt)
 	alSourcefv(g_Sources[sourceID], AL_POSITION, sourcePos);
 	alSourcefv(g_Sources[sourceID], AL_VELOCITY, sourceVel);
 
-	if (!strcmp(entityID.string, listenerScene->mainCamera.string))
+	if (!strcmp(
+		sceneGetEntityID(scene, entityID).string,
+		listenerScene->mainCamera.string))
 	{
 		ALfloat	listenerOri[6]={0,0,0, 0,1,0};
 
@@ -336,16 +333,26 @@ void shutdownAudioSystem(Scene *scene)
 
 System createAudioSystem(void)
 {
-	transformComponentID = idFromName("transform");
-	rigidBodyComponentID = idFromName("rigid_body");
-	audioManagerComponentID = idFromName("audio_manager");
-	audioSourceComponentID = idFromName("audio_source");
+	transformComponentID = componentTypeFromName("transform");
+	rigidBodyComponentID = componentTypeFromName("rigid_body");
+	audioManagerComponentID = componentTypeFromName("audio_manager");
+	audioSourceComponentID = componentTypeFromName("audio_source");
 
 	System sys = {};
 
-	sys.componentTypes = createList(sizeof(UUID));
+	sys.componentTypes = createList(sizeof(ComponentTypeHandle));
 	listPushFront(&sys.componentTypes, &audioSourceComponentID);
 
+	sys.readComponentTypes = createList(sizeof(ComponentTypeHandle));
+	listPushFront(&sys.readComponentTypes, &transformComponentID);
+	listPushFront(&sys.readComponentTypes, &rigidBodyComponentID);
+	listPushFront(&sys.readComponentTypes, &audioManagerComponentID);
+
+	sys.writeComponentTypes = createList(sizeof(ComponentTypeHandle));
+	listPushFront(&sys.writeComponentTypes, &audioSourceComponentID);
+
+	sys.mainThread = true;
+
 	sys.init = &initAudioSystem;
 	sys.begin = &beginAudioSystem;
 	sys.run = &runAudioSystem;
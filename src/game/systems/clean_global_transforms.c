@@ -3,6 +3,7 @@
 #include "data/data_types.h"
 #include "data/list.h"
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 
 #include "ECS/ecs_types.h"
 #include "ECS/scene.h"
@@ -10,16 +11,16 @@
 
 #include "components/component_types.h"
 
-internal UUID transformComponentID = {};
+internal ComponentTypeHandle transformComponentID = INVALID_HANDLE;
 
 internal
 void initCleanGlobalTransformsSystem(Scene *scene)
 {
-	ComponentDataTable **table = hashMapGetData(
-		scene->componentTypes,
-		&transformComponentID);
+	ComponentDataTable *table = sceneGetComponentDataTable(
+		scene,
+		transformComponentID);
 
-	for (ComponentDataTableIterator itr = cdtGetIterator(*table);
+	for (ComponentDataTableIterator itr = cdtGetIterator(table);
 		!cdtIteratorAtEnd(itr);
 		cdtMoveIterator(&itr))
 	{
@@ -38,12 +39,13 @@ void initCleanGlobalTransformsSystem(Scene *scene)
 }
 
 internal
-void runCleanGlobalTransformsSystem(Scene *scene, UUID entityID, real64 dt)
+void runCleanGlobalTransformsSystem(
+	Scene *scene,
+	EntityHandle entityID,
+	void **components,
+	real64 dt)
 {
-	TransformComponent *transform = sceneGetComponentFromEntity(
-		scene,
-		entityID,
-		transformComponentID);
+	TransformComponent *transform = components[0];
 
 	transform->lastGlobalPosition = transform->globalPosition;
 	transform->lastGlobalRotation = transform->globalRotation;
@@ -58,13 +60,20 @@ void runCleanGlobalTransformsSystem(Scene *scene, UUID entityID, real64 dt)
 
 System createCleanGlobalTransformsSystem(void)
 {
-	transformComponentID = idFromName("transform");
+	transformComponentID = componentTypeFromName("transform");
 
 	System cleanGlobalTransforms = {};
 
-	cleanGlobalTransforms.componentTypes = createList(sizeof(UUID));
+	cleanGlobalTransforms.componentTypes = createList(
+		sizeof(ComponentTypeHandle));
 	listPushFront(&cleanGlobalTransforms.componentTypes, &transformComponentID);
 
+	cleanGlobalTransforms.writeComponentTypes = createList(
+		sizeof(ComponentTypeHandle));
+	listPushFront(
+		&cleanGlobalTransforms.writeComponentTypes,
+		&transformComponentID);
+
 	cleanGlobalTransforms.init = &initCleanGlobalTransformsSystem;
 	cleanGlobalTransforms.begin = 0;
 	cleanGlobalTransforms.run = &runCleanGlobalTransformsSystem;
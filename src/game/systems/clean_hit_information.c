@@ -2,40 +2,43 @@
 
 #include "data/data_types.h"
 #include "data/list.h"
+#include "data/intern_table.h"
 
 #include "ECS/ecs_types.h"
 #include "ECS/scene.h"
+#include "ECS/component.h"
 
 #include "components/component_types.h"
 
 #include <string.h>
 
-internal UUID hitInformationComponentID = {};
+internal ComponentTypeHandle hitInformationComponentID = INVALID_HANDLE;
 
 internal
-void runCleanHitInformationSystem(Scene *scene, UUID entityID, real64 dt)
+void runCleanHitInformationSystem(
+	Scene *scene,
+	EntityHandle entityID,
+	void **components,
+	real64 dt)
 {
-	HitInformationComponent *hitInformation = sceneGetComponentFromEntity(
-		scene,
-		entityID,
-		hitInformationComponentID);
+	HitInformationComponent *hitInformation = components[0];
 
 	if (hitInformation->age >= 0)
 	{
 		if (++hitInformation->age > 2)
 		{
-			sceneRemoveEntity(scene, entityID);
+			sceneDeferRemoveEntity(scene, entityID);
 		}
 	}
 }
 
 System createCleanHitInformationSystem(void)
 {
-	hitInformationComponentID = idFromName("hit_information");
+	hitInformationComponentID = componentTypeFromName("hit_information");
 
 	System ret = {};
 
-	ret.componentTypes = createList(sizeof(UUID));
+	ret.componentTypes = createList(sizeof(ComponentTypeHandle));
 	listPushFront(&ret.componentTypes, &hitInformationComponentID);
 
 	ret.init = 0;
@@ -2,26 +2,29 @@
 
 #include "data/data_types.h"
 #include "data/list.h"
+#include "data/intern_table.h"
 
 #include "ECS/ecs_types.h"
 #include "ECS/scene.h"
+#include "ECS/component.h"
 
 #include "components/component_types.h"
 
-internal UUID collisionComponentID = {};
-internal UUID hitListComponentID = {};
+internal ComponentTypeHandle collisionComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle hitListComponentID = INVALID_HANDLE;
 
 internal
-void runCleanHitListSystem(Scene *scene, UUID entityID, real64 dt)
+void runCleanHitListSystem(
+	Scene *scene,
+	EntityHandle entityID,
+	void **components,
+	real64 dt)
 {
-	CollisionComponent *collision = sceneGetComponentFromEntity(
-		scene,
-		entityID,
-		collisionComponentID);
-
-	UUID nextItem = {};
-	for (UUID currentListItem = collision->lastHitList;
-		 strcmp(currentListItem.string, "");
+	CollisionComponent *collision = components[0];
+
+	EntityHandle nextItem = INVALID_HANDLE;
+	for (EntityHandle currentListItem = collision->lastHitList;
+		 currentListItem != INVALID_HANDLE;
 		 currentListItem = nextItem)
 	{
 		HitListComponent *hitList = sceneGetComponentFromEntity(
@@ -29,23 +32,28 @@ void runCleanHitListSystem(Scene *scene, UUID entityID, real64 dt)
 			currentListItem,
 			hitListComponentID);
 
+		if (!hitList)
+		{
+			break;
+		}
+
 		nextItem = hitList->nextHit;
 
-		sceneRemoveEntity(scene, currentListItem);
+		sceneDeferRemoveEntity(scene, currentListItem);
 	}
 
 	collision->lastHitList = collision->hitList;
-	collision->hitList = idFromName("");
+	collision->hitList = INVALID_HANDLE;
 }
 
 System createCleanHitListSystem(void)
 {
-	collisionComponentID = idFromName("collision");
-	hitListComponentID = idFromName("hit_list");
+	collisionComponentID = componentTypeFromName("collision");
+	hitListComponentID = componentTypeFromName("hit_list");
 
 	System ret = {};
 
-	ret.componentTypes = createList(sizeof(UUID));
+	ret.componentTypes = createList(sizeof(ComponentTypeHandle));
 	listPushFront(&ret.componentTypes, &collisionComponentID);
 
 	ret.run = &runCleanHitListSystem;
@@ -11,6 +11,7 @@
 
 #include "ECS/ecs_types.h"
 #include "ECS/scene.h"
+#include "ECS/component.h"
 
 #include "components/component_types.h"
 #include "components/transform.h"
@@ -18,6 +19,7 @@
 
 #include "data/data_types.h"
 #include "data/list.h"
+#include "data/intern_table.h"
 
 #include <kazmath/mat4.h>
 #include <kazmath/mat3.h>
@@ -48,13 +50,14 @@ internal Uniform customColorUniform;
 
 internal uint32 collisionPrimitiveRendererRefCount = 0;
 
-internal UUID transformComponentID = {};
-internal UUID cameraComponentID = {};
-internal UUID debugCollisionPrimitiveComponentID = {};
-internal UUID collisionTreeNodeComponentID = {};
-internal UUID boxComponentID = {};
-internal UUID sphereComponentID = {};
-internal UUID capsuleComponentID = {};
+internal ComponentTypeHandle transformComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle cameraComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle debugCollisionPrimitiveComponentID =
+	INVALID_HANDLE;
+internal ComponentTypeHandle collisionTreeNodeComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle boxComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle sphereComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle capsuleComponentID = INVALID_HANDLE;
 
 internal CameraComponent *camera;
 internal TransformComponent *cameraTransform;
@@ -63,7 +66,7 @@ extern real64 alpha;
 
 internal void drawCollisionPrimitives(
 	Scene *scene,
-	UUID entity,
+	EntityHandle entity,
 	TransformComponent *transformComponent,
 	DebugCollisionPrimitiveComponent *debugCollisionPrimitive,
 	CollisionTreeNodeComponent *collisionTreeNode);
@@ -92,6 +95,11 @@ void initCollisionPrimitiveRendererSystem(Scene *scene)
 		loadModel(CYLINDER_MODEL_NAME);
 		loadModel(HEMISPHERE_MODEL_NAME);
 
+		acquireModel(BOX_MODEL_NAME);
+		acquireModel(SPHERE_MODEL_NAME);
+		acquireModel(CYLINDER_MODEL_NAME);
+		acquireModel(HEMISPHERE_MODEL_NAME);
+
 		createShaderProgram(
 			VERTEX_SHADER_FILE,
 			NULL,
@@ -137,12 +145,12 @@ void beginCollisionPrimitiveRendererSystem(Scene *scene, real64 dt)
 {
 	camera = sceneGetComponentFromEntity(
 		scene,
-		scene->mainCamera,
+		scene->mainCameraEntity,
 		cameraComponentID);
 
 	cameraTransform = sceneGetComponentFromEntity(
 		scene,
-		scene->mainCamera,
+		scene->mainCameraEntity,
 		transformComponentID);
 
 	if (!camera || !cameraTransform)
@@ -156,28 +164,25 @@ void beginCollisionPrimitiveRendererSystem(Scene *scene, real64 dt)
 }
 
 internal
-void runCollisionPrimitiveRendererSystem(Scene *scene, UUID entity, real64 dt)
+void runCollisionPrimitiveRendererSystem(
+	Scene *scene,
+	EntityHandle entity,
+	void **components,
+	real64 dt)
 {
 	if (!camera || !cameraTransform)
 	{
 		return;
 	}
 
-	DebugCollisionPrimitiveComponent *debugCollisionPrimitive =
-		sceneGetComponentFromEntity(
-			scene,
-			entity,
-			debugCollisionPrimitiveComponentID);
+	DebugCollisionPrimitiveComponent *debugCollisionPrimitive = components[0];
 
 	if (!debugCollisionPrimitive->visible)
 	{
 		return;
 	}
 
-	TransformComponent *transform = sceneGetComponentFromEntity(
-		scene,
-		entity,
-		transformComponentID);
+	TransformComponent *transform = components[1];
 	CollisionTreeNodeComponent *collisionTreeNode = sceneGetComponentFromEntity(
 		scene,
 		entity,
@@ -211,6 +216,11 @@ void shutdownCollisionPrimitiveRendererSystem(Scene *scene)
 
 		glDeleteProgram(shaderProgram);
 
+		releaseModel(BOX_MODEL_NAME);
+		releaseModel(SPHERE_MODEL_NAME);
+		releaseModel(CYLINDER_MODEL_NAME);
+		releaseModel(HEMISPHERE_MODEL_NAME);
+
 		LOG("Successfully shut down collision primitive renderer\n");
 	}
 }
@@ -219,19 +229,21 @@ System createCollisionPrimitiveRendererSystem(void)
 {
 	System system = {};
 
-	transformComponentID = idFromName("transform");
-	cameraComponentID = idFromName("camera");
+	transformComponentID = componentTypeFromName("transform");
+	cameraComponentID = componentTypeFromName("camera");
 	debugCollisionPrimitiveComponentID =
-		idFromName("debug_collision_primitive");
-	collisionTreeNodeComponentID = idFromName("collision_tree_node");
-	boxComponentID = idFromName("box");
-	sphereComponentID = idFromName("sphere");
-	capsuleComponentID = idFromName("capsule");
+		componentTypeFromName("debug_collision_primitive");
+	collisionTreeNodeComponentID = componentTypeFromName("collision_tree_node");
+	boxComponentID = componentTypeFromName("box");
+	sphereComponentID = componentTypeFromName("sphere");
+	capsuleComponentID = componentTypeFromName("capsule");
 
-	system.componentTypes = createList(sizeof(UUID));
+	system.componentTypes = createList(sizeof(ComponentTypeHandle));
 	listPushFront(&system.componentTypes, &transformComponentID);
 	listPushFront(&system.componentTypes, &debugCollisionPrimitiveComponentID);
 
+	system.mainThread = true;
+
 	system.init = &initCollisionPrimitiveRendererSystem;
 	system.begin = &beginCollisionPrimitiveRendererSystem;
 	system.run = &runCollisionPrimitiveRendererSystem;
@@ -243,7 +255,7 @@ System createCollisionPrimitiveRendererSystem(void)
 
 void drawCollisionPrimitives(
 	Scene *scene,
-	UUID entity,
+	EntityHandle entity,
 	TransformComponent *transformComponent,
 	DebugCollisionPrimitiveComponent *debugCollisionPrimitive,
 	CollisionTreeNodeComponent *collisionTreeNode)
@@ -253,21 +265,22 @@ void drawCollisionPrimitives(
 		UUID child = transformComponent->firstChild;
 
 		do {
+			EntityHandle childEntity = sceneGetEntity(scene, child);
 			TransformComponent *childTransform = sceneGetComponentFromEntity(
 				scene,
-				child,
+				childEntity,
 				transformComponentID);
 			CollisionTreeNodeComponent *childCollisionTreeNode =
 				sceneGetComponentFromEntity(
 					scene,
-					child,
+					childEntity,
 					collisionTreeNodeComponentID);
 
 			if (childTransform)
 			{
 				drawCollisionPrimitives(
 					scene,
-					child,
+					childEntity,
 					childTransform,
 					debugCollisionPrimitive,
 					childCollisionTreeNode);
@@ -328,8 +341,8 @@ void drawCollisionPrimitives(
 			return;
 	}
 
-	Model model = getModel(modelName);
-	if (strlen(model.name.string) == 0)
+	Model *model = getModel(modelName);
+	if (!model)
 	{
 		return;
 	}
@@ -404,13 +417,13 @@ void drawCollisionPrimitives(
 		drawCollisionPrimitive(
 			&transform,
 			debugCollisionPrimitive,
-			&model,
+			model,
 			&color,
-			entity);
+			sceneGetEntityID(scene, entity));
 
 		model = getModel(HEMISPHERE_MODEL_NAME);
 
-		if (strlen(model.name.string) == 0)
+		if (!model)
 		{
 			return;
 		}
@@ -434,9 +447,9 @@ void drawCollisionPrimitives(
 		drawCollisionPrimitive(
 			&offsetTransform,
 			debugCollisionPrimitive,
-			&model,
+			model,
 			&color,
-			entity);
+			sceneGetEntityID(scene, entity));
 
 		addOffset(
 			&transform,
@@ -451,9 +464,9 @@ void drawCollisionPrimitives(
 	drawCollisionPrimitive(
 		&transform,
 		debugCollisionPrimitive,
-		&model,
+		model,
 		&color,
-		entity);
+		sceneGetEntityID(scene, entity));
 }
 
 void drawCollisionPrimitive(
@@ -3,9 +3,11 @@
 #include "core/log.h"
 
 #include "asset_management/asset_manager_types.h"
+#include "asset_management/asset_file.h"
 #include "asset_management/cubemap.h"
 #include "asset_management/model.h"
 #include "asset_management/mesh.h"
+#include "asset_management/mesh_file.h"
 
 #include "renderer/renderer_types.h"
 #include "renderer/renderer_utilities.h"
@@ -13,6 +15,7 @@
 
 #include "ECS/ecs_types.h"
 #include "ECS/scene.h"
+#include "ECS/component.h"
 
 #include "components/component_types.h"
 #include "components/transform.h"
@@ -20,6 +23,7 @@
 
 #include "data/data_types.h"
 #include "data/list.h"
+#include "data/intern_table.h"
 
 #define VERTEX_SHADER_FILE "resources/shaders/cubemap.vert"
 #define FRAGMENT_SHADER_FILE "resources/shaders/cubemap.frag"
@@ -34,9 +38,9 @@ internal Uniform cubemapTextureUniform;
 
 internal uint32 cubemapRendererRefCount = 0;
 
-internal UUID transformComponentID = {};
-internal UUID cameraComponentID = {};
-internal UUID cubemapComponentID = {};
+internal ComponentTypeHandle transformComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle cameraComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle cubemapComponentID = INVALID_HANDLE;
 
 internal CameraComponent *camera;
 internal TransformComponent *cameraTransform;
@@ -96,12 +100,12 @@ internal void beginCubemapRendererSystem(Scene *scene, real64 dt)
 {
 	camera = sceneGetComponentFromEntity(
 		scene,
-		scene->mainCamera,
+		scene->mainCameraEntity,
 		cameraComponentID);
 
 	cameraTransform = sceneGetComponentFromEntity(
 		scene,
-		scene->mainCamera,
+		scene->mainCameraEntity,
 		transformComponentID);
 
 	if (!camera || !cameraTransform || !cubemapMeshLoaded)
@@ -132,7 +136,11 @@ internal void beginCubemapRendererSystem(Scene *scene, real64 dt)
 	setUniform(cubemapTextureUniform, 1, &textureIndex);
 }
 
-internal void runCubemapRendererSystem(Scene *scene, UUID entity, real64 dt)
+internal void runCubemapRendererSystem(
+	Scene *scene,
+	EntityHandle entity,
+	void **components,
+	real64 dt)
 {
 	if (!camera ||
 		!cameraTransform ||
@@ -142,19 +150,16 @@ internal void runCubemapRendererSystem(Scene *scene, UUID entity, real64 dt)
 		return;
 	}
 
-	CubemapComponent *cubemapComponent = sceneGetComponentFromEntity(
-		scene,
-		entity,
-		cubemapComponentID);
+	CubemapComponent *cubemapComponent = components[0];
 
-	Cubemap cubemap = getCubemap(cubemapComponent->name);
+	Cubemap *cubemap = getCubemap(cubemapComponent->name);
 
-	if (strlen(cubemap.name.string) == 0)
+	if (!cubemap)
 	{
 		return;
 	}
 
-	currentCubemap = cubemap;
+	currentCubemap = *cubemap;
 
 	glBindVertexArray(cubemapMesh.vertexArray);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubemapMesh.indexBuffer);
@@ -165,7 +170,7 @@ internal void runCubemapRendererSystem(Scene *scene, UUID entity, real64 dt)
 	}
 
 	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap.cubemapID);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap->cubemapID);
 
 	glGetBooleanv(GL_DEPTH_WRITEMASK, &glDepthMaskValue);
 
@@ -178,7 +183,7 @@ internal void runCubemapRendererSystem(Scene *scene, UUID entity, real64 dt)
 		GL_UNSIGNED_INT,
 		NULL);
 
-	logGLError(false, "Failed to draw cubemap (%s)", cubemap.name.string);
+	logGLError(false, "Failed to draw cubemap (%s)", cubemap->name.string);
 
 	glDepthMask(glDepthMaskValue);
 	glFrontFace(GL_CCW);
@@ -222,13 +227,15 @@ System createCubemapRendererSystem(void)
 {
 	System system = {};
 
-	transformComponentID = idFromName("transform");
-	cameraComponentID = idFromName("camera");
-	cubemapComponentID = idFromName("cubemap");
+	transformComponentID = componentTypeFromName("transform");
+	cameraComponentID = componentTypeFromName("camera");
+	cubemapComponentID = componentTypeFromName("cubemap");
 
-	system.componentTypes = createList(sizeof(UUID));
+	system.componentTypes = createList(sizeof(ComponentTypeHandle));
 	listPushFront(&system.componentTypes, &cubemapComponentID);
 
+	system.mainThread = true;
+
 	system.init = &initCubemapRendererSystem;
 	system.begin = &beginCubemapRendererSystem;
 	system.run = &runCubemapRendererSystem;
@@ -256,16 +263,15 @@ int32 loadCubemapMesh(void)
 
 	free(cubemapMeshFolder);
 
-	FILE *file = fopen(filename, "rb");
+	FILE *file = openAssetFile(filename);
 
 	if (file)
 	{
-		uint8 meshBinaryFileVersion;
-		fread(&meshBinaryFileVersion, sizeof(uint8), 1, file);
+		uint8 meshBinaryFileVersion = readMeshFileHeader(file);
 
-		if (meshBinaryFileVersion < MESH_BINARY_FILE_VERSION)
+		if (meshBinaryFileVersion < MIN_MESH_BINARY_FILE_VERSION)
 		{
-			LOG("WARNING: %s out of date\n", filename);
+			LOG_WARNING("%s out of date\n", filename);
 			error = -1;
 		}
 	}
@@ -8,6 +8,7 @@
 
 #include "ECS/ecs_types.h"
 #include "ECS/scene.h"
+#include "ECS/component.h"
 
 #include "components/component_types.h"
 #include "components/transform.h"
@@ -15,6 +16,7 @@
 
 #include "data/data_types.h"
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 #include "data/list.h"
 
 #include <stddef.h>
@@ -59,12 +61,12 @@ internal GLuint shaderProgram;
 internal Uniform viewUniform;
 internal Uniform projectionUniform;
 
-internal UUID transformComponentID = {};
-internal UUID cameraComponentID = {};
-internal UUID debugPrimitiveComponentID = {};
-internal UUID debugPointComponentID = {};
-internal UUID debugLineComponentID = {};
-internal UUID debugTransformComponentID = {};
+internal ComponentTypeHandle transformComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle cameraComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle debugPrimitiveComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle debugPointComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle debugLineComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle debugTransformComponentID = INVALID_HANDLE;
 
 internal CameraComponent *camera;
 internal TransformComponent *cameraTransform;
@@ -143,16 +145,14 @@ internal void initDebugRendererSystem(Scene *scene)
 	debugRendererRefCount++;
 }
 
-internal void runDebugRendererSystem(Scene *scene, UUID entity, real64 dt)
+internal void runDebugRendererSystem(
+	Scene *scene,
+	EntityHandle entity,
+	void **components,
+	real64 dt)
 {
-	TransformComponent *transform = sceneGetComponentFromEntity(
-		scene,
-		entity,
-		transformComponentID);
-	DebugPrimitiveComponent *debugPrimitive = sceneGetComponentFromEntity(
-		scene,
-		entity,
-		debugPrimitiveComponentID);
+	TransformComponent *transform = components[1];
+	DebugPrimitiveComponent *debugPrimitive = components[0];
 	DebugPointComponent *debugPoint = sceneGetComponentFromEntity(
 		scene,
 		entity,
@@ -182,7 +182,7 @@ internal void runDebugRendererSystem(Scene *scene, UUID entity, real64 dt)
 	{
 		TransformComponent *endpointTransform =  sceneGetComponentFromEntity(
 			scene,
-			debugLine->endpoint,
+			sceneGetEntity(scene, debugLine->endpoint),
 			transformComponentID);
 
 		if (endpointTransform)
@@ -213,12 +213,12 @@ internal void endDebugRendererSystem(Scene *scene, real64 dt)
 {
 	camera = sceneGetComponentFromEntity(
 		scene,
-		scene->mainCamera,
+		scene->mainCameraEntity,
 		cameraComponentID);
 
 	cameraTransform = sceneGetComponentFromEntity(
 		scene,
-		scene->mainCamera,
+		scene->mainCameraEntity,
 		transformComponentID);
 
 	if (!camera || !cameraTransform)
@@ -267,17 +267,19 @@ System createDebugRendererSystem(void)
 {
 	System system = {};
 
-	transformComponentID = idFromName("transform");
-	cameraComponentID = idFromName("camera");
-	debugPrimitiveComponentID = idFromName("debug_primitive");
-	debugPointComponentID = idFromName("debug_point");
-	debugLineComponentID = idFromName("debug_line");
-	debugTransformComponentID = idFromName("debug_transform");
+	transformComponentID = componentTypeFromName("transform");
+	cameraComponentID = componentTypeFromName("camera");
+	debugPrimitiveComponentID = componentTypeFromName("debug_primitive");
+	debugPointComponentID = componentTypeFromName("debug_point");
+	debugLineComponentID = componentTypeFromName("debug_line");
+	debugTransformComponentID = componentTypeFromName("debug_transform");
 
-	system.componentTypes = createList(sizeof(UUID));
+	system.componentTypes = createList(sizeof(ComponentTypeHandle));
 	listPushFront(&system.componentTypes, &transformComponentID);
 	listPushFront(&system.componentTypes, &debugPrimitiveComponentID);
 
+	system.mainThread = true;
+
 	system.init = &initDebugRendererSystem;
 	system.run = &runDebugRendererSystem;
 	system.end = &endDebugRendererSystem;
@@ -325,11 +327,12 @@ void initializeVertexBuffer(DebugVertexBuffer *vertexBuffer)
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
 
-	vertexBuffer->vertexData = createHashMap(
+	vertexBuffer->vertexData = createHashMapWithHashFunction(
 		sizeof(real32),
 		sizeof(DebugVertexData),
 		VERTEX_DATA_BUCKET_COUNT,
-		(ComparisonOp)&floatcmp);
+		(ComparisonOp)&floatcmp,
+		&hashBytes);
 
 	clearVertexBuffer(vertexBuffer);
 }
@@ -436,7 +439,7 @@ void addTransforms(
 		do {
 			TransformComponent *childTransform = sceneGetComponentFromEntity(
 				scene,
-				child,
+				sceneGetEntity(scene, child),
 				transformComponentID);
 
 			if (childTransform)
@@ -10,6 +10,7 @@
 
 #include "data/data_types.h"
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 #include "data/list.h"
 
 #include "ECS/ecs_types.h"
@@ -30,16 +31,16 @@
 
 internal UUID defaultFontEntityID = {};
 
-internal UUID guiTransformComponentID = {};
-internal UUID panelComponentID = {};
-internal UUID widgetComponentID = {};
-internal UUID fontComponentID = {};
-internal UUID textComponentID = {};
-internal UUID imageComponentID = {};
-internal UUID buttonComponentID = {};
-internal UUID textFieldComponentID = {};
-internal UUID progressBarComponentID = {};
-internal UUID sliderComponentID = {};
+internal ComponentTypeHandle guiTransformComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle panelComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle widgetComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle fontComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle textComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle imageComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle buttonComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle textFieldComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle progressBarComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle sliderComponentID = INVALID_HANDLE;
 
 extern uint32 guiRefCount;
 
@@ -104,7 +105,7 @@ GLuint guiIndexBuffer;
 
 typedef struct panel_layer_t
 {
-	UUID entity;
+	EntityHandle entity;
 	PanelComponent *panel;
 } PanelLayer;
 
@@ -113,9 +114,9 @@ internal void quickSortPanelLayers(
 	int32 left,
 	int32 right);
 
-internal Font getEntityFont(
+internal Font* getEntityFont(
 	Scene *scene,
-	UUID entity,
+	EntityHandle entity,
 	FontComponent *fallbackFontComponent,
 	Font *fallBackFont,
 	FontComponent **fontComponent);
@@ -127,8 +128,8 @@ internal struct nk_rect getRect(
 
 internal void addWidgets(
 	Scene *scene,
-	UUID entity,
-	UUID panel,
+	UUID widgetID,
+	EntityHandle panel,
 	real32 panelWidth,
 	real32 panelHeight);
 internal void addText(TextComponent *text, FontComponent *font);
@@ -171,7 +172,8 @@ internal void initGUISystem(Scene *scene)
 			nk_buffer_init_default(&cmds);
 
 			loadImage(WIDGET_BACKGROUND, false);
-			widgetBackground = getImage(WIDGET_BACKGROUND);
+			acquireImage(WIDGET_BACKGROUND);
+			memset(&widgetBackground, 0, sizeof(Image));
 
 			memset(&nkConfig, 0, sizeof(struct nk_convert_config));
 			nkConfig.shape_AA = NK_ANTI_ALIASING_ON;
@@ -242,19 +244,19 @@ internal void beginGUISystem(Scene *scene, real64 dt)
 	if (viewportHeight != previousViewportHeight)
 	{
 		ComponentDataTable *fontComponents =
-			*(ComponentDataTable**)hashMapGetData(
-				scene->componentTypes,
-				&fontComponentID);
+			sceneGetComponentDataTable(
+				scene,
+				fontComponentID);
 
 		for (ComponentDataTableIterator itr = cdtGetIterator(fontComponents);
 			 !cdtIteratorAtEnd(itr);
 			 cdtMoveIterator(&itr))
 		{
 			FontComponent *fontComponent = cdtIteratorGetData(itr);
-			if (strlen(getFont(
+			if (!getFont(
 					fontComponent->name,
 					fontComponent->size,
-					fontComponent->autoScaling).name.string) == 0)
+					fontComponent->autoScaling))
 			{
 				loadFont(
 					fontComponent->name,
@@ -268,13 +270,21 @@ internal void beginGUISystem(Scene *scene, real64 dt)
 
 	defaultFontComponent = sceneGetComponentFromEntity(
 		scene,
-		defaultFontEntityID,
+		sceneGetEntity(scene, defaultFontEntityID),
 		fontComponentID);
 
-	defaultFont = getFont(
+	Font *font = getFont(
 		defaultFontComponent->name,
 		defaultFontComponent->size,
 		defaultFontComponent->autoScaling);
+	if (font)
+	{
+		defaultFont = *font;
+	}
+	else
+	{
+		memset(&defaultFont, 0, sizeof(Font));
+	}
 
 	if (updateDefaultFont)
 	{
@@ -292,7 +302,15 @@ internal void beginGUISystem(Scene *scene, real64 dt)
 
 	previousViewportHeight = viewportHeight;
 
-	widgetBackground = getImage(WIDGET_BACKGROUND);
+	Image *widgetBackgroundImage = getImage(WIDGET_BACKGROUND);
+	if (widgetBackgroundImage)
+	{
+		widgetBackground = *widgetBackgroundImage;
+	}
+	else
+	{
+		memset(&widgetBackground, 0, sizeof(Image));
+	}
 
 	glBindVertexArray(guiVertexArray);
 	glBindBuffer(GL_ARRAY_BUFFER, guiVertexBuffer);
@@ -315,9 +333,9 @@ internal void beginGUISystem(Scene *scene, real64 dt)
 	PanelLayer *panelLayers = NULL;
 
 	ComponentDataTable *panelComponents =
-		*(ComponentDataTable**)hashMapGetData(
-			scene->componentTypes,
-			&panelComponentID);
+		sceneGetComponentDataTable(
+			scene,
+			panelComponentID);
 
 	for (ComponentDataTableIterator itr = cdtGetIterator(panelComponents);
 		 !cdtIteratorAtEnd(itr);
@@ -339,7 +357,7 @@ internal void beginGUISystem(Scene *scene, real64 dt)
 
 		PanelLayer *panelLayer = &panelLayers[numPanelLayers++];
 		panelLayer->panel = panelComponent;
-		panelLayer->entity = cdtIteratorGetUUID(itr);
+		panelLayer->entity = cdtIteratorGetEntity(itr);
 	}
 
 	quickSortPanelLayers(panelLayers, 0, numPanelLayers - 1);
@@ -349,7 +367,7 @@ internal void beginGUISystem(Scene *scene, real64 dt)
 		PanelLayer *panelLayer = &panelLayers[i];
 
 		PanelComponent *panel = panelLayer->panel;
-		UUID entityID = panelLayer->entity;
+		EntityHandle entityID = panelLayer->entity;
 
 		ctx.style.window.fixed_background = nk_style_item_color(
 		getColor(&panel->color));
@@ -365,7 +383,11 @@ internal void beginGUISystem(Scene *scene, real64 dt)
 			viewportHeight);
 
 		char windowTitle[1024];
-		sprintf(windowTitle, "%s_%s", scene->name, entityID.string);
+		sprintf(
+			windowTitle,
+			"%s_%s",
+			scene->name,
+			sceneGetEntityID(scene, entityID).string);
 
 		if (nk_begin(
 			&ctx,
@@ -412,6 +434,8 @@ internal void shutdownGUISystem(Scene *scene)
 
 		glDeleteVertexArrays(1, &guiVertexArray);
 
+		releaseImage(WIDGET_BACKGROUND);
+
 		LOG("Successfully shut down GUI\n");
 	}
 }
@@ -420,23 +444,25 @@ System createGUISystem(void)
 {
 	defaultFontEntityID = idFromName("default_font");
 
-	guiTransformComponentID = idFromName("gui_transform");
-	panelComponentID = idFromName("panel");
-	widgetComponentID = idFromName("widget");
-	fontComponentID = idFromName("font");
-	textComponentID = idFromName("text");
-	imageComponentID = idFromName("image");
-	buttonComponentID = idFromName("button");
-	textFieldComponentID = idFromName("text_field");
-	progressBarComponentID = idFromName("progress_bar");
-	sliderComponentID = idFromName("slider");
+	guiTransformComponentID = componentTypeFromName("gui_transform");
+	panelComponentID = componentTypeFromName("panel");
+	widgetComponentID = componentTypeFromName("widget");
+	fontComponentID = componentTypeFromName("font");
+	textComponentID = componentTypeFromName("text");
+	imageComponentID = componentTypeFromName("image");
+	buttonComponentID = componentTypeFromName("button");
+	textFieldComponentID = componentTypeFromName("text_field");
+	progressBarComponentID = componentTypeFromName("progress_bar");
+	sliderComponentID = componentTypeFromName("slider");
 
 	System system = {};
 
-	system.componentTypes = createList(sizeof(UUID));
+	system.componentTypes = createList(sizeof(ComponentTypeHandle));
 	listPushFront(&system.componentTypes, &guiTransformComponentID);
 	listPushFront(&system.componentTypes, &panelComponentID);
 
+	system.mainThread = true;
+
 	system.init = &initGUISystem;
 	system.begin = &beginGUISystem;
 	system.end = &endGUISystem;
@@ -471,9 +497,9 @@ void quickSortPanelLayers(PanelLayer *panelLayers, int32 left, int32 right)
 	quickSortPanelLayers(panelLayers, count, right);
 }
 
-Font getEntityFont(
+Font* getEntityFont(
 	Scene *scene,
-	UUID entity,
+	EntityHandle entity,
 	FontComponent *fallbackFontComponent,
 	Font *fallBackFont,
 	FontComponent **fontComponent)
@@ -497,18 +523,18 @@ Font getEntityFont(
 
 	if (entityFontComponent)
 	{
-		Font font = getFont(
+		Font *font = getFont(
 			entityFontComponent->name,
 			entityFontComponent->size,
 			entityFontComponent->autoScaling);
 
-		if (strlen(font.name.string) > 0)
+		if (font)
 		{
 			return font;
 		}
 	}
 
-	return *fallBackFont;
+	return fallBackFont;
 }
 
 struct nk_color getColor(kmVec4 *color)
@@ -596,13 +622,13 @@ struct nk_rect getRect(
 
 void addWidgets(
 	Scene *scene,
-	UUID entity,
-	UUID panel,
+	UUID widgetID,
+	EntityHandle panel,
 	real32 panelWidth,
 	real32 panelHeight)
 {
 	FontComponent *panelFontComponent;
-	Font panelFont = getEntityFont(
+	Font *panelFont = getEntityFont(
 		scene,
 		panel,
 		defaultFontComponent,
@@ -611,6 +637,8 @@ void addWidgets(
 
 	do
 	{
+		EntityHandle entity = sceneGetEntity(scene, widgetID);
+
 		GUITransformComponent *guiTransform = sceneGetComponentFromEntity(
 			scene,
 			entity,
@@ -625,14 +653,14 @@ void addWidgets(
 			if (widget->enabled)
 			{
 				FontComponent *fontComponent;
-				Font font = getEntityFont(
+				Font *font = getEntityFont(
 					scene,
 					entity,
 					panelFontComponent,
-					&panelFont,
+					panelFont,
 					&fontComponent);
 
-				nk_style_set_font(&ctx, &font.font->handle);
+				nk_style_set_font(&ctx, &font->font->handle);
 
 				struct nk_rect rect = getRect(
 					guiTransform,
@@ -705,7 +733,7 @@ void addWidgets(
 				}
 			}
 
-			entity = widget->nextWidget;
+			widgetID = widget->nextWidget;
 		}
 		else
 		{
@@ -770,9 +798,9 @@ void addImage(
 	real32 panelWidth,
 	real32 panelHeight)
 {
-	Image image = getImage(imageComponent->name);
+	Image *image = getImage(imageComponent->name);
 
-	if (strlen(image.name.string) == 0)
+	if (!image)
 	{
 		return;
 	}
@@ -784,9 +812,9 @@ void addImage(
 
 	struct nk_rect widgetRect = getRect(guiTransform, panelWidth, panelHeight);
 
-	real32 width = (image.data.width / widgetRect.w) * imageComponent->scale.x;
+	real32 width = (image->data.width / widgetRect.w) * imageComponent->scale.x;
 	real32 height =
-		(image.data.height / widgetRect.h) * imageComponent->scale.x;
+		(image->data.height / widgetRect.h) * imageComponent->scale.x;
 
 	if (width > 1.0f)
 	{
@@ -811,7 +839,7 @@ void addImage(
 
 	nk_image_color(
 		&ctx,
-		nk_image_id(image.id),
+		nk_image_id(image->id),
 		getColor(&imageComponent->color));
 }
 
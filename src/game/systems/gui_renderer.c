@@ -206,7 +206,9 @@ System createGUIRendererSystem(void)
 {
 	System system = {};
 
-	system.componentTypes = createList(sizeof(UUID));
+	system.componentTypes = createList(sizeof(ComponentTypeHandle));
+
+	system.mainThread = true;
 
 	system.init = &initGUIRendererSystem;
 	system.begin = &beginGUIRendererSystem;
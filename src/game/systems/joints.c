@@ -4,6 +4,7 @@
 
 #include "data/data_types.h"
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 #include "data/list.h"
 
 #include "ECS/ecs_types.h"
@@ -17,16 +18,16 @@
 
 #include <string.h>
 
-internal UUID transformComponentID = {};
-internal UUID jointInfoComponentID = {};
-internal UUID rigidBodyComponentID = {};
-internal UUID jointConstraintComponentID = {};
+internal ComponentTypeHandle transformComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle jointInfoComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle rigidBodyComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle jointConstraintComponentID = INVALID_HANDLE;
 
-internal UUID jointHingeComponentID = {};
-internal UUID jointHinge2ComponentID = {};
-internal UUID jointSliderComponentID = {};
-internal UUID jointBallSocketComponentID = {};
-internal UUID jointBallSocket2ComponentID = {};
+internal ComponentTypeHandle jointHingeComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle jointHinge2ComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle jointSliderComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle jointBallSocketComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle jointBallSocket2ComponentID = INVALID_HANDLE;
 
 internal
 void setJointConstraints(
@@ -79,13 +80,13 @@ internal
 void initJointInformationSystem(Scene *scene)
 {
 	for (ComponentDataTableIterator itr = cdtGetIterator(
-			 *(ComponentDataTable **)hashMapGetData(
-				 scene->componentTypes,
-				 &jointInfoComponentID));
+			 sceneGetComponentDataTable(
+				 scene,
+				 jointInfoComponentID));
 		 !cdtIteratorAtEnd(itr);
 		 cdtMoveIterator(&itr))
 	{
-		UUID entityID = cdtIteratorGetUUID(itr);
+		EntityHandle entityID = cdtIteratorGetEntity(itr);
 
 		JointInformationComponent *joint = cdtIteratorGetData(itr);
 
@@ -96,12 +97,12 @@ void initJointInformationSystem(Scene *scene)
 
 		RigidBodyComponent *object1 = sceneGetComponentFromEntity(
 			scene,
-			joint->object1,
+			sceneGetEntity(scene, joint->object1),
 			rigidBodyComponentID);
 
 		RigidBodyComponent *object2 = sceneGetComponentFromEntity(
 			scene,
-			joint->object2,
+			sceneGetEntity(scene, joint->object2),
 			rigidBodyComponentID);
 
 		if (!(object1 || object2))
@@ -177,7 +178,8 @@ void initJointInformationSystem(Scene *scene)
 		} break;
 		default:
 		{
-			LOG("Invalid joint type added on entity %s\n", entityID.string);
+			LOG("Invalid joint type added on entity %s\n",
+				sceneGetEntityID(scene, entityID).string);
 		} break;
 		}
 
@@ -307,7 +309,11 @@ void initJointInformationSystem(Scene *scene)
 }
 
 internal
-void runJointInformationSystem(Scene *scene, UUID entityID, real64 dt)
+void runJointInformationSystem(
+	Scene *scene,
+	EntityHandle entityID,
+	void **components,
+	real64 dt)
 {
 	TransformComponent *trans = sceneGetComponentFromEntity(
 		scene,
@@ -328,20 +334,20 @@ void runJointInformationSystem(Scene *scene, UUID entityID, real64 dt)
 
 System createJointInformationSystem(void)
 {
-	transformComponentID = idFromName("transform");
-	jointInfoComponentID = idFromName("joint_information");
-	rigidBodyComponentID = idFromName("rigid_body");
-	jointConstraintComponentID = idFromName("joint_constraint");
+	transformComponentID = componentTypeFromName("transform");
+	jointInfoComponentID = componentTypeFromName("joint_information");
+	rigidBodyComponentID = componentTypeFromName("rigid_body");
+	jointConstraintComponentID = componentTypeFromName("joint_constraint");
 
-	jointHingeComponentID = idFromName("hinge_joint");
-	jointHinge2ComponentID = idFromName("hinge2_joint");
-	jointSliderComponentID = idFromName("slider_joint");
-	jointBallSocketComponentID = idFromName("ball_socket_joint");
-	jointBallSocket2ComponentID = idFromName("ball_socket2_joint");
+	jointHingeComponentID = componentTypeFromName("hinge_joint");
+	jointHinge2ComponentID = componentTypeFromName("hinge2_joint");
+	jointSliderComponentID = componentTypeFromName("slider_joint");
+	jointBallSocketComponentID = componentTypeFromName("ball_socket_joint");
+	jointBallSocket2ComponentID = componentTypeFromName("ball_socket2_joint");
 
 	System sys = {};
 
-	sys.componentTypes = createList(sizeof(UUID));
+	sys.componentTypes = createList(sizeof(ComponentTypeHandle));
 	listPushFront(&sys.componentTypes, &jointInfoComponentID);
 
 	sys.init = initJointInformationSystem;
@@ -5,6 +5,7 @@
 #include "data/data_types.h"
 #include "data/list.h"
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 
 #include "ECS/ecs_types.h"
 #include "ECS/scene.h"
@@ -13,8 +14,8 @@
 #include "components/component_types.h"
 #include "components/light.h"
 
-internal UUID transformComponentID = {};
-internal UUID lightComponentID = {};
+internal ComponentTypeHandle transformComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle lightComponentID = INVALID_HANDLE;
 
 internal uint32 lightsSystemRefCount = 0;
 
@@ -74,7 +75,7 @@ internal void beginLightsSystem(Scene *scene, real64 dt)
 
 	TransformComponent *cameraTransform = sceneGetComponentFromEntity(
 		scene,
-		scene->mainCamera,
+		scene->mainCameraEntity,
 		transformComponentID);
 
 	if (!cameraTransform)
@@ -97,9 +98,9 @@ internal void beginLightsSystem(Scene *scene, real64 dt)
 	}
 
 	ComponentDataTable *lightComponents =
-		*(ComponentDataTable**)hashMapGetData(
-			scene->componentTypes,
-			&lightComponentID);
+		sceneGetComponentDataTable(
+			scene,
+			lightComponentID);
 
 	for (ComponentDataTableIterator itr = cdtGetIterator(lightComponents);
 		 !cdtIteratorAtEnd(itr);
@@ -110,7 +111,7 @@ internal void beginLightsSystem(Scene *scene, real64 dt)
 		{
 			TransformComponent *transform = sceneGetComponentFromEntity(
 				scene,
-				cdtIteratorGetUUID(itr),
+				cdtIteratorGetEntity(itr),
 				transformComponentID);
 
 			kmVec3 displacement;
@@ -209,16 +210,14 @@ internal void beginLightsSystem(Scene *scene, real64 dt)
 		numOverflowShadowSpotlights * sizeof(TransformComponent*));
 }
 
-internal void runLightsSystem(Scene *scene, UUID entity, real64 dt)
+internal void runLightsSystem(
+	Scene *scene,
+	EntityHandle entity,
+	void **components,
+	real64 dt)
 {
-	TransformComponent *transform = sceneGetComponentFromEntity(
-		scene,
-		entity,
-		transformComponentID);
-	LightComponent *light = sceneGetComponentFromEntity(
-		scene,
-		entity,
-		lightComponentID);
+	TransformComponent *transform = components[1];
+	LightComponent *light = components[0];
 
 	switch (light->type)
 	{
@@ -246,15 +245,19 @@ internal void shutdownLightsSystem(Scene *scene)
 
 System createLightsSystem(void)
 {
-	transformComponentID = idFromName("transform");
-	lightComponentID = idFromName("light");
+	transformComponentID = componentTypeFromName("transform");
+	lightComponentID = componentTypeFromName("light");
 
 	System system = {};
 
-	system.componentTypes = createList(sizeof(UUID));
+	system.componentTypes = createList(sizeof(ComponentTypeHandle));
 	listPushFront(&system.componentTypes, &transformComponentID);
 	listPushFront(&system.componentTypes, &lightComponentID);
 
+	system.readComponentTypes = createList(sizeof(ComponentTypeHandle));
+	listPushFront(&system.readComponentTypes, &transformComponentID);
+	listPushFront(&system.readComponentTypes, &lightComponentID);
+
 	system.init = &initLightsSystem;
 	system.begin = &beginLightsSystem;
 	system.run = &runLightsSystem;
@@ -11,10 +11,12 @@
 
 #include "data/data_types.h"
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 #include "data/list.h"
 
 #include "ECS/ecs_types.h"
 #include "ECS/scene.h"
+#include "ECS/component.h"
 
 #include "renderer/renderer_utilities.h"
 
@@ -54,8 +56,8 @@ internal uint32 numTextures;
 
 internal uint32 particleRendererSystemRefCount = 0;
 
-internal UUID transformComponentID = {};
-internal UUID cameraComponentID = {};
+internal ComponentTypeHandle transformComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle cameraComponentID = INVALID_HANDLE;
 
 internal CameraComponent *camera;
 internal TransformComponent *cameraTransform;
@@ -190,12 +192,12 @@ internal void beginParticleRendererSystem(Scene *scene, real64 dt)
 
 	camera = sceneGetComponentFromEntity(
 		scene,
-		scene->mainCamera,
+		scene->mainCameraEntity,
 		cameraComponentID);
 
 	cameraTransform = sceneGetComponentFromEntity(
 		scene,
-		scene->mainCamera,
+		scene->mainCameraEntity,
 		transformComponentID);
 
 	if (!camera || !cameraTransform)
@@ -224,16 +226,20 @@ internal void beginParticleRendererSystem(Scene *scene, real64 dt)
 			continue;
 		}
 
-		Particle particleTexture = getParticle(
+		Particle *particleTexture = getParticle(
 			particleEmitter->currentParticle);
 
 		int32 texture = -1;
-		if (strlen(particleTexture.name.string) > 0)
+		kmVec2 spriteSize = {};
+
+		if (particleTexture)
 		{
+			spriteSize = particleTexture->spriteSize;
+
 			bool unique = true;
 			for (uint32 i = 0; i < numTextures; i++)
 			{
-				if (textures[i] == particleTexture.id)
+				if (textures[i] == particleTexture->id)
 				{
 					texture = i;
 					unique = false;
@@ -244,7 +250,7 @@ internal void beginParticleRendererSystem(Scene *scene, real64 dt)
 			if (unique)
 			{
 				texture = numTextures;
-				textures[numTextures++] = particleTexture.id;
+				textures[numTextures++] = particleTexture->id;
 			}
 		}
 		else
@@ -280,7 +286,7 @@ internal void beginParticleRendererSystem(Scene *scene, real64 dt)
 				&position,
 				&particle->size,
 				&particle->uv,
-				&particleTexture.spriteSize,
+				&spriteSize,
 				&particle->color,
 				texture);
 		}
@@ -404,10 +410,12 @@ System createParticleRendererSystem(void)
 {
 	System system = {};
 
-	transformComponentID = idFromName("transform");
-	cameraComponentID = idFromName("camera");
+	transformComponentID = componentTypeFromName("transform");
+	cameraComponentID = componentTypeFromName("camera");
+
+	system.componentTypes = createList(sizeof(ComponentTypeHandle));
 
-	system.componentTypes = createList(sizeof(UUID));
+	system.mainThread = true;
 
 	system.init = &initParticleRendererSystem;
 	system.begin = &beginParticleRendererSystem;
@@ -8,26 +8,36 @@
 
 #include "data/data_types.h"
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 #include "data/list.h"
 
 #include "ECS/ecs_types.h"
 #include "ECS/scene.h"
 #include "ECS/component.h"
+#include "ECS/query.h"
 
 #include "math/math.h"
 
 #include <malloc.h>
+#include <pthread.h>
 
 internal uint32 particleSimulatorSystemRefCount = 0;
 
-internal UUID transformComponentID = {};
-internal UUID particleEmitterComponentID = {};
-internal UUID particleComponentID = {};
+internal ComponentTypeHandle transformComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle particleEmitterComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle particleComponentID = INVALID_HANDLE;
 
 #define PARTICLE_EMITTERS_BUCKET_COUNT 127
 
 extern HashMap particleEmitters;
 
+// Emitters which ran out of particles while stopping. Stopping an emitter
+// removes it from the particle emitter map, which can't happen while other
+// threads are reading the map.
+internal List stoppedParticleEmitters;
+internal pthread_mutex_t stoppedParticleEmittersMutex =
+	PTHREAD_MUTEX_INITIALIZER;
+
 internal ParticleList* getParticleList(
 	UUID entity,
 	ParticleEmitterComponent *particleEmitter);
@@ -46,25 +56,28 @@ internal void initParticleSimulatorSystem(Scene *scene)
 			sizeof(ParticleList),
 			PARTICLE_EMITTERS_BUCKET_COUNT,
 			(ComparisonOp)&ptrcmp);
+
+		stoppedParticleEmitters = createList(
+			sizeof(ParticleEmitterReference));
 	}
 
-	ComponentDataTable **particleComponents =
-		(ComponentDataTable**)hashMapGetData(
-			scene->componentTypes,
-			&particleComponentID);
+	ComponentDataTable *particleComponents = sceneGetComponentDataTable(
+		scene,
+		particleComponentID);
 
-	if (particleComponents && *particleComponents)
+	if (particleComponents)
 	{
 		for (ComponentDataTableIterator itr =
-				 cdtGetIterator(*particleComponents);
-			 !cdtIteratorAtEnd(itr);)
+				 cdtGetIterator(particleComponents);
+			 !cdtIteratorAtEnd(itr);
+			 cdtMoveIterator(&itr))
 		{
 			ParticleComponent *particleComponent = cdtIteratorGetData(itr);
 
 			ParticleEmitterComponent *particleEmitter =
 				sceneGetComponentFromEntity(
 					scene,
-					particleComponent->particleEmitter,
+					sceneGetEntity(scene, particleComponent->particleEmitter),
 					particleEmitterComponentID);
 
 			if (particleEmitter)
@@ -83,17 +96,17 @@ internal void initParticleSimulatorSystem(Scene *scene)
 				particleList->numParticles++;
 			}
 
-			UUID entity = cdtIteratorGetUUID(itr);
-			cdtMoveIterator(&itr);
-			sceneRemoveEntity(scene, entity);
+			sceneDeferRemoveEntity(scene, cdtIteratorGetEntity(itr));
 		}
 
-		sceneRegisterEntity(scene, particleComponentID);
+		EntityHandle particlePrototypeEntity = sceneDeferRegisterEntity(
+			scene,
+			idFromName("particle"));
 
 		ParticleComponent particlePrototype = {};
-		sceneAddComponentToEntity(
+		sceneDeferAddComponentToEntity(
 			scene,
-			particleComponentID,
+			particlePrototypeEntity,
 			particleComponentID,
 			&particlePrototype);
 	}
@@ -101,24 +114,55 @@ internal void initParticleSimulatorSystem(Scene *scene)
 	particleSimulatorSystemRefCount++;
 }
 
-internal void runParticleSimulatorSystem(Scene *scene, UUID entityID, real64 dt)
+internal void beginParticleSimulatorSystem(Scene *scene, real64 dt)
 {
-	ParticleEmitterComponent *particleEmitter = sceneGetComponentFromEntity(
-		scene,
-		entityID,
-		particleEmitterComponentID);
+	ComponentTypeHandle componentTypes[2] = {
+		particleEmitterComponentID,
+		transformComponentID
+	};
+
+	Query *query = sceneGetQuery(scene, 2, componentTypes);
+
+	if (!query)
+	{
+		return;
+	}
+
+	// Emitters run in parallel, so every particle list has to exist before
+	// they start since inserting into the map can move the other lists
+	for (QueryIterator itr = queryGetIterator(query, scene);
+		 !queryIteratorAtEnd(itr);
+		 queryMoveIterator(&itr))
+	{
+		ParticleEmitterComponent *particleEmitter =
+			queryIteratorGetComponent(itr, 0);
+
+		if (particleEmitter->active)
+		{
+			getParticleList(
+				sceneGetEntityID(scene, queryIteratorGetEntity(itr)),
+				particleEmitter);
+		}
+	}
+}
+
+internal void runParticleSimulatorSystem(
+	Scene *scene,
+	EntityHandle entityID,
+	void **components,
+	real64 dt)
+{
+	ParticleEmitterComponent *particleEmitter = components[0];
 
 	if (!particleEmitter->active)
 	{
 		return;
 	}
 
-	TransformComponent *transform = sceneGetComponentFromEntity(
-		scene,
-		entityID,
-		transformComponentID);
+	TransformComponent *transform = components[1];
 
-	ParticleList *particleList = getParticleList(entityID, particleEmitter);
+	UUID entityUUID = sceneGetEntityID(scene, entityID);
+	ParticleList *particleList = getParticleList(entityUUID, particleEmitter);
 
 	if (!particleEmitter->paused)
 	{
@@ -154,12 +198,20 @@ internal void runParticleSimulatorSystem(Scene *scene, UUID entityID, real64 dt)
 			particle->lifetime -= dt;
 			if (particle->lifetime <= 0.0)
 			{
-				if (removeParticle(
-					entityID,
-					particleEmitter,
-					particleList,
-					&listItr) == -1)
+				listRemove(&particleList->particles, &listItr);
+				particleList->numParticles--;
+
+				if (particleEmitter->stopping
+					&& particleList->numParticles == 0)
 				{
+					ParticleEmitterReference reference;
+					reference.entity = entityUUID;
+					reference.particleEmitter = particleEmitter;
+
+					pthread_mutex_lock(&stoppedParticleEmittersMutex);
+					listPushBack(&stoppedParticleEmitters, &reference);
+					pthread_mutex_unlock(&stoppedParticleEmittersMutex);
+
 					return;
 				}
 			}
@@ -202,6 +254,8 @@ internal void runParticleSimulatorSystem(Scene *scene, UUID entityID, real64 dt)
 		return;
 	}
 
+	Particle *particleTexture = getParticle(particleEmitter->currentParticle);
+
 	for (ListIterator listItr = listGetIterator(&particleList->particles);
 		 !listIteratorAtEnd(listItr);
 		 listMoveIterator(&listItr))
@@ -218,11 +272,9 @@ internal void runParticleSimulatorSystem(Scene *scene, UUID entityID, real64 dt)
 		kmVec3Scale(&displacement, &particle->velocity, dt);
 		kmVec3Add(&particle->position, &particle->position, &displacement);
 
-		Particle particleTexture = getParticle(
-			particleEmitter->currentParticle);
-		if (strlen(particleTexture.name.string) > 0)
+		if (particleTexture)
 		{
-			uint32 lastSprite = particleTexture.numSprites - 1;
+			uint32 lastSprite = particleTexture->numSprites - 1;
 
 			if (particle->sprite == -1)
 			{
@@ -292,7 +344,7 @@ internal void runParticleSimulatorSystem(Scene *scene, UUID entityID, real64 dt)
 						if (particle->sprite != particleEmitter->finalSprite)
 						{
 							particle->sprite = nextSprite %
-								particleTexture.numSprites;
+								particleTexture->numSprites;
 						}
 
 						break;
@@ -312,7 +364,7 @@ internal void runParticleSimulatorSystem(Scene *scene, UUID entityID, real64 dt)
 						break;
 					case PARTICLE_ANIMATION_LOOP_FORWARD:
 						particle->sprite = nextSprite %
-							particleTexture.numSprites;
+							particleTexture->numSprites;
 						break;
 					case PARTICLE_ANIMATION_LOOP_BACKWARD:
 						if (nextSprite == -1)
@@ -329,7 +381,7 @@ internal void runParticleSimulatorSystem(Scene *scene, UUID entityID, real64 dt)
 					case PARTICLE_ANIMATION_BOUNCING_BACKWARD:
 						if (particle->animationDirection == 1)
 						{
-							if (nextSprite == particleTexture.numSprites)
+							if (nextSprite == particleTexture->numSprites)
 							{
 								particle->animationDirection = -1;
 								nextSprite = particle->sprite - 1;
@@ -356,17 +408,34 @@ internal void runParticleSimulatorSystem(Scene *scene, UUID entityID, real64 dt)
 
 			kmVec2Assign(
 				&particle->uv,
-				&particleTexture.spriteUVs[particle->sprite]);
+				&particleTexture->spriteUVs[particle->sprite]);
 		}
 	}
 }
 
+internal void endParticleSimulatorSystem(Scene *scene, real64 dt)
+{
+	for (ListIterator itr = listGetIterator(&stoppedParticleEmitters);
+		 !listIteratorAtEnd(itr);
+		 listMoveIterator(&itr))
+	{
+		ParticleEmitterReference *reference = LIST_ITERATOR_GET_ELEMENT(
+			ParticleEmitterReference,
+			itr);
+
+		stopParticleEmitter(
+			reference->entity,
+			reference->particleEmitter,
+			true);
+	}
+
+	listClear(&stoppedParticleEmitters);
+}
+
 internal void shutdownParticleSimulatorSystem(Scene *scene)
 {
-	ComponentDataTable **particleEmitterComponents =
-		(ComponentDataTable**)hashMapGetData(
-			scene->componentTypes,
-			&particleEmitterComponentID);
+	ComponentDataTable *particleEmitterComponents =
+		sceneGetComponentDataTable(scene, particleEmitterComponentID);
 
 	for (HashMapIterator itr = hashMapGetIterator(particleEmitters);
 		 !hashMapIteratorAtEnd(itr);)
@@ -376,7 +445,7 @@ internal void shutdownParticleSimulatorSystem(Scene *scene)
 
 		bool inScene = false;
 		for (ComponentDataTableIterator itr =
-				 cdtGetIterator(*particleEmitterComponents);
+				 cdtGetIterator(particleEmitterComponents);
 			 !cdtIteratorAtEnd(itr);
 			 cdtMoveIterator(&itr))
 		{
@@ -415,7 +484,7 @@ internal void shutdownParticleSimulatorSystem(Scene *scene)
 				particleObject,
 				sizeof(ParticleObject));
 
-			UUID particleEntity = sceneCreateEntity(scene);
+			EntityHandle particleEntity = sceneCreateEntity(scene);
 			sceneAddComponentToEntity(
 				scene,
 				particleEntity,
@@ -433,6 +502,7 @@ internal void shutdownParticleSimulatorSystem(Scene *scene)
 	if (--particleSimulatorSystemRefCount == 0)
 	{
 		freeHashMap(&particleEmitters);
+		listClear(&stoppedParticleEmitters);
 	}
 }
 
@@ -440,16 +510,26 @@ System createParticleSimulatorSystem(void)
 {
 	System system = {};
 
-	transformComponentID = idFromName("transform");
-	particleEmitterComponentID = idFromName("particle_emitter");
-	particleComponentID = idFromName("particle");
+	transformComponentID = componentTypeFromName("transform");
+	particleEmitterComponentID = componentTypeFromName("particle_emitter");
+	particleComponentID = componentTypeFromName("particle");
 
-	system.componentTypes = createList(sizeof(UUID));
+	system.componentTypes = createList(sizeof(ComponentTypeHandle));
 	listPushFront(&system.componentTypes, &transformComponentID);
 	listPushFront(&system.componentTypes, &particleEmitterComponentID);
 
+	system.readComponentTypes = createList(sizeof(ComponentTypeHandle));
+	listPushFront(&system.readComponentTypes, &transformComponentID);
+
+	system.writeComponentTypes = createList(sizeof(ComponentTypeHandle));
+	listPushFront(&system.writeComponentTypes, &particleEmitterComponentID);
+
+	system.parallel = true;
+
 	system.init = &initParticleSimulatorSystem;
+	system.begin = &beginParticleSimulatorSystem;
 	system.run = &runParticleSimulatorSystem;
+	system.end = &endParticleSimulatorSystem;
 	system.shutdown = &shutdownParticleSimulatorSystem;
 
 	return system;
@@ -215,7 +215,9 @@ System createPostProcessingSystem(void)
 {
 	System system = {};
 
-	system.componentTypes = createList(sizeof(UUID));
+	system.componentTypes = createList(sizeof(ComponentTypeHandle));
+
+	system.mainThread = true;
 
 	system.init = &initPostProcessingSystem;
 	system.begin = &beginPostProcessingSystem;
@@ -6,6 +6,7 @@
 
 #include "data/data_types.h"
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 #include "data/list.h"
 
 #include "ECS/ecs_types.h"
@@ -36,9 +37,9 @@
 
 #define INDEX(x, y, max) ((y) * (max) + (x))
 
-internal UUID heightmapComponentID = {};
-internal UUID cameraComponentID = {};
-internal UUID transformComponentID = {};
+internal ComponentTypeHandle heightmapComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle cameraComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle transformComponentID = INVALID_HANDLE;
 
 internal CameraComponent *camera;
 internal TransformComponent *cameraTransform;
@@ -78,11 +79,12 @@ void initRenderHeightmapSystem(Scene *scene)
 	{
 		LOG("Initializing heightmap renderer...\n");
 
-		heightmapModels = createHashMap(
+		heightmapModels = createHashMapWithHashFunction(
 			sizeof(Scene *),
 			sizeof(HashMap),
 			SCENE_BUCKET_COUNT,
-			&ptrEq);
+			&ptrEq,
+			&hashBytes);
 
 		createShaderProgram(
 			VERTEX_SHADER_FILE,
@@ -120,22 +122,23 @@ void initRenderHeightmapSystem(Scene *scene)
 
 	rendererRefCount++;
 
-	HashMap map = createHashMap(
-		sizeof(UUID),
+	HashMap map = createHashMapWithHashFunction(
+		sizeof(EntityHandle),
 		sizeof(HeightmapModel),
 		SCENE_BUCKET_COUNT,
-		(ComparisonOp)&strcmp);
+		&compareHandles,
+		&hashBytes);
 	hashMapInsert(heightmapModels, &scene, &map);
 
 	// iterate over all the heightmaps and load the images and create geometry for it
 	for (ComponentDataTableIterator itr = cdtGetIterator(
-			 *(ComponentDataTable **)hashMapGetData(
-				 scene->componentTypes,
-				 &heightmapComponentID));
+			 sceneGetComponentDataTable(
+				 scene,
+				 heightmapComponentID));
 		 !cdtIteratorAtEnd(itr);
 		 cdtMoveIterator(&itr))
 	{
-		UUID entityID = cdtIteratorGetUUID(itr);
+		EntityHandle entityID = cdtIteratorGetEntity(itr);
 		HeightmapComponent *heightmap = cdtIteratorGetData(itr);
 		TransformComponent *transform = sceneGetComponentFromEntity(
 			scene,
@@ -216,8 +219,9 @@ void initRenderHeightmapSystem(Scene *scene)
 
 		dGeomSetQuaternion(heightmap->heightfieldGeom, q);
 
+		UUID entityUUID = sceneGetEntityID(scene, entityID);
 		void *userData = calloc(1, sizeof(UUID));
-		memcpy(userData, &entityID, sizeof(UUID));
+		memcpy(userData, &entityUUID, sizeof(UUID));
 		dGeomSetData(heightmap->heightfieldGeom, userData);
 
 		// Create verts at the correct heights (currently it's doing it wrong)
@@ -452,12 +456,12 @@ void beginRenderHeightmapSystem(Scene *scene, real64 dt)
 {
 	camera = sceneGetComponentFromEntity(
 		scene,
-		scene->mainCamera,
+		scene->mainCameraEntity,
 		cameraComponentID);
 
 	cameraTransform = sceneGetComponentFromEntity(
 		scene,
-		scene->mainCamera,
+		scene->mainCameraEntity,
 		transformComponentID);
 
 	if (!camera || !cameraTransform)
@@ -471,7 +475,11 @@ void beginRenderHeightmapSystem(Scene *scene, real64 dt)
 }
 
 internal
-void runRenderHeightmapSystem(Scene *scene, UUID entityID, real64 dt)
+void runRenderHeightmapSystem(
+	Scene *scene,
+	EntityHandle entityID,
+	void **components,
+	real64 dt)
 {
 	if (!camera || !cameraTransform)
 	{
@@ -487,17 +495,14 @@ void runRenderHeightmapSystem(Scene *scene, UUID entityID, real64 dt)
 	if (!heightmapModel)
 	{
 		LOG("No heightmap loaded for entity %s, skipping render\n",
-			entityID.string);
+			sceneGetEntityID(scene, entityID).string);
 		return;
 	}
 
 	Mesh *heightmap = &heightmapModel->mesh;
 	Material *material = &heightmapModel->material;
 
-	TransformComponent *transform = sceneGetComponentFromEntity(
-		scene,
-		entityID,
-		transformComponentID);
+	TransformComponent *transform = components[1];
 
 	kmMat4 transformMat = tGetInterpolatedTransformMatrix(
 		transform,
@@ -555,14 +560,14 @@ void shutdownRenderHeightmapSystem(Scene *scene)
 	HashMap *map = hashMapGetData(heightmapModels, &scene);
 
 	for (ComponentDataTableIterator itr = cdtGetIterator(
-			 *(ComponentDataTable **)hashMapGetData(
-				 scene->componentTypes,
-				 &heightmapComponentID));
+			 sceneGetComponentDataTable(
+				 scene,
+				 heightmapComponentID));
 		 !cdtIteratorAtEnd(itr);
 		 cdtMoveIterator(&itr))
 	{
 		HeightmapComponent *heightmap = cdtIteratorGetData(itr);
-		UUID entity = cdtIteratorGetUUID(itr);
+		EntityHandle entity = cdtIteratorGetEntity(itr);
 
 		HeightmapModel *hm = hashMapGetData(*map, &entity);
 		Mesh *m = &hm->mesh;
@@ -598,16 +603,18 @@ void shutdownRenderHeightmapSystem(Scene *scene)
 
 System createRenderHeightmapSystem(void)
 {
-	heightmapComponentID = idFromName("heightmap");
-	cameraComponentID = idFromName("camera");
-	transformComponentID = idFromName("transform");
+	heightmapComponentID = componentTypeFromName("heightmap");
+	cameraComponentID = componentTypeFromName("camera");
+	transformComponentID = componentTypeFromName("transform");
 
 	System ret = {};
 
-	ret.componentTypes = createList(sizeof(UUID));
+	ret.componentTypes = createList(sizeof(ComponentTypeHandle));
 	listPushFront(&ret.componentTypes, &transformComponentID);
 	listPushFront(&ret.componentTypes, &heightmapComponentID);
 
+	ret.mainThread = true;
+
 	ret.init = &initRenderHeightmapSystem;
 	ret.begin = &beginRenderHeightmapSystem;
 	ret.run = &runRenderHeightmapSystem;
@@ -17,10 +17,12 @@
 
 #include "data/data_types.h"
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 #include "data/list.h"
 
 #include "ECS/ecs_types.h"
 #include "ECS/scene.h"
+#include "ECS/component.h"
 
 #include "math/math.h"
 
@@ -117,11 +119,11 @@ internal HashMap *skeletons;
 
 internal uint32 rendererRefCount = 0;
 
-internal UUID transformComponentID = {};
-internal UUID modelComponentID = {};
-internal UUID animationComponentID = {};
-internal UUID animatorComponentID = {};
-internal UUID cameraComponentID = {};
+internal ComponentTypeHandle transformComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle modelComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle animationComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle animatorComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle cameraComponentID = INVALID_HANDLE;
 
 internal CameraComponent *camera;
 internal TransformComponent *cameraTransform;
@@ -173,7 +175,7 @@ void initRendererSystem(Scene *scene)
 
 		if (fallbackShaders)
 		{
-			LOG("WARNING: Required OpenGL extensions "
+			LOG_WARNING("Required OpenGL extensions "
 				"(GL_ARB_bindless_texture and GL_ARB_gpu_shader_int64) "
 				"are not supported\n");
 			LOG("Using fallback shaders\n");
@@ -514,12 +516,12 @@ void beginRendererSystem(Scene *scene, real64 dt)
 {
 	camera = sceneGetComponentFromEntity(
 		scene,
-		scene->mainCamera,
+		scene->mainCameraEntity,
 		cameraComponentID);
 
 	cameraTransform = sceneGetComponentFromEntity(
 		scene,
-		scene->mainCamera,
+		scene->mainCameraEntity,
 		transformComponentID);
 
 	if (!camera || !cameraTransform)
@@ -725,25 +727,26 @@ void beginRendererSystem(Scene *scene, real64 dt)
 }
 
 internal
-void runRendererSystem(Scene *scene, UUID entityID, real64 dt)
+void runRendererSystem(
+	Scene *scene,
+	EntityHandle entityID,
+	void **components,
+	real64 dt)
 {
 	if (!camera || !cameraTransform)
 	{
 		return;
 	}
 
-	ModelComponent *modelComponent = sceneGetComponentFromEntity(
-		scene,
-		entityID,
-		modelComponentID);
+	ModelComponent *modelComponent = components[0];
 
 	if (!modelComponent->visible)
 	{
 		return;
 	}
 
-	Model model = getModel(modelComponent->name);
-	if (strlen(model.name.string) == 0)
+	Model *model = getModel(modelComponent->name);
+	if (!model)
 	{
 		return;
 	}
@@ -777,10 +780,7 @@ void runRendererSystem(Scene *scene, UUID entityID, real64 dt)
 		true : false;
 	setUniform(hasAnimationsUniform, 1, &hasAnimations);
 
-	TransformComponent *transform = sceneGetComponentFromEntity(
-		scene,
-		entityID,
-		transformComponentID);
+	TransformComponent *transform = components[1];
 
 	kmMat4 worldMatrix = tGetInterpolatedTransformMatrix(
 		transform,
@@ -796,7 +796,7 @@ void runRendererSystem(Scene *scene, UUID entityID, real64 dt)
 			kmMat4Identity(&boneMatrices[i]);
 		}
 
-		Skeleton *skeleton = &model.skeleton;
+		Skeleton *skeleton = &model->skeleton;
 		for (uint32 i = 0; i < skeleton->numBoneOffsets; i++)
 		{
 			BoneOffset *boneOffset = &skeleton->boneOffsets[i];
@@ -804,11 +804,20 @@ void runRendererSystem(Scene *scene, UUID entityID, real64 dt)
 				*skeletonTransforms,
 				&boneOffset->name);
 
+			TransformComponent *jointTransformComponent = NULL;
 			if (jointTransform)
+			{
+				jointTransformComponent = sceneGetComponentFromEntity(
+					scene,
+					jointTransform->entity,
+					transformComponentID);
+			}
+
+			if (jointTransformComponent)
 			{
 				TransformComponent interpolatedJointTransform;
 				tGetInterpolatedTransform(
-					jointTransform->transform,
+					jointTransformComponent,
 					&interpolatedJointTransform.globalPosition,
 					&interpolatedJointTransform.globalRotation,
 					&interpolatedJointTransform.globalScale,
@@ -832,9 +841,9 @@ void runRendererSystem(Scene *scene, UUID entityID, real64 dt)
 
 	setUniform(modelUniform, 1, &worldMatrix);
 
-	for (uint32 i = 0; i < model.numSubsets; i++)
+	for (uint32 i = 0; i < model->numSubsets; i++)
 	{
-		Subset *subset = &model.subsets[i];
+		Subset *subset = &model->subsets[i];
 		Mesh *mesh = &subset->mesh;
 		Material *material = &subset->material;
 		Mask *mask = &subset->mask;
@@ -849,7 +858,7 @@ void runRendererSystem(Scene *scene, UUID entityID, real64 dt)
 
 		setMaterialActiveUniform(&materialActiveUniform, material);
 
-		bool opacityMaskActive = strlen(model.opacityTexture.string) > 0;
+		bool opacityMaskActive = strlen(model->opacityTexture.string) > 0;
 		setUniform(opacityMaskActiveUniform, 1, &opacityMaskActive);
 
 		if (!fallbackShaders)
@@ -913,7 +922,7 @@ void runRendererSystem(Scene *scene, UUID entityID, real64 dt)
 		if (fallbackShaders)
 		{
 			activateFallbackMaterialTextures(material, &textureIndex);
-			activateTexture(model.opacityTexture, &textureIndex);
+			activateTexture(model->opacityTexture, &textureIndex);
 		}
 
 		if (config.graphicsConfig.pbr)
@@ -933,10 +942,10 @@ void runRendererSystem(Scene *scene, UUID entityID, real64 dt)
 			setMaterialUniform(&materialUniform, material);
 			setBindlessTextureUniform(
 				&materialMaskUniform,
-				model.materialTexture);
+				model->materialTexture);
 			setBindlessTextureUniform(
 				&opacityMaskUniform,
-				model.opacityTexture);
+				model->opacityTexture);
 			setMaterialUniform(
 				&collectionMaterialUniform,
 				&mask->collectionMaterial);
@@ -976,7 +985,7 @@ void runRendererSystem(Scene *scene, UUID entityID, real64 dt)
 		logGLError(
 			false,
 			"Failed to draw model (%s), subset (%s)",
-			model.name.string,
+			model->name.string,
 			subset->name.string);
 
 		glEnable(GL_CULL_FACE);
@@ -1043,16 +1052,18 @@ System createRendererSystem(void)
 {
 	System system = {};
 
-	transformComponentID = idFromName("transform");
-	modelComponentID = idFromName("model");
-	animationComponentID = idFromName("animation");
-	animatorComponentID = idFromName("animator");
-	cameraComponentID = idFromName("camera");
+	transformComponentID = componentTypeFromName("transform");
+	modelComponentID = componentTypeFromName("model");
+	animationComponentID = componentTypeFromName("animation");
+	animatorComponentID = componentTypeFromName("animator");
+	cameraComponentID = componentTypeFromName("camera");
 
-	system.componentTypes = createList(sizeof(UUID));
+	system.componentTypes = createList(sizeof(ComponentTypeHandle));
 	listPushFront(&system.componentTypes, &transformComponentID);
 	listPushFront(&system.componentTypes, &modelComponentID);
 
+	system.mainThread = true;
+
 	system.init = &initRendererSystem;
 	system.begin = &beginRendererSystem;
 	system.run = &runRendererSystem;
@@ -16,10 +16,12 @@
 
 #include "data/data_types.h"
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 #include "data/list.h"
 
 #include "ECS/ecs_types.h"
 #include "ECS/component.h"
+#include "ECS/query.h"
 #include "ECS/scene.h"
 
 #include "math/math.h"
@@ -76,11 +78,11 @@ internal HashMap *skeletons;
 
 uint32 shadowsSystemRefCount = 0;
 
-internal UUID transformComponentID = {};
-internal UUID modelComponentID = {};
-internal UUID animationComponentID = {};
-internal UUID animatorComponentID = {};
-internal UUID cameraComponentID = {};
+internal ComponentTypeHandle transformComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle modelComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle animationComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle animatorComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle cameraComponentID = INVALID_HANDLE;
 
 uint32 numShadowDirectionalLights = 0;
 ShadowDirectionalLight shadowDirectionalLight;
@@ -122,6 +124,7 @@ internal void drawAllShadows(
 	Uniform *hasAnimationsUniform,
 	Uniform *boneTransformsUniform);
 internal void drawShadows(
+	Scene *scene,
 	ModelComponent *modelComponent,
 	TransformComponent *transform,
 	AnimationComponent *animationComponent,
@@ -331,16 +334,18 @@ System createShadowsSystem(void)
 {
 	System system = {};
 
-	transformComponentID = idFromName("transform");
-	modelComponentID = idFromName("model");
-	animationComponentID = idFromName("animation");
-	animatorComponentID = idFromName("animator");
-	cameraComponentID = idFromName("camera");
+	transformComponentID = componentTypeFromName("transform");
+	modelComponentID = componentTypeFromName("model");
+	animationComponentID = componentTypeFromName("animation");
+	animatorComponentID = componentTypeFromName("animator");
+	cameraComponentID = componentTypeFromName("camera");
 
-	system.componentTypes = createList(sizeof(UUID));
+	system.componentTypes = createList(sizeof(ComponentTypeHandle));
 	listPushFront(&system.componentTypes, &transformComponentID);
 	listPushFront(&system.componentTypes, &modelComponentID);
 
+	system.mainThread = true;
+
 	system.init = &initShadowsSystem;
 	system.begin = &beginShadowsSystem;
 	system.end = &endShadowsSystem;
@@ -393,11 +398,11 @@ void drawShadowDirectionalLight(Scene *scene)
 
 	TransformComponent *cameraTransform = sceneGetComponentFromEntity(
 		scene,
-		scene->mainCamera,
+		scene->mainCameraEntity,
 		transformComponentID);
 	CameraComponent *camera = sceneGetComponentFromEntity(
 		scene,
-		scene->mainCamera,
+		scene->mainCameraEntity,
 		cameraComponentID);
 
 	if (!cameraTransform || !camera)
@@ -736,29 +741,22 @@ void drawAllShadows(
 	Uniform *hasAnimationsUniform,
 	Uniform *boneTransformsUniform)
 {
-	ComponentDataTable *modelComponents =
-		*(ComponentDataTable**)hashMapGetData(
-			scene->componentTypes,
-			&modelComponentID);
-
-	for (ComponentDataTableIterator itr = cdtGetIterator(modelComponents);
-		 !cdtIteratorAtEnd(itr);
-		 cdtMoveIterator(&itr))
-	{
-		ModelComponent *modelComponent = cdtIteratorGetData(itr);
+	ComponentTypeHandle componentTypes[2] = {
+		modelComponentID,
+		transformComponentID
+	};
 
-		UUID entity = cdtIteratorGetUUID(itr);
+	Query *query = sceneGetQuery(scene, 2, componentTypes);
 
+	for (QueryIterator itr = queryGetIterator(query, scene);
+		 !queryIteratorAtEnd(itr);
+		 queryMoveIterator(&itr))
+	{
+		ModelComponent *modelComponent = queryIteratorGetComponent(itr, 0);
 		TransformComponent *transformComponent =
-			sceneGetComponentFromEntity(
-				scene,
-				entity,
-				transformComponentID);
+			queryIteratorGetComponent(itr, 1);
 
-		if (!transformComponent)
-		{
-			continue;
-		}
+		EntityHandle entity = queryIteratorGetEntity(itr);
 
 		AnimationComponent *animationComponent =
 			sceneGetComponentFromEntity(
@@ -772,6 +770,7 @@ void drawAllShadows(
 				animatorComponentID);
 
 		drawShadows(
+			scene,
 			modelComponent,
 			transformComponent,
 			animationComponent,
@@ -783,6 +782,7 @@ void drawAllShadows(
 }
 
 void drawShadows(
+	Scene *scene,
 	ModelComponent *modelComponent,
 	TransformComponent *transform,
 	AnimationComponent *animationComponent,
@@ -796,8 +796,8 @@ void drawShadows(
 		return;
 	}
 
-	Model model = getModel(modelComponent->name);
-	if (strlen(model.name.string) == 0)
+	Model *model = getModel(modelComponent->name);
+	if (!model)
 	{
 		return;
 	}
@@ -835,7 +835,7 @@ void drawShadows(
 			kmMat4Identity(&boneMatrices[i]);
 		}
 
-		Skeleton *skeleton = &model.skeleton;
+		Skeleton *skeleton = &model->skeleton;
 		for (uint32 i = 0; i < skeleton->numBoneOffsets; i++)
 		{
 			BoneOffset *boneOffset = &skeleton->boneOffsets[i];
@@ -843,11 +843,20 @@ void drawShadows(
 				*skeletonTransforms,
 				&boneOffset->name);
 
+			TransformComponent *jointTransformComponent = NULL;
 			if (jointTransform)
+			{
+				jointTransformComponent = sceneGetComponentFromEntity(
+					scene,
+					jointTransform->entity,
+					transformComponentID);
+			}
+
+			if (jointTransformComponent)
 			{
 				TransformComponent interpolatedJointTransform;
 				tGetInterpolatedTransform(
-					jointTransform->transform,
+					jointTransformComponent,
 					&interpolatedJointTransform.globalPosition,
 					&interpolatedJointTransform.globalRotation,
 					&interpolatedJointTransform.globalScale,
@@ -871,9 +880,9 @@ void drawShadows(
 
 	setUniform(*modelUniform, 1, &worldMatrix);
 
-	for (uint32 i = 0; i < model.numSubsets; i++)
+	for (uint32 i = 0; i < model->numSubsets; i++)
 	{
-		Subset *subset = &model.subsets[i];
+		Subset *subset = &model->subsets[i];
 		Mesh *mesh = &subset->mesh;
 
 		glBindVertexArray(mesh->vertexArray);
@@ -893,7 +902,7 @@ void drawShadows(
 		logGLError(
 			false,
 			"Failed to draw render shadows for model (%s)",
-			model.name.string);
+			model->name.string);
 
 		for (uint8 j = 0; j < NUM_VERTEX_ATTRIBUTES; j++)
 		{
@@ -4,6 +4,7 @@
 
 #include "data/data_types.h"
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 #include "data/list.h"
 
 #include "ECS/ecs_types.h"
@@ -18,13 +19,13 @@
 
 #include <math.h>
 
-internal UUID transformComponentID = {};
-internal UUID rigidBodyComponentID = {};
-internal UUID collisionComponentID = {};
-internal UUID collisionTreeNodeComponentID = {};
-internal UUID hitInformationComponentID = {};
-internal UUID hitListComponentID = {};
-internal UUID surfaceInformationComponentID = {};
+internal ComponentTypeHandle transformComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle rigidBodyComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle collisionComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle collisionTreeNodeComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle hitInformationComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle hitListComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle surfaceInformationComponentID = INVALID_HANDLE;
 
 internal
 void initSimulateRigidbodiesSystem(Scene *scene)
@@ -32,14 +33,34 @@ void initSimulateRigidbodiesSystem(Scene *scene)
 	// turn all the loaded rigidbodies into real rigidbodies
 	// for each rigidbody
 	for (ComponentDataTableIterator itr = cdtGetIterator(
-			 *(ComponentDataTable **)hashMapGetData(
-				 scene->componentTypes,
-				 &rigidBodyComponentID));
+			 sceneGetComponentDataTable(
+				 scene,
+				 rigidBodyComponentID));
 		 !cdtIteratorAtEnd(itr);
 		 cdtMoveIterator(&itr))
 	{
 		// Create a rigidbody in the physics world
-		registerRigidBody(scene, cdtIteratorGetUUID(itr));
+		registerRigidBody(scene, cdtIteratorGetEntity(itr));
+	}
+
+	ComponentDataTable *collisionComponents = sceneGetComponentDataTable(
+		scene,
+		collisionComponentID);
+
+	if (!collisionComponents)
+	{
+		return;
+	}
+
+	// Hit list handles don't mean anything once they have been saved, and
+	// the lists are rebuilt every frame anyway
+	for (ComponentDataTableIterator itr = cdtGetIterator(collisionComponents);
+		 !cdtIteratorAtEnd(itr);
+		 cdtMoveIterator(&itr))
+	{
+		CollisionComponent *collision = cdtIteratorGetData(itr);
+		collision->hitList = INVALID_HANDLE;
+		collision->lastHitList = INVALID_HANDLE;
 	}
 }
 
@@ -60,24 +81,34 @@ void nearCallback(void *data, dGeomID o1, dGeomID o2)
 		UUID *volume1 = dGeomGetData(o1);
 		UUID *volume2 = dGeomGetData(o2);
 
+		EntityHandle volume1Entity = sceneGetEntity(scene, *volume1);
+		EntityHandle volume2Entity = sceneGetEntity(scene, *volume2);
+
 		CollisionTreeNodeComponent *node1 = sceneGetComponentFromEntity(
 			scene,
-			*volume1,
+			volume1Entity,
 			collisionTreeNodeComponentID);
 
 		CollisionTreeNodeComponent *node2 = sceneGetComponentFromEntity(
 			scene,
-			*volume2,
+			volume2Entity,
 			collisionTreeNodeComponentID);
 
+		EntityHandle object1Entity = sceneGetEntity(
+			scene,
+			node1->collisionVolume);
+		EntityHandle object2Entity = sceneGetEntity(
+			scene,
+			node2->collisionVolume);
+
 		RigidBodyComponent *body1 = sceneGetComponentFromEntity(
 			scene,
-			node1->collisionVolume,
+			object1Entity,
 			rigidBodyComponentID);
 
 		RigidBodyComponent *body2 = sceneGetComponentFromEntity(
 			scene,
-			node2->collisionVolume,
+			object2Entity,
 			rigidBodyComponentID);
 
 		if (!body1 || !body2 || (node1->isTrigger && node2->isTrigger))
@@ -97,11 +128,11 @@ void nearCallback(void *data, dGeomID o1, dGeomID o2)
 		// get surface information from the two objects
 		SurfaceInformationComponent *surface1 = sceneGetComponentFromEntity(
 			scene,
-			*volume1,
+			volume1Entity,
 			surfaceInformationComponentID);
 		SurfaceInformationComponent *surface2 = sceneGetComponentFromEntity(
 			scene,
-			*volume2,
+			volume2Entity,
 			surfaceInformationComponentID);
 
 		SurfaceInformationComponent temp = {};
@@ -204,8 +235,8 @@ void nearCallback(void *data, dGeomID o1, dGeomID o2)
 			contact.geom.pos[2]);
 		hitInformation.depth = contact.geom.depth;
 
-		UUID hitInformationEntity = sceneCreateEntity(scene);
-		sceneAddComponentToEntity(
+		EntityHandle hitInformationEntity = sceneDeferCreateEntity(scene);
+		sceneDeferAddComponentToEntity(
 			scene,
 			hitInformationEntity,
 			hitInformationComponentID,
@@ -214,28 +245,28 @@ void nearCallback(void *data, dGeomID o1, dGeomID o2)
 		// create two hit_list entities and link them to the appropriate lists
 		CollisionComponent *coll1 = sceneGetComponentFromEntity(
 			scene,
-			hitInformation.object1,
+			object1Entity,
 			collisionComponentID);
 		CollisionComponent *coll2 = sceneGetComponentFromEntity(
 			scene,
-			hitInformation.object2,
+			object2Entity,
 			collisionComponentID);
 
 		HitListComponent list1 = {};
 		HitListComponent list2 = {};
 		list1.hit = hitInformationEntity;
-		list2.hit = hitInformationEntity;
+		list2.hit = list1.hit;
 		list1.nextHit = coll1->hitList;
 		list2.nextHit = coll2->hitList;
 
-		UUID list1Entity = sceneCreateEntity(scene);
-		UUID list2Entity = sceneCreateEntity(scene);
-		sceneAddComponentToEntity(
+		EntityHandle list1Entity = sceneDeferCreateEntity(scene);
+		EntityHandle list2Entity = sceneDeferCreateEntity(scene);
+		sceneDeferAddComponentToEntity(
 			scene,
 			list1Entity,
 			hitListComponentID,
 			&list1);
-		sceneAddComponentToEntity(
+		sceneDeferAddComponentToEntity(
 			scene,
 			list2Entity,
 			hitListComponentID,
@@ -254,15 +285,15 @@ void beginSimulateRigidbodiesSystem(Scene *scene, real64 dt)
 	RigidBodyComponent *body = 0;
 	CollisionComponent *coll = 0;
 	for (ComponentDataTableIterator itr = cdtGetIterator(
-			 *(ComponentDataTable **)hashMapGetData(
-				 scene->componentTypes,
-				 &rigidBodyComponentID));
+			 sceneGetComponentDataTable(
+				 scene,
+				 rigidBodyComponentID));
 		 !cdtIteratorAtEnd(itr);
 		 cdtMoveIterator(&itr))
 	{
 		body = (RigidBodyComponent *)cdtIteratorGetData(itr);
 
-		UUID entity = cdtIteratorGetUUID(itr);
+		EntityHandle entity = cdtIteratorGetEntity(itr);
 
 		trans = sceneGetComponentFromEntity(
 			scene,
@@ -276,8 +307,8 @@ void beginSimulateRigidbodiesSystem(Scene *scene, real64 dt)
 
 		if (kmQuaternionLengthSq(&trans->globalRotation) == 0.0f)
 		{
-			LOG("ERROR: Rotation with a magnitude of 0 on entity: %s\n",
-				entity.string);
+			LOG_ERROR("Rotation with a magnitude of 0 on entity: %s\n",
+				sceneGetEntityID(scene, entity).string);
 			ASSERT(false);
 		}
 
@@ -290,21 +321,19 @@ void beginSimulateRigidbodiesSystem(Scene *scene, real64 dt)
 }
 
 internal
-void runSimulateRigidbodiesSystem(Scene *scene, UUID entityID, real64 dt)
+void runSimulateRigidbodiesSystem(
+	Scene *scene,
+	EntityHandle entityID,
+	void **components,
+	real64 dt)
 {
 	// update the rest of the rigidbody information
-	TransformComponent *transform = sceneGetComponentFromEntity(
-		scene,
-		entityID,
-		transformComponentID);
+	TransformComponent *transform = components[1];
 	TransformComponent *parentTransform = sceneGetComponentFromEntity(
 		scene,
-		transform->parent,
+		sceneGetEntity(scene, transform->parent),
 		transformComponentID);
-	RigidBodyComponent *body = sceneGetComponentFromEntity(
-		scene,
-		entityID,
-		rigidBodyComponentID);
+	RigidBodyComponent *body = components[0];
 
 	const dReal *dPos = dBodyGetPosition(body->bodyID);
 	kmVec3Assign(&transform->position, (kmVec3*)dPos);
@@ -355,17 +384,18 @@ void runSimulateRigidbodiesSystem(Scene *scene, UUID entityID, real64 dt)
 
 System createSimulateRigidbodiesSystem(void)
 {
-	transformComponentID = idFromName("transform");
-	rigidBodyComponentID = idFromName("rigid_body");
-	collisionTreeNodeComponentID = idFromName("collision_tree_node");
-	collisionComponentID = idFromName("collision");
-	hitInformationComponentID = idFromName("hit_information");
-	hitListComponentID = idFromName("hit_list");
-	surfaceInformationComponentID = idFromName("surface_information");
+	transformComponentID = componentTypeFromName("transform");
+	rigidBodyComponentID = componentTypeFromName("rigid_body");
+	collisionTreeNodeComponentID = componentTypeFromName("collision_tree_node");
+	collisionComponentID = componentTypeFromName("collision");
+	hitInformationComponentID = componentTypeFromName("hit_information");
+	hitListComponentID = componentTypeFromName("hit_list");
+	surfaceInformationComponentID =
+		componentTypeFromName("surface_information");
 
 	System sys = {};
 
-	sys.componentTypes = createList(sizeof(UUID));
+	sys.componentTypes = createList(sizeof(ComponentTypeHandle));
 	listPushFront(&sys.componentTypes, &transformComponentID);
 	listPushFront(&sys.componentTypes, &rigidBodyComponentID);
 
@@ -14,10 +14,12 @@
 
 #include "data/data_types.h"
 #include "data/hash_map.h"
+#include "data/intern_table.h"
 #include "data/list.h"
 
 #include "ECS/ecs_types.h"
 #include "ECS/scene.h"
+#include "ECS/component.h"
 
 #include "renderer/renderer_types.h"
 #include "renderer/renderer_utilities.h"
@@ -50,12 +52,12 @@ internal HashMap *skeletons;
 
 internal uint32 wireframeRendererRefCount = 0;
 
-internal UUID transformComponentID = {};
-internal UUID modelComponentID = {};
-internal UUID wireframeComponentID = {};
-internal UUID animationComponentID = {};
-internal UUID animatorComponentID = {};
-internal UUID cameraComponentID = {};
+internal ComponentTypeHandle transformComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle modelComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle wireframeComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle animationComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle animatorComponentID = INVALID_HANDLE;
+internal ComponentTypeHandle cameraComponentID = INVALID_HANDLE;
 
 internal CameraComponent *camera;
 internal TransformComponent *cameraTransform;
@@ -124,12 +126,12 @@ void beginWireframeRendererSystem(Scene *scene, real64 dt)
 {
 	camera = sceneGetComponentFromEntity(
 		scene,
-		scene->mainCamera,
+		scene->mainCameraEntity,
 		cameraComponentID);
 
 	cameraTransform = sceneGetComponentFromEntity(
 		scene,
-		scene->mainCamera,
+		scene->mainCameraEntity,
 		transformComponentID);
 
 	if (!camera || !cameraTransform)
@@ -148,30 +150,28 @@ void beginWireframeRendererSystem(Scene *scene, real64 dt)
 }
 
 internal
-void runWireframeRendererSystem(Scene *scene, UUID entityID, real64 dt)
+void runWireframeRendererSystem(
+	Scene *scene,
+	EntityHandle entityID,
+	void **components,
+	real64 dt)
 {
 	if (!camera || !cameraTransform)
 	{
 		return;
 	}
 
-	WireframeComponent *wireframeComponent = sceneGetComponentFromEntity(
-		scene,
-		entityID,
-		wireframeComponentID);
+	WireframeComponent *wireframeComponent = components[0];
 
 	if (!wireframeComponent->visible)
 	{
 		return;
 	}
 
-	ModelComponent *modelComponent = sceneGetComponentFromEntity(
-		scene,
-		entityID,
-		modelComponentID);
+	ModelComponent *modelComponent = components[1];
 
-	Model model = getModel(modelComponent->name);
-	if (strlen(model.name.string) == 0)
+	Model *model = getModel(modelComponent->name);
+	if (!model)
 	{
 		return;
 	}
@@ -205,11 +205,7 @@ void runWireframeRendererSystem(Scene *scene, UUID entityID, real64 dt)
 		true : false;
 	setUniform(hasAnimationsUniform, 1, &hasAnimations);
 
-	TransformComponent transform =
-		*(TransformComponent*)sceneGetComponentFromEntity(
-			scene,
-			entityID,
-			transformComponentID);
+	TransformComponent transform = *(TransformComponent*)components[2];
 
 	kmVec3Mul(
 		&transform.lastGlobalScale,
@@ -234,7 +230,7 @@ void runWireframeRendererSystem(Scene *scene, UUID entityID, real64 dt)
 			kmMat4Identity(&boneMatrices[i]);
 		}
 
-		Skeleton *skeleton = &model.skeleton;
+		Skeleton *skeleton = &model->skeleton;
 		for (uint32 i = 0; i < skeleton->numBoneOffsets; i++)
 		{
 			BoneOffset *boneOffset = &skeleton->boneOffsets[i];
@@ -242,11 +238,20 @@ void runWireframeRendererSystem(Scene *scene, UUID entityID, real64 dt)
 				*skeletonTransforms,
 				&boneOffset->name);
 
+			TransformComponent *jointTransformComponent = NULL;
 			if (jointTransform)
+			{
+				jointTransformComponent = sceneGetComponentFromEntity(
+					scene,
+					jointTransform->entity,
+					transformComponentID);
+			}
+
+			if (jointTransformComponent)
 			{
 				TransformComponent interpolatedJointTransform;
 				tGetInterpolatedTransform(
-					jointTransform->transform,
+					jointTransformComponent,
 					&interpolatedJointTransform.globalPosition,
 					&interpolatedJointTransform.globalRotation,
 					&interpolatedJointTransform.globalScale,
@@ -270,9 +275,9 @@ void runWireframeRendererSystem(Scene *scene, UUID entityID, real64 dt)
 
 	setUniform(modelUniform, 1, &worldMatrix);
 
-	for (uint32 i = 0; i < model.numSubsets; i++)
+	for (uint32 i = 0; i < model->numSubsets; i++)
 	{
-		Subset *subset = &model.subsets[i];
+		Subset *subset = &model->subsets[i];
 		Mesh *mesh = &subset->mesh;
 
 		glBindVertexArray(mesh->vertexArray);
@@ -304,7 +309,7 @@ void runWireframeRendererSystem(Scene *scene, UUID entityID, real64 dt)
 		logGLError(
 			false,
 			"Failed to draw wireframe for model (%s), subset (%s)",
-			model.name.string,
+			model->name.string,
 			subset->name.string);
 
 		glLineWidth(lineWidth);
@@ -350,18 +355,20 @@ System createWireframeRendererSystem(void)
 {
 	System system = {};
 
-	transformComponentID = idFromName("transform");
-	modelComponentID = idFromName("model");
-	wireframeComponentID = idFromName("wireframe");
-	animationComponentID = idFromName("animation");
-	animatorComponentID = idFromName("animator");
-	cameraComponentID = idFromName("camera");
+	transformComponentID = componentTypeFromName("transform");
+	modelComponentID = componentTypeFromName("model");
+	wireframeComponentID = componentTypeFromName("wireframe");
+	animationComponentID = componentTypeFromName("animation");
+	animatorComponentID = componentTypeFromName("animator");
+	cameraComponentID = componentTypeFromName("camera");
 
-	system.componentTypes = createList(sizeof(UUID));
+	system.componentTypes = createList(sizeof(ComponentTypeHandle));
 	listPushFront(&system.componentTypes, &transformComponentID);
 	listPushFront(&system.componentTypes, &modelComponentID);
 	listPushFront(&system.componentTypes, &wireframeComponentID);
 
+	system.mainThread = true;
+
 	system.init = &initWireframeRendererSystem;
 	system.begin = &beginWireframeRendererSystem;
 	system.run = &runWireframeRendererSystem;